@@ -0,0 +1,64 @@
+// Compares the throughput of crypto_aead_xchacha20poly1305_ietf with
+// crypto_aead_aes256gcm, both stateless and through crypto_aead_aes256gcm_instance,
+// which expands the key once. AES-256-GCM is skipped on CPUs without AES-NI.
+//
+// node bench/crypto_aead.js [totalBytes]
+
+var sodium = require('..')
+
+var total = Number(process.argv[2]) || 64 * 1024 * 1024
+var sizes = [64, 1024, 16 * 1024, 1024 * 1024]
+
+var available = sodium.crypto_aead_aes256gcm_is_available()
+if (!available) console.log('crypto_aead_aes256gcm is not available on this CPU')
+
+var xkey = Buffer.alloc(sodium.crypto_aead_xchacha20poly1305_ietf_KEYBYTES)
+var xnonce = Buffer.alloc(sodium.crypto_aead_xchacha20poly1305_ietf_NPUBBYTES)
+sodium.randombytes_buf(xkey)
+sodium.randombytes_buf(xnonce)
+
+var gkey = Buffer.alloc(sodium.crypto_aead_aes256gcm_KEYBYTES)
+var gnonce = Buffer.alloc(sodium.crypto_aead_aes256gcm_NPUBBYTES)
+sodium.randombytes_buf(gkey)
+sodium.randombytes_buf(gnonce)
+
+var instance = available ? sodium.crypto_aead_aes256gcm_instance(gkey) : null
+
+sizes.forEach(function (size) {
+  var message = Buffer.alloc(size)
+  var ciphertext = Buffer.alloc(size + 16)
+  var count = Math.max(1, Math.floor(total / size))
+
+  sodium.randombytes_buf(message)
+  console.log(size + ' byte messages:')
+
+  var baseline = run('  crypto_aead_xchacha20poly1305_ietf_encrypt', size, count, null, function () {
+    for (var i = 0; i < count; i++) sodium.crypto_aead_xchacha20poly1305_ietf_encrypt(ciphertext, message, null, null, xnonce, xkey)
+  })
+
+  if (!available) return
+
+  run('  crypto_aead_aes256gcm_encrypt', size, count, baseline, function () {
+    for (var i = 0; i < count; i++) sodium.crypto_aead_aes256gcm_encrypt(ciphertext, message, null, null, gnonce, gkey)
+  })
+
+  run('  instance.encrypt', size, count, baseline, function () {
+    for (var i = 0; i < count; i++) instance.encrypt(ciphertext, message, null, null, gnonce)
+  })
+})
+
+function run (name, size, count, baseline, fn) {
+  fn() // warm up
+
+  var start = process.hrtime()
+  fn()
+  var time = process.hrtime(start)
+  var seconds = time[0] + time[1] / 1e9
+  var rate = size * count / seconds
+
+  var line = name + ': ' + (rate / (1024 * 1024)).toFixed(0) + ' MiB/s, ' + (seconds * 1e6 / count).toFixed(2) + ' us/op'
+  if (baseline) line += ' (' + (rate / baseline).toFixed(2) + 'x)'
+  console.log(line)
+
+  return rate
+}
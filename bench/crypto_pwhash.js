@@ -0,0 +1,69 @@
+// Compares the latency of consecutive crypto_pwhash_async calls with and
+// without crypto_pwhash_arena_enable, which keeps the work area of every
+// threadpool thread mapped and faulted in between calls. Arenas need a static
+// Linux build (SODIUM_NATIVE_STATIC=1).
+//
+// node bench/crypto_pwhash.js [memlimit] [count]
+
+var sodium = require('..')
+
+var memlimit = Number(process.argv[2]) || sodium.crypto_pwhash_MEMLIMIT_MODERATE
+var count = Number(process.argv[3]) || 16
+
+// consecutive calls can run on any threadpool thread, and the first call on
+// each thread maps its arena, like a call without one
+var warmup = Number(process.env.UV_THREADPOOL_SIZE) || 4
+
+var output = Buffer.alloc(32)
+var password = Buffer.from('correct horse battery staple')
+var salt = Buffer.alloc(sodium.crypto_pwhash_SALTBYTES)
+sodium.randombytes_buf(salt)
+
+console.log('crypto_pwhash_async, ' + (memlimit / (1024 * 1024)).toFixed(0) + ' MiB, ' + count + ' calls one after the other:')
+
+var runs = [['  without arenas', null]]
+
+if (sodium.crypto_pwhash_arena_available()) {
+  runs.push(['  arenas', false], ['  arenas with huge pages', true])
+} else {
+  console.log('  arenas are not available in this build')
+}
+
+next(0)
+
+function next (i) {
+  if (i === runs.length) {
+    if (sodium.crypto_pwhash_arena_available()) sodium.crypto_pwhash_arena_disable()
+    return
+  }
+
+  if (runs[i][1] !== null) {
+    sodium.crypto_pwhash_arena_disable()
+    sodium.crypto_pwhash_arena_enable(runs[i][1])
+  }
+
+  var times = []
+
+  hash(count + warmup, times, function () {
+    times.splice(0, warmup)
+    times.sort(function (a, b) { return a - b })
+
+    var mean = times.reduce(function (a, b) { return a + b }, 0) / times.length
+    var p50 = times[Math.floor(times.length / 2)]
+
+    console.log(runs[i][0] + ': mean ' + mean.toFixed(1) + ' ms, p50 ' + p50.toFixed(1) + ' ms')
+    next(i + 1)
+  })
+}
+
+function hash (left, times, cb) {
+  if (left === 0) return cb()
+
+  var start = process.hrtime()
+  sodium.crypto_pwhash_async(output, password, salt, sodium.crypto_pwhash_OPSLIMIT_INTERACTIVE, memlimit, sodium.crypto_pwhash_ALG_DEFAULT, function (err) {
+    if (err) throw err
+    var time = process.hrtime(start)
+    times.push(time[0] * 1e3 + time[1] / 1e6)
+    hash(left - 1, times, cb)
+  })
+}
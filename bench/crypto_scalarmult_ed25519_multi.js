@@ -0,0 +1,55 @@
+// Compares crypto_scalarmult_ed25519_multi with a noclamp multiplication and
+// an addition per term.
+//
+// node bench/crypto_scalarmult_ed25519_multi.js [terms]
+
+var sodium = require('..')
+
+var count = Number(process.argv[2]) || 4096
+
+var scalars = Buffer.alloc(count * sodium.crypto_scalarmult_ed25519_SCALARBYTES)
+var points = Buffer.alloc(count * sodium.crypto_scalarmult_ed25519_BYTES)
+var r = Buffer.alloc(sodium.crypto_core_ed25519_UNIFORMBYTES)
+
+sodium.randombytes_buf(scalars)
+for (var i = 0; i < count; i++) {
+  sodium.randombytes_buf(r)
+  sodium.crypto_core_ed25519_from_uniform(points.subarray(i * 32, i * 32 + 32), r)
+}
+
+var sum = Buffer.alloc(sodium.crypto_scalarmult_ed25519_BYTES)
+var q = Buffer.alloc(sodium.crypto_scalarmult_ed25519_BYTES)
+
+var baseline = run('noclamp + add', null, function () {
+  sodium.crypto_scalarmult_ed25519_noclamp(sum, scalars.subarray(0, 32), points.subarray(0, 32))
+  for (var i = 1; i < count; i++) {
+    sodium.crypto_scalarmult_ed25519_noclamp(q, scalars.subarray(i * 32, i * 32 + 32), points.subarray(i * 32, i * 32 + 32))
+    sodium.crypto_core_ed25519_add(sum, sum, q)
+  }
+})
+
+run('crypto_scalarmult_ed25519_multi', baseline, function () {
+  sodium.crypto_scalarmult_ed25519_multi(q, scalars, points)
+})
+
+var start = process.hrtime()
+sodium.crypto_scalarmult_ed25519_multi_async(q, scalars, points, function (err) {
+  if (err) throw err
+  report('crypto_scalarmult_ed25519_multi_async', baseline, process.hrtime(start))
+})
+
+function run (name, baseline, fn) {
+  var start = process.hrtime()
+  fn()
+  return report(name, baseline, process.hrtime(start))
+}
+
+function report (name, baseline, time) {
+  var ns = (time[0] * 1e9 + time[1]) / count
+
+  var line = name + ': ' + (ns / 1e3).toFixed(2) + ' us/term'
+  if (baseline) line += ' (' + (baseline / ns).toFixed(2) + 'x)'
+  console.log(line)
+
+  return ns
+}
@@ -0,0 +1,65 @@
+// Compares the stateless signing and verification functions with
+// crypto_sign_instance, which expands the secret key once, and
+// crypto_sign_verify_instance, which decodes the public key once.
+//
+// node bench/crypto_sign.js [messages] [messageLength]
+
+var sodium = require('..')
+
+var count = Number(process.argv[2]) || 20000
+var length = Number(process.argv[3]) || 64
+
+var pk = Buffer.alloc(sodium.crypto_sign_PUBLICKEYBYTES)
+var sk = Buffer.alloc(sodium.crypto_sign_SECRETKEYBYTES)
+sodium.crypto_sign_keypair(pk, sk)
+
+var messages = []
+for (var i = 0; i < count; i++) {
+  var message = Buffer.alloc(length)
+  sodium.randombytes_buf(message)
+  messages.push(message)
+}
+
+var signature = Buffer.alloc(sodium.crypto_sign_BYTES)
+var signatures = Buffer.alloc(count * sodium.crypto_sign_BYTES)
+var signer = sodium.crypto_sign_instance(sk)
+var verifier = sodium.crypto_sign_verify_instance(pk)
+
+var baseline = run('crypto_sign_detached', null, function () {
+  for (var i = 0; i < count; i++) sodium.crypto_sign_detached(signature, messages[i], sk)
+})
+
+run('instance.signDetached', baseline, function () {
+  for (var i = 0; i < count; i++) signer.signDetached(signature, messages[i])
+})
+
+run('instance.signBatch', baseline, function () {
+  signer.signBatch(signatures, messages)
+})
+
+var sigs = messages.map(function (m, i) {
+  return signatures.subarray(i * sodium.crypto_sign_BYTES, (i + 1) * sodium.crypto_sign_BYTES)
+})
+
+baseline = run('crypto_sign_verify_detached', null, function () {
+  for (var i = 0; i < count; i++) sodium.crypto_sign_verify_detached(sigs[i], messages[i], pk)
+})
+
+run('instance.verifyDetached', baseline, function () {
+  for (var i = 0; i < count; i++) verifier.verifyDetached(sigs[i], messages[i])
+})
+
+function run (name, baseline, fn) {
+  fn() // warm up
+
+  var start = process.hrtime()
+  fn()
+  var time = process.hrtime(start)
+  var ns = (time[0] * 1e9 + time[1]) / count
+
+  var line = name + ': ' + (ns / 1e3).toFixed(2) + ' us/op, ' + Math.round(1e9 / ns) + ' ops/s'
+  if (baseline) line += ' (' + (baseline / ns).toFixed(2) + 'x)'
+  console.log(line)
+
+  return ns
+}
@@ -0,0 +1,94 @@
+// Compares the throughput of crypto_aead_xchacha20poly1305_ietf_encrypt_file_async
+// and _decrypt_file_async with the io_uring and pread engines, and with reading,
+// encrypting and writing one chunk at a time from JS. The io_uring engine is
+// skipped where it is unavailable.
+//
+// node bench/file_crypt.js [totalBytes] [chunkSize]
+
+var fs = require('fs')
+var os = require('os')
+var path = require('path')
+var sodium = require('..')
+
+var total = Number(process.argv[2]) || 256 * 1024 * 1024
+var chunkSize = Number(process.argv[3]) || 256 * 1024
+
+var dir = fs.mkdtempSync(path.join(os.tmpdir(), 'sodium-native-file-crypt-'))
+var plain = path.join(dir, 'plain')
+var encrypted = path.join(dir, 'encrypted')
+var decrypted = path.join(dir, 'decrypted')
+
+var key = Buffer.alloc(sodium.crypto_aead_xchacha20poly1305_ietf_KEYBYTES)
+sodium.randombytes_buf(key)
+
+var block = Buffer.alloc(1024 * 1024)
+var fd = fs.openSync(plain, 'w')
+for (var written = 0; written < total; written += block.length) {
+  sodium.randombytes_buf(block)
+  fs.writeSync(fd, block, 0, Math.min(block.length, total - written))
+}
+fs.closeSync(fd)
+
+var engines = ['pread']
+if (sodium.crypto_aead_xchacha20poly1305_ietf_file_io_uring_available()) engines.push('io_uring')
+else console.log('io_uring is not available')
+
+console.log((total / (1024 * 1024)).toFixed(0) + ' MiB in ' + (chunkSize / 1024).toFixed(0) + ' KiB chunks:')
+
+var baseline = serial()
+next(0)
+
+// what the engines replace: read, encrypt and write one chunk after the other
+function serial () {
+  var input = fs.openSync(plain, 'r')
+  var output = fs.openSync(encrypted, 'w')
+  var message = Buffer.alloc(chunkSize)
+  var ciphertext = Buffer.alloc(chunkSize + sodium.crypto_aead_xchacha20poly1305_ietf_ABYTES)
+  var nonce = Buffer.alloc(sodium.crypto_aead_xchacha20poly1305_ietf_NPUBBYTES)
+
+  var start = process.hrtime()
+  var n = 0
+  while ((n = fs.readSync(input, message, 0, chunkSize, null)) > 0) {
+    sodium.sodium_increment(nonce)
+    var clen = sodium.crypto_aead_xchacha20poly1305_ietf_encrypt(ciphertext.subarray(0, n + 16), message.subarray(0, n), null, null, nonce, key)
+    fs.writeSync(output, ciphertext, 0, clen)
+  }
+
+  fs.closeSync(input)
+  fs.closeSync(output)
+
+  return report('  serial read, encrypt, write', process.hrtime(start), null)
+}
+
+function next (i) {
+  if (i === engines.length) {
+    fs.rmSync(dir, { recursive: true })
+    return
+  }
+
+  var opts = { engine: engines[i], chunkSize: chunkSize }
+  var start = process.hrtime()
+
+  sodium.crypto_aead_xchacha20poly1305_ietf_encrypt_file_async(plain, encrypted, key, opts, function (err) {
+    if (err) throw err
+    report('  ' + engines[i] + ' encrypt', process.hrtime(start), baseline)
+
+    start = process.hrtime()
+    sodium.crypto_aead_xchacha20poly1305_ietf_decrypt_file_async(encrypted, decrypted, key, opts, function (err) {
+      if (err) throw err
+      report('  ' + engines[i] + ' decrypt', process.hrtime(start), baseline)
+      next(i + 1)
+    })
+  })
+}
+
+function report (name, time, baseline) {
+  var seconds = time[0] + time[1] / 1e9
+  var rate = total / seconds
+
+  var line = name + ': ' + (rate / (1024 * 1024)).toFixed(0) + ' MiB/s'
+  if (baseline) line += ' (' + (rate / baseline).toFixed(2) + 'x)'
+  console.log(line)
+
+  return rate
+}
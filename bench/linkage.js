@@ -0,0 +1,109 @@
+// Compares builds of sodium.node, such as the default build against a shared
+// libsodium and a SODIUM_NATIVE_STATIC=1 build with libsodium linked in with
+// LTO: time to load the addon, and the per-call cost of calls whose work is
+// small enough that the call itself dominates.
+//
+//   npm run dev && cp -r build/Release /tmp/shared
+//   SODIUM_NATIVE_STATIC=1 npm run dev && cp -r build/Release /tmp/static
+//   node bench/linkage.js /tmp/shared /tmp/static [runs]
+//
+// Every directory must contain a sodium.node, next to the libsodium it was
+// linked against if that is a shared library.
+
+var path = require('path')
+var proc = require('child_process')
+
+var dirs = process.argv.slice(2).filter(function (arg) {
+  return !/^\d+$/.test(arg)
+})
+var runs = Number(process.argv.slice(2).filter(function (arg) {
+  return /^\d+$/.test(arg)
+})[0]) || 15
+
+if (!dirs.length) {
+  console.error('Usage: node bench/linkage.js <build dir> [<build dir> ...] [runs]')
+  process.exit(1)
+}
+
+var child = function () {
+  var file = process.argv[1]
+  var start = process.hrtime()
+  var sodium = require(file)
+  var loaded = process.hrtime(start)
+  var count = 200000
+
+  var message = Buffer.alloc(16)
+  var hash = Buffer.alloc(sodium.crypto_generichash_BYTES_MIN)
+  var key = Buffer.alloc(sodium.crypto_secretbox_KEYBYTES)
+  var nonce = Buffer.alloc(sodium.crypto_secretbox_NONCEBYTES)
+  var cipher = Buffer.alloc(message.length + sodium.crypto_secretbox_MACBYTES)
+  var a = Buffer.alloc(32)
+  var b = Buffer.alloc(32)
+
+  var result = { require: loaded[0] * 1e3 + loaded[1] / 1e6 }
+
+  time('sodium_memcmp', function () {
+    sodium.sodium_memcmp(a, b)
+  })
+  time('sodium_increment', function () {
+    sodium.sodium_increment(a)
+  })
+  time('randombytes_random', function () {
+    sodium.randombytes_random()
+  })
+  time('crypto_generichash', function () {
+    sodium.crypto_generichash(hash, message)
+  })
+  time('crypto_secretbox_easy', function () {
+    sodium.crypto_secretbox_easy(cipher, message, nonce, key)
+  })
+
+  console.log(JSON.stringify(result))
+
+  function time (name, fn) {
+    var i
+    for (i = 0; i < count; i++) fn() // warm up
+    var start = process.hrtime()
+    for (i = 0; i < count; i++) fn()
+    var t = process.hrtime(start)
+    result[name] = (t[0] * 1e9 + t[1]) / count
+  }
+}
+
+var results = dirs.map(function (dir) {
+  var file = path.resolve(dir, 'sodium.node')
+  var samples = []
+
+  for (var i = 0; i < runs; i++) {
+    var out = proc.execFileSync(process.execPath, ['-e', '(' + child.toString() + ')()', file])
+    samples.push(JSON.parse(out.toString()))
+  }
+
+  return { dir: dir, samples: samples }
+})
+
+var keys = Object.keys(results[0].samples[0])
+
+keys.forEach(function (key) {
+  var unit = key === 'require' ? 'ms' : 'ns/call'
+  var baseline = 0
+
+  console.log(key === 'require' ? 'require()' : key)
+
+  results.forEach(function (r, i) {
+    var m = median(r.samples.map(function (s) {
+      return s[key]
+    }))
+    var line = '  ' + r.dir + ': ' + m.toFixed(2) + ' ' + unit
+    if (i === 0) baseline = m
+    else line += ' (' + (baseline / m).toFixed(2) + 'x)'
+    console.log(line)
+  })
+})
+
+function median (values) {
+  values.sort(function (a, b) {
+    return a - b
+  })
+  return values[Math.floor(values.length / 2)]
+}
@@ -0,0 +1,59 @@
+// Measures the cost of require('sodium-native') in a fresh process: wall time
+// of the require itself, the heap it leaves behind, and the time to first use
+// of a typical handful of primitives.
+//
+// node bench/startup.js [runs]
+
+var path = require('path')
+var proc = require('child_process')
+
+var runs = Number(process.argv[2]) || 25
+
+var child = function () {
+  var dir = process.argv[1]
+  global.gc()
+  var heap = process.memoryUsage().heapUsed
+  var start = process.hrtime()
+  var sodium = require(dir)
+  var required = process.hrtime(start)
+
+  var key = Buffer.alloc(sodium.crypto_secretbox_KEYBYTES)
+  var nonce = Buffer.alloc(sodium.crypto_secretbox_NONCEBYTES)
+  var message = Buffer.alloc(64)
+  var cipher = Buffer.alloc(message.length + sodium.crypto_secretbox_MACBYTES)
+  var hash = Buffer.alloc(sodium.crypto_generichash_BYTES)
+  sodium.randombytes_buf(key)
+  sodium.crypto_secretbox_easy(cipher, message, nonce, key)
+  sodium.crypto_secretbox_open_easy(message, cipher, nonce, key)
+  sodium.crypto_generichash(hash, message)
+  sodium.crypto_generichash_instance().update(message)
+  var used = process.hrtime(start)
+
+  global.gc()
+  console.log(JSON.stringify({
+    require: required[0] * 1e3 + required[1] / 1e6,
+    firstUse: used[0] * 1e3 + used[1] / 1e6,
+    heap: process.memoryUsage().heapUsed - heap
+  }))
+}
+
+var samples = []
+for (var i = 0; i < runs; i++) {
+  var out = proc.execFileSync(process.execPath, ['--expose-gc', '-e', '(' + child.toString() + ')()', path.join(__dirname, '..')])
+  samples.push(JSON.parse(out.toString()))
+}
+
+report('require()', 'require', 'ms')
+report('require() + first use of 5 functions', 'firstUse', 'ms')
+report('retained heap', 'heap', 'kB', 1 / 1024)
+
+function report (name, key, unit, scale) {
+  var values = samples.map(function (s) {
+    return s[key] * (scale || 1)
+  }).sort(function (a, b) {
+    return a - b
+  })
+
+  var median = values[Math.floor(values.length / 2)]
+  console.log(name + ': median ' + median.toFixed(2) + ' ' + unit + ', min ' + values[0].toFixed(2) + ' ' + unit + ' (' + runs + ' runs)')
+}
@@ -0,0 +1,102 @@
+// A mix of the calls a typical server makes: small-message encryption,
+// hashing, signing and key derivation, where argument checks and the call
+// into the binding are a large share of the time. pgo.js trains on it and
+// measures the gain with it.
+//
+// node bench/workload.js [iterations] [--json]
+
+var sodium = require('..')
+
+var iterations = Number(process.argv.filter(function (arg) {
+  return /^\d+$/.test(arg)
+})[0]) || 20000
+var json = process.argv.indexOf('--json') > -1
+
+var message = Buffer.alloc(64)
+var large = Buffer.alloc(1024)
+var key = Buffer.alloc(sodium.crypto_secretbox_KEYBYTES)
+var nonce = Buffer.alloc(sodium.crypto_secretbox_NONCEBYTES)
+var box = Buffer.alloc(message.length + sodium.crypto_secretbox_MACBYTES)
+var aeadKey = Buffer.alloc(sodium.crypto_aead_xchacha20poly1305_ietf_KEYBYTES)
+var npub = Buffer.alloc(sodium.crypto_aead_xchacha20poly1305_ietf_NPUBBYTES)
+var aead = Buffer.alloc(large.length + sodium.crypto_aead_xchacha20poly1305_ietf_ABYTES)
+var hash = Buffer.alloc(sodium.crypto_generichash_BYTES)
+var sha = Buffer.alloc(sodium.crypto_hash_sha256_BYTES)
+var masterKey = Buffer.alloc(sodium.crypto_kdf_KEYBYTES)
+var context = Buffer.from('workload')
+var subkey = Buffer.alloc(32)
+var pk = Buffer.alloc(sodium.crypto_sign_PUBLICKEYBYTES)
+var sk = Buffer.alloc(sodium.crypto_sign_SECRETKEYBYTES)
+var sig = Buffer.alloc(sodium.crypto_sign_BYTES)
+
+sodium.randombytes_buf(message)
+sodium.randombytes_buf(large)
+sodium.randombytes_buf(key)
+sodium.randombytes_buf(aeadKey)
+sodium.crypto_kdf_keygen(masterKey)
+sodium.crypto_sign_keypair(pk, sk)
+sodium.crypto_secretbox_easy(box, message, nonce, key)
+sodium.crypto_sign_detached(sig, message, sk)
+
+var ops = {
+  crypto_secretbox_easy: function () {
+    sodium.crypto_secretbox_easy(box, message, nonce, key)
+  },
+  crypto_secretbox_open_easy: function () {
+    sodium.crypto_secretbox_open_easy(message, box, nonce, key)
+  },
+  crypto_aead_xchacha20poly1305_ietf_encrypt: function () {
+    sodium.crypto_aead_xchacha20poly1305_ietf_encrypt(aead, large, message, null, npub, aeadKey)
+  },
+  crypto_generichash: function () {
+    sodium.crypto_generichash(hash, message)
+  },
+  'crypto_generichash_instance update/final': function () {
+    var instance = sodium.crypto_generichash_instance()
+    instance.update(message)
+    instance.final(hash)
+  },
+  crypto_hash_sha256: function () {
+    sodium.crypto_hash_sha256(sha, message)
+  },
+  crypto_kdf_derive_from_key: function () {
+    sodium.crypto_kdf_derive_from_key(subkey, 1, context, masterKey)
+  },
+  crypto_sign_detached: function () {
+    sodium.crypto_sign_detached(sig, message, sk)
+  },
+  crypto_sign_verify_detached: function () {
+    sodium.crypto_sign_verify_detached(sig, message, pk)
+  },
+  randombytes_buf: function () {
+    sodium.randombytes_buf(subkey)
+  },
+  sodium_memcmp: function () {
+    sodium.sodium_memcmp(hash, sha)
+  }
+}
+
+var results = {}
+
+Object.keys(ops).forEach(function (name) {
+  var fn = ops[name]
+  // signing is about a hundred times slower than the rest
+  var count = /sign/.test(name) ? Math.ceil(iterations / 20) : iterations
+  var i
+
+  for (i = 0; i < count; i++) fn() // warm up
+
+  var start = process.hrtime()
+  for (i = 0; i < count; i++) fn()
+  var time = process.hrtime(start)
+
+  results[name] = (time[0] * 1e9 + time[1]) / count
+})
+
+if (json) {
+  console.log(JSON.stringify(results))
+} else {
+  Object.keys(results).forEach(function (name) {
+    console.log(name + ': ' + results[name].toFixed(0) + ' ns/op')
+  })
+}
@@ -1,20 +1,43 @@
 #include <node.h>
 #include <node_buffer.h>
+#include <string>
+#include <vector>
 #include <nan.h>
 #include <sodium.h>
 #include "src/crypto_generichash_wrap.h"
+#include "src/crypto_generichash_chunker_wrap.h"
 #include "src/crypto_onetimeauth_wrap.h"
+#include "src/crypto_aead_aes256gcm_wrap.h"
 #include "src/crypto_hash_sha256_wrap.h"
 #include "src/crypto_hash_sha512_wrap.h"
+#include "src/crypto_sign_wrap.h"
+#include "src/crypto_sign_verify_wrap.h"
+#include "src/crypto_sign_verify_cache_wrap.h"
+#include "src/crypto_scalarmult_ed25519_fixed_base_wrap.h"
 #include "src/crypto_stream_xor_wrap.h"
 #include "src/crypto_stream_chacha20_xor_wrap.h"
 #include "src/crypto_secretstream_xchacha20poly1305_state_wrap.h"
+#include "src/crypto_secretstream_xchacha20poly1305_table.h"
+#include "src/iov.h"
+#include "src/ed25519.h"
+#include "src/crypto_core_ed25519_scalar_batch.h"
+#include "src/command_buffer.h"
+#include "src/pwhash_arena.h"
+#include "src/stats.h"
+#include "src/per_isolate.h"
 #include "src/crypto_pwhash_async.cc"
 #include "src/crypto_pwhash_str_async.cc"
 #include "src/crypto_pwhash_str_verify_async.cc"
 #include "src/crypto_pwhash_scryptsalsa208sha256_async.cc"
 #include "src/crypto_pwhash_scryptsalsa208sha256_str_async.cc"
 #include "src/crypto_pwhash_scryptsalsa208sha256_str_verify_async.cc"
+#include "src/crypto_generichash_chunks_async.cc"
+#include "src/crypto_sign_verify_detached_many_async.cc"
+#include "src/crypto_scalarmult_ed25519_multi_async.cc"
+#include "src/crypto_core_ed25519_batch_async.cc"
+#include "src/command_buffer_async.cc"
+#include "src/file_hash_async.cc"
+#include "src/file_crypt_async.cc"
 #include "src/macros.h"
 
 // memory management
@@ -70,19 +93,19 @@ NAN_METHOD(sodium_malloc) {
 NAN_METHOD(sodium_mprotect_noaccess) {
   ASSERT_BUFFER(info[0], buf)
 
-  CALL_SODIUM(sodium_mprotect_noaccess(node::Buffer::Data(buf)))
+  CALL_SODIUM(sodium_mprotect_noaccess(CDATA(buf)))
 }
 
 NAN_METHOD(sodium_mprotect_readonly) {
   ASSERT_BUFFER(info[0], buf)
 
-  CALL_SODIUM(sodium_mprotect_readonly(node::Buffer::Data(buf)))
+  CALL_SODIUM(sodium_mprotect_readonly(CDATA(buf)))
 }
 
 NAN_METHOD(sodium_mprotect_readwrite) {
   ASSERT_BUFFER(info[0], buf)
 
-  CALL_SODIUM(sodium_mprotect_readwrite(node::Buffer::Data(buf)))
+  CALL_SODIUM(sodium_mprotect_readwrite(CDATA(buf)))
 }
 
 // randombytes
@@ -243,6 +266,46 @@ NAN_METHOD(crypto_kx_server_session_keys) {
   CALL_SODIUM(crypto_kx_server_session_keys(rx, tx, CDATA(server_pk), CDATA(server_sk), CDATA(client_pk)))
 }
 
+// scatter/gather arguments are a single buffer or an array of buffers
+
+static bool iov_from_value (v8::Local<v8::Value> value, std::vector<iov_buffer> &iov) {
+  if (IS_BUFFER_SOURCE(value)) {
+    iov_buffer buf = { CDATA(value), (size_t) CLENGTH(value) };
+    iov.push_back(buf);
+    return true;
+  }
+
+  if (!value->IsArray()) return false;
+
+  v8::Local<v8::Array> array = value.As<v8::Array>();
+  uint32_t count = array->Length();
+  iov.reserve(count);
+
+  for (uint32_t i = 0; i < count; i++) {
+    v8::Local<v8::Value> item = Nan::Get(array, i).ToLocalChecked();
+    if (!IS_BUFFER_SOURCE(item)) return false;
+    iov_buffer buf = { CDATA(item), (size_t) CLENGTH(item) };
+    iov.push_back(buf);
+  }
+
+  return true;
+}
+
+#define ASSERT_IOV(name, var) \
+  std::vector<iov_buffer> var; \
+  if (!iov_from_value(name, var)) { \
+    Nan::ThrowError(#var " must be a buffer or an array of buffers"); \
+    return; \
+  } \
+  size_t var##_length = iov_length(var.data(), var.size());
+
+#define ASSERT_IOV_MIN_LENGTH(name, var, length_name, length) \
+  ASSERT_IOV(name, var) \
+  if (var##_length < length) { \
+    Nan::ThrowError(#var " must be at least " #length_name " bytes in total"); \
+    return; \
+  }
+
 // crypto_aead
 
 NAN_METHOD(crypto_aead_xchacha20poly1305_ietf_keygen) {
@@ -322,6 +385,72 @@ NAN_METHOD(crypto_aead_xchacha20poly1305_ietf_decrypt) {
   info.GetReturnValue().Set(Nan::New((uint32_t) mlen));
 }
 
+// (ciphertext_buf|ciphertext_bufs, message_buf|message_bufs, [ad], null, npub_buf, k_buf)
+NAN_METHOD(crypto_aead_xchacha20poly1305_ietf_encrypt_iov) {
+  ASSERT_IOV(info[1], message)
+  ASSERT_IOV_MIN_LENGTH(info[0], ciphertext,
+    `message.length + crypto_aead_xchacha20poly1305_ietf_ABYTES`,
+    message_length + crypto_aead_xchacha20poly1305_ietf_abytes())
+  ASSERT_BUFFER_MIN_LENGTH(info[4], npub,
+    crypto_aead_xchacha20poly1305_ietf_NPUBBYTES,
+    crypto_aead_xchacha20poly1305_ietf_npubbytes())
+  ASSERT_BUFFER_MIN_LENGTH(info[5], k,
+    crypto_aead_xchacha20poly1305_ietf_KEYBYTES,
+    crypto_aead_xchacha20poly1305_ietf_keybytes())
+
+  const unsigned char *ad_data = NULL;
+  size_t ad_len = 0;
+  if (info[2]->IsObject()) {
+    ASSERT_BUFFER_SET_LENGTH(info[2], ad)
+    ad_data = CDATA(ad);
+    ad_len = ad_length;
+  }
+
+  CALL_SODIUM(iov_aead_xchacha20poly1305_ietf_encrypt(
+    ciphertext.data(), ciphertext.size(),
+    message.data(), message.size(),
+    ad_data, ad_len,
+    CDATA(npub),
+    CDATA(k)
+  ))
+
+  info.GetReturnValue().Set(Nan::New((uint32_t) (message_length + crypto_aead_xchacha20poly1305_ietf_abytes())));
+}
+
+// (message_buf|message_bufs, null, ciphertext_buf|ciphertext_bufs, [ad], npub, k)
+NAN_METHOD(crypto_aead_xchacha20poly1305_ietf_decrypt_iov) {
+  ASSERT_IOV_MIN_LENGTH(info[2], ciphertext,
+    crypto_aead_xchacha20poly1305_ietf_ABYTES,
+    crypto_aead_xchacha20poly1305_ietf_abytes())
+  ASSERT_IOV_MIN_LENGTH(info[0], message,
+    `ciphertext.length - crypto_aead_xchacha20poly1305_ietf_ABYTES`,
+    ciphertext_length - crypto_aead_xchacha20poly1305_ietf_abytes())
+  ASSERT_BUFFER_MIN_LENGTH(info[4], npub,
+    crypto_aead_xchacha20poly1305_ietf_NPUBBYTES,
+    crypto_aead_xchacha20poly1305_ietf_npubbytes())
+  ASSERT_BUFFER_MIN_LENGTH(info[5], k,
+    crypto_aead_xchacha20poly1305_ietf_KEYBYTES,
+    crypto_aead_xchacha20poly1305_ietf_keybytes())
+
+  const unsigned char *ad_data = NULL;
+  size_t ad_len = 0;
+  if (info[3]->IsObject()) {
+    ASSERT_BUFFER_SET_LENGTH(info[3], ad)
+    ad_data = CDATA(ad);
+    ad_len = ad_length;
+  }
+
+  CALL_SODIUM(iov_aead_xchacha20poly1305_ietf_decrypt(
+    message.data(), message.size(),
+    ciphertext.data(), ciphertext.size(),
+    ad_data, ad_len,
+    CDATA(npub),
+    CDATA(k)
+  ))
+
+  info.GetReturnValue().Set(Nan::New((uint32_t) (ciphertext_length - crypto_aead_xchacha20poly1305_ietf_abytes())));
+}
+
 // (ciphertext_buf, mac, message_buf, [ad], null, npub_buf, k_buf)
 NAN_METHOD(crypto_aead_xchacha20poly1305_ietf_encrypt_detached) {
   ASSERT_BUFFER_SET_LENGTH(info[2], message)
@@ -395,6 +524,184 @@ NAN_METHOD(crypto_aead_xchacha20poly1305_ietf_decrypt_detached) {
   ))
 }
 
+// crypto_aead_aes256gcm, only usable on CPUs with AES-NI and PCLMUL
+
+#define ASSERT_AES256GCM_AVAILABLE \
+  if (!crypto_aead_aes256gcm_is_available()) { \
+    Nan::ThrowError(ERRNO_EXCEPTION(ENOSYS)); \
+    return; \
+  }
+
+NAN_METHOD(crypto_aead_aes256gcm_is_available) {
+  info.GetReturnValue().Set(crypto_aead_aes256gcm_is_available() ? Nan::True() : Nan::False());
+}
+
+NAN_METHOD(crypto_aead_aes256gcm_keygen) {
+  ASSERT_BUFFER_MIN_LENGTH(info[0], k,
+    crypto_aead_aes256gcm_KEYBYTES,
+    crypto_aead_aes256gcm_keybytes())
+  crypto_aead_aes256gcm_keygen(CDATA(k));
+}
+
+// (ciphertext_buf, message_buf, [ad], null, npub_buf, k_buf)
+NAN_METHOD(crypto_aead_aes256gcm_encrypt) {
+  ASSERT_AES256GCM_AVAILABLE
+  ASSERT_BUFFER_SET_LENGTH(info[1], message)
+  ASSERT_BUFFER_MIN_LENGTH(info[0], ciphertext,
+    `message.length + crypto_aead_aes256gcm_ABYTES`,
+    message_length + crypto_aead_aes256gcm_abytes())
+  ASSERT_BUFFER_MIN_LENGTH(info[4], npub,
+    crypto_aead_aes256gcm_NPUBBYTES,
+    crypto_aead_aes256gcm_npubbytes())
+  ASSERT_BUFFER_MIN_LENGTH(info[5], k,
+    crypto_aead_aes256gcm_KEYBYTES,
+    crypto_aead_aes256gcm_keybytes())
+
+  const unsigned char *ad_data = NULL;
+  size_t ad_len = 0;
+  if (info[2]->IsObject()) {
+    ASSERT_BUFFER_SET_LENGTH(info[2], ad)
+    ad_data = CDATA(ad);
+    ad_len = ad_length;
+  }
+
+  const unsigned char *nsec = NULL;
+  unsigned long long clen;
+  CALL_SODIUM(crypto_aead_aes256gcm_encrypt(
+    CDATA(ciphertext), &clen,
+    CDATA(message), message_length,
+    ad_data, ad_len,
+    nsec,
+    CDATA(npub),
+    CDATA(k)
+  ))
+
+  info.GetReturnValue().Set(Nan::New((uint32_t) clen));
+}
+
+// (message, null, ciphertext, [ad], npub, k)
+NAN_METHOD(crypto_aead_aes256gcm_decrypt) {
+  ASSERT_AES256GCM_AVAILABLE
+  ASSERT_BUFFER_MIN_LENGTH(info[2], ciphertext,
+    crypto_aead_aes256gcm_ABYTES,
+    crypto_aead_aes256gcm_abytes())
+  ASSERT_BUFFER_MIN_LENGTH(info[0], message,
+    `ciphertext.length - crypto_aead_aes256gcm_ABYTES`,
+    ciphertext_length - crypto_aead_aes256gcm_abytes())
+  ASSERT_BUFFER_MIN_LENGTH(info[4], npub,
+    crypto_aead_aes256gcm_NPUBBYTES,
+    crypto_aead_aes256gcm_npubbytes())
+  ASSERT_BUFFER_MIN_LENGTH(info[5], k,
+    crypto_aead_aes256gcm_KEYBYTES,
+    crypto_aead_aes256gcm_keybytes())
+
+  const unsigned char *ad_data = NULL;
+  size_t ad_len = 0;
+  if (info[3]->IsObject()) {
+    ASSERT_BUFFER_SET_LENGTH(info[3], ad)
+    ad_data = CDATA(ad);
+    ad_len = ad_length;
+  }
+
+  unsigned char *nsec = NULL;
+  unsigned long long mlen;
+  CALL_SODIUM(crypto_aead_aes256gcm_decrypt(
+    CDATA(message), &mlen,
+    nsec,
+    CDATA(ciphertext), ciphertext_length,
+    ad_data, ad_len,
+    CDATA(npub),
+    CDATA(k)
+  ))
+
+  info.GetReturnValue().Set(Nan::New((uint32_t) mlen));
+}
+
+// (ciphertext, mac, message, [ad], null, npub, k)
+NAN_METHOD(crypto_aead_aes256gcm_encrypt_detached) {
+  ASSERT_AES256GCM_AVAILABLE
+  ASSERT_BUFFER_SET_LENGTH(info[2], message)
+  ASSERT_BUFFER_MIN_LENGTH(info[1], mac,
+    crypto_aead_aes256gcm_ABYTES,
+    crypto_aead_aes256gcm_abytes())
+  ASSERT_BUFFER_MIN_LENGTH(info[0], ciphertext,
+    `message.length`,
+    message_length)
+  ASSERT_BUFFER_MIN_LENGTH(info[5], npub,
+    crypto_aead_aes256gcm_NPUBBYTES,
+    crypto_aead_aes256gcm_npubbytes())
+  ASSERT_BUFFER_MIN_LENGTH(info[6], k,
+    crypto_aead_aes256gcm_KEYBYTES,
+    crypto_aead_aes256gcm_keybytes())
+
+  const unsigned char *ad_data = NULL;
+  size_t ad_len = 0;
+  if (info[3]->IsObject()) {
+    ASSERT_BUFFER_SET_LENGTH(info[3], ad)
+    ad_data = CDATA(ad);
+    ad_len = ad_length;
+  }
+
+  const unsigned char *nsec = NULL;
+  unsigned long long maclen;
+  CALL_SODIUM(crypto_aead_aes256gcm_encrypt_detached(
+    CDATA(ciphertext),
+    CDATA(mac), &maclen,
+    CDATA(message), message_length,
+    ad_data, ad_len,
+    nsec,
+    CDATA(npub),
+    CDATA(k)
+  ))
+
+  info.GetReturnValue().Set(Nan::New((uint32_t) maclen));
+}
+
+// (message, null, ciphertext, mac, [ad], npub, k)
+NAN_METHOD(crypto_aead_aes256gcm_decrypt_detached) {
+  ASSERT_AES256GCM_AVAILABLE
+  ASSERT_BUFFER_SET_LENGTH(info[2], ciphertext)
+  ASSERT_BUFFER_MIN_LENGTH(info[0], message, `ciphertext.length`, ciphertext_length)
+  ASSERT_BUFFER_MIN_LENGTH(info[3], mac,
+    crypto_aead_aes256gcm_ABYTES,
+    crypto_aead_aes256gcm_abytes())
+  ASSERT_BUFFER_MIN_LENGTH(info[5], npub,
+    crypto_aead_aes256gcm_NPUBBYTES,
+    crypto_aead_aes256gcm_npubbytes())
+  ASSERT_BUFFER_MIN_LENGTH(info[6], k,
+    crypto_aead_aes256gcm_KEYBYTES,
+    crypto_aead_aes256gcm_keybytes())
+
+  const unsigned char *ad_data = NULL;
+  size_t ad_len = 0;
+  if (info[4]->IsObject()) {
+    ASSERT_BUFFER_SET_LENGTH(info[4], ad)
+    ad_data = CDATA(ad);
+    ad_len = ad_length;
+  }
+
+  unsigned char *nsec = NULL;
+  CALL_SODIUM(crypto_aead_aes256gcm_decrypt_detached(
+    CDATA(message),
+    nsec,
+    CDATA(ciphertext), ciphertext_length,
+    CDATA(mac),
+    ad_data, ad_len,
+    CDATA(npub),
+    CDATA(k)
+  ))
+}
+
+// (k)
+NAN_METHOD(crypto_aead_aes256gcm_instance) {
+  ASSERT_AES256GCM_AVAILABLE
+  ASSERT_BUFFER_MIN_LENGTH(info[0], k,
+    crypto_aead_aes256gcm_KEYBYTES,
+    crypto_aead_aes256gcm_keybytes())
+
+  info.GetReturnValue().Set(CryptoAeadAes256gcmWrap::NewInstance(CDATA(k)));
+}
+
 // crypto_sign
 
 NAN_METHOD(crypto_sign_seed_keypair) {
@@ -458,6 +765,38 @@ NAN_METHOD(crypto_sign_detached) {
   CALL_SODIUM(crypto_sign_detached(CDATA(signature), &signature_length_dummy, CDATA(message), CLENGTH(message), CDATA(secret_key)))
 }
 
+NAN_METHOD(crypto_sign_instance) {
+  ASSERT_BUFFER_MIN_LENGTH(info[0], secret_key, crypto_sign_SECRETKEYBYTES, crypto_sign_secretkeybytes())
+
+  v8::Local<v8::Value> instance = CryptoSignWrap::NewInstance(CDATA(secret_key));
+
+  if (instance.IsEmpty()) {
+    Nan::ThrowError(ERRNO_EXCEPTION(ENOMEM));
+    return;
+  }
+
+  info.GetReturnValue().Set(instance);
+}
+
+NAN_METHOD(crypto_sign_verify_instance) {
+  ASSERT_BUFFER_MIN_LENGTH(info[0], public_key, crypto_sign_PUBLICKEYBYTES, crypto_sign_publickeybytes())
+
+  info.GetReturnValue().Set(CryptoSignVerifyWrap::NewInstance(CDATA(public_key)));
+}
+
+NAN_METHOD(crypto_sign_verify_cache_instance) {
+  ASSERT_UINT_BOUNDS(info[0], capacity, 1, 1, crypto_sign_verify_cache_CAPACITY_MAX, CRYPTO_SIGN_VERIFY_CACHE_CAPACITY_MAX)
+
+  v8::Local<v8::Value> instance = CryptoSignVerifyCacheWrap::NewInstance((size_t) capacity);
+
+  if (instance.IsEmpty()) {
+    Nan::ThrowError(ERRNO_EXCEPTION(ENOMEM));
+    return;
+  }
+
+  info.GetReturnValue().Set(instance);
+}
+
 NAN_METHOD(crypto_sign_ed25519_pk_to_curve25519) {
   ASSERT_BUFFER_MIN_LENGTH(info[0], curve25519_pk, crypto_box_PUBLICKEYBYTES, crypto_box_publickeybytes())
   ASSERT_BUFFER_MIN_LENGTH(info[1], ed25519_pk, crypto_sign_PUBLICKEYBYTES, crypto_sign_publickeybytes())
@@ -485,6 +824,71 @@ NAN_METHOD(crypto_sign_verify_detached) {
   CALL_SODIUM_BOOL(crypto_sign_verify_detached(CDATA(signature), CDATA(message), CLENGTH(message), CDATA(public_key)))
 }
 
+// (results, signatures, messages, public_keys, callback)
+NAN_METHOD(crypto_sign_verify_detached_many_async) {
+  if (!info[1]->IsArray() || !info[2]->IsArray() || !info[3]->IsArray()) {
+    Nan::ThrowError("signatures, messages and public_keys must be arrays");
+    return;
+  }
+
+  v8::Local<v8::Array> signatures = info[1].As<v8::Array>();
+  v8::Local<v8::Array> messages = info[2].As<v8::Array>();
+  v8::Local<v8::Array> public_keys = info[3].As<v8::Array>();
+  uint32_t length = signatures->Length();
+
+  if (messages->Length() != length || public_keys->Length() != length) {
+    Nan::ThrowError("signatures, messages and public_keys must have the same length");
+    return;
+  }
+
+  unsigned char *results_data = NULL;
+  if (!info[0]->IsNull() && !info[0]->IsUndefined()) {
+    ASSERT_BUFFER_MIN_LENGTH(info[0], results, `Math.ceil(signatures.length / 8)`, (length + 7) / 8)
+    results_data = CDATA(results);
+  }
+
+  ASSERT_FUNCTION(info[4], callback)
+
+  // every buffer is referenced from a private array until the callback runs,
+  // so none of them can be collected even if the input arrays are modified
+  v8::Local<v8::Array> buffers = Nan::New<v8::Array>(length * 3 + 1);
+  std::vector<crypto_sign_verify_detached_many_tuple> tuples(length);
+
+  for (uint32_t i = 0; i < length; i++) {
+    v8::Local<v8::Value> signature_value = Nan::Get(signatures, i).ToLocalChecked();
+    v8::Local<v8::Value> message_value = Nan::Get(messages, i).ToLocalChecked();
+    v8::Local<v8::Value> public_key_value = Nan::Get(public_keys, i).ToLocalChecked();
+
+    ASSERT_BUFFER_MIN_LENGTH(signature_value, signature, crypto_sign_BYTES, crypto_sign_bytes())
+    ASSERT_BUFFER(message_value, message)
+    ASSERT_BUFFER_MIN_LENGTH(public_key_value, public_key, crypto_sign_PUBLICKEYBYTES, crypto_sign_publickeybytes())
+
+    tuples[i].signature = CDATA(signature);
+    tuples[i].message = CDATA(message);
+    tuples[i].message_length = CLENGTH(message);
+    tuples[i].public_key = CDATA(public_key);
+
+    Nan::Set(buffers, i * 3, signature);
+    Nan::Set(buffers, i * 3 + 1, message);
+    Nan::Set(buffers, i * 3 + 2, public_key);
+  }
+
+  if (results_data != NULL) Nan::Set(buffers, length * 3, info[0]);
+
+  crypto_sign_verify_detached_many_job *job = new crypto_sign_verify_detached_many_job();
+  job->tuples.swap(tuples);
+  job->results = results_data;
+  job->next = 0;
+  job->invalid = false;
+  job->pending = crypto_sign_verify_detached_many_slices(length);
+  job->callback = new Nan::Callback(callback);
+  job->buffers.Reset(buffers);
+
+  for (size_t i = 0, slices = job->pending; i < slices; i++) {
+    Nan::AsyncQueueWorker(new CryptoSignVerifyDetachedManyAsync(job));
+  }
+}
+
 // crypto_generic_hash
 
 NAN_METHOD(crypto_generichash) {
@@ -503,6 +907,30 @@ NAN_METHOD(crypto_generichash) {
   CALL_SODIUM(crypto_generichash(CDATA(output), CLENGTH(output), CDATA(input), CLENGTH(input), key_data, key_len))
 }
 
+// sets key_data and key_len from an optional generichash key
+#define ASSERT_GENERICHASH_KEY(name) \
+  ASSERT_BUFFER_MIN_LENGTH(name, key, crypto_generichash_KEYBYTES_MIN, crypto_generichash_keybytes_min()) \
+  if (key_length > crypto_generichash_keybytes_max()) { \
+    Nan::ThrowError("key must be a buffer of size at most crypto_generichash_KEYBYTES_MAX"); \
+    return; \
+  } \
+  key_data = CDATA(key); \
+  key_len = key_length;
+
+NAN_METHOD(crypto_generichash_iov) {
+  ASSERT_BUFFER_MIN_LENGTH(info[0], output, crypto_generichash_BYTES_MIN, crypto_generichash_bytes_min())
+  ASSERT_IOV(info[1], input)
+
+  unsigned char *key_data = NULL;
+  size_t key_len = 0;
+
+  if (info[2]->IsObject()) {
+    ASSERT_GENERICHASH_KEY(info[2])
+  }
+
+  CALL_SODIUM(iov_generichash(CDATA(output), CLENGTH(output), input.data(), input.size(), key_data, key_len))
+}
+
 NAN_METHOD(crypto_generichash_batch) {
   ASSERT_BUFFER_MIN_LENGTH(info[0], output, crypto_generichash_BYTES_MIN, crypto_generichash_bytes_min())
 
@@ -515,44 +943,208 @@ NAN_METHOD(crypto_generichash_batch) {
     key_len = key_length;
   }
 
-  if (!info[1]->IsArray()) {
-    Nan::ThrowError("batch must be an array of buffers");
-    return;
+  if (!info[1]->IsArray()) {
+    Nan::ThrowError("batch must be an array of buffers");
+    return;
+  }
+
+  v8::Local<v8::Array> buffers = info[1].As<v8::Array>();
+
+  crypto_generichash_state state;
+  crypto_generichash_init(&state, key_data, key_len, output_length);
+
+  uint32_t len = buffers->Length();
+  for (uint32_t i = 0; i < len; i++) {
+    v8::Local<v8::Value> buf = buffers->Get(Nan::GetCurrentContext(), i).ToLocalChecked();
+    if (!IS_BUFFER_SOURCE(buf)) {
+      Nan::ThrowError("batch must be an array of buffers");
+      return;
+    }
+    crypto_generichash_update(&state, CDATA(buf), CLENGTH(buf));
+  }
+
+  crypto_generichash_final(&state, CDATA(output), output_length);
+}
+
+NAN_METHOD(crypto_generichash_instance) {
+  unsigned long long output_length = crypto_generichash_bytes();
+
+  if (IS_BUFFER_SOURCE(info[1])) {
+    output_length = CLENGTH(info[1]);
+  } else if (info[1]->IsNumber()) {
+    output_length = Nan::To<uint32_t>(info[1]).ToChecked();
+  }
+
+  if (info[0]->IsObject()) {
+    ASSERT_BUFFER_MIN_LENGTH(info[0], key, crypto_generichash_KEYBYTES_MIN, crypto_generichash_keybytes_min())
+    info.GetReturnValue().Set(CryptoGenericHashWrap::NewInstance(CDATA(key), key_length, output_length));
+  } else {
+    info.GetReturnValue().Set(CryptoGenericHashWrap::NewInstance(NULL, 0, output_length));
+  }
+}
+
+// (state, [key], [output_length])
+NAN_METHOD(crypto_generichash_init) {
+  ASSERT_BUFFER_MIN_LENGTH(info[0], state, crypto_generichash_STATEBYTES, SEALED_STATEBYTES(crypto_generichash_state))
+
+  unsigned char *key_data = NULL;
+  size_t key_len = 0;
+  int output_index = 1;
+
+  if (info[1]->IsObject()) {
+    ASSERT_BUFFER_MIN_LENGTH(info[1], key, crypto_generichash_KEYBYTES_MIN, crypto_generichash_keybytes_min())
+    key_data = CDATA(key);
+    key_len = key_length;
+    output_index = 2;
+  } else if (info[1]->IsNull()) {
+    output_index = 2;
+  }
+
+  size_t output_length = crypto_generichash_bytes();
+
+  if (!info[output_index]->IsUndefined()) {
+    ASSERT_UINT_BOUNDS(info[output_index], output_len,
+      crypto_generichash_BYTES_MIN, crypto_generichash_bytes_min(),
+      crypto_generichash_BYTES_MAX, crypto_generichash_bytes_max())
+    output_length = output_len;
+  }
+
+  sealed_state<crypto_generichash_state> s(CDATA(state), true);
+  CALL_SODIUM(crypto_generichash_init(s.state, key_data, key_len, output_length))
+  s.valid = true;
+}
+
+NAN_METHOD(crypto_generichash_update) {
+  ASSERT_BUFFER_MIN_LENGTH(info[0], state, crypto_generichash_STATEBYTES, SEALED_STATEBYTES(crypto_generichash_state))
+  ASSERT_BUFFER(info[1], input)
+
+  ASSERT_SEALED_STATE(state, s, crypto_generichash_state, crypto_generichash_init)
+  CALL_SODIUM(crypto_generichash_update(s.state, CDATA(input), CLENGTH(input)))
+}
+
+NAN_METHOD(crypto_generichash_final) {
+  ASSERT_BUFFER_MIN_LENGTH(info[0], state, crypto_generichash_STATEBYTES, SEALED_STATEBYTES(crypto_generichash_state))
+  ASSERT_BUFFER_MIN_LENGTH(info[1], output, crypto_generichash_BYTES_MIN, crypto_generichash_bytes_min())
+
+  if (output_length > crypto_generichash_bytes_max()) {
+    Nan::ThrowError("output must be a buffer of at most crypto_generichash_BYTES_MAX");
+    return;
+  }
+
+  ASSERT_SEALED_STATE(state, s, crypto_generichash_state, crypto_generichash_init)
+  CALL_SODIUM(crypto_generichash_final(s.state, CDATA(output), output_length))
+}
+
+// (lengths, digests, input, min_size, avg_size, max_size, [key])
+NAN_METHOD(crypto_generichash_chunks) {
+  ASSERT_BUFFER_SET_LENGTH(info[2], input)
+  ASSERT_UINT_BOUNDS(info[3], min_size, 64, CRYPTO_GENERICHASH_CHUNKER_MIN, 2^32 - 1, 0xffffffff)
+  ASSERT_UINT_BOUNDS(info[4], avg_size, 256, CRYPTO_GENERICHASH_CHUNKER_AVG_MIN, 2^32 - 1, 0xffffffff)
+  ASSERT_UINT_BOUNDS(info[5], max_size, 64, CRYPTO_GENERICHASH_CHUNKER_MIN, 2^32 - 1, 0xffffffff)
+
+  unsigned long long count = input_length / min_size + 1;
+
+  ASSERT_UINT32ARRAY(info[0], lengths)
+  ASSERT_BUFFER_MIN_LENGTH(info[0], lengths, `input.length / min + 1` entries, count * 4)
+  ASSERT_BUFFER_MIN_LENGTH(info[1], digests,
+    `(input.length / min + 1) * crypto_generichash_BYTES`,
+    count * crypto_generichash_BYTES)
+
+  unsigned char *key_data = NULL;
+  size_t key_len = 0;
+
+  if (info[6]->IsObject()) {
+    ASSERT_GENERICHASH_KEY(info[6])
+  }
+
+  crypto_generichash_chunker_state state;
+
+  if (crypto_generichash_chunker_init(&state, min_size, avg_size, max_size, key_data, key_len)) {
+    Nan::ThrowError("chunk sizes must satisfy min <= avg <= max and min < max");
+    return;
+  }
+
+  size_t chunks = crypto_generichash_chunker_update(&state, (uint32_t *) CDATA(lengths), CDATA(digests), CDATA(input), input_length);
+  chunks += crypto_generichash_chunker_final(&state, (uint32_t *) CDATA(lengths) + chunks, CDATA(digests) + chunks * crypto_generichash_BYTES);
+  crypto_generichash_chunker_destroy(&state);
+
+  info.GetReturnValue().Set(Nan::New((uint32_t) chunks));
+}
+
+// (lengths, digests, input, min_size, avg_size, max_size, [key], callback)
+NAN_METHOD(crypto_generichash_chunks_async) {
+  ASSERT_BUFFER_SET_LENGTH(info[2], input)
+  ASSERT_UINT_BOUNDS(info[3], min_size, 64, CRYPTO_GENERICHASH_CHUNKER_MIN, 2^32 - 1, 0xffffffff)
+  ASSERT_UINT_BOUNDS(info[4], avg_size, 256, CRYPTO_GENERICHASH_CHUNKER_AVG_MIN, 2^32 - 1, 0xffffffff)
+  ASSERT_UINT_BOUNDS(info[5], max_size, 64, CRYPTO_GENERICHASH_CHUNKER_MIN, 2^32 - 1, 0xffffffff)
+
+  unsigned long long count = input_length / min_size + 1;
+
+  ASSERT_UINT32ARRAY(info[0], lengths)
+  ASSERT_BUFFER_MIN_LENGTH(info[0], lengths, `input.length / min + 1` entries, count * 4)
+  ASSERT_BUFFER_MIN_LENGTH(info[1], digests,
+    `(input.length / min + 1) * crypto_generichash_BYTES`,
+    count * crypto_generichash_BYTES)
+
+  unsigned char *key_data = NULL;
+  size_t key_len = 0;
+  int callback_index = 6;
+
+  if (!info[6]->IsFunction()) {
+    if (info[6]->IsObject()) {
+      ASSERT_GENERICHASH_KEY(info[6])
+    }
+    callback_index = 7;
   }
 
-  v8::Local<v8::Array> buffers = info[1].As<v8::Array>();
+  ASSERT_FUNCTION(info[callback_index], callback)
 
-  crypto_generichash_state state;
-  crypto_generichash_init(&state, key_data, key_len, output_length);
+  crypto_generichash_chunker_state state;
 
-  uint32_t len = buffers->Length();
-  for (uint32_t i = 0; i < len; i++) {
-    v8::Local<v8::Value> buf = buffers->Get(Nan::GetCurrentContext(), i).ToLocalChecked();
-    if (!buf->IsObject()) {
-      Nan::ThrowError("batch must be an array of buffers");
-      return;
-    }
-    crypto_generichash_update(&state, CDATA(buf), CLENGTH(buf));
+  if (crypto_generichash_chunker_init(&state, min_size, avg_size, max_size, key_data, key_len)) {
+    Nan::ThrowError("chunk sizes must satisfy min <= avg <= max and min < max");
+    return;
   }
 
-  crypto_generichash_final(&state, CDATA(output), output_length);
+  CryptoGenerichashChunksAsync *worker = new CryptoGenerichashChunksAsync(
+    new Nan::Callback(callback),
+    &state,
+    (uint32_t *) CDATA(lengths),
+    CDATA(digests),
+    CDATA(input),
+    input_length
+  );
+  crypto_generichash_chunker_destroy(&state);
+
+  worker->SaveToPersistent("lengths", lengths);
+  worker->SaveToPersistent("digests", digests);
+  worker->SaveToPersistent("input", input);
+
+  Nan::AsyncQueueWorker(worker);
 }
 
-NAN_METHOD(crypto_generichash_instance) {
-  unsigned long long output_length = crypto_generichash_bytes();
+// (min_size, avg_size, max_size, [key])
+NAN_METHOD(crypto_generichash_chunker_instance) {
+  ASSERT_UINT_BOUNDS(info[0], min_size, 64, CRYPTO_GENERICHASH_CHUNKER_MIN, 2^32 - 1, 0xffffffff)
+  ASSERT_UINT_BOUNDS(info[1], avg_size, 256, CRYPTO_GENERICHASH_CHUNKER_AVG_MIN, 2^32 - 1, 0xffffffff)
+  ASSERT_UINT_BOUNDS(info[2], max_size, 64, CRYPTO_GENERICHASH_CHUNKER_MIN, 2^32 - 1, 0xffffffff)
 
-  if (info[1]->IsObject()) {
-    output_length = CLENGTH(info[1]->ToObject(Nan::GetCurrentContext()).ToLocalChecked());
-  } else if (info[1]->IsNumber()) {
-    output_length = Nan::To<uint32_t>(info[1]).ToChecked();
+  unsigned char *key_data = NULL;
+  size_t key_len = 0;
+
+  if (info[3]->IsObject()) {
+    ASSERT_GENERICHASH_KEY(info[3])
   }
 
-  if (info[0]->IsObject()) {
-    ASSERT_BUFFER_MIN_LENGTH(info[0], key, crypto_generichash_KEYBYTES_MIN, crypto_generichash_keybytes_min())
-    info.GetReturnValue().Set(CryptoGenericHashWrap::NewInstance(CDATA(key), key_length, output_length));
-  } else {
-    info.GetReturnValue().Set(CryptoGenericHashWrap::NewInstance(NULL, 0, output_length));
+  crypto_generichash_chunker_state state;
+
+  if (crypto_generichash_chunker_init(&state, min_size, avg_size, max_size, key_data, key_len)) {
+    Nan::ThrowError("chunk sizes must satisfy min <= avg <= max and min < max");
+    return;
   }
+
+  info.GetReturnValue().Set(CryptoGenericHashChunkerWrap::NewInstance(&state));
+  crypto_generichash_chunker_destroy(&state);
 }
 
 // crypto_hash
@@ -690,6 +1282,24 @@ NAN_METHOD(crypto_secretbox_open_easy) {
   CALL_SODIUM_BOOL(crypto_secretbox_open_easy(CDATA(message), CDATA(ciphertext), ciphertext_length, CDATA(nonce), CDATA(key)))
 }
 
+NAN_METHOD(crypto_secretbox_easy_iov) {
+  ASSERT_IOV(info[1], message)
+  ASSERT_IOV_MIN_LENGTH(info[0], ciphertext, `message.length + crypto_secretbox_MACBYTES`, crypto_secretbox_macbytes() + message_length)
+  ASSERT_BUFFER_MIN_LENGTH(info[2], nonce, crypto_secretbox_NONCEBYTES, crypto_secretbox_noncebytes())
+  ASSERT_BUFFER_MIN_LENGTH(info[3], key, crypto_secretbox_KEYBYTES, crypto_secretbox_keybytes())
+
+  CALL_SODIUM(iov_secretbox_easy(ciphertext.data(), ciphertext.size(), message.data(), message.size(), CDATA(nonce), CDATA(key)))
+}
+
+NAN_METHOD(crypto_secretbox_open_easy_iov) {
+  ASSERT_IOV_MIN_LENGTH(info[1], ciphertext, crypto_secretbox_MACBYTES, crypto_secretbox_macbytes())
+  ASSERT_IOV_MIN_LENGTH(info[0], message, `ciphertext.length - crypto_secretbox_MACBYTES`, ciphertext_length - crypto_secretbox_macbytes())
+  ASSERT_BUFFER_MIN_LENGTH(info[2], nonce, crypto_secretbox_NONCEBYTES, crypto_secretbox_noncebytes())
+  ASSERT_BUFFER_MIN_LENGTH(info[3], key, crypto_secretbox_KEYBYTES, crypto_secretbox_keybytes())
+
+  CALL_SODIUM_BOOL(iov_secretbox_open_easy(message.data(), message.size(), ciphertext.data(), ciphertext.size(), CDATA(nonce), CDATA(key)))
+}
+
 // crypto_stream
 
 NAN_METHOD(crypto_stream) {
@@ -772,6 +1382,31 @@ NAN_METHOD(crypto_onetimeauth_instance) {
   info.GetReturnValue().Set(CryptoOnetimeAuthWrap::NewInstance(CDATA(key)));
 }
 
+NAN_METHOD(crypto_onetimeauth_init) {
+  ASSERT_BUFFER_MIN_LENGTH(info[0], state, crypto_onetimeauth_STATEBYTES, SEALED_STATEBYTES(crypto_onetimeauth_state))
+  ASSERT_BUFFER_MIN_LENGTH(info[1], key, crypto_onetimeauth_KEYBYTES, crypto_onetimeauth_keybytes())
+
+  sealed_state<crypto_onetimeauth_state> s(CDATA(state), true);
+  CALL_SODIUM(crypto_onetimeauth_init(s.state, CDATA(key)))
+  s.valid = true;
+}
+
+NAN_METHOD(crypto_onetimeauth_update) {
+  ASSERT_BUFFER_MIN_LENGTH(info[0], state, crypto_onetimeauth_STATEBYTES, SEALED_STATEBYTES(crypto_onetimeauth_state))
+  ASSERT_BUFFER(info[1], input)
+
+  ASSERT_SEALED_STATE(state, s, crypto_onetimeauth_state, crypto_onetimeauth_init)
+  CALL_SODIUM(crypto_onetimeauth_update(s.state, CDATA(input), CLENGTH(input)))
+}
+
+NAN_METHOD(crypto_onetimeauth_final) {
+  ASSERT_BUFFER_MIN_LENGTH(info[0], state, crypto_onetimeauth_STATEBYTES, SEALED_STATEBYTES(crypto_onetimeauth_state))
+  ASSERT_BUFFER_MIN_LENGTH(info[1], output, crypto_onetimeauth_BYTES, crypto_onetimeauth_bytes())
+
+  ASSERT_SEALED_STATE(state, s, crypto_onetimeauth_state, crypto_onetimeauth_init)
+  CALL_SODIUM(crypto_onetimeauth_final(s.state, CDATA(output)))
+}
+
 // crypto_pwhash
 
 NAN_METHOD(crypto_pwhash) {
@@ -993,6 +1628,35 @@ NAN_METHOD(crypto_pwhash_scryptsalsa208sha256_str_verify_async) {
   ));
 }
 
+// pwhash arenas, shared by every isolate in the process
+
+NAN_METHOD(crypto_pwhash_arena_available) {
+  info.GetReturnValue().Set(pwhash_arena_available() ? Nan::True() : Nan::False());
+}
+
+// ([hugePages]), returns whether memory pressure is watched
+NAN_METHOD(crypto_pwhash_arena_enable) {
+  if (!pwhash_arena_available()) {
+    Nan::ThrowError(ERRNO_EXCEPTION(ENOSYS));
+    return;
+  }
+
+  bool huge_pages = info[0]->IsTrue();
+  info.GetReturnValue().Set(pwhash_arena_enable(huge_pages) ? Nan::True() : Nan::False());
+}
+
+NAN_METHOD(crypto_pwhash_arena_disable) {
+  pwhash_arena_disable();
+}
+
+NAN_METHOD(crypto_pwhash_arena_trim) {
+  info.GetReturnValue().Set(Nan::New<v8::Number>((double) pwhash_arena_trim()));
+}
+
+NAN_METHOD(crypto_pwhash_arena_bytes) {
+  info.GetReturnValue().Set(Nan::New<v8::Number>((double) pwhash_arena_bytes()));
+}
+
 // crypto_scalarmult
 
 NAN_METHOD(crypto_scalarmult_base) {
@@ -1070,6 +1734,187 @@ NAN_METHOD(crypto_core_ed25519_sub) {
   CALL_SODIUM(crypto_core_ed25519_sub(CDATA(r), CDATA(p), CDATA(q)))
 }
 
+NAN_METHOD(crypto_scalarmult_ed25519_fixed_base_instance) {
+  ASSERT_BUFFER_MIN_LENGTH(info[0], p, crypto_scalarmult_ed25519_BYTES, crypto_scalarmult_ed25519_bytes())
+
+  if (crypto_core_ed25519_is_valid_point(CDATA(p)) != 1) {
+    Nan::ThrowError(ERRNO_EXCEPTION(EINVAL));
+    return;
+  }
+
+  v8::Local<v8::Value> instance = CryptoScalarmultEd25519FixedBaseWrap::NewInstance(CDATA(p));
+
+  if (instance.IsEmpty()) {
+    Nan::ThrowError(ERRNO_EXCEPTION(errno));
+    return;
+  }
+
+  info.GetReturnValue().Set(instance);
+}
+
+// scalars and points are packed arrays of 32 byte values, checks their lengths
+// and declares var##_count
+#define ASSERT_SCALARMULT_ED25519_MULTI(scalars_name, points_name, var) \
+  ASSERT_BUFFER_SET_LENGTH(scalars_name, scalars) \
+  ASSERT_BUFFER_SET_LENGTH(points_name, points) \
+  if (scalars_length == 0 || scalars_length % crypto_scalarmult_ed25519_SCALARBYTES != 0) { \
+    Nan::ThrowError("scalars must be a non-empty multiple of crypto_scalarmult_ed25519_SCALARBYTES"); \
+    return; \
+  } \
+  if (points_length * crypto_scalarmult_ed25519_SCALARBYTES != scalars_length * crypto_scalarmult_ed25519_BYTES) { \
+    Nan::ThrowError("points must hold one point per scalar"); \
+    return; \
+  } \
+  size_t var##_count = scalars_length / crypto_scalarmult_ed25519_SCALARBYTES;
+
+// (q, scalars, points)
+NAN_METHOD(crypto_scalarmult_ed25519_multi) {
+  ASSERT_BUFFER_MIN_LENGTH(info[0], q, crypto_scalarmult_ed25519_BYTES, crypto_scalarmult_ed25519_bytes())
+  ASSERT_SCALARMULT_ED25519_MULTI(info[1], info[2], terms)
+
+  CALL_SODIUM(crypto_scalarmult_ed25519_multi(CDATA(q), CDATA(scalars), CDATA(points), terms_count))
+}
+
+// (q, scalars, points, callback)
+NAN_METHOD(crypto_scalarmult_ed25519_multi_async) {
+  ASSERT_BUFFER_MIN_LENGTH(info[0], q, crypto_scalarmult_ed25519_BYTES, crypto_scalarmult_ed25519_bytes())
+  ASSERT_SCALARMULT_ED25519_MULTI(info[1], info[2], terms)
+  ASSERT_FUNCTION(info[3], callback)
+
+  // the buffers are referenced from a private array until the callback runs
+  v8::Local<v8::Array> buffers = Nan::New<v8::Array>(3);
+  Nan::Set(buffers, 0, q);
+  Nan::Set(buffers, 1, scalars);
+  Nan::Set(buffers, 2, points);
+
+  size_t slices = crypto_scalarmult_ed25519_multi_slices(terms_count);
+
+  crypto_scalarmult_ed25519_multi_job *job = new crypto_scalarmult_ed25519_multi_job();
+  job->q = CDATA(q);
+  job->scalars = CDATA(scalars);
+  job->points = CDATA(points);
+  job->count = terms_count;
+  job->partials.resize(slices);
+  job->invalid = false;
+  job->pending = slices;
+  job->callback = new Nan::Callback(callback);
+  job->buffers.Reset(buffers);
+
+  for (size_t i = 0; i < slices; i++) {
+    Nan::AsyncQueueWorker(new CryptoScalarmultEd25519MultiAsync(job, i));
+  }
+}
+
+// a packed array of values of length bytes each, declares var##_count
+#define ASSERT_BUFFER_ARRAY(name, var, length_name, length) \
+  ASSERT_BUFFER_SET_LENGTH(name, var) \
+  if (var##_length % length != 0) { \
+    Nan::ThrowError(#var " must be a buffer of a multiple of " #length_name " bytes"); \
+    return; \
+  } \
+  size_t var##_count = var##_length / length;
+
+#define ASSERT_SAME_COUNT(a, b) \
+  if (a##_count != b##_count) { \
+    Nan::ThrowError(#a " and " #b " must hold the same number of values"); \
+    return; \
+  }
+
+// (results, points)
+NAN_METHOD(crypto_core_ed25519_is_valid_point_batch) {
+  ASSERT_BUFFER_ARRAY(info[1], points, crypto_core_ed25519_BYTES, crypto_core_ed25519_BYTES)
+  ASSERT_BUFFER_MIN_LENGTH(info[0], results, `Math.ceil(points.length / crypto_core_ed25519_BYTES / 8)`, (points_count + 7) / 8)
+
+  int ret = crypto_core_ed25519_is_valid_point_batch(CDATA(results), CDATA(points), points_count);
+  info.GetReturnValue().Set(ret == 1 ? Nan::True() : Nan::False());
+}
+
+// (p, r)
+NAN_METHOD(crypto_core_ed25519_from_uniform_batch) {
+  ASSERT_BUFFER_ARRAY(info[1], r, crypto_core_ed25519_UNIFORMBYTES, crypto_core_ed25519_UNIFORMBYTES)
+  ASSERT_BUFFER_MIN_LENGTH(info[0], p, `r.length`, r_count * crypto_core_ed25519_BYTES)
+
+  crypto_core_ed25519_from_uniform_batch(CDATA(p), CDATA(r), r_count);
+}
+
+// (r, p, q)
+NAN_METHOD(crypto_core_ed25519_add_batch) {
+  ASSERT_BUFFER_ARRAY(info[1], p, crypto_core_ed25519_BYTES, crypto_core_ed25519_BYTES)
+  ASSERT_BUFFER_ARRAY(info[2], q, crypto_core_ed25519_BYTES, crypto_core_ed25519_BYTES)
+  ASSERT_SAME_COUNT(p, q)
+  ASSERT_BUFFER_MIN_LENGTH(info[0], r, `p.length`, p_length)
+
+  CALL_SODIUM(crypto_core_ed25519_add_batch(CDATA(r), CDATA(p), CDATA(q), p_count))
+}
+
+// (r, p, q)
+NAN_METHOD(crypto_core_ed25519_sub_batch) {
+  ASSERT_BUFFER_ARRAY(info[1], p, crypto_core_ed25519_BYTES, crypto_core_ed25519_BYTES)
+  ASSERT_BUFFER_ARRAY(info[2], q, crypto_core_ed25519_BYTES, crypto_core_ed25519_BYTES)
+  ASSERT_SAME_COUNT(p, q)
+  ASSERT_BUFFER_MIN_LENGTH(info[0], r, `p.length`, p_length)
+
+  CALL_SODIUM(crypto_core_ed25519_sub_batch(CDATA(r), CDATA(p), CDATA(q), p_count))
+}
+
+// (results, points, callback)
+NAN_METHOD(crypto_core_ed25519_is_valid_point_batch_async) {
+  ASSERT_BUFFER_ARRAY(info[1], points, crypto_core_ed25519_BYTES, crypto_core_ed25519_BYTES)
+  ASSERT_BUFFER_MIN_LENGTH(info[0], results, `Math.ceil(points.length / crypto_core_ed25519_BYTES / 8)`, (points_count + 7) / 8)
+  ASSERT_FUNCTION(info[2], callback)
+
+  v8::Local<v8::Array> buffers = Nan::New<v8::Array>(2);
+  Nan::Set(buffers, 0, results);
+  Nan::Set(buffers, 1, points);
+
+  crypto_core_ed25519_batch_queue(CRYPTO_CORE_ED25519_BATCH_IS_VALID_POINT, CDATA(results), CDATA(points), NULL, points_count, buffers, callback);
+}
+
+// (p, r, callback)
+NAN_METHOD(crypto_core_ed25519_from_uniform_batch_async) {
+  ASSERT_BUFFER_ARRAY(info[1], r, crypto_core_ed25519_UNIFORMBYTES, crypto_core_ed25519_UNIFORMBYTES)
+  ASSERT_BUFFER_MIN_LENGTH(info[0], p, `r.length`, r_count * crypto_core_ed25519_BYTES)
+  ASSERT_FUNCTION(info[2], callback)
+
+  v8::Local<v8::Array> buffers = Nan::New<v8::Array>(2);
+  Nan::Set(buffers, 0, p);
+  Nan::Set(buffers, 1, r);
+
+  crypto_core_ed25519_batch_queue(CRYPTO_CORE_ED25519_BATCH_FROM_UNIFORM, CDATA(p), CDATA(r), NULL, r_count, buffers, callback);
+}
+
+// (r, p, q, callback)
+NAN_METHOD(crypto_core_ed25519_add_batch_async) {
+  ASSERT_BUFFER_ARRAY(info[1], p, crypto_core_ed25519_BYTES, crypto_core_ed25519_BYTES)
+  ASSERT_BUFFER_ARRAY(info[2], q, crypto_core_ed25519_BYTES, crypto_core_ed25519_BYTES)
+  ASSERT_SAME_COUNT(p, q)
+  ASSERT_BUFFER_MIN_LENGTH(info[0], r, `p.length`, p_length)
+  ASSERT_FUNCTION(info[3], callback)
+
+  v8::Local<v8::Array> buffers = Nan::New<v8::Array>(3);
+  Nan::Set(buffers, 0, r);
+  Nan::Set(buffers, 1, p);
+  Nan::Set(buffers, 2, q);
+
+  crypto_core_ed25519_batch_queue(CRYPTO_CORE_ED25519_BATCH_ADD, CDATA(r), CDATA(p), CDATA(q), p_count, buffers, callback);
+}
+
+// (r, p, q, callback)
+NAN_METHOD(crypto_core_ed25519_sub_batch_async) {
+  ASSERT_BUFFER_ARRAY(info[1], p, crypto_core_ed25519_BYTES, crypto_core_ed25519_BYTES)
+  ASSERT_BUFFER_ARRAY(info[2], q, crypto_core_ed25519_BYTES, crypto_core_ed25519_BYTES)
+  ASSERT_SAME_COUNT(p, q)
+  ASSERT_BUFFER_MIN_LENGTH(info[0], r, `p.length`, p_length)
+  ASSERT_FUNCTION(info[3], callback)
+
+  v8::Local<v8::Array> buffers = Nan::New<v8::Array>(3);
+  Nan::Set(buffers, 0, r);
+  Nan::Set(buffers, 1, p);
+  Nan::Set(buffers, 2, q);
+
+  crypto_core_ed25519_batch_queue(CRYPTO_CORE_ED25519_BATCH_SUB, CDATA(r), CDATA(p), CDATA(q), p_count, buffers, callback);
+}
+
 NAN_METHOD(crypto_core_ed25519_scalar_random) {
   ASSERT_BUFFER_MIN_LENGTH(info[0], r, crypto_core_ed25519_SCALARBYTES, crypto_core_ed25519_scalarbytes())
 
@@ -1120,6 +1965,55 @@ NAN_METHOD(crypto_core_ed25519_scalar_sub) {
   crypto_core_ed25519_scalar_sub(CDATA(z), CDATA(x), CDATA(y));
 }
 
+NAN_METHOD(crypto_core_ed25519_scalar_mul) {
+  ASSERT_BUFFER_MIN_LENGTH(info[0], z, crypto_core_ed25519_SCALARBYTES, crypto_core_ed25519_scalarbytes())
+  ASSERT_BUFFER_MIN_LENGTH(info[1], x, crypto_core_ed25519_SCALARBYTES, crypto_core_ed25519_scalarbytes())
+  ASSERT_BUFFER_MIN_LENGTH(info[2], y, crypto_core_ed25519_SCALARBYTES, crypto_core_ed25519_scalarbytes())
+
+  ed25519_sc_mul(CDATA(z), CDATA(x), CDATA(y));
+}
+
+// (recip, s)
+NAN_METHOD(crypto_core_ed25519_scalar_invert_batch) {
+  ASSERT_BUFFER_ARRAY(info[1], s, crypto_core_ed25519_SCALARBYTES, crypto_core_ed25519_SCALARBYTES)
+  ASSERT_BUFFER_MIN_LENGTH(info[0], recip, `s.length`, s_length)
+
+  CALL_SODIUM(crypto_core_ed25519_scalar_invert_batch(CDATA(recip), CDATA(s), s_count))
+}
+
+// (neg, s)
+NAN_METHOD(crypto_core_ed25519_scalar_negate_batch) {
+  ASSERT_BUFFER_ARRAY(info[1], s, crypto_core_ed25519_SCALARBYTES, crypto_core_ed25519_SCALARBYTES)
+  ASSERT_BUFFER_MIN_LENGTH(info[0], neg, `s.length`, s_length)
+
+  crypto_core_ed25519_scalar_negate_batch(CDATA(neg), CDATA(s), s_count);
+}
+
+// (r, s)
+NAN_METHOD(crypto_core_ed25519_scalar_reduce_batch) {
+  ASSERT_BUFFER_ARRAY(info[1], s, crypto_core_ed25519_NONREDUCEDSCALARBYTES, crypto_core_ed25519_NONREDUCEDSCALARBYTES)
+  ASSERT_BUFFER_MIN_LENGTH(info[0], r, `s.length / 2`, s_count * crypto_core_ed25519_SCALARBYTES)
+
+  crypto_core_ed25519_scalar_reduce_batch(CDATA(r), CDATA(s), s_count);
+}
+
+// (z, x, y) for add, sub and mul
+#define SCALAR_BATCH_METHOD(name) \
+  NAN_METHOD(name) { \
+    ASSERT_BUFFER_ARRAY(info[1], x, crypto_core_ed25519_SCALARBYTES, crypto_core_ed25519_SCALARBYTES) \
+    ASSERT_BUFFER_ARRAY(info[2], y, crypto_core_ed25519_SCALARBYTES, crypto_core_ed25519_SCALARBYTES) \
+    ASSERT_SAME_COUNT(x, y) \
+    ASSERT_BUFFER_MIN_LENGTH(info[0], z, `x.length`, x_length) \
+    \
+    name(CDATA(z), CDATA(x), CDATA(y), x_count); \
+  }
+
+SCALAR_BATCH_METHOD(crypto_core_ed25519_scalar_add_batch)
+SCALAR_BATCH_METHOD(crypto_core_ed25519_scalar_sub_batch)
+SCALAR_BATCH_METHOD(crypto_core_ed25519_scalar_mul_batch)
+
+#undef SCALAR_BATCH_METHOD
+
 // crypto_shorthash
 
 NAN_METHOD(crypto_shorthash) {
@@ -1160,6 +2054,29 @@ NAN_METHOD(crypto_hash_sha256_instance) {
   info.GetReturnValue().Set(CryptoHashSha256Wrap::NewInstance());
 }
 
+NAN_METHOD(crypto_hash_sha256_init) {
+  ASSERT_BUFFER_MIN_LENGTH(info[0], state, crypto_hash_sha256_STATEBYTES, crypto_hash_sha256_statebytes())
+
+  caller_state<crypto_hash_sha256_state> s(CDATA(state));
+  CALL_SODIUM(crypto_hash_sha256_init(s.state))
+}
+
+NAN_METHOD(crypto_hash_sha256_update) {
+  ASSERT_BUFFER_MIN_LENGTH(info[0], state, crypto_hash_sha256_STATEBYTES, crypto_hash_sha256_statebytes())
+  ASSERT_BUFFER(info[1], input)
+
+  caller_state<crypto_hash_sha256_state> s(CDATA(state));
+  CALL_SODIUM(crypto_hash_sha256_update(s.state, CDATA(input), CLENGTH(input)))
+}
+
+NAN_METHOD(crypto_hash_sha256_final) {
+  ASSERT_BUFFER_MIN_LENGTH(info[0], state, crypto_hash_sha256_STATEBYTES, crypto_hash_sha256_statebytes())
+  ASSERT_BUFFER_MIN_LENGTH(info[1], output, crypto_hash_sha256_BYTES, crypto_hash_sha256_bytes())
+
+  caller_state<crypto_hash_sha256_state> s(CDATA(state));
+  CALL_SODIUM(crypto_hash_sha256_final(s.state, CDATA(output)))
+}
+
 // crypto_hash_sha512
 
 NAN_METHOD(crypto_hash_sha512) {
@@ -1173,12 +2090,275 @@ NAN_METHOD(crypto_hash_sha512_instance) {
   info.GetReturnValue().Set(CryptoHashSha512Wrap::NewInstance());
 }
 
+NAN_METHOD(crypto_hash_sha512_init) {
+  ASSERT_BUFFER_MIN_LENGTH(info[0], state, crypto_hash_sha512_STATEBYTES, crypto_hash_sha512_statebytes())
+
+  caller_state<crypto_hash_sha512_state> s(CDATA(state));
+  CALL_SODIUM(crypto_hash_sha512_init(s.state))
+}
+
+NAN_METHOD(crypto_hash_sha512_update) {
+  ASSERT_BUFFER_MIN_LENGTH(info[0], state, crypto_hash_sha512_STATEBYTES, crypto_hash_sha512_statebytes())
+  ASSERT_BUFFER(info[1], input)
+
+  caller_state<crypto_hash_sha512_state> s(CDATA(state));
+  CALL_SODIUM(crypto_hash_sha512_update(s.state, CDATA(input), CLENGTH(input)))
+}
+
+NAN_METHOD(crypto_hash_sha512_final) {
+  ASSERT_BUFFER_MIN_LENGTH(info[0], state, crypto_hash_sha512_STATEBYTES, crypto_hash_sha512_statebytes())
+  ASSERT_BUFFER_MIN_LENGTH(info[1], output, crypto_hash_sha512_BYTES, crypto_hash_sha512_bytes())
+
+  caller_state<crypto_hash_sha512_state> s(CDATA(state));
+  CALL_SODIUM(crypto_hash_sha512_final(s.state, CDATA(output)))
+}
+
+// file hashing
+
+// declares var as the option, returning with the exception pending when a
+// getter on opts throws
+#define OPTION_VALUE(opts, name, var) \
+  v8::Local<v8::Value> var; \
+  if (!Nan::Get(opts, LOCAL_STRING(#name)).ToLocal(&var)) return;
+
+#define ASSERT_FILE(name, var) \
+  if (!name->IsNumber() && !name->IsString()) { \
+    Nan::ThrowError(#var " must be a file descriptor or a path"); \
+    return; \
+  } \
+  int var##_fd = -1; \
+  std::string var##_path; \
+  if (name->IsNumber()) { \
+    ASSERT_UINT_BOUNDS(name, var, 0, 0, 2^31 - 1, 0x7fffffff) \
+    var##_fd = (int) var; \
+  } else { \
+    var##_path = *Nan::Utf8String(name); \
+  }
+
+// (fd | path, [opts], callback), opts being { offset, length } and, for
+// generichash, { key, outputLength }. The digest is a new buffer passed to
+// the callback
+static void file_hash_async (Nan::NAN_METHOD_ARGS_TYPE info, enum file_hash_algorithm algorithm, const char *resource_name, size_t output_length) {
+  ASSERT_FILE(info[0], file)
+
+  uint64_t range_offset = 0;
+  uint64_t range_length = FILE_HASH_TO_END;
+  v8::Local<v8::Value> key_value = Nan::Undefined();
+  int callback_index = 1;
+
+  if (!info[1]->IsFunction()) {
+    if (info[1]->IsObject()) {
+      v8::Local<v8::Object> opts = info[1].As<v8::Object>();
+
+      OPTION_VALUE(opts, offset, offset_value)
+      if (!offset_value->IsUndefined()) {
+        ASSERT_UINT(offset_value, offset)
+        range_offset = offset;
+      }
+
+      OPTION_VALUE(opts, length, length_value)
+      if (!length_value->IsUndefined()) {
+        ASSERT_UINT(length_value, length)
+        range_length = length;
+      }
+
+      if (algorithm == FILE_HASH_GENERICHASH) {
+        OPTION_VALUE(opts, outputLength, output_length_value)
+        if (!output_length_value->IsUndefined()) {
+          ASSERT_UINT_BOUNDS(output_length_value, outputLength, crypto_generichash_BYTES_MIN, crypto_generichash_bytes_min(), crypto_generichash_BYTES_MAX, crypto_generichash_bytes_max())
+          output_length = outputLength;
+        }
+
+        OPTION_VALUE(opts, key, key_option)
+        key_value = key_option;
+        if (!key_value->IsUndefined() && !key_value->IsNull()) {
+          ASSERT_BUFFER_MIN_LENGTH(key_value, key, crypto_generichash_KEYBYTES_MIN, crypto_generichash_keybytes_min())
+          if (key_length > crypto_generichash_keybytes_max()) {
+            Nan::ThrowError("key must be a buffer of size at most crypto_generichash_KEYBYTES_MAX");
+            return;
+          }
+        } else {
+          key_value = Nan::Undefined();
+        }
+      }
+    }
+    callback_index = 2;
+  }
+
+  ASSERT_FUNCTION(info[callback_index], callback)
+
+  v8::Local<v8::Object> output = Nan::NewBuffer(output_length).ToLocalChecked();
+  const unsigned char *key_data = NULL;
+  size_t key_len = 0;
+
+  if (!key_value->IsUndefined()) {
+    key_data = CDATA(key_value.As<v8::Object>());
+    key_len = CLENGTH(key_value.As<v8::Object>());
+  }
+
+  FileHashAsync *worker = new FileHashAsync(new Nan::Callback(callback), resource_name, algorithm, CDATA(output), output_length, key_data, key_len, file_fd, file_path, range_offset, range_length);
+  worker->SaveToPersistent("output", output);
+  if (!key_value->IsUndefined()) worker->SaveToPersistent("key", key_value);
+
+  Nan::AsyncQueueWorker(worker);
+}
+
+NAN_METHOD(crypto_generichash_file_async) {
+  file_hash_async(info, FILE_HASH_GENERICHASH, "sodium-native:crypto_generichash_file_async", crypto_generichash_BYTES);
+}
+
+NAN_METHOD(crypto_hash_sha256_file_async) {
+  file_hash_async(info, FILE_HASH_SHA256, "sodium-native:crypto_hash_sha256_file_async", crypto_hash_sha256_BYTES);
+}
+
+NAN_METHOD(crypto_hash_sha512_file_async) {
+  file_hash_async(info, FILE_HASH_SHA512, "sodium-native:crypto_hash_sha512_file_async", crypto_hash_sha512_BYTES);
+}
+
+// file encryption
+
+// (input, output, key, [opts], callback), opts being { chunkSize, depth,
+// threads, engine }
+static void file_crypt_async (Nan::NAN_METHOD_ARGS_TYPE info, int encrypt, const char *resource_name) {
+  ASSERT_FILE(info[0], input)
+  ASSERT_FILE(info[1], output)
+  ASSERT_BUFFER_MIN_LENGTH(info[2], key, crypto_aead_xchacha20poly1305_ietf_KEYBYTES, crypto_aead_xchacha20poly1305_ietf_keybytes())
+
+  file_crypt_options options;
+  options.encrypt = encrypt;
+  options.in_fd = input_fd;
+  options.out_fd = output_fd;
+  options.chunk_size = FILE_CRYPT_CHUNK_DEFAULT;
+  options.depth = FILE_CRYPT_DEPTH_DEFAULT;
+  options.threads = 0;
+  options.engine = FILE_CRYPT_ENGINE_AUTO;
+
+  int callback_index = 3;
+
+  if (!info[3]->IsFunction()) {
+    if (info[3]->IsObject()) {
+      v8::Local<v8::Object> opts = info[3].As<v8::Object>();
+
+      OPTION_VALUE(opts, chunkSize, chunk_size_value)
+      if (!chunk_size_value->IsUndefined()) {
+        ASSERT_UINT_BOUNDS(chunk_size_value, chunkSize, 4096, FILE_CRYPT_CHUNK_MIN, 16777216, FILE_CRYPT_CHUNK_MAX)
+        options.chunk_size = (uint32_t) chunkSize;
+      }
+
+      OPTION_VALUE(opts, depth, depth_value)
+      if (!depth_value->IsUndefined()) {
+        ASSERT_UINT_BOUNDS(depth_value, depth, 1, 1, 256, FILE_CRYPT_DEPTH_MAX)
+        options.depth = (uint32_t) depth;
+      }
+
+      OPTION_VALUE(opts, threads, threads_value)
+      if (!threads_value->IsUndefined()) {
+        ASSERT_UINT_BOUNDS(threads_value, threads, 1, 1, 64, FILE_CRYPT_THREADS_MAX)
+        options.threads = (uint32_t) threads;
+      }
+
+      OPTION_VALUE(opts, engine, engine_value)
+      if (!engine_value->IsUndefined()) {
+        std::string engine = engine_value->IsString() ? *Nan::Utf8String(engine_value) : "";
+
+        if (engine == "io_uring") {
+          options.engine = FILE_CRYPT_ENGINE_IO_URING;
+        } else if (engine == "pread") {
+          options.engine = FILE_CRYPT_ENGINE_PREAD;
+        } else {
+          Nan::ThrowError("engine must be \"io_uring\" or \"pread\"");
+          return;
+        }
+      }
+    }
+    callback_index = 4;
+  }
+
+  ASSERT_FUNCTION(info[callback_index], callback)
+
+  memcpy(options.key, CDATA(key), sizeof(options.key));
+
+  FileCryptAsync *worker = new FileCryptAsync(new Nan::Callback(callback), resource_name, options, input_path, output_path);
+  sodium_memzero(options.key, sizeof(options.key));
+
+  Nan::AsyncQueueWorker(worker);
+}
+
+NAN_METHOD(crypto_aead_xchacha20poly1305_ietf_encrypt_file_async) {
+  file_crypt_async(info, 1, "sodium-native:crypto_aead_xchacha20poly1305_ietf_encrypt_file_async");
+}
+
+NAN_METHOD(crypto_aead_xchacha20poly1305_ietf_decrypt_file_async) {
+  file_crypt_async(info, 0, "sodium-native:crypto_aead_xchacha20poly1305_ietf_decrypt_file_async");
+}
+
+NAN_METHOD(crypto_aead_xchacha20poly1305_ietf_file_io_uring_available) {
+  info.GetReturnValue().Set(file_crypt_io_uring_available() ? Nan::True() : Nan::False());
+}
+
 // crypto_secretstream
 
+// handles index a table owned by the current isolate
+static thread_local crypto_secretstream_xchacha20poly1305_table *secretstream_table = NULL;
+
+static void secretstream_table_cleanup (void *arg) {
+  crypto_secretstream_xchacha20poly1305_table_destroy(secretstream_table);
+  delete secretstream_table;
+  secretstream_table = NULL;
+}
+
+// a state is either a state object or a handle into secretstream_table
+static crypto_secretstream_xchacha20poly1305_state * secretstream_state (v8::Local<v8::Value> state) {
+  if (state->IsNumber()) {
+    crypto_secretstream_xchacha20poly1305_state *s = NULL;
+
+    if (secretstream_table != NULL && state->IsUint32()) {
+      s = crypto_secretstream_xchacha20poly1305_table_get(secretstream_table, Nan::To<uint32_t>(state).FromJust());
+    }
+
+    if (s == NULL) Nan::ThrowError("state must be an allocated handle");
+    return s;
+  }
+
+  if (!state->IsObject()) {
+    Nan::ThrowError("state must be a CryptoSecretstreamXchacha20poly1305StateWrap or a handle");
+    return NULL;
+  }
+
+  return &(Nan::ObjectWrap::Unwrap<CryptoSecretstreamXchacha20poly1305StateWrap>(state.As<v8::Object>())->state);
+}
+
+#define ASSERT_SECRETSTREAM_STATE(name, var) \
+  crypto_secretstream_xchacha20poly1305_state *var = secretstream_state(name); \
+  if (var == NULL) return;
+
 NAN_METHOD(crypto_secretstream_xchacha20poly1305_state_new) {
   info.GetReturnValue().Set(CryptoSecretstreamXchacha20poly1305StateWrap::NewInstance());
 }
 
+NAN_METHOD(crypto_secretstream_xchacha20poly1305_handle_new) {
+  if (secretstream_table == NULL) {
+    secretstream_table = new crypto_secretstream_xchacha20poly1305_table();
+    per_isolate_cleanup_add(secretstream_table_cleanup, NULL);
+  }
+
+  int64_t handle = crypto_secretstream_xchacha20poly1305_table_alloc(secretstream_table);
+
+  if (handle < 0) {
+    Nan::ThrowError(ERRNO_EXCEPTION(ENOMEM));
+    return;
+  }
+
+  info.GetReturnValue().Set(Nan::New((uint32_t) handle));
+}
+
+NAN_METHOD(crypto_secretstream_xchacha20poly1305_handle_free) {
+  if (!info[0]->IsUint32() || secretstream_table == NULL ||
+      crypto_secretstream_xchacha20poly1305_table_free(secretstream_table, Nan::To<uint32_t>(info[0]).FromJust())) {
+    Nan::ThrowError("handle must be an allocated handle");
+  }
+}
+
 NAN_METHOD(crypto_secretstream_xchacha20poly1305_keygen) {
   ASSERT_BUFFER_MIN_LENGTH(info[0], key, crypto_secretstream_xchacha20poly1305_KEYBYTES, crypto_secretstream_xchacha20poly1305_keybytes())
 
@@ -1186,15 +2366,15 @@ NAN_METHOD(crypto_secretstream_xchacha20poly1305_keygen) {
 }
 
 NAN_METHOD(crypto_secretstream_xchacha20poly1305_init_push) {
-  ASSERT_UNWRAP(info[0], obj, CryptoSecretstreamXchacha20poly1305StateWrap)
+  ASSERT_SECRETSTREAM_STATE(info[0], state)
   ASSERT_BUFFER_MIN_LENGTH(info[1], header, crypto_secretstream_xchacha20poly1305_HEADERBYTES, crypto_secretstream_xchacha20poly1305_headerbytes())
   ASSERT_BUFFER_MIN_LENGTH(info[2], key, crypto_secretstream_xchacha20poly1305_KEYBYTES, crypto_secretstream_xchacha20poly1305_keybytes())
 
-  CALL_SODIUM(crypto_secretstream_xchacha20poly1305_init_push(&obj->state, CDATA(header), CDATA(key)))
+  CALL_SODIUM(crypto_secretstream_xchacha20poly1305_init_push(state, CDATA(header), CDATA(key)))
 }
 
 NAN_METHOD(crypto_secretstream_xchacha20poly1305_push) {
-  ASSERT_UNWRAP(info[0], obj, CryptoSecretstreamXchacha20poly1305StateWrap)
+  ASSERT_SECRETSTREAM_STATE(info[0], state)
   ASSERT_BUFFER_SET_LENGTH(info[2], message)
   ASSERT_BUFFER_MIN_LENGTH(info[1], ciphertext,
     `message.length + crypto_secretstream_xchacha20poly1305_ABYTES`,
@@ -1212,21 +2392,21 @@ NAN_METHOD(crypto_secretstream_xchacha20poly1305_push) {
 
   unsigned long long mlen;
 
-  CALL_SODIUM(crypto_secretstream_xchacha20poly1305_push(&obj->state, CDATA(ciphertext), &mlen, CDATA(message), message_length, ad_data, ad_len, *CDATA(tag)));
+  CALL_SODIUM(crypto_secretstream_xchacha20poly1305_push(state, CDATA(ciphertext), &mlen, CDATA(message), message_length, ad_data, ad_len, *CDATA(tag)));
 
   info.GetReturnValue().Set(Nan::New((uint32_t) mlen));
 }
 
 NAN_METHOD(crypto_secretstream_xchacha20poly1305_init_pull) {
-  ASSERT_UNWRAP(info[0], obj, CryptoSecretstreamXchacha20poly1305StateWrap)
+  ASSERT_SECRETSTREAM_STATE(info[0], state)
   ASSERT_BUFFER_MIN_LENGTH(info[1], header, crypto_secretstream_xchacha20poly1305_HEADERBYTES, crypto_secretstream_xchacha20poly1305_headerbytes())
   ASSERT_BUFFER_MIN_LENGTH(info[2], key, crypto_secretstream_xchacha20poly1305_KEYBYTES, crypto_secretstream_xchacha20poly1305_keybytes())
 
-  CALL_SODIUM(crypto_secretstream_xchacha20poly1305_init_pull(&obj->state, CDATA(header), CDATA(key)))
+  CALL_SODIUM(crypto_secretstream_xchacha20poly1305_init_pull(state, CDATA(header), CDATA(key)))
 }
 
 NAN_METHOD(crypto_secretstream_xchacha20poly1305_pull) {
-  ASSERT_UNWRAP(info[0], obj, CryptoSecretstreamXchacha20poly1305StateWrap)
+  ASSERT_SECRETSTREAM_STATE(info[0], state)
   ASSERT_BUFFER_SET_LENGTH(info[3], ciphertext)
   ASSERT_BUFFER_MIN_LENGTH(info[1], message,
     `ciphertext.length - crypto_secretstream_xchacha20poly1305_ABYTES`,
@@ -1249,19 +2429,74 @@ NAN_METHOD(crypto_secretstream_xchacha20poly1305_pull) {
 
   unsigned long long clen = 0;
 
-  CALL_SODIUM(crypto_secretstream_xchacha20poly1305_pull(&obj->state, CDATA(message), &clen, tag_p, CDATA(ciphertext), ciphertext_length, ad_data, ad_len));
+  CALL_SODIUM(crypto_secretstream_xchacha20poly1305_pull(state, CDATA(message), &clen, tag_p, CDATA(ciphertext), ciphertext_length, ad_data, ad_len));
 
   info.GetReturnValue().Set(Nan::New((uint32_t) clen));
 }
 
 NAN_METHOD(crypto_secretstream_xchacha20poly1305_rekey) {
-  ASSERT_UNWRAP(info[0], obj, CryptoSecretstreamXchacha20poly1305StateWrap)
+  ASSERT_SECRETSTREAM_STATE(info[0], state)
+
+  crypto_secretstream_xchacha20poly1305_rekey(state);
+}
+
+// command buffers
+
+#define ASSERT_COMMAND_BUFFER(commands_name, slots_name, var) \
+  ASSERT_UINT32ARRAY(commands_name, commands) \
+  std::vector<iov_buffer> var##_slots; \
+  if (!slots_name->IsArray() || !iov_from_value(slots_name, var##_slots)) { \
+    Nan::ThrowError("buffers must be an array of buffers"); \
+    return; \
+  } \
+  std::vector<command_buffer_command> var; \
+  size_t var##_error_index = 0; \
+  const char *var##_error = command_buffer_compile(var, (const uint32_t *) CDATA(commands_name), CLENGTH(commands_name) / 4, var##_slots.data(), var##_slots.size(), &var##_error_index); \
+  if (var##_error != NULL) { \
+    Nan::ThrowError(("command " + std::to_string(var##_error_index) + ": " + var##_error).c_str()); \
+    return; \
+  }
+
+// (commands, buffers)
+NAN_METHOD(sodium_command_buffer_run) {
+  ASSERT_COMMAND_BUFFER(info[0], info[1], program)
+
+  long failed = command_buffer_run(program.data(), program.size(), program_slots.data());
+  info.GetReturnValue().Set(failed < 0 ? Nan::True() : Nan::False());
+}
+
+// (commands, buffers, callback)
+NAN_METHOD(sodium_command_buffer_run_async) {
+  ASSERT_COMMAND_BUFFER(info[0], info[1], program)
+  ASSERT_FUNCTION(info[2], callback)
+
+  // a copy of the array, so the buffers stay referenced even if the caller
+  // changes its own array before the callback runs
+  v8::Local<v8::Array> slots = info[1].As<v8::Array>();
+  v8::Local<v8::Array> buffers = Nan::New<v8::Array>(slots->Length());
+  for (uint32_t i = 0; i < slots->Length(); i++) {
+    Nan::Set(buffers, i, Nan::Get(slots, i).ToLocalChecked());
+  }
+
+  SodiumCommandBufferRunAsync *worker = new SodiumCommandBufferRunAsync(new Nan::Callback(callback), program, program_slots);
+  worker->SaveToPersistent("buffers", buffers);
+
+  Nan::AsyncQueueWorker(worker);
+}
 
-  crypto_secretstream_xchacha20poly1305_rekey(&obj->state);
+// sodium_init is process wide, while InitAll runs once for every isolate that
+// loads the addon (the main thread and each worker_thread)
+static uv_once_t sodium_init_once = UV_ONCE_INIT;
+static int sodium_init_result = -1;
+
+static void sodium_init_process () {
+  sodium_init_result = sodium_init();
 }
 
 NAN_MODULE_INIT(InitAll) {
-  if (sodium_init() == -1) {
+  uv_once(&sodium_init_once, sodium_init_process);
+
+  if (sodium_init_result == -1) {
     Nan::ThrowError("sodium_init() failed");
     return;
   }
@@ -1320,22 +2555,50 @@ NAN_MODULE_INIT(InitAll) {
   EXPORT_FUNCTION(crypto_aead_xchacha20poly1305_ietf_keygen)
   EXPORT_FUNCTION(crypto_aead_xchacha20poly1305_ietf_encrypt)
   EXPORT_FUNCTION(crypto_aead_xchacha20poly1305_ietf_decrypt)
+  EXPORT_FUNCTION(crypto_aead_xchacha20poly1305_ietf_encrypt_iov)
+  EXPORT_FUNCTION(crypto_aead_xchacha20poly1305_ietf_decrypt_iov)
   EXPORT_FUNCTION(crypto_aead_xchacha20poly1305_ietf_encrypt_detached)
   EXPORT_FUNCTION(crypto_aead_xchacha20poly1305_ietf_decrypt_detached)
 
+  EXPORT_NUMBER_VALUE(crypto_aead_xchacha20poly1305_ietf_FILE_HEADERBYTES, FILE_CRYPT_HEADERBYTES)
+  EXPORT_FUNCTION(crypto_aead_xchacha20poly1305_ietf_encrypt_file_async)
+  EXPORT_FUNCTION(crypto_aead_xchacha20poly1305_ietf_decrypt_file_async)
+  EXPORT_FUNCTION(crypto_aead_xchacha20poly1305_ietf_file_io_uring_available)
+
+  // crypto_aead_aes256gcm
+
+  EXPORT_NUMBER_VALUE(crypto_aead_aes256gcm_ABYTES, crypto_aead_aes256gcm_abytes())
+  EXPORT_NUMBER_VALUE(crypto_aead_aes256gcm_KEYBYTES, crypto_aead_aes256gcm_keybytes())
+  EXPORT_NUMBER_VALUE(crypto_aead_aes256gcm_NPUBBYTES, crypto_aead_aes256gcm_npubbytes())
+  EXPORT_NUMBER_VALUE(crypto_aead_aes256gcm_NSECBYTES, crypto_aead_aes256gcm_nsecbytes())
+  EXPORT_NUMBER_VALUE(crypto_aead_aes256gcm_MESSAGEBYTES_MAX, crypto_aead_aes256gcm_messagebytes_max())
+
+  EXPORT_FUNCTION(crypto_aead_aes256gcm_is_available)
+  EXPORT_FUNCTION(crypto_aead_aes256gcm_keygen)
+  EXPORT_FUNCTION(crypto_aead_aes256gcm_encrypt)
+  EXPORT_FUNCTION(crypto_aead_aes256gcm_decrypt)
+  EXPORT_FUNCTION(crypto_aead_aes256gcm_encrypt_detached)
+  EXPORT_FUNCTION(crypto_aead_aes256gcm_decrypt_detached)
+  EXPORT_FUNCTION(crypto_aead_aes256gcm_instance)
+
   // crypto_sign
 
   EXPORT_NUMBER_VALUE(crypto_sign_SEEDBYTES, crypto_sign_seedbytes())
   EXPORT_NUMBER_VALUE(crypto_sign_PUBLICKEYBYTES, crypto_sign_publickeybytes())
   EXPORT_NUMBER_VALUE(crypto_sign_SECRETKEYBYTES, crypto_sign_secretkeybytes())
   EXPORT_NUMBER_VALUE(crypto_sign_BYTES, crypto_sign_bytes())
+  EXPORT_NUMBER_VALUE(crypto_sign_verify_cache_CAPACITY_MAX, CRYPTO_SIGN_VERIFY_CACHE_CAPACITY_MAX)
 
   EXPORT_FUNCTION(crypto_sign_seed_keypair)
   EXPORT_FUNCTION(crypto_sign_keypair)
   EXPORT_FUNCTION(crypto_sign)
   EXPORT_FUNCTION(crypto_sign_open)
   EXPORT_FUNCTION(crypto_sign_detached)
+  EXPORT_FUNCTION(crypto_sign_instance)
   EXPORT_FUNCTION(crypto_sign_verify_detached)
+  EXPORT_FUNCTION(crypto_sign_verify_detached_many_async)
+  EXPORT_FUNCTION(crypto_sign_verify_instance)
+  EXPORT_FUNCTION(crypto_sign_verify_cache_instance)
   EXPORT_FUNCTION(crypto_sign_ed25519_pk_to_curve25519)
   EXPORT_FUNCTION(crypto_sign_ed25519_sk_to_curve25519)
   EXPORT_FUNCTION(crypto_sign_ed25519_sk_to_pk)
@@ -1349,12 +2612,18 @@ NAN_MODULE_INIT(InitAll) {
   EXPORT_NUMBER_VALUE(crypto_generichash_KEYBYTES_MIN, crypto_generichash_keybytes_min())
   EXPORT_NUMBER_VALUE(crypto_generichash_KEYBYTES_MAX, crypto_generichash_keybytes_max())
   EXPORT_NUMBER_VALUE(crypto_generichash_KEYBYTES, crypto_generichash_keybytes())
-
-  CryptoGenericHashWrap::Init();
+  EXPORT_NUMBER_VALUE(crypto_generichash_STATEBYTES, SEALED_STATEBYTES(crypto_generichash_state))
 
   EXPORT_FUNCTION(crypto_generichash)
+  EXPORT_FUNCTION(crypto_generichash_iov)
   EXPORT_FUNCTION(crypto_generichash_instance)
+  EXPORT_FUNCTION(crypto_generichash_init)
+  EXPORT_FUNCTION(crypto_generichash_update)
+  EXPORT_FUNCTION(crypto_generichash_final)
   EXPORT_FUNCTION(crypto_generichash_batch)
+  EXPORT_FUNCTION(crypto_generichash_chunks)
+  EXPORT_FUNCTION(crypto_generichash_chunks_async)
+  EXPORT_FUNCTION(crypto_generichash_chunker_instance)
 
   // crypto_hash
 
@@ -1396,12 +2665,11 @@ NAN_MODULE_INIT(InitAll) {
   EXPORT_FUNCTION(crypto_secretbox_easy)
   EXPORT_FUNCTION(crypto_secretbox_open_detached)
   EXPORT_FUNCTION(crypto_secretbox_open_easy)
+  EXPORT_FUNCTION(crypto_secretbox_easy_iov)
+  EXPORT_FUNCTION(crypto_secretbox_open_easy_iov)
 
   // crypto_stream
 
-  CryptoStreamXorWrap::Init();
-  CryptoStreamChacha20XorWrap::Init();
-
   EXPORT_NUMBER_VALUE(crypto_stream_KEYBYTES, crypto_stream_keybytes())
   EXPORT_NUMBER_VALUE(crypto_stream_NONCEBYTES, crypto_stream_noncebytes())
   EXPORT_STRING(crypto_stream_PRIMITIVE)
@@ -1409,7 +2677,6 @@ NAN_MODULE_INIT(InitAll) {
   EXPORT_NUMBER_VALUE(crypto_stream_chacha20_KEYBYTES, crypto_stream_chacha20_keybytes())
   EXPORT_NUMBER_VALUE(crypto_stream_chacha20_NONCEBYTES, crypto_stream_chacha20_noncebytes())
 
-
   EXPORT_FUNCTION(crypto_stream)
   EXPORT_FUNCTION(crypto_stream_xor)
   EXPORT_FUNCTION(crypto_stream_xor_instance)
@@ -1430,13 +2697,15 @@ NAN_MODULE_INIT(InitAll) {
 
   EXPORT_NUMBER_VALUE(crypto_onetimeauth_BYTES, crypto_onetimeauth_bytes())
   EXPORT_NUMBER_VALUE(crypto_onetimeauth_KEYBYTES, crypto_onetimeauth_keybytes())
+  EXPORT_NUMBER_VALUE(crypto_onetimeauth_STATEBYTES, SEALED_STATEBYTES(crypto_onetimeauth_state))
   EXPORT_STRING(crypto_onetimeauth_PRIMITIVE)
 
-  CryptoOnetimeAuthWrap::Init();
-
   EXPORT_FUNCTION(crypto_onetimeauth)
   EXPORT_FUNCTION(crypto_onetimeauth_verify)
   EXPORT_FUNCTION(crypto_onetimeauth_instance)
+  EXPORT_FUNCTION(crypto_onetimeauth_init)
+  EXPORT_FUNCTION(crypto_onetimeauth_update)
+  EXPORT_FUNCTION(crypto_onetimeauth_final)
 
   // crypto_pwhash
 
@@ -1496,6 +2765,12 @@ NAN_MODULE_INIT(InitAll) {
   EXPORT_FUNCTION(crypto_pwhash_scryptsalsa208sha256_str_async)
   EXPORT_FUNCTION(crypto_pwhash_scryptsalsa208sha256_str_verify_async)
 
+  EXPORT_FUNCTION(crypto_pwhash_arena_available)
+  EXPORT_FUNCTION(crypto_pwhash_arena_enable)
+  EXPORT_FUNCTION(crypto_pwhash_arena_disable)
+  EXPORT_FUNCTION(crypto_pwhash_arena_trim)
+  EXPORT_FUNCTION(crypto_pwhash_arena_bytes)
+
   // crypto_scalarmult
 
   EXPORT_STRING(crypto_scalarmult_PRIMITIVE)
@@ -1521,6 +2796,17 @@ NAN_MODULE_INIT(InitAll) {
   EXPORT_FUNCTION(crypto_scalarmult_ed25519_base_noclamp)
   EXPORT_FUNCTION(crypto_core_ed25519_add)
   EXPORT_FUNCTION(crypto_core_ed25519_sub)
+  EXPORT_FUNCTION(crypto_scalarmult_ed25519_fixed_base_instance)
+  EXPORT_FUNCTION(crypto_scalarmult_ed25519_multi)
+  EXPORT_FUNCTION(crypto_scalarmult_ed25519_multi_async)
+  EXPORT_FUNCTION(crypto_core_ed25519_is_valid_point_batch)
+  EXPORT_FUNCTION(crypto_core_ed25519_from_uniform_batch)
+  EXPORT_FUNCTION(crypto_core_ed25519_add_batch)
+  EXPORT_FUNCTION(crypto_core_ed25519_sub_batch)
+  EXPORT_FUNCTION(crypto_core_ed25519_is_valid_point_batch_async)
+  EXPORT_FUNCTION(crypto_core_ed25519_from_uniform_batch_async)
+  EXPORT_FUNCTION(crypto_core_ed25519_add_batch_async)
+  EXPORT_FUNCTION(crypto_core_ed25519_sub_batch_async)
 
   EXPORT_FUNCTION(crypto_core_ed25519_scalar_random)
   EXPORT_FUNCTION(crypto_core_ed25519_scalar_reduce)
@@ -1529,6 +2815,13 @@ NAN_MODULE_INIT(InitAll) {
   EXPORT_FUNCTION(crypto_core_ed25519_scalar_complement)
   EXPORT_FUNCTION(crypto_core_ed25519_scalar_add)
   EXPORT_FUNCTION(crypto_core_ed25519_scalar_sub)
+  EXPORT_FUNCTION(crypto_core_ed25519_scalar_mul)
+  EXPORT_FUNCTION(crypto_core_ed25519_scalar_invert_batch)
+  EXPORT_FUNCTION(crypto_core_ed25519_scalar_negate_batch)
+  EXPORT_FUNCTION(crypto_core_ed25519_scalar_reduce_batch)
+  EXPORT_FUNCTION(crypto_core_ed25519_scalar_add_batch)
+  EXPORT_FUNCTION(crypto_core_ed25519_scalar_sub_batch)
+  EXPORT_FUNCTION(crypto_core_ed25519_scalar_mul_batch)
 
   // crypto_shorthash
 
@@ -1551,23 +2844,31 @@ NAN_MODULE_INIT(InitAll) {
 
   // crypto_hash_256
 
-  CryptoHashSha256Wrap::Init();
-
   EXPORT_NUMBER_VALUE(crypto_hash_sha256_BYTES, crypto_hash_sha256_bytes())
+  EXPORT_NUMBER_VALUE(crypto_hash_sha256_STATEBYTES, crypto_hash_sha256_statebytes())
   EXPORT_FUNCTION(crypto_hash_sha256)
   EXPORT_FUNCTION(crypto_hash_sha256_instance)
+  EXPORT_FUNCTION(crypto_hash_sha256_init)
+  EXPORT_FUNCTION(crypto_hash_sha256_update)
+  EXPORT_FUNCTION(crypto_hash_sha256_final)
 
   // crypto_hash_512
 
-  CryptoHashSha512Wrap::Init();
-
   EXPORT_NUMBER_VALUE(crypto_hash_sha512_BYTES, crypto_hash_sha512_bytes())
+  EXPORT_NUMBER_VALUE(crypto_hash_sha512_STATEBYTES, crypto_hash_sha512_statebytes())
   EXPORT_FUNCTION(crypto_hash_sha512)
   EXPORT_FUNCTION(crypto_hash_sha512_instance)
+  EXPORT_FUNCTION(crypto_hash_sha512_init)
+  EXPORT_FUNCTION(crypto_hash_sha512_update)
+  EXPORT_FUNCTION(crypto_hash_sha512_final)
 
-  // crypto_secretstream
+  // file hashing
 
-  CryptoSecretstreamXchacha20poly1305StateWrap::Init();
+  EXPORT_FUNCTION(crypto_generichash_file_async)
+  EXPORT_FUNCTION(crypto_hash_sha256_file_async)
+  EXPORT_FUNCTION(crypto_hash_sha512_file_async)
+
+  // crypto_secretstream
 
   EXPORT_NUMBER_VALUE(crypto_secretstream_xchacha20poly1305_ABYTES, crypto_secretstream_xchacha20poly1305_abytes())
   EXPORT_NUMBER_VALUE(crypto_secretstream_xchacha20poly1305_HEADERBYTES, crypto_secretstream_xchacha20poly1305_headerbytes())
@@ -1583,31 +2884,75 @@ NAN_MODULE_INIT(InitAll) {
 
   EXPORT_FUNCTION(crypto_secretstream_xchacha20poly1305_keygen)
   EXPORT_FUNCTION(crypto_secretstream_xchacha20poly1305_state_new)
+  EXPORT_FUNCTION(crypto_secretstream_xchacha20poly1305_handle_new)
+  EXPORT_FUNCTION(crypto_secretstream_xchacha20poly1305_handle_free)
   EXPORT_FUNCTION(crypto_secretstream_xchacha20poly1305_init_push)
   EXPORT_FUNCTION(crypto_secretstream_xchacha20poly1305_push)
   EXPORT_FUNCTION(crypto_secretstream_xchacha20poly1305_init_pull)
   EXPORT_FUNCTION(crypto_secretstream_xchacha20poly1305_pull)
   EXPORT_FUNCTION(crypto_secretstream_xchacha20poly1305_rekey)
+
+  // command buffers
+
+  EXPORT_NUMBER_VALUE(sodium_command_NONE, COMMAND_BUFFER_NONE)
+  EXPORT_NUMBER_VALUE(sodium_command_randombytes_buf, COMMAND_BUFFER_RANDOMBYTES_BUF)
+  EXPORT_NUMBER_VALUE(sodium_command_crypto_kdf_derive_from_key, COMMAND_BUFFER_CRYPTO_KDF_DERIVE_FROM_KEY)
+  EXPORT_NUMBER_VALUE(sodium_command_crypto_aead_xchacha20poly1305_ietf_encrypt, COMMAND_BUFFER_CRYPTO_AEAD_XCHACHA20POLY1305_IETF_ENCRYPT)
+  EXPORT_NUMBER_VALUE(sodium_command_crypto_aead_xchacha20poly1305_ietf_decrypt, COMMAND_BUFFER_CRYPTO_AEAD_XCHACHA20POLY1305_IETF_DECRYPT)
+  EXPORT_NUMBER_VALUE(sodium_command_crypto_secretbox_easy, COMMAND_BUFFER_CRYPTO_SECRETBOX_EASY)
+  EXPORT_NUMBER_VALUE(sodium_command_crypto_secretbox_open_easy, COMMAND_BUFFER_CRYPTO_SECRETBOX_OPEN_EASY)
+  EXPORT_NUMBER_VALUE(sodium_command_crypto_generichash, COMMAND_BUFFER_CRYPTO_GENERICHASH)
+  EXPORT_NUMBER_VALUE(sodium_command_crypto_hash_sha256, COMMAND_BUFFER_CRYPTO_HASH_SHA256)
+  EXPORT_NUMBER_VALUE(sodium_command_crypto_hash_sha512, COMMAND_BUFFER_CRYPTO_HASH_SHA512)
+  EXPORT_NUMBER_VALUE(sodium_command_crypto_auth, COMMAND_BUFFER_CRYPTO_AUTH)
+  EXPORT_NUMBER_VALUE(sodium_command_crypto_auth_verify, COMMAND_BUFFER_CRYPTO_AUTH_VERIFY)
+  EXPORT_NUMBER_VALUE(sodium_command_crypto_sign_detached, COMMAND_BUFFER_CRYPTO_SIGN_DETACHED)
+  EXPORT_NUMBER_VALUE(sodium_command_crypto_sign_verify_detached, COMMAND_BUFFER_CRYPTO_SIGN_VERIFY_DETACHED)
+
+  EXPORT_FUNCTION(sodium_command_buffer_run)
+  EXPORT_FUNCTION(sodium_command_buffer_run_async)
+
+  // instrumentation, not instrumented itself
+  Nan::Set(target, LOCAL_STRING("stats"), LOCAL_FUNCTION(sodium_native_stats));
+  Nan::Set(target, LOCAL_STRING("resetStats"), LOCAL_FUNCTION(sodium_native_reset_stats));
 }
 
-NODE_MODULE(sodium, InitAll)
+NAN_MODULE_WORKER_ENABLED(sodium, InitAll)
 
 #undef EXPORT_FUNCTION
 #undef EXPORT_NUMBER_VALUE
 #undef EXPORT_NUMBER
 #undef EXPORT_STRING
 #undef LOCAL_FUNCTION
+#undef STATS_FUNCTION
+#undef STATS_PROTOTYPE_METHOD
 #undef LOCAL_STRING
 #undef CDATA
 #undef CLENGTH
+#undef IS_BUFFER_SOURCE
+#undef IS_SHARED_ARRAY_BUFFER
+#undef ARRAY_BUFFER_DATA
 #undef STR
 #undef STR_HELPER
 #undef ASSERT_BUFFER
 #undef ASSERT_BUFFER_MIN_LENGTH
 #undef ASSERT_BUFFER_SET_LENGTH
+#undef ASSERT_UINT32ARRAY
 #undef ASSERT_UINT
 #undef ASSERT_UINT_BOUNDS
 #undef ASSERT_FUNCTION
 #undef ASSERT_UNWRAP
+#undef ASSERT_SECRETSTREAM_STATE
+#undef ASSERT_IOV
+#undef ASSERT_IOV_MIN_LENGTH
+#undef ASSERT_SCALARMULT_ED25519_MULTI
+#undef ASSERT_BUFFER_ARRAY
+#undef ASSERT_SAME_COUNT
+#undef ASSERT_COMMAND_BUFFER
+#undef ASSERT_AES256GCM_AVAILABLE
+#undef OPTION_VALUE
+#undef ASSERT_FILE
+#undef ASSERT_SEALED_STATE
+#undef ASSERT_GENERICHASH_KEY
 #undef CALL_SODIUM
 #undef CALL_SODIUM_BOOL
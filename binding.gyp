@@ -1,6 +1,8 @@
 {
   'variables': {
-    'target_arch%': '<!(node preinstall.js --print-arch)>'
+    'target_arch%': '<!(node preinstall.js --print-arch)>',
+    'sodium_native_stats%': '<!(node -p "process.env.SODIUM_NATIVE_STATS || 0")',
+    'sodium_native_static%': '<!(node preinstall.js --print-static)'
   },
   'targets': [
     {
@@ -11,39 +13,96 @@
       ],
       'sources': [
         'binding.cc',
+        'src/per_isolate.cc',
+        'src/stats.cc',
+        'src/iov.cc',
         'src/crypto_hash_sha256_wrap.cc',
         'src/crypto_hash_sha512_wrap.cc',
         'src/crypto_generichash_wrap.cc',
+        'src/crypto_generichash_chunker.cc',
+        'src/crypto_generichash_chunker_wrap.cc',
         'src/crypto_onetimeauth_wrap.cc',
+        'src/crypto_aead_aes256gcm_wrap.cc',
+        'src/ed25519.cc',
+        'src/crypto_scalarmult_ed25519_multi.cc',
+        'src/crypto_core_ed25519_batch.cc',
+        'src/crypto_core_ed25519_scalar_batch.cc',
+        'src/crypto_scalarmult_ed25519_fixed_base.cc',
+        'src/command_buffer.cc',
+        'src/file_hash.cc',
+        'src/file_crypt.cc',
+        'src/pwhash_arena.cc',
+        'src/crypto_sign_expanded.cc',
+        'src/crypto_sign_prepared.cc',
+        'src/crypto_sign_verify_cache.cc',
+        'src/crypto_sign_wrap.cc',
+        'src/crypto_sign_verify_wrap.cc',
+        'src/crypto_sign_verify_cache_wrap.cc',
+        'src/crypto_scalarmult_ed25519_fixed_base_wrap.cc',
         'src/crypto_stream_xor_wrap.cc',
         'src/crypto_stream_chacha20_xor_wrap.cc',
         'src/crypto_secretstream_xchacha20poly1305_state_wrap.cc',
+        'src/crypto_secretstream_xchacha20poly1305_table.cc',
         'src/crypto_pwhash_async.cc',
         'src/crypto_pwhash_str_async.cc',
         'src/crypto_pwhash_str_verify_async.cc',
         'src/crypto_pwhash_scryptsalsa208sha256_async.cc',
         'src/crypto_pwhash_scryptsalsa208sha256_str_async.cc',
-        'src/crypto_pwhash_scryptsalsa208sha256_str_verify_async.cc'
+        'src/crypto_pwhash_scryptsalsa208sha256_str_verify_async.cc',
+        'src/crypto_generichash_chunks_async.cc',
+        'src/crypto_sign_verify_detached_many_async.cc',
+        'src/crypto_scalarmult_ed25519_multi_async.cc',
+        'src/crypto_core_ed25519_batch_async.cc',
+        'src/command_buffer_async.cc',
+        'src/file_hash_async.cc',
+        'src/file_crypt_async.cc'
       ],
       'xcode_settings': {
         'OTHER_CFLAGS': [
           '-g',
           '-O3',
+          '<!@(node preinstall.js --print-cflags)'
         ]
       },
       'cflags': [
         '-g',
         '-O3',
+        '<!@(node preinstall.js --print-cflags)'
       ],
       'libraries': [
         '<!(node preinstall.js --print-lib)'
       ],
       'conditions': [
-        ['OS != "mac" and OS != "win"', {
+        ['sodium_native_stats != 0', {
+          'defines': [ 'SODIUM_NATIVE_STATS' ]
+        }],
+        ['OS != "mac" and OS != "win" and sodium_native_static == 0', {
           'link_settings': {
             'libraries': [ "-Wl,-rpath=\\$$ORIGIN"]
           }
         }],
+        # libsodium is compiled with -flto into a static archive by preinstall.js,
+        # and optimised together with the binding when sodium.node is linked
+        ['OS != "win" and sodium_native_static != 0', {
+          'cflags': [ '-flto' ],
+          # code is generated at link time, for the same CPU as at compile time
+          'ldflags': [ '-flto', '-O3', '<!@(node preinstall.js --print-cflags)' ],
+          'xcode_settings': {
+            'LLVM_LTO': 'YES',
+            'OTHER_LDFLAGS': [ '<!@(node preinstall.js --print-cflags)' ]
+          }
+        }],
+        # keep the libsodium symbols out of the dynamic symbol table, so they
+        # never interpose on another copy of libsodium loaded in the process.
+        # preinstall.js compiles the static libsodium with its mmap and munmap
+        # calls renamed to the ones in src/pwhash_arena.cc, so pwhash work
+        # areas can be reused
+        ['OS == "linux" and sodium_native_static != 0', {
+          'defines': [ 'SODIUM_NATIVE_PWHASH_ARENA' ],
+          'ldflags': [
+            '-Wl,--exclude-libs,ALL'
+          ]
+        }],
       ],
     }
   ]
@@ -1,3 +1,29 @@
-var sodium = require('node-gyp-build')(__dirname)
+var fs = require('fs')
+var load = require('node-gyp-build')
+var variant = require('./variant')
+
+var sodium = load(variant(__dirname, process.env, readCpuinfo, loadable))
 
 module.exports = sodium
+
+function loadable (dir) {
+  if (!fs.existsSync(dir)) return false
+
+  try {
+    load.path(dir)
+    return true
+  } catch (err) {
+    // no build of this variant for this platform and node version
+    return false
+  }
+}
+
+function readCpuinfo () {
+  if (process.platform !== 'linux' || process.arch !== 'x64') return null
+
+  try {
+    return fs.readFileSync('/proc/cpuinfo', 'utf8')
+  } catch (err) {
+    return null
+  }
+}
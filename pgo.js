@@ -0,0 +1,102 @@
+#!/usr/bin/env node
+
+// Builds a profile-guided sodium.node. libsodium and the bindings are first
+// built instrumented, bench/workload.js is run to record which branches and
+// calls are hot, and everything is then rebuilt with that profile. The
+// workload is timed on a regular static build and on the final one, to
+// report the gain.
+//
+// node pgo.js [iterations]
+
+var fs = require('fs')
+var os = require('os')
+var path = require('path')
+var proc = require('child_process')
+
+var iterations = process.argv[2] || '20000'
+var pgoDir = path.join(__dirname, 'tmp-pgo')
+var nodeGyp = path.join(__dirname, 'node_modules/.bin/node-gyp')
+var clang = /clang/.test(process.env.CC || process.env.CXX || (os.platform() === 'darwin' ? 'clang' : 'gcc'))
+
+if (os.platform() === 'win32') {
+  console.error('PGO builds are not supported on Windows')
+  process.exit(1)
+}
+
+console.log('Building without a profile')
+build('')
+var before = measure()
+
+console.log('Building instrumented')
+rimraf(pgoDir)
+fs.mkdirSync(pgoDir)
+build('generate')
+workload(['--json'])
+
+if (clang) {
+  var raw = fs.readdirSync(pgoDir).filter(function (file) {
+    return /\.profraw$/.test(file)
+  }).map(function (file) {
+    return path.join(pgoDir, file)
+  })
+  var profdata = os.platform() === 'darwin' ? ['xcrun', 'llvm-profdata'] : ['llvm-profdata']
+  run(profdata[0], profdata.slice(1).concat(['merge', '-output=' + path.join(pgoDir, 'sodium.profdata')], raw), {})
+}
+
+console.log('Building with the profile')
+build('use')
+var after = measure()
+
+var ratios = Object.keys(before).map(function (name) {
+  var ratio = before[name] / after[name]
+  console.log(name + ': ' + before[name].toFixed(0) + ' -> ' + after[name].toFixed(0) + ' ns/op (' + ratio.toFixed(2) + 'x)')
+  return ratio
+})
+
+var mean = Math.exp(ratios.reduce(function (sum, r) {
+  return sum + Math.log(r)
+}, 0) / ratios.length)
+
+console.log('Geometric mean speedup: ' + mean.toFixed(3) + 'x')
+console.log('build/Release/sodium.node is now the profile-guided build')
+
+// PGO builds are static, so the baseline is too, to only measure the profile
+function build (pgo) {
+  var env = Object.assign({}, process.env, { SODIUM_NATIVE_STATIC: '1', SODIUM_NATIVE_PGO: pgo })
+  run(process.execPath, [path.join(__dirname, 'preinstall.js')], env)
+  run(nodeGyp, ['rebuild'], env)
+}
+
+// the best of three runs of every operation
+function measure () {
+  var best = {}
+
+  for (var i = 0; i < 3; i++) {
+    var result = JSON.parse(workload(['--json']))
+    Object.keys(result).forEach(function (name) {
+      if (!(name in best) || result[name] < best[name]) best[name] = result[name]
+    })
+  }
+
+  return best
+}
+
+function workload (args) {
+  // always the build in build/Release, never a prebuilt CPU variant
+  var env = Object.assign({}, process.env, { SODIUM_NATIVE_VARIANT: 'baseline' })
+  return proc.execFileSync(process.execPath, [path.join(__dirname, 'bench/workload.js'), iterations].concat(args), { cwd: __dirname, env: env }).toString()
+}
+
+function run (cmd, args, env) {
+  proc.execFileSync(cmd, args, { cwd: __dirname, env: env, stdio: 'inherit' })
+}
+
+function rimraf (dir) {
+  if (!fs.existsSync(dir)) return
+  fs.readdirSync(dir).forEach(function (file) {
+    var p = path.join(dir, file)
+    if (fs.statSync(p).isDirectory()) rimraf(p)
+    else fs.unlinkSync(p)
+  })
+  fs.rmdirSync(dir)
+}
@@ -10,7 +10,14 @@ var tmp = path.join(__dirname, 'tmp')
 var build = fs.existsSync(release) ? release : debug
 var arch = process.env.ARCH || os.arch()
 
-switch (os.platform()) {
+// a static libsodium is linked into sodium.node, there is nothing to copy
+var cpu = process.env.SODIUM_NATIVE_CPU && process.env.SODIUM_NATIVE_CPU !== 'baseline'
+var isStatic = (!!Number(process.env.SODIUM_NATIVE_STATIC || 0) || !!cpu || !!process.env.SODIUM_NATIVE_PGO) && os.platform() !== 'win32'
+
+switch (isStatic ? 'static' : os.platform()) {
+  case 'static':
+    break
+
   case 'win32':
     buildWindows()
     break
@@ -0,0 +1,52 @@
+#!/usr/bin/env node
+
+// Prebuilds sodium.node for every CPU variant index.js can pick, on top of the
+// baseline prebuilds made by `npm run prebuild`. Every variant is built with
+// prebuildify like the baseline, with SODIUM_NATIVE_CPU set, and then moved to
+// variants/<name>/prebuilds, where node-gyp-build finds it.
+
+var fs = require('fs')
+var os = require('os')
+var path = require('path')
+var proc = require('child_process')
+
+var variants = ['x86-64-v3', 'x86-64-v4']
+var platform = os.platform() + '-' + (process.env.PREBUILD_ARCH || os.arch())
+
+if (os.arch() !== 'x64' || os.platform() === 'win32') {
+  console.log('CPU variants are only built for x64 outside of Windows')
+  process.exit(0)
+}
+
+var prebuildify = path.join(__dirname, 'node_modules/.bin/prebuildify')
+var prebuilds = path.join(__dirname, 'prebuilds', platform)
+var baseline = prebuilds + '.baseline'
+
+// prebuildify writes to prebuilds/, so the baseline is kept aside meanwhile
+if (fs.existsSync(prebuilds)) fs.renameSync(prebuilds, baseline)
+
+try {
+  variants.forEach(function (name) {
+    var env = Object.assign({}, process.env, { SODIUM_NATIVE_CPU: name })
+    var args = ['-a', '--strip', '--preinstall', 'node preinstall.js', '--postinstall', 'node postinstall.js']
+
+    console.log('Building the ' + name + ' variant')
+    proc.execFileSync(prebuildify, args, { cwd: __dirname, env: env, stdio: 'inherit' })
+
+    var dst = path.join(__dirname, 'variants', name, 'prebuilds', platform)
+    mkdirp(dst)
+
+    fs.readdirSync(prebuilds).forEach(function (file) {
+      fs.renameSync(path.join(prebuilds, file), path.join(dst, file))
+    })
+    fs.rmdirSync(prebuilds)
+  })
+} finally {
+  if (fs.existsSync(baseline)) fs.renameSync(baseline, prebuilds)
+}
+
+function mkdirp (dir) {
+  if (fs.existsSync(dir)) return
+  mkdirp(path.dirname(dir))
+  fs.mkdirSync(dir)
+}
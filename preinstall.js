@@ -16,20 +16,60 @@ if (process.argv.indexOf('--arch') > -1) {
 
 var warch = arch === 'x64' ? 'x64' : 'Win32'
 
+// SODIUM_NATIVE_CPU=x86-64-v3 or x86-64-v4 compiles libsodium and the bindings
+// for that x64 microarchitecture level instead of the baseline. index.js picks
+// the best of these variants for the running CPU.
+var cpus = ['x86-64-v3', 'x86-64-v4']
+var cpu = process.env.SODIUM_NATIVE_CPU === 'baseline' ? '' : (process.env.SODIUM_NATIVE_CPU || '')
+
+if (cpu && (cpus.indexOf(cpu) === -1 || arch !== 'x64' || os.platform() === 'win32')) {
+  console.error('SODIUM_NATIVE_CPU must be one of baseline, ' + cpus.join(', ') + ', and is only supported for x64 outside of Windows')
+  process.exit(1)
+}
+
+// SODIUM_NATIVE_PGO=generate builds libsodium and the bindings instrumented to
+// write a profile to tmp-pgo, SODIUM_NATIVE_PGO=use optimises them with it.
+// pgo.js drives both steps.
+var pgo = process.env.SODIUM_NATIVE_PGO || ''
+var pgoDir = path.join(__dirname, 'tmp-pgo')
+var clang = /clang/.test(process.env.CC || process.env.CXX || (os.platform() === 'darwin' ? 'clang' : 'gcc'))
+
+if (pgo && ((pgo !== 'generate' && pgo !== 'use') || os.platform() === 'win32')) {
+  console.error('SODIUM_NATIVE_PGO must be generate or use, and is not supported on Windows')
+  process.exit(1)
+}
+
+// SODIUM_NATIVE_STATIC=1 builds libsodium as a static PIC archive with LTO and
+// links it into sodium.node, see binding.gyp. Windows always uses the DLL.
+// CPU variants and PGO builds are always static, so each one is a
+// self-contained sodium.node.
+var isStatic = (!!Number(process.env.SODIUM_NATIVE_STATIC || 0) || !!cpu || !!pgo) && os.platform() !== 'win32'
+var staticLib = path.join(__dirname, 'lib/libsodium-' + arch + (cpu ? '-' + cpu : '') + (pgo ? '-pgo-' + pgo : '') + '.a')
+
 if (process.argv.indexOf('--print-arch') > -1) {
   console.log(arch)
   process.exit(0)
 }
 
+if (process.argv.indexOf('--print-static') > -1) {
+  console.log(isStatic ? 1 : 0)
+  process.exit(0)
+}
+
+if (process.argv.indexOf('--print-cflags') > -1) {
+  console.log(cflags().join(' '))
+  process.exit(0)
+}
+
 if (process.argv.indexOf('--print-lib') > -1) {
   switch (os.platform()) {
     case 'darwin':
-      console.log('../lib/libsodium-' + arch + '.dylib')
+      console.log(isStatic ? staticLib : '../lib/libsodium-' + arch + '.dylib')
       break
     case 'openbsd':
     case 'freebsd':
     case 'linux':
-      console.log(path.join(__dirname, 'lib/libsodium-' + arch + '.so'))
+      console.log(isStatic ? staticLib : path.join(__dirname, 'lib/libsodium-' + arch + '.so'))
       break
     case 'win32':
       console.log('../libsodium/Build/ReleaseDLL/' + warch + '/libsodium.lib')
@@ -43,7 +83,11 @@ if (process.argv.indexOf('--print-lib') > -1) {
 
 mkdirSync(path.join(__dirname, 'lib'))
 
-switch (os.platform()) {
+switch (isStatic ? 'static' : os.platform()) {
+  case 'static':
+    buildStatic()
+    break
+
   case 'darwin':
     buildDarwin()
     break
@@ -134,6 +178,80 @@ function buildUnix (ext, cb) {
   })
 }
 
+// The archive holds LTO objects, so sodium.node is optimised together with
+// libsodium at link time. GCC also needs its plugin-aware ar to index them,
+// and keeps regular code next to the LTO data so a linker without the plugin
+// still works.
+function buildStatic () {
+  var res = staticLib
+  // a PGO build depends on the profile, so it is never reused
+  if (pgo && fs.existsSync(res)) fs.unlinkSync(res)
+  if (fs.existsSync(res)) return
+
+  var prefix = path.join(__dirname, 'tmp-static')
+  var env = Object.assign({}, process.env)
+  var cc = env.CC || (os.platform() === 'darwin' ? 'clang' : 'gcc')
+  var flags = ['-O3', '-fPIC', '-flto'].concat(cflags())
+
+  if (!/clang/.test(cc)) {
+    flags.push('-ffat-lto-objects')
+    // gcc-7 comes with gcc-ar-7
+    var version = (cc.match(/gcc(-[\d.]+)$/) || [])[1] || ''
+    env.AR = env.AR || 'gcc-ar' + version
+    env.RANLIB = env.RANLIB || 'gcc-ranlib' + version
+  }
+
+  env.CFLAGS = flags.join(' ') + (env.CFLAGS ? ' ' + env.CFLAGS : '')
+
+  var args = ['--prefix=' + prefix, '--disable-shared', '--enable-static', '--with-pic']
+
+  spawn('./configure', args, { cwd: __dirname, env: env, stdio: 'inherit' }, function (err) {
+    if (err) throw err
+    spawn('make', ['clean'], { cwd: dir, env: env, stdio: 'inherit' }, function (err) {
+      if (err) throw err
+      spawn('make', ['install'].concat(arenaFlags(cc)), { cwd: dir, env: env, stdio: 'inherit' }, function (err) {
+        if (err) throw err
+        fs.rename(path.join(prefix, 'lib/libsodium.a'), res, function (err) {
+          if (err) throw err
+        })
+      })
+    })
+  })
+}
+
+// On Linux, libsodium's mmap and munmap calls go to src/pwhash_arena.cc, so
+// pwhash work areas can be reused. They are renamed by the preprocessor rather
+// than at link time, which LTO can bypass, and only when compiling: configure
+// has to find the real mmap, or libsodium would fall back to malloc.
+function arenaFlags (cc) {
+  if (os.platform() !== 'linux') return []
+  return ['CC=' + cc + ' -Dmmap=sodium_native_pwhash_mmap -Dmunmap=sodium_native_pwhash_munmap']
+}
+
+// flags for libsodium and the bindings alike, also passed when linking
+function cflags () {
+  var flags = []
+
+  if (cpu) flags.push('-march=' + cpu)
+
+  if (pgo === 'generate') {
+    flags.push('-fprofile-generate=' + pgoDir)
+    // the threadpool runs instrumented code concurrently
+    if (!clang) flags.push('-fprofile-update=atomic')
+  }
+
+  if (pgo === 'use') {
+    if (clang) {
+      // pgo.js merges the raw profiles into one file first
+      flags.push('-fprofile-use=' + path.join(pgoDir, 'sodium.profdata'), '-Wno-profile-instr-unprofiled')
+    } else {
+      flags.push('-fprofile-use=' + pgoDir, '-fprofile-correction', '-Wno-missing-profile')
+    }
+  }
+
+  return flags
+}
+
 function buildDarwin () {
   buildUnix('dylib', function (err, res) {
     if (err) throw err
@@ -0,0 +1,257 @@
+#include "command_buffer.h"
+#include <string.h>
+
+// number of operands of every opcode, indexed by opcode
+static const size_t operand_counts[] = {
+  0,
+  1, // randombytes_buf
+  4, // crypto_kdf_derive_from_key
+  5, // crypto_aead_xchacha20poly1305_ietf_encrypt
+  5, // crypto_aead_xchacha20poly1305_ietf_decrypt
+  4, // crypto_secretbox_easy
+  4, // crypto_secretbox_open_easy
+  3, // crypto_generichash
+  2, // crypto_hash_sha256
+  2, // crypto_hash_sha512
+  3, // crypto_auth
+  3, // crypto_auth_verify
+  3, // crypto_sign_detached
+  3  // crypto_sign_verify_detached
+};
+
+#define COMMAND_BUFFER_OPS (sizeof(operand_counts) / sizeof(operand_counts[0]))
+
+#define SLOT(index, var) \
+  if (c->operands[index] >= slots_count) return #var " is not a slot"; \
+  size_t var##_length = slots[c->operands[index]].length; \
+  (void) var##_length;
+
+#define OPTIONAL_SLOT(index, var) \
+  if (c->operands[index] != COMMAND_BUFFER_NONE && c->operands[index] >= slots_count) return #var " is not a slot"; \
+  size_t var##_length = c->operands[index] == COMMAND_BUFFER_NONE ? 0 : slots[c->operands[index]].length; \
+  (void) var##_length;
+
+#define SLOT_MIN_LENGTH(index, var, length_name, length) \
+  SLOT(index, var) \
+  if (var##_length < (length)) return #var " must be at least " #length_name " bytes";
+
+#define SLOT_LENGTH_BOUNDS(index, var, min_name, min, max_name, max) \
+  SLOT(index, var) \
+  if (var##_length < (min) || var##_length > (max)) return #var " must be between " #min_name " and " #max_name " bytes";
+
+static const char * check (const command_buffer_command *c, const iov_buffer *slots, size_t slots_count) {
+  switch (c->op) {
+    case COMMAND_BUFFER_RANDOMBYTES_BUF: {
+      SLOT(0, buf)
+      return NULL;
+    }
+
+    case COMMAND_BUFFER_CRYPTO_KDF_DERIVE_FROM_KEY: {
+      SLOT_LENGTH_BOUNDS(0, subkey,
+        crypto_kdf_BYTES_MIN, crypto_kdf_bytes_min(),
+        crypto_kdf_BYTES_MAX, crypto_kdf_bytes_max())
+      SLOT_MIN_LENGTH(2, context, crypto_kdf_CONTEXTBYTES, crypto_kdf_contextbytes())
+      SLOT_MIN_LENGTH(3, key, crypto_kdf_KEYBYTES, crypto_kdf_keybytes())
+      return NULL;
+    }
+
+    case COMMAND_BUFFER_CRYPTO_AEAD_XCHACHA20POLY1305_IETF_ENCRYPT: {
+      SLOT(1, message)
+      SLOT_MIN_LENGTH(0, ciphertext,
+        `message.length + crypto_aead_xchacha20poly1305_ietf_ABYTES`,
+        message_length + crypto_aead_xchacha20poly1305_ietf_abytes())
+      OPTIONAL_SLOT(2, ad)
+      SLOT_MIN_LENGTH(3, npub, crypto_aead_xchacha20poly1305_ietf_NPUBBYTES, crypto_aead_xchacha20poly1305_ietf_npubbytes())
+      SLOT_MIN_LENGTH(4, k, crypto_aead_xchacha20poly1305_ietf_KEYBYTES, crypto_aead_xchacha20poly1305_ietf_keybytes())
+      return NULL;
+    }
+
+    case COMMAND_BUFFER_CRYPTO_AEAD_XCHACHA20POLY1305_IETF_DECRYPT: {
+      SLOT_MIN_LENGTH(1, ciphertext, crypto_aead_xchacha20poly1305_ietf_ABYTES, crypto_aead_xchacha20poly1305_ietf_abytes())
+      SLOT_MIN_LENGTH(0, message,
+        `ciphertext.length - crypto_aead_xchacha20poly1305_ietf_ABYTES`,
+        ciphertext_length - crypto_aead_xchacha20poly1305_ietf_abytes())
+      OPTIONAL_SLOT(2, ad)
+      SLOT_MIN_LENGTH(3, npub, crypto_aead_xchacha20poly1305_ietf_NPUBBYTES, crypto_aead_xchacha20poly1305_ietf_npubbytes())
+      SLOT_MIN_LENGTH(4, k, crypto_aead_xchacha20poly1305_ietf_KEYBYTES, crypto_aead_xchacha20poly1305_ietf_keybytes())
+      return NULL;
+    }
+
+    case COMMAND_BUFFER_CRYPTO_SECRETBOX_EASY: {
+      SLOT(1, message)
+      SLOT_MIN_LENGTH(0, ciphertext,
+        `message.length + crypto_secretbox_MACBYTES`,
+        message_length + crypto_secretbox_macbytes())
+      SLOT_MIN_LENGTH(2, nonce, crypto_secretbox_NONCEBYTES, crypto_secretbox_noncebytes())
+      SLOT_MIN_LENGTH(3, key, crypto_secretbox_KEYBYTES, crypto_secretbox_keybytes())
+      return NULL;
+    }
+
+    case COMMAND_BUFFER_CRYPTO_SECRETBOX_OPEN_EASY: {
+      SLOT_MIN_LENGTH(1, ciphertext, crypto_secretbox_MACBYTES, crypto_secretbox_macbytes())
+      SLOT_MIN_LENGTH(0, message,
+        `ciphertext.length - crypto_secretbox_MACBYTES`,
+        ciphertext_length - crypto_secretbox_macbytes())
+      SLOT_MIN_LENGTH(2, nonce, crypto_secretbox_NONCEBYTES, crypto_secretbox_noncebytes())
+      SLOT_MIN_LENGTH(3, key, crypto_secretbox_KEYBYTES, crypto_secretbox_keybytes())
+      return NULL;
+    }
+
+    case COMMAND_BUFFER_CRYPTO_GENERICHASH: {
+      SLOT_LENGTH_BOUNDS(0, output,
+        crypto_generichash_BYTES_MIN, crypto_generichash_bytes_min(),
+        crypto_generichash_BYTES_MAX, crypto_generichash_bytes_max())
+      SLOT(1, input)
+      OPTIONAL_SLOT(2, key)
+      if (c->operands[2] != COMMAND_BUFFER_NONE &&
+          (key_length < crypto_generichash_keybytes_min() || key_length > crypto_generichash_keybytes_max())) {
+        return "key must be between crypto_generichash_KEYBYTES_MIN and crypto_generichash_KEYBYTES_MAX bytes";
+      }
+      return NULL;
+    }
+
+    case COMMAND_BUFFER_CRYPTO_HASH_SHA256: {
+      SLOT_MIN_LENGTH(0, output, crypto_hash_sha256_BYTES, crypto_hash_sha256_bytes())
+      SLOT(1, input)
+      return NULL;
+    }
+
+    case COMMAND_BUFFER_CRYPTO_HASH_SHA512: {
+      SLOT_MIN_LENGTH(0, output, crypto_hash_sha512_BYTES, crypto_hash_sha512_bytes())
+      SLOT(1, input)
+      return NULL;
+    }
+
+    case COMMAND_BUFFER_CRYPTO_AUTH:
+    case COMMAND_BUFFER_CRYPTO_AUTH_VERIFY: {
+      SLOT_MIN_LENGTH(0, output, crypto_auth_BYTES, crypto_auth_bytes())
+      SLOT(1, input)
+      SLOT_MIN_LENGTH(2, key, crypto_auth_KEYBYTES, crypto_auth_keybytes())
+      return NULL;
+    }
+
+    case COMMAND_BUFFER_CRYPTO_SIGN_DETACHED: {
+      SLOT_MIN_LENGTH(0, signature, crypto_sign_BYTES, crypto_sign_bytes())
+      SLOT(1, message)
+      SLOT_MIN_LENGTH(2, secretKey, crypto_sign_SECRETKEYBYTES, crypto_sign_secretkeybytes())
+      return NULL;
+    }
+
+    case COMMAND_BUFFER_CRYPTO_SIGN_VERIFY_DETACHED: {
+      SLOT_MIN_LENGTH(0, signature, crypto_sign_BYTES, crypto_sign_bytes())
+      SLOT(1, message)
+      SLOT_MIN_LENGTH(2, publicKey, crypto_sign_PUBLICKEYBYTES, crypto_sign_publickeybytes())
+      return NULL;
+    }
+  }
+
+  return "unknown opcode";
+}
+
+#undef SLOT
+#undef OPTIONAL_SLOT
+#undef SLOT_MIN_LENGTH
+#undef SLOT_LENGTH_BOUNDS
+
+const char * command_buffer_compile (std::vector<command_buffer_command> &commands, const uint32_t *words, size_t words_count, const iov_buffer *slots, size_t slots_count, size_t *error_index) {
+  commands.clear();
+
+  for (size_t i = 0; i < words_count;) {
+    command_buffer_command c;
+    *error_index = commands.size();
+
+    c.op = words[i++];
+    if (c.op == 0 || c.op >= COMMAND_BUFFER_OPS) return "unknown opcode";
+
+    size_t count = operand_counts[c.op];
+    if (words_count - i < count) return "command is missing operands";
+
+    for (size_t j = 0; j < COMMAND_BUFFER_MAX_OPERANDS; j++) {
+      c.operands[j] = j < count ? words[i + j] : COMMAND_BUFFER_NONE;
+    }
+    i += count;
+
+    const char *error = check(&c, slots, slots_count);
+    if (error != NULL) return error;
+
+    commands.push_back(c);
+  }
+
+  return NULL;
+}
+
+// operands are checked by command_buffer_compile
+#define DATA(index) slots[c->operands[index]].data
+#define LENGTH(index) slots[c->operands[index]].length
+#define OPTIONAL_DATA(index) (c->operands[index] == COMMAND_BUFFER_NONE ? NULL : DATA(index))
+#define OPTIONAL_LENGTH(index) (c->operands[index] == COMMAND_BUFFER_NONE ? 0 : LENGTH(index))
+
+long command_buffer_run (const command_buffer_command *commands, size_t count, const iov_buffer *slots) {
+  for (size_t i = 0; i < count; i++) {
+    const command_buffer_command *c = commands + i;
+    int ret = 0;
+
+    switch (c->op) {
+      case COMMAND_BUFFER_RANDOMBYTES_BUF:
+        randombytes_buf(DATA(0), LENGTH(0));
+        break;
+
+      case COMMAND_BUFFER_CRYPTO_KDF_DERIVE_FROM_KEY:
+        crypto_kdf_derive_from_key(DATA(0), LENGTH(0), c->operands[1], (const char *) DATA(2), DATA(3));
+        break;
+
+      case COMMAND_BUFFER_CRYPTO_AEAD_XCHACHA20POLY1305_IETF_ENCRYPT:
+        crypto_aead_xchacha20poly1305_ietf_encrypt(DATA(0), NULL, DATA(1), LENGTH(1), OPTIONAL_DATA(2), OPTIONAL_LENGTH(2), NULL, DATA(3), DATA(4));
+        break;
+
+      case COMMAND_BUFFER_CRYPTO_AEAD_XCHACHA20POLY1305_IETF_DECRYPT:
+        ret = crypto_aead_xchacha20poly1305_ietf_decrypt(DATA(0), NULL, NULL, DATA(1), LENGTH(1), OPTIONAL_DATA(2), OPTIONAL_LENGTH(2), DATA(3), DATA(4));
+        break;
+
+      case COMMAND_BUFFER_CRYPTO_SECRETBOX_EASY:
+        crypto_secretbox_easy(DATA(0), DATA(1), LENGTH(1), DATA(2), DATA(3));
+        break;
+
+      case COMMAND_BUFFER_CRYPTO_SECRETBOX_OPEN_EASY:
+        ret = crypto_secretbox_open_easy(DATA(0), DATA(1), LENGTH(1), DATA(2), DATA(3));
+        break;
+
+      case COMMAND_BUFFER_CRYPTO_GENERICHASH:
+        crypto_generichash(DATA(0), LENGTH(0), DATA(1), LENGTH(1), OPTIONAL_DATA(2), OPTIONAL_LENGTH(2));
+        break;
+
+      case COMMAND_BUFFER_CRYPTO_HASH_SHA256:
+        crypto_hash_sha256(DATA(0), DATA(1), LENGTH(1));
+        break;
+
+      case COMMAND_BUFFER_CRYPTO_HASH_SHA512:
+        crypto_hash_sha512(DATA(0), DATA(1), LENGTH(1));
+        break;
+
+      case COMMAND_BUFFER_CRYPTO_AUTH:
+        crypto_auth(DATA(0), DATA(1), LENGTH(1), DATA(2));
+        break;
+
+      case COMMAND_BUFFER_CRYPTO_AUTH_VERIFY:
+        ret = crypto_auth_verify(DATA(0), DATA(1), LENGTH(1), DATA(2));
+        break;
+
+      case COMMAND_BUFFER_CRYPTO_SIGN_DETACHED:
+        crypto_sign_detached(DATA(0), NULL, DATA(1), LENGTH(1), DATA(2));
+        break;
+
+      case COMMAND_BUFFER_CRYPTO_SIGN_VERIFY_DETACHED:
+        ret = crypto_sign_verify_detached(DATA(0), DATA(1), LENGTH(1), DATA(2));
+        break;
+    }
+
+    if (ret != 0) return (long) i;
+  }
+
+  return -1;
+}
+
+#undef DATA
+#undef LENGTH
+#undef OPTIONAL_DATA
+#undef OPTIONAL_LENGTH
@@ -0,0 +1,72 @@
+#ifndef SODIUM_NATIVE_COMMAND_BUFFER_H
+#define SODIUM_NATIVE_COMMAND_BUFFER_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+#include "iov.h"
+
+// A command buffer is a short program of sodium calls over a table of slots,
+// run by a single call into the binding. It is encoded as a list of 32 bit
+// words: an opcode followed by a fixed number of operands, most of them slot
+// indexes. Since the slots are plain buffers, an output written by one
+// command is the input of every later command referencing the same slot.
+//
+// Programs are compiled before anything runs: opcodes, slot indexes and the
+// length of every slot are checked against what each call needs, so the only
+// way a compiled program can stop early is a decryption or signature that
+// does not verify.
+//
+// Lengths are those of the slots, as with the single calls: a ciphertext is
+// as long as its slot minus the MAC, a hash as long as its output slot.
+
+// marks an optional slot, such as the additional data or a hashing key, as absent
+#define COMMAND_BUFFER_NONE 0xffffffff
+
+// opcodes, followed by their operands
+enum command_buffer_op {
+  // (buf)
+  COMMAND_BUFFER_RANDOMBYTES_BUF = 1,
+  // (subkey, subkey_id, ctx, key), subkey_id is a number, not a slot
+  COMMAND_BUFFER_CRYPTO_KDF_DERIVE_FROM_KEY,
+  // (c, m, ad | NONE, npub, k)
+  COMMAND_BUFFER_CRYPTO_AEAD_XCHACHA20POLY1305_IETF_ENCRYPT,
+  // (m, c, ad | NONE, npub, k), stops the program if c does not verify
+  COMMAND_BUFFER_CRYPTO_AEAD_XCHACHA20POLY1305_IETF_DECRYPT,
+  // (c, m, n, k)
+  COMMAND_BUFFER_CRYPTO_SECRETBOX_EASY,
+  // (m, c, n, k), stops the program if c does not verify
+  COMMAND_BUFFER_CRYPTO_SECRETBOX_OPEN_EASY,
+  // (out, in, key | NONE)
+  COMMAND_BUFFER_CRYPTO_GENERICHASH,
+  // (out, in)
+  COMMAND_BUFFER_CRYPTO_HASH_SHA256,
+  // (out, in)
+  COMMAND_BUFFER_CRYPTO_HASH_SHA512,
+  // (out, in, k)
+  COMMAND_BUFFER_CRYPTO_AUTH,
+  // (h, in, k), stops the program if h does not verify
+  COMMAND_BUFFER_CRYPTO_AUTH_VERIFY,
+  // (sig, m, sk)
+  COMMAND_BUFFER_CRYPTO_SIGN_DETACHED,
+  // (sig, m, pk), stops the program if sig does not verify
+  COMMAND_BUFFER_CRYPTO_SIGN_VERIFY_DETACHED
+};
+
+#define COMMAND_BUFFER_MAX_OPERANDS 5
+
+typedef struct command_buffer_command {
+  uint32_t op;
+  uint32_t operands[COMMAND_BUFFER_MAX_OPERANDS];
+} command_buffer_command;
+
+// Decodes and checks a program against its slots. Returns NULL on success,
+// otherwise a message for the command at *error_index, and commands is left
+// in an unspecified state.
+const char * command_buffer_compile (std::vector<command_buffer_command> &commands, const uint32_t *words, size_t words_count, const iov_buffer *slots, size_t slots_count, size_t *error_index);
+
+// Runs a compiled program. Returns the index of the command that failed to
+// verify, after which nothing else ran, or -1 if every command ran.
+long command_buffer_run (const command_buffer_command *commands, size_t count, const iov_buffer *slots);
+
+#endif
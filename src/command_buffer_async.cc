@@ -0,0 +1,39 @@
+#include <nan.h>
+#include <vector>
+#include "macros.h"
+#include "timed_async_worker.h"
+#include "command_buffer.h"
+
+#include "../libsodium/src/libsodium/include/sodium.h"
+
+// runs a compiled program on the threadpool, the slots are kept alive by the
+// binding with SaveToPersistent
+class SodiumCommandBufferRunAsync : public TimedAsyncWorker {
+ public:
+  SodiumCommandBufferRunAsync(Nan::Callback *callback, std::vector<command_buffer_command> &commands, std::vector<iov_buffer> &slots)
+    : TimedAsyncWorker(callback, "sodium-native:sodium_command_buffer_run_async"), failed(-1) {
+    this->commands.swap(commands);
+    this->slots.swap(slots);
+  }
+  ~SodiumCommandBufferRunAsync() {}
+
+  void Run () {
+    failed = command_buffer_run(commands.data(), commands.size(), slots.data());
+  }
+
+  void HandleOKCallback () {
+    Nan::HandleScope scope;
+
+    v8::Local<v8::Value> argv[] = {
+        Nan::Null(),
+        failed < 0 ? Nan::True() : Nan::False()
+    };
+
+    callback->Call(2, argv, async_resource);
+  }
+
+ private:
+  std::vector<command_buffer_command> commands;
+  std::vector<iov_buffer> slots;
+  long failed;
+};
@@ -0,0 +1,145 @@
+#include "crypto_aead_aes256gcm_wrap.h"
+#include "macros.h"
+#include "per_isolate.h"
+
+static thread_local Nan::Persistent<v8::FunctionTemplate> crypto_aead_aes256gcm_constructor;
+
+CryptoAeadAes256gcmWrap::CryptoAeadAes256gcmWrap () {}
+
+CryptoAeadAes256gcmWrap::~CryptoAeadAes256gcmWrap () {
+  sodium_memzero(&state, sizeof(state));
+}
+
+NAN_METHOD(CryptoAeadAes256gcmWrap::New) {
+  CryptoAeadAes256gcmWrap* obj = new CryptoAeadAes256gcmWrap();
+  obj->Wrap(info.This());
+  info.GetReturnValue().Set(info.This());
+}
+
+#define AD_ARGUMENT(name) \
+  const unsigned char *ad_data = NULL; \
+  size_t ad_len = 0; \
+  if (name->IsObject()) { \
+    ASSERT_BUFFER_SET_LENGTH(name, ad) \
+    ad_data = CDATA(ad); \
+    ad_len = ad_length; \
+  }
+
+// (ciphertext, message, [ad], null, npub)
+NAN_METHOD(CryptoAeadAes256gcmWrap::Encrypt) {
+  CryptoAeadAes256gcmWrap *self = Nan::ObjectWrap::Unwrap<CryptoAeadAes256gcmWrap>(info.This());
+  ASSERT_BUFFER_SET_LENGTH(info[1], message)
+  ASSERT_BUFFER_MIN_LENGTH(info[0], ciphertext,
+    `message.length + crypto_aead_aes256gcm_ABYTES`,
+    message_length + crypto_aead_aes256gcm_abytes())
+  ASSERT_BUFFER_MIN_LENGTH(info[4], npub, crypto_aead_aes256gcm_NPUBBYTES, crypto_aead_aes256gcm_npubbytes())
+  AD_ARGUMENT(info[2])
+
+  unsigned long long clen;
+  CALL_SODIUM(crypto_aead_aes256gcm_encrypt_afternm(
+    CDATA(ciphertext), &clen,
+    CDATA(message), message_length,
+    ad_data, ad_len,
+    NULL,
+    CDATA(npub),
+    &(self->state)
+  ))
+
+  info.GetReturnValue().Set(Nan::New((uint32_t) clen));
+}
+
+// (message, null, ciphertext, [ad], npub)
+NAN_METHOD(CryptoAeadAes256gcmWrap::Decrypt) {
+  CryptoAeadAes256gcmWrap *self = Nan::ObjectWrap::Unwrap<CryptoAeadAes256gcmWrap>(info.This());
+  ASSERT_BUFFER_MIN_LENGTH(info[2], ciphertext, crypto_aead_aes256gcm_ABYTES, crypto_aead_aes256gcm_abytes())
+  ASSERT_BUFFER_MIN_LENGTH(info[0], message,
+    `ciphertext.length - crypto_aead_aes256gcm_ABYTES`,
+    ciphertext_length - crypto_aead_aes256gcm_abytes())
+  ASSERT_BUFFER_MIN_LENGTH(info[4], npub, crypto_aead_aes256gcm_NPUBBYTES, crypto_aead_aes256gcm_npubbytes())
+  AD_ARGUMENT(info[3])
+
+  unsigned long long mlen;
+  CALL_SODIUM(crypto_aead_aes256gcm_decrypt_afternm(
+    CDATA(message), &mlen,
+    NULL,
+    CDATA(ciphertext), ciphertext_length,
+    ad_data, ad_len,
+    CDATA(npub),
+    &(self->state)
+  ))
+
+  info.GetReturnValue().Set(Nan::New((uint32_t) mlen));
+}
+
+// (ciphertext, mac, message, [ad], null, npub)
+NAN_METHOD(CryptoAeadAes256gcmWrap::EncryptDetached) {
+  CryptoAeadAes256gcmWrap *self = Nan::ObjectWrap::Unwrap<CryptoAeadAes256gcmWrap>(info.This());
+  ASSERT_BUFFER_SET_LENGTH(info[2], message)
+  ASSERT_BUFFER_MIN_LENGTH(info[1], mac, crypto_aead_aes256gcm_ABYTES, crypto_aead_aes256gcm_abytes())
+  ASSERT_BUFFER_MIN_LENGTH(info[0], ciphertext, `message.length`, message_length)
+  ASSERT_BUFFER_MIN_LENGTH(info[5], npub, crypto_aead_aes256gcm_NPUBBYTES, crypto_aead_aes256gcm_npubbytes())
+  AD_ARGUMENT(info[3])
+
+  unsigned long long maclen;
+  CALL_SODIUM(crypto_aead_aes256gcm_encrypt_detached_afternm(
+    CDATA(ciphertext),
+    CDATA(mac), &maclen,
+    CDATA(message), message_length,
+    ad_data, ad_len,
+    NULL,
+    CDATA(npub),
+    &(self->state)
+  ))
+
+  info.GetReturnValue().Set(Nan::New((uint32_t) maclen));
+}
+
+// (message, null, ciphertext, mac, [ad], npub)
+NAN_METHOD(CryptoAeadAes256gcmWrap::DecryptDetached) {
+  CryptoAeadAes256gcmWrap *self = Nan::ObjectWrap::Unwrap<CryptoAeadAes256gcmWrap>(info.This());
+  ASSERT_BUFFER_SET_LENGTH(info[2], ciphertext)
+  ASSERT_BUFFER_MIN_LENGTH(info[0], message, `ciphertext.length`, ciphertext_length)
+  ASSERT_BUFFER_MIN_LENGTH(info[3], mac, crypto_aead_aes256gcm_ABYTES, crypto_aead_aes256gcm_abytes())
+  ASSERT_BUFFER_MIN_LENGTH(info[5], npub, crypto_aead_aes256gcm_NPUBBYTES, crypto_aead_aes256gcm_npubbytes())
+  AD_ARGUMENT(info[4])
+
+  CALL_SODIUM(crypto_aead_aes256gcm_decrypt_detached_afternm(
+    CDATA(message),
+    NULL,
+    CDATA(ciphertext), ciphertext_length,
+    CDATA(mac),
+    ad_data, ad_len,
+    CDATA(npub),
+    &(self->state)
+  ))
+}
+
+#undef AD_ARGUMENT
+
+void CryptoAeadAes256gcmWrap::Init () {
+  v8::Local<v8::FunctionTemplate> tpl = Nan::New<v8::FunctionTemplate>(CryptoAeadAes256gcmWrap::New);
+  per_isolate_constructor_set(&crypto_aead_aes256gcm_constructor, tpl);
+  tpl->SetClassName(Nan::New("CryptoAeadAes256gcmWrap").ToLocalChecked());
+  tpl->InstanceTemplate()->SetInternalFieldCount(1);
+
+  STATS_PROTOTYPE_METHOD(tpl, "crypto_aead_aes256gcm_instance", "encrypt", CryptoAeadAes256gcmWrap::Encrypt)
+  STATS_PROTOTYPE_METHOD(tpl, "crypto_aead_aes256gcm_instance", "decrypt", CryptoAeadAes256gcmWrap::Decrypt)
+  STATS_PROTOTYPE_METHOD(tpl, "crypto_aead_aes256gcm_instance", "encryptDetached", CryptoAeadAes256gcmWrap::EncryptDetached)
+  STATS_PROTOTYPE_METHOD(tpl, "crypto_aead_aes256gcm_instance", "decryptDetached", CryptoAeadAes256gcmWrap::DecryptDetached)
+}
+
+v8::Local<v8::Value> CryptoAeadAes256gcmWrap::NewInstance (unsigned char *key) {
+  Nan::EscapableHandleScope scope;
+
+  if (crypto_aead_aes256gcm_constructor.IsEmpty()) CryptoAeadAes256gcmWrap::Init();
+
+  v8::Local<v8::Object> instance;
+
+  v8::Local<v8::FunctionTemplate> constructorHandle = Nan::New<v8::FunctionTemplate>(crypto_aead_aes256gcm_constructor);
+  instance = Nan::NewInstance(Nan::GetFunction(constructorHandle).ToLocalChecked()).ToLocalChecked();
+
+  CryptoAeadAes256gcmWrap *self = Nan::ObjectWrap::Unwrap<CryptoAeadAes256gcmWrap>(instance);
+  crypto_aead_aes256gcm_beforenm(&(self->state), key);
+
+  return scope.Escape(instance);
+}
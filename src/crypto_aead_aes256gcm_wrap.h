@@ -0,0 +1,26 @@
+#ifndef CRYPTO_AEAD_AES256GCM_WRAP_H
+#define CRYPTO_AEAD_AES256GCM_WRAP_H
+
+#include <nan.h>
+#include "../libsodium/src/libsodium/include/sodium.h"
+
+// crypto_aead_aes256gcm with the key schedule expanded once, by
+// crypto_aead_aes256gcm_beforenm, instead of on every message
+class CryptoAeadAes256gcmWrap : public Nan::ObjectWrap {
+public:
+  static void Init ();
+  static v8::Local<v8::Value> NewInstance (unsigned char *key);
+  CryptoAeadAes256gcmWrap ();
+  ~CryptoAeadAes256gcmWrap ();
+
+private:
+  crypto_aead_aes256gcm_state state;
+
+  static NAN_METHOD(New);
+  static NAN_METHOD(Encrypt);
+  static NAN_METHOD(Decrypt);
+  static NAN_METHOD(EncryptDetached);
+  static NAN_METHOD(DecryptDetached);
+};
+
+#endif
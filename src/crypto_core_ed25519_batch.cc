@@ -0,0 +1,80 @@
+#include "crypto_core_ed25519_batch.h"
+#include "ed25519.h"
+#include <errno.h>
+#include <string.h>
+
+int crypto_core_ed25519_is_valid_point_batch (unsigned char *results, const unsigned char *p, size_t count) {
+  ed25519_ge_p3 h;
+  unsigned char byte = 0;
+  int all = 1;
+
+  for (size_t i = 0; i < count; i++) {
+    const unsigned char *s = p + 32 * i;
+
+    // the checks of crypto_core_ed25519_is_valid_point, the subgroup check
+    // with a vartime multiplication by L as the points are public
+    int valid = ed25519_ge_is_canonical(s) &&
+      !ed25519_ge_has_small_order(s) &&
+      ed25519_ge_frombytes(&h, s) == 0 &&
+      ed25519_ge_is_on_main_subgroup_vartime(&h);
+
+    byte |= valid << (i & 7);
+    all &= valid;
+
+    if ((i & 7) == 7 || i + 1 == count) {
+      results[i >> 3] = byte;
+      byte = 0;
+    }
+  }
+
+  return all;
+}
+
+void crypto_core_ed25519_from_uniform_batch (unsigned char *p, const unsigned char *r, size_t count) {
+  ed25519_ge_p3 h[CRYPTO_CORE_ED25519_BATCH];
+  ed25519_fe scratch[3 * CRYPTO_CORE_ED25519_BATCH];
+
+  for (size_t i = 0; i < count; i += CRYPTO_CORE_ED25519_BATCH) {
+    size_t n = count - i < CRYPTO_CORE_ED25519_BATCH ? count - i : CRYPTO_CORE_ED25519_BATCH;
+
+    ed25519_ge_from_uniform_batch(h, r + 32 * i, scratch, n);
+    ed25519_ge_p3_batch_tobytes(p + 32 * i, h, scratch, n);
+  }
+}
+
+static int add_batch (unsigned char *r, const unsigned char *p, const unsigned char *q, size_t count, int sub) {
+  ed25519_ge_p3 h[CRYPTO_CORE_ED25519_BATCH];
+  ed25519_fe scratch[2 * CRYPTO_CORE_ED25519_BATCH];
+  ed25519_ge_p3 a, b;
+  ed25519_ge_cached c;
+  ed25519_ge_p1p1 t;
+
+  for (size_t i = 0; i < count; i += CRYPTO_CORE_ED25519_BATCH) {
+    size_t n = count - i < CRYPTO_CORE_ED25519_BATCH ? count - i : CRYPTO_CORE_ED25519_BATCH;
+
+    // every input of the group is read before any output is written
+    for (size_t j = 0; j < n; j++) {
+      if (ed25519_ge_frombytes(&a, p + 32 * (i + j)) != 0 || ed25519_ge_frombytes(&b, q + 32 * (i + j)) != 0) {
+        errno = EINVAL;
+        return -1;
+      }
+
+      ed25519_ge_p3_to_cached(&c, &b);
+      if (sub) ed25519_ge_sub(&t, &a, &c);
+      else ed25519_ge_add(&t, &a, &c);
+      ed25519_ge_p1p1_to_p3(&h[j], &t);
+    }
+
+    ed25519_ge_p3_batch_tobytes(r + 32 * i, h, scratch, n);
+  }
+
+  return 0;
+}
+
+int crypto_core_ed25519_add_batch (unsigned char *r, const unsigned char *p, const unsigned char *q, size_t count) {
+  return add_batch(r, p, q, count, 0);
+}
+
+int crypto_core_ed25519_sub_batch (unsigned char *r, const unsigned char *p, const unsigned char *q, size_t count) {
+  return add_batch(r, p, q, count, 1);
+}
@@ -0,0 +1,29 @@
+#ifndef CRYPTO_CORE_ED25519_BATCH_H
+#define CRYPTO_CORE_ED25519_BATCH_H
+
+#include <stddef.h>
+#include "../libsodium/src/libsodium/include/sodium.h"
+
+// Batch forms of crypto_core_ed25519_is_valid_point, _from_uniform, _add and
+// _sub over packed arrays of count 32 byte values, with the same results as
+// calling those once per element.
+//
+// Points are processed in groups of CRYPTO_CORE_ED25519_BATCH and the
+// results of a group are encoded together with a single field inversion.
+// Outputs may be the same array as an input but must not overlap it
+// otherwise.
+
+#define CRYPTO_CORE_ED25519_BATCH 64
+
+// bit i % 8 of results[i / 8] is set if point i is valid, the bits after the
+// last point are cleared. Returns 1 if every point is valid.
+int crypto_core_ed25519_is_valid_point_batch (unsigned char *results, const unsigned char *p, size_t count);
+
+void crypto_core_ed25519_from_uniform_batch (unsigned char *p, const unsigned char *r, size_t count);
+
+// -1 if any point does not decode, r is only partially written then
+int crypto_core_ed25519_add_batch (unsigned char *r, const unsigned char *p, const unsigned char *q, size_t count);
+
+int crypto_core_ed25519_sub_batch (unsigned char *r, const unsigned char *p, const unsigned char *q, size_t count);
+
+#endif
@@ -0,0 +1,123 @@
+#include <nan.h>
+#include <atomic>
+#include "macros.h"
+#include "threadpool_slices.h"
+#include "crypto_core_ed25519_batch.h"
+
+#include "../libsodium/src/libsodium/include/sodium.h"
+
+enum crypto_core_ed25519_batch_op {
+  CRYPTO_CORE_ED25519_BATCH_IS_VALID_POINT,
+  CRYPTO_CORE_ED25519_BATCH_FROM_UNIFORM,
+  CRYPTO_CORE_ED25519_BATCH_ADD,
+  CRYPTO_CORE_ED25519_BATCH_SUB
+};
+
+struct crypto_core_ed25519_batch_job {
+  crypto_core_ed25519_batch_op op;
+  unsigned char *out;
+  const unsigned char *a;
+  const unsigned char *b;
+  size_t count;
+  std::atomic<size_t> next;
+  // an invalid point, which stops add and sub early
+  std::atomic<bool> invalid;
+  // only touched on the main thread
+  size_t pending;
+  Nan::Callback *callback;
+  Nan::Persistent<v8::Array> buffers;
+
+  ~crypto_core_ed25519_batch_job () {
+    buffers.Reset();
+    delete callback;
+  }
+};
+
+static inline size_t crypto_core_ed25519_batch_slices (size_t count) {
+  return threadpool_slices((count + CRYPTO_CORE_ED25519_BATCH - 1) / CRYPTO_CORE_ED25519_BATCH);
+}
+
+// one slice of a job. Slices pull groups of CRYPTO_CORE_ED25519_BATCH points,
+// a multiple of 8 so every byte of a validity bitmap has one writer, and the
+// last one to complete calls back into javascript
+class CryptoCoreEd25519BatchAsync : public Nan::AsyncWorker {
+ public:
+  CryptoCoreEd25519BatchAsync(crypto_core_ed25519_batch_job *job)
+    : Nan::AsyncWorker(NULL, "sodium-native:crypto_core_ed25519_batch_async"), job(job) {}
+
+  void Execute () {
+    while (true) {
+      if (job->op != CRYPTO_CORE_ED25519_BATCH_IS_VALID_POINT && job->invalid.load(std::memory_order_relaxed)) return;
+
+      size_t start = job->next.fetch_add(CRYPTO_CORE_ED25519_BATCH, std::memory_order_relaxed);
+      if (start >= job->count) return;
+
+      size_t n = job->count - start < CRYPTO_CORE_ED25519_BATCH ? job->count - start : CRYPTO_CORE_ED25519_BATCH;
+      int ok = 1;
+
+      switch (job->op) {
+        case CRYPTO_CORE_ED25519_BATCH_IS_VALID_POINT:
+          ok = crypto_core_ed25519_is_valid_point_batch(job->out + start / 8, job->a + 32 * start, n);
+          break;
+        case CRYPTO_CORE_ED25519_BATCH_FROM_UNIFORM:
+          crypto_core_ed25519_from_uniform_batch(job->out + 32 * start, job->a + 32 * start, n);
+          break;
+        case CRYPTO_CORE_ED25519_BATCH_ADD:
+          ok = crypto_core_ed25519_add_batch(job->out + 32 * start, job->a + 32 * start, job->b + 32 * start, n) == 0;
+          break;
+        case CRYPTO_CORE_ED25519_BATCH_SUB:
+          ok = crypto_core_ed25519_sub_batch(job->out + 32 * start, job->a + 32 * start, job->b + 32 * start, n) == 0;
+          break;
+      }
+
+      if (!ok) job->invalid.store(true, std::memory_order_relaxed);
+    }
+  }
+
+  void HandleOKCallback () {
+    if (--(job->pending) > 0) return;
+
+    Nan::HandleScope scope;
+
+    bool invalid = job->invalid.load();
+
+    if (job->op == CRYPTO_CORE_ED25519_BATCH_IS_VALID_POINT) {
+      v8::Local<v8::Value> argv[] = {
+          Nan::Null(),
+          invalid ? Nan::False() : Nan::True()
+      };
+
+      job->callback->Call(2, argv, async_resource);
+    } else {
+      v8::Local<v8::Value> argv[] = {
+          invalid ? ERRNO_EXCEPTION(EINVAL) : Nan::Null()
+      };
+
+      job->callback->Call(1, argv, async_resource);
+    }
+
+    delete job;
+  }
+
+ private:
+  crypto_core_ed25519_batch_job *job;
+};
+
+// the buffers stay referenced from a private array until the callback runs
+static inline void crypto_core_ed25519_batch_queue (crypto_core_ed25519_batch_op op, unsigned char *out, const unsigned char *a, const unsigned char *b, size_t count, v8::Local<v8::Array> buffers, v8::Local<v8::Function> callback) {
+  crypto_core_ed25519_batch_job *job = new crypto_core_ed25519_batch_job();
+  job->op = op;
+  job->out = out;
+  job->a = a;
+  job->b = b;
+  job->count = count;
+  job->next = 0;
+  job->invalid = false;
+  job->pending = crypto_core_ed25519_batch_slices(count);
+  job->callback = new Nan::Callback(callback);
+  job->buffers.Reset(buffers);
+
+  for (size_t i = 0, slices = job->pending; i < slices; i++) {
+    Nan::AsyncQueueWorker(new CryptoCoreEd25519BatchAsync(job));
+  }
+}
@@ -0,0 +1,86 @@
+#include "crypto_core_ed25519_scalar_batch.h"
+#include "ed25519.h"
+#include <errno.h>
+#include <string.h>
+#include <vector>
+
+int crypto_core_ed25519_scalar_invert_batch (unsigned char *recip, const unsigned char *s, size_t count) {
+  std::vector<unsigned char> reduced(32 * count);
+  std::vector<unsigned char> prefix(32 * count);
+  unsigned char wide[64];
+  unsigned char acc[32];
+  unsigned char t[32];
+  int ret = 0;
+
+  memset(wide + 32, 0, 32);
+  memset(acc, 0, sizeof(acc));
+  acc[0] = 1;
+
+  // prefix[i] = product of the non-zero scalars before i, zeros count as 1
+  for (size_t i = 0; i < count; i++) {
+    unsigned char *r = &reduced[32 * i];
+
+    if (sodium_is_zero(s + 32 * i, 32)) ret = -1;
+
+    memcpy(wide, s + 32 * i, 32);
+    crypto_core_ed25519_scalar_reduce(r, wide);
+    memcpy(&prefix[32 * i], acc, 32);
+
+    if (!sodium_is_zero(r, 32)) ed25519_sc_mul(acc, acc, r);
+  }
+
+  // acc is still 1 if every scalar was zero
+  crypto_core_ed25519_scalar_invert(t, acc);
+  memcpy(acc, t, 32);
+
+  for (size_t i = count; i-- > 0;) {
+    unsigned char *r = &reduced[32 * i];
+
+    if (sodium_is_zero(r, 32)) {
+      memset(recip + 32 * i, 0, 32);
+      continue;
+    }
+
+    ed25519_sc_mul(t, acc, &prefix[32 * i]);
+    ed25519_sc_mul(acc, acc, r);
+    memcpy(recip + 32 * i, t, 32);
+  }
+
+  sodium_memzero(reduced.data(), reduced.size());
+  sodium_memzero(prefix.data(), prefix.size());
+  sodium_memzero(wide, sizeof(wide));
+  sodium_memzero(acc, sizeof(acc));
+  sodium_memzero(t, sizeof(t));
+
+  if (ret != 0) errno = EINVAL;
+  return ret;
+}
+
+void crypto_core_ed25519_scalar_negate_batch (unsigned char *neg, const unsigned char *s, size_t count) {
+  for (size_t i = 0; i < count; i++) crypto_core_ed25519_scalar_negate(neg + 32 * i, s + 32 * i);
+}
+
+void crypto_core_ed25519_scalar_add_batch (unsigned char *z, const unsigned char *x, const unsigned char *y, size_t count) {
+  for (size_t i = 0; i < count; i++) crypto_core_ed25519_scalar_add(z + 32 * i, x + 32 * i, y + 32 * i);
+}
+
+void crypto_core_ed25519_scalar_sub_batch (unsigned char *z, const unsigned char *x, const unsigned char *y, size_t count) {
+  for (size_t i = 0; i < count; i++) crypto_core_ed25519_scalar_sub(z + 32 * i, x + 32 * i, y + 32 * i);
+}
+
+void crypto_core_ed25519_scalar_mul_batch (unsigned char *z, const unsigned char *x, const unsigned char *y, size_t count) {
+  for (size_t i = 0; i < count; i++) ed25519_sc_mul(z + 32 * i, x + 32 * i, y + 32 * i);
+}
+
+void crypto_core_ed25519_scalar_reduce_batch (unsigned char *r, const unsigned char *s, size_t count) {
+  unsigned char wide[64];
+
+  // r[i] overlaps the upper half of s[i / 2] when r is s, so every input is
+  // copied out before its output is written
+  for (size_t i = 0; i < count; i++) {
+    memcpy(wide, s + 64 * i, 64);
+    crypto_core_ed25519_scalar_reduce(r + 32 * i, wide);
+  }
+
+  sodium_memzero(wide, sizeof(wide));
+}
@@ -0,0 +1,28 @@
+#ifndef CRYPTO_CORE_ED25519_SCALAR_BATCH_H
+#define CRYPTO_CORE_ED25519_SCALAR_BATCH_H
+
+#include <stddef.h>
+#include "../libsodium/src/libsodium/include/sodium.h"
+
+// Elementwise forms of the crypto_core_ed25519_scalar_* functions over packed
+// arrays of count scalars, with the same results as calling them once per
+// element. Outputs may be the same array as an input but must not overlap it
+// otherwise.
+
+// Montgomery's trick: one scalar inversion and 3 * (count - 1)
+// multiplications. Like crypto_core_ed25519_scalar_invert, scalars that are
+// 0 mod L invert to 0 and -1 is returned if any scalar is all zero bytes.
+int crypto_core_ed25519_scalar_invert_batch (unsigned char *recip, const unsigned char *s, size_t count);
+
+void crypto_core_ed25519_scalar_negate_batch (unsigned char *neg, const unsigned char *s, size_t count);
+
+void crypto_core_ed25519_scalar_add_batch (unsigned char *z, const unsigned char *x, const unsigned char *y, size_t count);
+
+void crypto_core_ed25519_scalar_sub_batch (unsigned char *z, const unsigned char *x, const unsigned char *y, size_t count);
+
+void crypto_core_ed25519_scalar_mul_batch (unsigned char *z, const unsigned char *x, const unsigned char *y, size_t count);
+
+// s holds count 64 byte scalars
+void crypto_core_ed25519_scalar_reduce_batch (unsigned char *r, const unsigned char *s, size_t count);
+
+#endif
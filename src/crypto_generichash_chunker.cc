@@ -0,0 +1,167 @@
+#include "crypto_generichash_chunker.h"
+
+// gear[i] is the first 8 bytes (little endian) of BLAKE2b-64(i), which gives a
+// fixed, well distributed table without shipping a random seed.
+static const uint64_t gear[256] = {
+  0x4882ead1cdd9f694ULL, 0xad19753f0a3de800ULL, 0xa2d93ed663050975ULL, 0x3e037483d854fbc2ULL,
+  0xae684cdda3330f45ULL, 0xe1876d8ceb4cd828ULL, 0x6e3711fc9de9f3e8ULL, 0x1d94f7e2642eff3cULL,
+  0x6871b24dca53e958ULL, 0x4fb2458b41a4d44cULL, 0xc6e949dba8c23050ULL, 0xf85abdd789cfba40ULL,
+  0x97e977ca936f06c0ULL, 0xe371d1d8b33c0188ULL, 0xd5cc91d852cae6b7ULL, 0x448e050a4c4f3592ULL,
+  0x5297ef5e1493e8bfULL, 0x1c120d9f3cd478b5ULL, 0x367daf5891b58803ULL, 0xd1284314a8b60bfaULL,
+  0xe34e96deef38a3fcULL, 0xc0bd6cb1b16d29d2ULL, 0xf3d0ac60571e6748ULL, 0xc8492756b0f2ec1cULL,
+  0x2d1928bb0bba1d4aULL, 0x855f2b7e904a8ddeULL, 0xf002b042c205e8daULL, 0x5e2cd82a1208bc91ULL,
+  0x49466ca1d40e9ac2ULL, 0xf7e9ddae25cd8f3fULL, 0x7c591b39069010afULL, 0xf9c9e74398d138f6ULL,
+  0x427b5c7a78c54f14ULL, 0xa12a13ab78099a3fULL, 0x507f56872e76330dULL, 0xf5f55f3ee2ad6b46ULL,
+  0x3794ff797629bab1ULL, 0xa7d55722544d1a83ULL, 0xd4d4c09f5eda9291ULL, 0xb6d1d4fdb878bc9aULL,
+  0x2f8ffaf817f6a55bULL, 0xa9903f6fa17cb0f4ULL, 0x6e00483ee9656fa3ULL, 0x109e03bb1e5a0426ULL,
+  0x2f5cbe5203c82406ULL, 0x978012ec12655c96ULL, 0x8470e3b6cf791df0ULL, 0x901d479c282838bfULL,
+  0x75dfcd439d7d2b84ULL, 0x7637ba9f0342fcf6ULL, 0x6c6f6ffdf61ef41bULL, 0x018ed9a60519259eULL,
+  0xb618307f067b1d71ULL, 0xa0998dee9f08548bULL, 0x4c00f1f72d183d1bULL, 0x828f78ceca1750e7ULL,
+  0xfa36d2cb672738a3ULL, 0x05f915fadd7fba8eULL, 0xad927e4f82f17c3fULL, 0x9c90793ea6d0719bULL,
+  0xecbe3bd84dc590d4ULL, 0x1cd65a4785b96f96ULL, 0xaba2e2d4681ed1e8ULL, 0xe9b730ecef921acdULL,
+  0x824885d5cf32cbf8ULL, 0x46507cca99a3891aULL, 0x72da4bd88ac2b4ffULL, 0x0b3c46dcf4939a65ULL,
+  0x78fe5c00aa7fa8d3ULL, 0x21413d7dc6554682ULL, 0xb0c65270d9f2fc2bULL, 0x3dc9acdde08c5b8bULL,
+  0xc47e192f468193f4ULL, 0x034e1db4feaeae09ULL, 0x8d1ad3f2cda75cdbULL, 0x2a925ba0e56ff69dULL,
+  0x00d486aee6488d03ULL, 0x69df3d7bd1507236ULL, 0xeb1109bf78911dd2ULL, 0xf74270a08a175550ULL,
+  0xc9d1e159c9c5070fULL, 0xd09218f47387bc4eULL, 0x32aba3e1dc5562bfULL, 0x7f30b83bb6176e40ULL,
+  0xa71f94fb93691f5eULL, 0xbd3ed4892ae3ad03ULL, 0x7508310db74787c5ULL, 0xccc1b2ce2939f181ULL,
+  0x95e352c5d14f91ffULL, 0xdfeb25aff6bf75a4ULL, 0x3b5b313dfc2aca82ULL, 0xa538749ef95b0643ULL,
+  0x829681c073cf7e4dULL, 0x55f1af37144423c0ULL, 0xec628580b04bf7c4ULL, 0x95ab0e7e246b6e51ULL,
+  0x105d54f3c8e2e3a4ULL, 0x2f42665b399ef840ULL, 0x754f854de3c27284ULL, 0x1b2c07cd64633f37ULL,
+  0x7b8ca8bc56e5a5b5ULL, 0x4f1d2fb024a5d810ULL, 0xdb8e39b68f0c962eULL, 0xbc30dbaed87c766cULL,
+  0x30335fe014629146ULL, 0x3c67888c3c79d1d4ULL, 0x082009f826c24035ULL, 0x63d485f95fcb52acULL,
+  0xd67a27f2a785b562ULL, 0x8c026404a20d03b3ULL, 0xb4981e97a533ba5dULL, 0xa866abb7b75130a0ULL,
+  0x1f69f389bdd5720dULL, 0x3514bd29fb70352bULL, 0xf1dc5a7f078e3acbULL, 0xde6ecfaac38449e6ULL,
+  0xd6d472e0f5dc73caULL, 0x08d267e10c593806ULL, 0x9df7dc769517eba3ULL, 0x20925082a2286b9eULL,
+  0x4f586ef96743df4aULL, 0x5fa69583c58ca30fULL, 0x3041fd28a7b04184ULL, 0x3ad2d0ea0faa2ea2ULL,
+  0x04a60e474646c7e0ULL, 0x9e9b334a268d3d35ULL, 0x7d5048759cbdfc4dULL, 0x9056bdd764d2b2d1ULL,
+  0x88bbcf893f264325ULL, 0x912f821026099956ULL, 0x371cbe840cd4c99cULL, 0x5256d8bab06a14f3ULL,
+  0x7bf6a5c970a2eb67ULL, 0x66dd05d68c7c7c80ULL, 0x49041848e6a3ab59ULL, 0x8f2f2405d1bb6100ULL,
+  0x3628fe6e0d9c343bULL, 0x1a076ce2df80b859ULL, 0x30e421bff23acc14ULL, 0x5b10b27ef6e88c5bULL,
+  0xedf6c669df145438ULL, 0x1084aeb8fe6310fdULL, 0x909036e7cac0f305ULL, 0x100d7b4a10d6ae67ULL,
+  0x586913630e92bef9ULL, 0xec4e6d3375c57ee8ULL, 0xf9d2048c7365925bULL, 0x1f8bdd84dbb44964ULL,
+  0xf1280b6f5c6647e2ULL, 0x9dc271832dfcfd0aULL, 0x0b89b86ec80ec371ULL, 0x32ab801bdbf7696bULL,
+  0x55be4677d163992dULL, 0xcf7c0829005bd392ULL, 0xff9ed4050d9979ecULL, 0x4b0815c8eecb2f58ULL,
+  0x004133230755dfc1ULL, 0xb1b53af3f4f81f2bULL, 0x7621c889acd2c698ULL, 0xeb79b3d52f2e56caULL,
+  0xcc6f75c8f1872739ULL, 0x851fea1dd96d778dULL, 0x721da81914745db9ULL, 0x32905b5ae044de5cULL,
+  0x2fd053771e842801ULL, 0x3b199f6135f4f4d6ULL, 0x65d9e85a4e2cff93ULL, 0x1a652d36e6f0bb5aULL,
+  0xee486ec84d88f931ULL, 0x1d23aa1796db52eeULL, 0xe7c60d398de57d49ULL, 0x34f461206305b22cULL,
+  0x5fc50a7f36ec7951ULL, 0xb03b9fd4cd3e2d13ULL, 0x65f41ae61a6a4b92ULL, 0xd7a7227c03ae6b8bULL,
+  0x3d50a7c3a3fe20e6ULL, 0x39bd8a696c95eec3ULL, 0x1c97c5da6ebb3f8aULL, 0xaba1f364b5afd5c7ULL,
+  0x6b64eaf471e9be7fULL, 0xbe2116ba751393ccULL, 0x52475ed56160f9b2ULL, 0xa9a1365a1f80e2e5ULL,
+  0xaef1826c34c4268fULL, 0xb2c51c9cd6062e1cULL, 0x6857a998d70da151ULL, 0xdffd6f0892de89acULL,
+  0x152ad96a5bc2bf0aULL, 0xbbe002dbf326c3c5ULL, 0x625ba3d8a83e3449ULL, 0xbeebd0a42d195330ULL,
+  0x5865ae85cc7113c4ULL, 0x080060a99837cb27ULL, 0xd77d31971e694fabULL, 0xa11e13714594a64eULL,
+  0x2da91883f313877aULL, 0xbd2552159d53b16cULL, 0x7f5d922c29b5029aULL, 0x5641f34064e3f1f8ULL,
+  0xb605524ff79b276dULL, 0xca1437ba40d5beafULL, 0xf99a8b06f6313f3bULL, 0x792ace25df80c65fULL,
+  0x2e4c04280f806144ULL, 0x2bce961e9f6f00bfULL, 0xa2e6d922bf84069dULL, 0x2049ac802138d205ULL,
+  0x2f3aecc79649199bULL, 0xed718e36bbd4cc53ULL, 0x5ac5ccbd250e5379ULL, 0x9a3b4ce67289a8f5ULL,
+  0x819da58af79a1ad4ULL, 0x320b7db5ad531547ULL, 0x591f28d7d59059d4ULL, 0x50857f1bc5dae02dULL,
+  0x849af34720d68f0dULL, 0xec5bd13a124a7c8eULL, 0x7627664f3be0e76eULL, 0xa7deb56d3f0bf4b9ULL,
+  0xcd39873223e073cfULL, 0x7a08982e34e0a60fULL, 0xb6937863af5a93b2ULL, 0xf7ccfd976e625b0cULL,
+  0xfc2be77308da8c27ULL, 0x000362d59b5d02e4ULL, 0x523131b93deed1e0ULL, 0x58129eb58ceae22dULL,
+  0x0555b58a6d7e4529ULL, 0x85377287e2205b08ULL, 0x352d1d0d1d15892fULL, 0x36b4b432592f981aULL,
+  0x3062a55abf1d2f75ULL, 0x55346b743cac7cebULL, 0x97c0b6157e655809ULL, 0x5f5b0ceb90a1c469ULL,
+  0xf9a5d3c1cae0f022ULL, 0xc9c8df9940d81778ULL, 0x22bbfe128881cf71ULL, 0x893be2a6477efec2ULL,
+  0x85c369f9ca12887dULL, 0xe7ff3d3b6c53db72ULL, 0x4845cef1cbe8372aULL, 0x440c878d95d0e1f3ULL,
+  0x86d3ac5742347a01ULL, 0xeb5217d4aac11301ULL, 0x572ac42f5dfed937ULL, 0xfb4b184c8c9d78f4ULL,
+  0x60d9596b7f819b8aULL, 0x3ee291fdaaff1927ULL, 0x251ac42fff8d8d82ULL, 0xd79283133097e136ULL,
+  0x73a5c73be155f56dULL, 0x1eb783c3b2f38aceULL, 0xf5e025b68c2f22e3ULL, 0x91bf0c83d9ee2ea7ULL
+};
+
+static uint64_t crypto_generichash_chunker_mask (uint32_t bits) {
+  // use the top bits of the fingerprint, as those depend on the most bytes
+  return ~(uint64_t) 0 << (64 - bits);
+}
+
+static void crypto_generichash_chunker_reset (crypto_generichash_chunker_state *state) {
+  state->fp = 0;
+  state->length = 0;
+  crypto_generichash_init(&(state->hash), state->key_length ? state->key : NULL, state->key_length, crypto_generichash_BYTES);
+}
+
+static void crypto_generichash_chunker_emit (crypto_generichash_chunker_state *state, uint32_t *length, unsigned char *digest) {
+  *length = state->length;
+  crypto_generichash_final(&(state->hash), digest, crypto_generichash_BYTES);
+  crypto_generichash_chunker_reset(state);
+}
+
+int crypto_generichash_chunker_init (crypto_generichash_chunker_state *state, uint32_t min, uint32_t avg, uint32_t max, const unsigned char *key, size_t key_length) {
+  if (min < CRYPTO_GENERICHASH_CHUNKER_MIN || avg < CRYPTO_GENERICHASH_CHUNKER_AVG_MIN) return -1;
+  if (min > avg || avg > max || min >= max) return -1;
+  if (key_length > sizeof(state->key)) return -1;
+
+  uint32_t bits = 0;
+  while ((avg >> (bits + 1)) != 0) bits++;
+
+  state->mask_s = crypto_generichash_chunker_mask(bits + 2);
+  state->mask_l = crypto_generichash_chunker_mask(bits - 2);
+  state->min = min;
+  state->avg = avg;
+  state->max = max;
+  state->key_length = key_length;
+  if (key_length) memcpy(state->key, key, key_length);
+
+  crypto_generichash_chunker_reset(state);
+  return 0;
+}
+
+size_t crypto_generichash_chunker_update (crypto_generichash_chunker_state *state, uint32_t *lengths, unsigned char *digests, const unsigned char *input, unsigned long long input_length) {
+  size_t count = 0;
+  unsigned long long offset = 0;
+
+  while (offset < input_length) {
+    unsigned long long start = offset;
+    uint32_t length = state->length;
+    uint64_t fp = state->fp;
+    int cut = 0;
+
+    // bytes below the minimum size can never be a cut point, so skip them
+    if (length < state->min) {
+      unsigned long long skip = state->min - length;
+      if (skip > input_length - offset) skip = input_length - offset;
+      length += (uint32_t) skip;
+      offset += skip;
+    }
+
+    // normalized chunking: a harder mask before avg, an easier one after
+    while (offset < input_length && length >= state->min && length < state->avg) {
+      fp = (fp << 1) + gear[input[offset++]];
+      length++;
+      if (!(fp & state->mask_s)) {
+        cut = 1;
+        break;
+      }
+    }
+
+    while (!cut && offset < input_length && length >= state->avg && length < state->max) {
+      fp = (fp << 1) + gear[input[offset++]];
+      length++;
+      if (!(fp & state->mask_l)) cut = 1;
+    }
+
+    if (length == state->max) cut = 1;
+
+    crypto_generichash_update(&(state->hash), input + start, offset - start);
+    state->length = length;
+    state->fp = fp;
+
+    if (cut) {
+      crypto_generichash_chunker_emit(state, lengths + count, digests + count * crypto_generichash_BYTES);
+      count++;
+    }
+  }
+
+  return count;
+}
+
+size_t crypto_generichash_chunker_final (crypto_generichash_chunker_state *state, uint32_t *lengths, unsigned char *digests) {
+  if (state->length == 0) return 0;
+
+  crypto_generichash_chunker_emit(state, lengths, digests);
+  return 1;
+}
+
+void crypto_generichash_chunker_destroy (crypto_generichash_chunker_state *state) {
+  sodium_memzero(state, sizeof(*state));
+}
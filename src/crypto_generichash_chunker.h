@@ -0,0 +1,36 @@
+#ifndef CRYPTO_GENERICHASH_CHUNKER_H
+#define CRYPTO_GENERICHASH_CHUNKER_H
+
+#include <stdint.h>
+#include "../libsodium/src/libsodium/include/sodium.h"
+
+// Content-defined chunking (FastCDC style gear hash with normalized chunking)
+// with a keyed BLAKE2b digest of crypto_generichash_BYTES per chunk.
+// Every chunk cut by update is longer than min and at most max bytes, so a
+// call emits at most (input_length / min) + 1 chunks.
+
+#define CRYPTO_GENERICHASH_CHUNKER_MIN 64U
+#define CRYPTO_GENERICHASH_CHUNKER_AVG_MIN 256U
+
+typedef struct crypto_generichash_chunker_state {
+  crypto_generichash_state hash;
+  unsigned char key[crypto_generichash_KEYBYTES_MAX];
+  size_t key_length;
+  uint64_t fp;
+  uint64_t mask_s;
+  uint64_t mask_l;
+  uint32_t min;
+  uint32_t avg;
+  uint32_t max;
+  uint32_t length;
+} crypto_generichash_chunker_state;
+
+int crypto_generichash_chunker_init (crypto_generichash_chunker_state *state, uint32_t min, uint32_t avg, uint32_t max, const unsigned char *key, size_t key_length);
+
+size_t crypto_generichash_chunker_update (crypto_generichash_chunker_state *state, uint32_t *lengths, unsigned char *digests, const unsigned char *input, unsigned long long input_length);
+
+size_t crypto_generichash_chunker_final (crypto_generichash_chunker_state *state, uint32_t *lengths, unsigned char *digests);
+
+void crypto_generichash_chunker_destroy (crypto_generichash_chunker_state *state);
+
+#endif
@@ -0,0 +1,69 @@
+#include "crypto_generichash_chunker_wrap.h"
+#include "macros.h"
+#include "per_isolate.h"
+
+static thread_local Nan::Persistent<v8::FunctionTemplate> crypto_generichash_chunker_constructor;
+
+CryptoGenericHashChunkerWrap::CryptoGenericHashChunkerWrap () {}
+
+CryptoGenericHashChunkerWrap::~CryptoGenericHashChunkerWrap () {
+  crypto_generichash_chunker_destroy(&(this->state));
+}
+
+NAN_METHOD(CryptoGenericHashChunkerWrap::New) {
+  CryptoGenericHashChunkerWrap* obj = new CryptoGenericHashChunkerWrap();
+  obj->Wrap(info.This());
+  info.GetReturnValue().Set(info.This());
+}
+
+NAN_METHOD(CryptoGenericHashChunkerWrap::Update) {
+  CryptoGenericHashChunkerWrap *self = Nan::ObjectWrap::Unwrap<CryptoGenericHashChunkerWrap>(info.This());
+  ASSERT_BUFFER_SET_LENGTH(info[2], input)
+
+  unsigned long long count = input_length / self->state.min + 1;
+
+  ASSERT_UINT32ARRAY(info[0], lengths)
+  ASSERT_BUFFER_MIN_LENGTH(info[0], lengths, `input.length / min + 1` entries, count * 4)
+  ASSERT_BUFFER_MIN_LENGTH(info[1], digests,
+    `(input.length / min + 1) * crypto_generichash_BYTES`,
+    count * crypto_generichash_BYTES)
+
+  size_t chunks = crypto_generichash_chunker_update(&(self->state), (uint32_t *) CDATA(lengths), CDATA(digests), CDATA(input), input_length);
+  info.GetReturnValue().Set(Nan::New((uint32_t) chunks));
+}
+
+NAN_METHOD(CryptoGenericHashChunkerWrap::Final) {
+  CryptoGenericHashChunkerWrap *self = Nan::ObjectWrap::Unwrap<CryptoGenericHashChunkerWrap>(info.This());
+  ASSERT_UINT32ARRAY(info[0], lengths)
+  ASSERT_BUFFER_MIN_LENGTH(info[0], lengths, 1 entry, 4)
+  ASSERT_BUFFER_MIN_LENGTH(info[1], digests, crypto_generichash_BYTES, crypto_generichash_BYTES)
+
+  size_t chunks = crypto_generichash_chunker_final(&(self->state), (uint32_t *) CDATA(lengths), CDATA(digests));
+  info.GetReturnValue().Set(Nan::New((uint32_t) chunks));
+}
+
+void CryptoGenericHashChunkerWrap::Init () {
+  v8::Local<v8::FunctionTemplate> tpl = Nan::New<v8::FunctionTemplate>(CryptoGenericHashChunkerWrap::New);
+  per_isolate_constructor_set(&crypto_generichash_chunker_constructor, tpl);
+  tpl->SetClassName(Nan::New("CryptoGenericHashChunkerWrap").ToLocalChecked());
+  tpl->InstanceTemplate()->SetInternalFieldCount(1);
+
+  STATS_PROTOTYPE_METHOD(tpl, "crypto_generichash_chunker_instance", "update", CryptoGenericHashChunkerWrap::Update)
+  STATS_PROTOTYPE_METHOD(tpl, "crypto_generichash_chunker_instance", "final", CryptoGenericHashChunkerWrap::Final)
+}
+
+v8::Local<v8::Value> CryptoGenericHashChunkerWrap::NewInstance (crypto_generichash_chunker_state *state) {
+  Nan::EscapableHandleScope scope;
+
+  if (crypto_generichash_chunker_constructor.IsEmpty()) CryptoGenericHashChunkerWrap::Init();
+
+  v8::Local<v8::Object> instance;
+
+  v8::Local<v8::FunctionTemplate> constructorHandle = Nan::New<v8::FunctionTemplate>(crypto_generichash_chunker_constructor);
+  instance = Nan::NewInstance(Nan::GetFunction(constructorHandle).ToLocalChecked()).ToLocalChecked();
+
+  CryptoGenericHashChunkerWrap *self = Nan::ObjectWrap::Unwrap<CryptoGenericHashChunkerWrap>(instance);
+  memcpy(&(self->state), state, sizeof(self->state));
+
+  return scope.Escape(instance);
+}
@@ -0,0 +1,23 @@
+#ifndef CRYPTO_GENERICHASH_CHUNKER_WRAP_H
+#define CRYPTO_GENERICHASH_CHUNKER_WRAP_H
+
+#include <nan.h>
+#include "../libsodium/src/libsodium/include/sodium.h"
+#include "crypto_generichash_chunker.h"
+
+class CryptoGenericHashChunkerWrap : public Nan::ObjectWrap {
+public:
+  crypto_generichash_chunker_state state;
+
+  static void Init ();
+  static v8::Local<v8::Value> NewInstance (crypto_generichash_chunker_state *state);
+  CryptoGenericHashChunkerWrap ();
+  ~CryptoGenericHashChunkerWrap ();
+
+private:
+  static NAN_METHOD(New);
+  static NAN_METHOD(Update);
+  static NAN_METHOD(Final);
+};
+
+#endif
@@ -0,0 +1,40 @@
+#include <nan.h>
+#include "macros.h"
+#include "crypto_generichash_chunker.h"
+
+#include "../libsodium/src/libsodium/include/sodium.h"
+
+class CryptoGenerichashChunksAsync : public Nan::AsyncWorker {
+ public:
+  CryptoGenerichashChunksAsync(Nan::Callback *callback, crypto_generichash_chunker_state *state, uint32_t *lengths, unsigned char *digests, const unsigned char * const input, unsigned long long input_length)
+    : Nan::AsyncWorker(callback, "sodium-native:crypto_generichash_chunks_async"), lengths(lengths), digests(digests), input(input), input_length(input_length), count(0) {
+    memcpy(&(this->state), state, sizeof(this->state));
+  }
+  ~CryptoGenerichashChunksAsync() {
+    crypto_generichash_chunker_destroy(&state);
+  }
+
+  void Execute () {
+    count = crypto_generichash_chunker_update(&state, lengths, digests, input, input_length);
+    count += crypto_generichash_chunker_final(&state, lengths + count, digests + count * crypto_generichash_BYTES);
+  }
+
+  void HandleOKCallback () {
+    Nan::HandleScope scope;
+
+    v8::Local<v8::Value> argv[] = {
+        Nan::Null(),
+        Nan::New((uint32_t) count)
+    };
+
+    callback->Call(2, argv, async_resource);
+  }
+
+ private:
+  crypto_generichash_chunker_state state;
+  uint32_t *lengths;
+  unsigned char *digests;
+  const unsigned char * const input;
+  unsigned long long input_length;
+  size_t count;
+};
@@ -1,7 +1,8 @@
 #include "crypto_generichash_wrap.h"
 #include "macros.h"
+#include "per_isolate.h"
 
-static Nan::Persistent<v8::FunctionTemplate> crypto_generichash_constructor;
+static thread_local Nan::Persistent<v8::FunctionTemplate> crypto_generichash_constructor;
 
 CryptoGenericHashWrap::CryptoGenericHashWrap () {}
 
@@ -27,17 +28,19 @@ NAN_METHOD(CryptoGenericHashWrap::Final) {
 
 void CryptoGenericHashWrap::Init () {
   v8::Local<v8::FunctionTemplate> tpl = Nan::New<v8::FunctionTemplate>(CryptoGenericHashWrap::New);
-  crypto_generichash_constructor.Reset(tpl);
+  per_isolate_constructor_set(&crypto_generichash_constructor, tpl);
   tpl->SetClassName(Nan::New("CryptoGenericHashWrap").ToLocalChecked());
   tpl->InstanceTemplate()->SetInternalFieldCount(1);
 
-  Nan::SetPrototypeMethod(tpl, "update", CryptoGenericHashWrap::Update);
-  Nan::SetPrototypeMethod(tpl, "final", CryptoGenericHashWrap::Final);
+  STATS_PROTOTYPE_METHOD(tpl, "crypto_generichash_instance", "update", CryptoGenericHashWrap::Update)
+  STATS_PROTOTYPE_METHOD(tpl, "crypto_generichash_instance", "final", CryptoGenericHashWrap::Final)
 }
 
 v8::Local<v8::Value> CryptoGenericHashWrap::NewInstance (unsigned char *key, unsigned long long key_length, unsigned long long output_length) {
   Nan::EscapableHandleScope scope;
 
+  if (crypto_generichash_constructor.IsEmpty()) CryptoGenericHashWrap::Init();
+
   v8::Local<v8::Object> instance;
 
   v8::Local<v8::FunctionTemplate> constructorHandle = Nan::New<v8::FunctionTemplate>(crypto_generichash_constructor);
@@ -1,7 +1,8 @@
 #include "crypto_hash_sha256_wrap.h"
 #include "macros.h"
+#include "per_isolate.h"
 
-static Nan::Persistent<v8::FunctionTemplate> crypto_hash_sha256_constructor;
+static thread_local Nan::Persistent<v8::FunctionTemplate> crypto_hash_sha256_constructor;
 
 CryptoHashSha256Wrap::CryptoHashSha256Wrap () {}
 
@@ -27,17 +28,19 @@ NAN_METHOD(CryptoHashSha256Wrap::Final) {
 
 void CryptoHashSha256Wrap::Init () {
   v8::Local<v8::FunctionTemplate> tpl = Nan::New<v8::FunctionTemplate>(CryptoHashSha256Wrap::New);
-  crypto_hash_sha256_constructor.Reset(tpl);
+  per_isolate_constructor_set(&crypto_hash_sha256_constructor, tpl);
   tpl->SetClassName(Nan::New("CryptoHashSha256Wrap").ToLocalChecked());
   tpl->InstanceTemplate()->SetInternalFieldCount(1);
 
-  Nan::SetPrototypeMethod(tpl, "update", CryptoHashSha256Wrap::Update);
-  Nan::SetPrototypeMethod(tpl, "final", CryptoHashSha256Wrap::Final);
+  STATS_PROTOTYPE_METHOD(tpl, "crypto_hash_sha256_instance", "update", CryptoHashSha256Wrap::Update)
+  STATS_PROTOTYPE_METHOD(tpl, "crypto_hash_sha256_instance", "final", CryptoHashSha256Wrap::Final)
 }
 
 v8::Local<v8::Value> CryptoHashSha256Wrap::NewInstance () {
   Nan::EscapableHandleScope scope;
 
+  if (crypto_hash_sha256_constructor.IsEmpty()) CryptoHashSha256Wrap::Init();
+
   v8::Local<v8::Object> instance;
 
   v8::Local<v8::FunctionTemplate> constructorHandle = Nan::New<v8::FunctionTemplate>(crypto_hash_sha256_constructor);
@@ -1,7 +1,8 @@
 #include "crypto_hash_sha512_wrap.h"
 #include "macros.h"
+#include "per_isolate.h"
 
-static Nan::Persistent<v8::FunctionTemplate> crypto_hash_sha512_constructor;
+static thread_local Nan::Persistent<v8::FunctionTemplate> crypto_hash_sha512_constructor;
 
 CryptoHashSha512Wrap::CryptoHashSha512Wrap () {}
 
@@ -27,17 +28,19 @@ NAN_METHOD(CryptoHashSha512Wrap::Final) {
 
 void CryptoHashSha512Wrap::Init () {
   v8::Local<v8::FunctionTemplate> tpl = Nan::New<v8::FunctionTemplate>(CryptoHashSha512Wrap::New);
-  crypto_hash_sha512_constructor.Reset(tpl);
+  per_isolate_constructor_set(&crypto_hash_sha512_constructor, tpl);
   tpl->SetClassName(Nan::New("CryptoHashSha512Wrap").ToLocalChecked());
   tpl->InstanceTemplate()->SetInternalFieldCount(1);
 
-  Nan::SetPrototypeMethod(tpl, "update", CryptoHashSha512Wrap::Update);
-  Nan::SetPrototypeMethod(tpl, "final", CryptoHashSha512Wrap::Final);
+  STATS_PROTOTYPE_METHOD(tpl, "crypto_hash_sha512_instance", "update", CryptoHashSha512Wrap::Update)
+  STATS_PROTOTYPE_METHOD(tpl, "crypto_hash_sha512_instance", "final", CryptoHashSha512Wrap::Final)
 }
 
 v8::Local<v8::Value> CryptoHashSha512Wrap::NewInstance () {
   Nan::EscapableHandleScope scope;
 
+  if (crypto_hash_sha512_constructor.IsEmpty()) CryptoHashSha512Wrap::Init();
+
   v8::Local<v8::Object> instance;
 
   v8::Local<v8::FunctionTemplate> constructorHandle = Nan::New<v8::FunctionTemplate>(crypto_hash_sha512_constructor);
@@ -1,7 +1,8 @@
 #include "crypto_onetimeauth_wrap.h"
 #include "macros.h"
+#include "per_isolate.h"
 
-static Nan::Persistent<v8::FunctionTemplate> crypto_onetimeauth_constructor;
+static thread_local Nan::Persistent<v8::FunctionTemplate> crypto_onetimeauth_constructor;
 
 CryptoOnetimeAuthWrap::CryptoOnetimeAuthWrap () {}
 
@@ -27,17 +28,19 @@ NAN_METHOD(CryptoOnetimeAuthWrap::Final) {
 
 void CryptoOnetimeAuthWrap::Init () {
   v8::Local<v8::FunctionTemplate> tpl = Nan::New<v8::FunctionTemplate>(CryptoOnetimeAuthWrap::New);
-  crypto_onetimeauth_constructor.Reset(tpl);
+  per_isolate_constructor_set(&crypto_onetimeauth_constructor, tpl);
   tpl->SetClassName(Nan::New("CryptoOnetimeAuthWrap").ToLocalChecked());
   tpl->InstanceTemplate()->SetInternalFieldCount(1);
 
-  Nan::SetPrototypeMethod(tpl, "update", CryptoOnetimeAuthWrap::Update);
-  Nan::SetPrototypeMethod(tpl, "final", CryptoOnetimeAuthWrap::Final);
+  STATS_PROTOTYPE_METHOD(tpl, "crypto_onetimeauth_instance", "update", CryptoOnetimeAuthWrap::Update)
+  STATS_PROTOTYPE_METHOD(tpl, "crypto_onetimeauth_instance", "final", CryptoOnetimeAuthWrap::Final)
 }
 
 v8::Local<v8::Value> CryptoOnetimeAuthWrap::NewInstance (unsigned char *key) {
   Nan::EscapableHandleScope scope;
 
+  if (crypto_onetimeauth_constructor.IsEmpty()) CryptoOnetimeAuthWrap::Init();
+
   v8::Local<v8::Object> instance;
 
   v8::Local<v8::FunctionTemplate> constructorHandle = Nan::New<v8::FunctionTemplate>(crypto_onetimeauth_constructor);
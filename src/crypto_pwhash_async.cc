@@ -1,15 +1,19 @@
 #include <nan.h>
 #include "macros.h"
+#include "timed_async_worker.h"
+#include "pwhash_arena.h"
 
 #include "../libsodium/src/libsodium/include/sodium.h"
 
-class CryptoPwhashAsync : public Nan::AsyncWorker {
+class CryptoPwhashAsync : public TimedAsyncWorker {
  public:
   CryptoPwhashAsync(Nan::Callback *callback, unsigned char * const out, unsigned long long outlen, const char * const passwd, unsigned long long passwdlen, const unsigned char * const salt, unsigned long long opslimit, size_t memlimit, int alg)
-    : Nan::AsyncWorker(callback, "sodium-native:crypto_pwhash_async"), out(out), outlen(outlen), passwd(passwd), passwdlen(passwdlen), salt(salt), opslimit(opslimit), memlimit(memlimit), alg(alg) {}
+    : TimedAsyncWorker(callback, "sodium-native:crypto_pwhash_async"), out(out), outlen(outlen), passwd(passwd), passwdlen(passwdlen), salt(salt), opslimit(opslimit), memlimit(memlimit), alg(alg) {}
   ~CryptoPwhashAsync() {}
 
-  void Execute () {
+  void Run () {
+    pwhash_arena_scope arena;
+
     CALL_SODIUM_ASYNC_WORKER(errorno, crypto_pwhash(out, outlen, passwd, passwdlen, salt, opslimit, memlimit, alg))
   }
 
@@ -1,15 +1,19 @@
 #include <nan.h>
 #include "macros.h"
+#include "timed_async_worker.h"
+#include "pwhash_arena.h"
 
 #include "../libsodium/src/libsodium/include/sodium.h"
 
-class CryptoPwhashScryptsalsa208sha256Async : public Nan::AsyncWorker {
+class CryptoPwhashScryptsalsa208sha256Async : public TimedAsyncWorker {
  public:
   CryptoPwhashScryptsalsa208sha256Async(Nan::Callback *callback, unsigned char * const out, unsigned long long outlen, const char * const passwd, unsigned long long passwdlen, const unsigned char * const salt, unsigned long long opslimit, size_t memlimit)
-    : Nan::AsyncWorker(callback, "sodium-native:crypto_pwhash_scryptsalsa208sha256_async"), out(out), outlen(outlen), passwd(passwd), passwdlen(passwdlen), salt(salt), opslimit(opslimit), memlimit(memlimit) {}
+    : TimedAsyncWorker(callback, "sodium-native:crypto_pwhash_scryptsalsa208sha256_async"), out(out), outlen(outlen), passwd(passwd), passwdlen(passwdlen), salt(salt), opslimit(opslimit), memlimit(memlimit) {}
   ~CryptoPwhashScryptsalsa208sha256Async() {}
 
-  void Execute () {
+  void Run () {
+    pwhash_arena_scope arena;
+
     CALL_SODIUM_ASYNC_WORKER(errorno, crypto_pwhash_scryptsalsa208sha256(out, outlen, passwd, passwdlen, salt, opslimit, memlimit))
   }
 
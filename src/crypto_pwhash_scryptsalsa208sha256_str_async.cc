@@ -1,15 +1,19 @@
 #include <nan.h>
 #include "macros.h"
+#include "timed_async_worker.h"
+#include "pwhash_arena.h"
 
 #include "../libsodium/src/libsodium/include/sodium.h"
 
-class CryptoPwhashScryptsalsa208sha256StrAsync : public Nan::AsyncWorker {
+class CryptoPwhashScryptsalsa208sha256StrAsync : public TimedAsyncWorker {
  public:
   CryptoPwhashScryptsalsa208sha256StrAsync(Nan::Callback *callback, char * out, const char * const passwd, unsigned long long passwdlen, unsigned long long opslimit, size_t memlimit)
-    : Nan::AsyncWorker(callback, "sodium-native:crypto_pwhash_scryptsalsa208sha256_str_async"), out(out), passwd(passwd), passwdlen(passwdlen), opslimit(opslimit), memlimit(memlimit) {}
+    : TimedAsyncWorker(callback, "sodium-native:crypto_pwhash_scryptsalsa208sha256_str_async"), out(out), passwd(passwd), passwdlen(passwdlen), opslimit(opslimit), memlimit(memlimit) {}
   ~CryptoPwhashScryptsalsa208sha256StrAsync() {}
 
-  void Execute () {
+  void Run () {
+    pwhash_arena_scope arena;
+
     CALL_SODIUM_ASYNC_WORKER(errorno, crypto_pwhash_scryptsalsa208sha256_str(out, passwd, passwdlen, opslimit, memlimit))
   }
 
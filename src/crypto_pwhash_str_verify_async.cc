@@ -1,15 +1,19 @@
 #include <nan.h>
 #include "macros.h"
+#include "timed_async_worker.h"
+#include "pwhash_arena.h"
 
 #include "../libsodium/src/libsodium/include/sodium.h"
 
-class CryptoPwhashStrVerifyAsync : public Nan::AsyncWorker {
+class CryptoPwhashStrVerifyAsync : public TimedAsyncWorker {
  public:
   CryptoPwhashStrVerifyAsync(Nan::Callback *callback, const char * str, const char * const passwd, unsigned long long passwdlen)
-    : Nan::AsyncWorker(callback, "sodium-native:crypto_pwhash_str_verify_async"), str(str), passwd(passwd), passwdlen(passwdlen) {}
+    : TimedAsyncWorker(callback, "sodium-native:crypto_pwhash_str_verify_async"), str(str), passwd(passwd), passwdlen(passwdlen) {}
   ~CryptoPwhashStrVerifyAsync() {}
 
-  void Execute () {
+  void Run () {
+    pwhash_arena_scope arena;
+
     if (crypto_pwhash_str_verify(str, passwd, passwdlen) < 0) {
       SetErrorMessage("crypto_pwhash_str_verify_async failed. Either the password is wrong or the operating system most likely refused to allocate the required memory");
       return;
@@ -0,0 +1,162 @@
+#include "crypto_scalarmult_ed25519_fixed_base.h"
+#include <errno.h>
+#include <stdint.h>
+#include <string.h>
+
+#define FIXED_BASE_GROUP 64
+
+int crypto_scalarmult_ed25519_fixed_base_init (crypto_scalarmult_ed25519_fixed_base_table *table, const unsigned char *p) {
+  ed25519_ge_p3 base, multiples[8];
+  ed25519_ge_cached cached;
+  ed25519_ge_p1p1 t;
+  ed25519_ge_p2 p2;
+  ed25519_fe scratch[16];
+
+  if (ed25519_ge_frombytes(&base, p) != 0) {
+    errno = EINVAL;
+    return -1;
+  }
+
+  for (int i = 0; i < 32; i++) {
+    ed25519_ge_p3_to_cached(&cached, &base);
+    memcpy(&multiples[0], &base, sizeof(base));
+    for (int j = 1; j < 8; j++) {
+      ed25519_ge_add(&t, &multiples[j - 1], &cached);
+      ed25519_ge_p1p1_to_p3(&multiples[j], &t);
+    }
+    ed25519_ge_p3_batch_to_precomp(table->rows[i], multiples, scratch, 8);
+
+    // base = 256 * base
+    ed25519_ge_p3_to_p2(&p2, &base);
+    for (int k = 1; k < 8; k++) {
+      ed25519_ge_p2_dbl(&t, &p2);
+      ed25519_ge_p1p1_to_p2(&p2, &t);
+    }
+    ed25519_ge_p2_dbl(&t, &p2);
+    ed25519_ge_p1p1_to_p3(&base, &t);
+  }
+
+  return 0;
+}
+
+static unsigned char equal (signed char b, signed char c) {
+  uint32_t y = (unsigned char) (b ^ c);
+  y -= 1;
+  return (unsigned char) (y >> 31);
+}
+
+static unsigned char negative (signed char b) {
+  uint64_t x = (uint64_t) (int64_t) b;
+  return (unsigned char) (x >> 63);
+}
+
+static void precomp_cmov (ed25519_ge_precomp *t, const ed25519_ge_precomp *u, unsigned char b) {
+  ed25519_fe_cmov(t->yplusx, u->yplusx, b);
+  ed25519_fe_cmov(t->yminusx, u->yminusx, b);
+  ed25519_fe_cmov(t->xy2d, u->xy2d, b);
+}
+
+// t = b * 256^pos * P for b in [-8, 8], reading every entry of the row
+static void table_select (ed25519_ge_precomp *t, const ed25519_ge_precomp row[8], signed char b) {
+  ed25519_ge_precomp minust;
+  unsigned char bnegative = negative(b);
+  unsigned char babs = (unsigned char) (b - (((-bnegative) & b) * 2));
+
+  ed25519_fe_1(t->yplusx);
+  ed25519_fe_1(t->yminusx);
+  ed25519_fe_0(t->xy2d);
+
+  for (int i = 0; i < 8; i++) precomp_cmov(t, &row[i], equal((signed char) babs, (signed char) (i + 1)));
+
+  ed25519_fe_copy(minust.yplusx, t->yminusx);
+  ed25519_fe_copy(minust.yminusx, t->yplusx);
+  ed25519_fe_neg(minust.xy2d, t->xy2d);
+  precomp_cmov(t, &minust, bnegative);
+}
+
+static void fixed_base_p3 (ed25519_ge_p3 *h, const unsigned char *n, const crypto_scalarmult_ed25519_fixed_base_table *table) {
+  signed char e[64];
+  signed char carry = 0;
+  ed25519_ge_precomp t;
+  ed25519_ge_p1p1 r;
+  ed25519_ge_p2 s;
+
+  for (int i = 0; i < 32; i++) {
+    unsigned char a = i == 31 ? (n[i] & 127) : n[i];
+    e[2 * i] = a & 15;
+    e[2 * i + 1] = (a >> 4) & 15;
+  }
+
+  // every digit in [-8, 8), the top one at most 8
+  for (int i = 0; i < 63; i++) {
+    e[i] += carry;
+    carry = (signed char) ((e[i] + 8) >> 4);
+    e[i] -= (signed char) (carry * ((signed char) 1 << 4));
+  }
+  e[63] += carry;
+
+  ed25519_ge_p3_0(h);
+
+  for (int i = 1; i < 64; i += 2) {
+    table_select(&t, table->rows[i / 2], e[i]);
+    ed25519_ge_madd(&r, h, &t);
+    ed25519_ge_p1p1_to_p3(h, &r);
+  }
+
+  ed25519_ge_p3_dbl(&r, h);
+  ed25519_ge_p1p1_to_p2(&s, &r);
+  ed25519_ge_p2_dbl(&r, &s);
+  ed25519_ge_p1p1_to_p2(&s, &r);
+  ed25519_ge_p2_dbl(&r, &s);
+  ed25519_ge_p1p1_to_p2(&s, &r);
+  ed25519_ge_p2_dbl(&r, &s);
+  ed25519_ge_p1p1_to_p3(h, &r);
+
+  for (int i = 0; i < 64; i += 2) {
+    table_select(&t, table->rows[i / 2], e[i]);
+    ed25519_ge_madd(&r, h, &t);
+    ed25519_ge_p1p1_to_p3(h, &r);
+  }
+
+  sodium_memzero(e, sizeof(e));
+}
+
+// the identity encodes as y = 1, x = 0
+static int is_identity (const unsigned char *q) {
+  unsigned char d = q[0] ^ 1;
+  for (int i = 1; i < 32; i++) d |= q[i];
+  return d == 0;
+}
+
+int crypto_scalarmult_ed25519_fixed_base (unsigned char *q, const unsigned char *n, const crypto_scalarmult_ed25519_fixed_base_table *table) {
+  ed25519_ge_p3 h;
+
+  fixed_base_p3(&h, n, table);
+  ed25519_ge_p3_tobytes(q, &h);
+
+  if (is_identity(q)) {
+    errno = EINVAL;
+    return -1;
+  }
+  return 0;
+}
+
+int crypto_scalarmult_ed25519_fixed_base_many (unsigned char *q, const unsigned char *n, size_t count, const crypto_scalarmult_ed25519_fixed_base_table *table) {
+  ed25519_ge_p3 h[FIXED_BASE_GROUP];
+  ed25519_fe scratch[2 * FIXED_BASE_GROUP];
+  int ret = 0;
+
+  for (size_t i = 0; i < count; i += FIXED_BASE_GROUP) {
+    size_t group = count - i < FIXED_BASE_GROUP ? count - i : FIXED_BASE_GROUP;
+
+    for (size_t j = 0; j < group; j++) fixed_base_p3(&h[j], n + 32 * (i + j), table);
+    ed25519_ge_p3_batch_tobytes(q + 32 * i, h, scratch, group);
+
+    for (size_t j = 0; j < group; j++) {
+      if (is_identity(q + 32 * (i + j))) ret = -1;
+    }
+  }
+
+  if (ret != 0) errno = EINVAL;
+  return ret;
+}
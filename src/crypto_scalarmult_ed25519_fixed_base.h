@@ -0,0 +1,31 @@
+#ifndef CRYPTO_SCALARMULT_ED25519_FIXED_BASE_H
+#define CRYPTO_SCALARMULT_ED25519_FIXED_BASE_H
+
+#include <stddef.h>
+#include "../libsodium/src/libsodium/include/sodium.h"
+#include "ed25519.h"
+
+// Scalar multiplication by a fixed, application chosen point, e.g. the second
+// generator of Pedersen commitments, with the same table layout as
+// libsodium's crypto_scalarmult_ed25519_base: 64 signed radix 16 digits, the
+// odd ones added first, four doublings, then the even ones. Entries are
+// picked with constant time selects, so the scalars may be secret.
+
+typedef struct crypto_scalarmult_ed25519_fixed_base_table {
+  // rows[i][j] = (j + 1) * 256^i * P
+  ed25519_ge_precomp rows[32][8];
+} crypto_scalarmult_ed25519_fixed_base_table;
+
+// -1 with errno set to EINVAL if p does not decode. Callers check that it is
+// a valid point first.
+int crypto_scalarmult_ed25519_fixed_base_init (crypto_scalarmult_ed25519_fixed_base_table *table, const unsigned char *p);
+
+// q = n * P, ignoring the top bit of n like crypto_scalarmult_ed25519_noclamp,
+// -1 if the result is the identity
+int crypto_scalarmult_ed25519_fixed_base (unsigned char *q, const unsigned char *n, const crypto_scalarmult_ed25519_fixed_base_table *table);
+
+// count products at once, sharing the field inversion of the encoding. -1 if
+// any result is the identity, every result is still written then.
+int crypto_scalarmult_ed25519_fixed_base_many (unsigned char *q, const unsigned char *n, size_t count, const crypto_scalarmult_ed25519_fixed_base_table *table);
+
+#endif
@@ -0,0 +1,70 @@
+#include "crypto_scalarmult_ed25519_fixed_base_wrap.h"
+#include "macros.h"
+#include "per_isolate.h"
+
+static thread_local Nan::Persistent<v8::FunctionTemplate> crypto_scalarmult_ed25519_fixed_base_constructor;
+
+// the table is about 30 KB held inline, which V8 should know about when
+// deciding to collect instances
+CryptoScalarmultEd25519FixedBaseWrap::CryptoScalarmultEd25519FixedBaseWrap () {
+  Nan::AdjustExternalMemory(sizeof(table));
+}
+
+CryptoScalarmultEd25519FixedBaseWrap::~CryptoScalarmultEd25519FixedBaseWrap () {
+  Nan::AdjustExternalMemory(-(int) sizeof(table));
+}
+
+NAN_METHOD(CryptoScalarmultEd25519FixedBaseWrap::New) {
+  CryptoScalarmultEd25519FixedBaseWrap* obj = new CryptoScalarmultEd25519FixedBaseWrap();
+  obj->Wrap(info.This());
+  info.GetReturnValue().Set(info.This());
+}
+
+NAN_METHOD(CryptoScalarmultEd25519FixedBaseWrap::Mul) {
+  CryptoScalarmultEd25519FixedBaseWrap *self = Nan::ObjectWrap::Unwrap<CryptoScalarmultEd25519FixedBaseWrap>(info.This());
+  ASSERT_BUFFER_MIN_LENGTH(info[0], q, crypto_scalarmult_ed25519_BYTES, crypto_scalarmult_ed25519_bytes())
+  ASSERT_BUFFER_MIN_LENGTH(info[1], n, crypto_scalarmult_ed25519_SCALARBYTES, crypto_scalarmult_ed25519_scalarbytes())
+
+  CALL_SODIUM(crypto_scalarmult_ed25519_fixed_base(CDATA(q), CDATA(n), &(self->table)))
+}
+
+NAN_METHOD(CryptoScalarmultEd25519FixedBaseWrap::MulMany) {
+  CryptoScalarmultEd25519FixedBaseWrap *self = Nan::ObjectWrap::Unwrap<CryptoScalarmultEd25519FixedBaseWrap>(info.This());
+  ASSERT_BUFFER_SET_LENGTH(info[1], scalars)
+
+  if (scalars_length % crypto_scalarmult_ed25519_SCALARBYTES != 0) {
+    Nan::ThrowError("scalars must be a buffer of a multiple of crypto_scalarmult_ed25519_SCALARBYTES bytes");
+    return;
+  }
+
+  size_t count = scalars_length / crypto_scalarmult_ed25519_SCALARBYTES;
+  ASSERT_BUFFER_MIN_LENGTH(info[0], q, `scalars.length`, count * crypto_scalarmult_ed25519_BYTES)
+
+  CALL_SODIUM(crypto_scalarmult_ed25519_fixed_base_many(CDATA(q), CDATA(scalars), count, &(self->table)))
+}
+
+void CryptoScalarmultEd25519FixedBaseWrap::Init () {
+  v8::Local<v8::FunctionTemplate> tpl = Nan::New<v8::FunctionTemplate>(CryptoScalarmultEd25519FixedBaseWrap::New);
+  per_isolate_constructor_set(&crypto_scalarmult_ed25519_fixed_base_constructor, tpl);
+  tpl->SetClassName(Nan::New("CryptoScalarmultEd25519FixedBaseWrap").ToLocalChecked());
+  tpl->InstanceTemplate()->SetInternalFieldCount(1);
+
+  STATS_PROTOTYPE_METHOD(tpl, "crypto_scalarmult_ed25519_fixed_base_instance", "mul", CryptoScalarmultEd25519FixedBaseWrap::Mul)
+  STATS_PROTOTYPE_METHOD(tpl, "crypto_scalarmult_ed25519_fixed_base_instance", "mulMany", CryptoScalarmultEd25519FixedBaseWrap::MulMany)
+}
+
+v8::Local<v8::Value> CryptoScalarmultEd25519FixedBaseWrap::NewInstance (unsigned char *point) {
+  Nan::EscapableHandleScope scope;
+
+  if (crypto_scalarmult_ed25519_fixed_base_constructor.IsEmpty()) CryptoScalarmultEd25519FixedBaseWrap::Init();
+
+  v8::Local<v8::Object> instance;
+
+  v8::Local<v8::FunctionTemplate> constructorHandle = Nan::New<v8::FunctionTemplate>(crypto_scalarmult_ed25519_fixed_base_constructor);
+  instance = Nan::NewInstance(Nan::GetFunction(constructorHandle).ToLocalChecked()).ToLocalChecked();
+
+  CryptoScalarmultEd25519FixedBaseWrap *self = Nan::ObjectWrap::Unwrap<CryptoScalarmultEd25519FixedBaseWrap>(instance);
+  if (crypto_scalarmult_ed25519_fixed_base_init(&(self->table), point) != 0) return v8::Local<v8::Value>();
+
+  return scope.Escape(instance);
+}
@@ -0,0 +1,23 @@
+#ifndef CRYPTO_SCALARMULT_ED25519_FIXED_BASE_WRAP_H
+#define CRYPTO_SCALARMULT_ED25519_FIXED_BASE_WRAP_H
+
+#include <nan.h>
+#include "../libsodium/src/libsodium/include/sodium.h"
+#include "crypto_scalarmult_ed25519_fixed_base.h"
+
+class CryptoScalarmultEd25519FixedBaseWrap : public Nan::ObjectWrap {
+public:
+  static void Init ();
+  static v8::Local<v8::Value> NewInstance (unsigned char *point);
+  CryptoScalarmultEd25519FixedBaseWrap ();
+  ~CryptoScalarmultEd25519FixedBaseWrap ();
+
+private:
+  crypto_scalarmult_ed25519_fixed_base_table table;
+
+  static NAN_METHOD(New);
+  static NAN_METHOD(Mul);
+  static NAN_METHOD(MulMany);
+};
+
+#endif
@@ -0,0 +1,202 @@
+#include "crypto_scalarmult_ed25519_multi.h"
+#include <errno.h>
+#include <stdint.h>
+#include <string.h>
+#include <vector>
+
+// s mod L after dropping the top bit, as noclamp does. The points are on the
+// main subgroup, so reducing does not change the products, and -1 if s is a
+// multiple of L, where noclamp would fail on the identity.
+static int scalar_prepare (unsigned char *r, const unsigned char *s) {
+  unsigned char wide[64];
+
+  memcpy(wide, s, 32);
+  wide[31] &= 127;
+  memset(wide + 32, 0, 32);
+  crypto_core_ed25519_scalar_reduce(r, wide);
+
+  return sodium_is_zero(r, 32) ? -1 : 0;
+}
+
+// the checks crypto_scalarmult_ed25519_noclamp does on its point, bar the
+// subgroup check, which is left to the callers as Straus has the table for it
+static int point_decode (ed25519_ge_p3 *p, const unsigned char *s) {
+  if (!ed25519_ge_is_canonical(s) || ed25519_ge_has_small_order(s)) return -1;
+  return ed25519_ge_frombytes(p, s);
+}
+
+static int straus (ed25519_ge_p3 *r, const unsigned char *scalars, const unsigned char *points, size_t count) {
+  std::vector<ed25519_ge_cached> tables(count * 8);
+  std::vector<ed25519_wnaf_term> terms(count);
+  unsigned char s[32];
+  ed25519_ge_p3 p;
+  ed25519_ge_p2 sum;
+
+  for (size_t i = 0; i < count; i++) {
+    if (point_decode(&p, points + 32 * i) != 0) return -1;
+
+    ed25519_ge_odd_multiples(&tables[8 * i], &p);
+    if (!ed25519_ge_odd_multiples_on_main_subgroup_vartime(&tables[8 * i])) return -1;
+    if (scalar_prepare(s, scalars + 32 * i) != 0) return -1;
+    ed25519_slide(terms[i].digits, s);
+    terms[i].cached = &tables[8 * i];
+    terms[i].precomp = NULL;
+  }
+
+  ed25519_ge_wnaf_vartime(&sum, terms.data(), count);
+  ed25519_ge_p2_to_p3(r, &sum);
+  return 0;
+}
+
+// window width minimising the number of additions, one per point and two per
+// bucket in every window
+static int pippenger_width (size_t count) {
+  int best = 4;
+  double best_cost = 0;
+
+  for (int c = 4; c <= 16; c++) {
+    double cost = (double) (253 / c + 1) * ((double) count + (double) (1 << c));
+    if (c == 4 || cost < best_cost) {
+      best = c;
+      best_cost = cost;
+    }
+  }
+
+  return best;
+}
+
+// signed digits in [-2^(c - 1), 2^(c - 1)] of a scalar below 2^253. There is
+// one window more than 253 / c, so the top digit never carries.
+static void pippenger_digits (int16_t *d, size_t stride, const unsigned char *s, int c, int windows) {
+  int carry = 0;
+
+  for (int w = 0; w < windows; w++) {
+    int bit = w * c;
+    uint32_t v = 0;
+
+    for (int k = 0; k < 3; k++) {
+      int i = (bit >> 3) + k;
+      if (i < 32) v |= (uint32_t) s[i] << (8 * k);
+    }
+
+    int digit = (int) ((v >> (bit & 7)) & ((1U << c) - 1)) + carry;
+    carry = 0;
+
+    if (digit > (1 << (c - 1))) {
+      digit -= 1 << c;
+      carry = 1;
+    }
+
+    d[w * stride] = (int16_t) digit;
+  }
+}
+
+static void p3_add_or_copy (ed25519_ge_p3 *r, const ed25519_ge_p3 *p, bool *have) {
+  if (*have) {
+    ed25519_ge_p3_add(r, r, p);
+  } else {
+    memcpy(r, p, sizeof(ed25519_ge_p3));
+    *have = true;
+  }
+}
+
+static int pippenger (ed25519_ge_p3 *r, const unsigned char *scalars, const unsigned char *points, size_t count) {
+  int c = pippenger_width(count);
+  int windows = 253 / c + 1;
+  size_t buckets_length = (size_t) 1 << (c - 1);
+
+  std::vector<ed25519_ge_precomp> precomp(count);
+  std::vector<int16_t> digits(count * windows);
+  std::vector<ed25519_ge_p3> buckets(buckets_length);
+  std::vector<unsigned char> used(buckets_length);
+  unsigned char s[32];
+  ed25519_ge_p3 p;
+  ed25519_ge_cached cached;
+  ed25519_ge_p1p1 t;
+  ed25519_ge_p2 t2;
+
+  for (size_t i = 0; i < count; i++) {
+    if (point_decode(&p, points + 32 * i) != 0) return -1;
+    if (!ed25519_ge_is_on_main_subgroup_vartime(&p)) return -1;
+
+    // decoded points have Z = 1, so the cached form is already affine
+    ed25519_ge_p3_to_cached(&cached, &p);
+    ed25519_fe_copy(precomp[i].yplusx, cached.YplusX);
+    ed25519_fe_copy(precomp[i].yminusx, cached.YminusX);
+    ed25519_fe_copy(precomp[i].xy2d, cached.T2d);
+
+    if (scalar_prepare(s, scalars + 32 * i) != 0) return -1;
+    pippenger_digits(&digits[i], count, s, c, windows);
+  }
+
+  ed25519_ge_p3_0(r);
+
+  for (int w = windows - 1; w >= 0; w--) {
+    if (w != windows - 1) {
+      ed25519_ge_p3_to_p2(&t2, r);
+      for (int k = 1; k < c; k++) {
+        ed25519_ge_p2_dbl(&t, &t2);
+        ed25519_ge_p1p1_to_p2(&t2, &t);
+      }
+      ed25519_ge_p2_dbl(&t, &t2);
+      ed25519_ge_p1p1_to_p3(r, &t);
+    }
+
+    const int16_t *d = &digits[w * count];
+    memset(used.data(), 0, buckets_length);
+
+    for (size_t i = 0; i < count; i++) {
+      if (d[i] == 0) continue;
+
+      size_t b = (size_t) (d[i] > 0 ? d[i] : -d[i]) - 1;
+      if (!used[b]) {
+        ed25519_ge_p3_0(&buckets[b]);
+        used[b] = 1;
+      }
+
+      if (d[i] > 0) ed25519_ge_madd(&t, &buckets[b], &precomp[i]);
+      else ed25519_ge_msub(&t, &buckets[b], &precomp[i]);
+      ed25519_ge_p1p1_to_p3(&buckets[b], &t);
+    }
+
+    // sum of (b + 1) * buckets[b] as a running sum from the top bucket down
+    ed25519_ge_p3 running, sum;
+    bool have_running = false, have_sum = false;
+
+    for (size_t b = buckets_length; b-- > 0;) {
+      if (used[b]) p3_add_or_copy(&running, &buckets[b], &have_running);
+      if (have_running) p3_add_or_copy(&sum, &running, &have_sum);
+    }
+
+    if (have_sum) ed25519_ge_p3_add(r, r, &sum);
+  }
+
+  return 0;
+}
+
+int crypto_scalarmult_ed25519_multi_p3 (ed25519_ge_p3 *r, const unsigned char *scalars, const unsigned char *points, size_t count) {
+  if (count <= CRYPTO_SCALARMULT_ED25519_MULTI_STRAUS_MAX) {
+    return straus(r, scalars, points, count);
+  }
+  return pippenger(r, scalars, points, count);
+}
+
+int crypto_scalarmult_ed25519_multi_final (unsigned char *q, const ed25519_ge_p3 *r) {
+  ed25519_ge_p3_tobytes(q, r);
+
+  // the identity encodes as y = 1, x = 0
+  unsigned char d = q[0] ^ 1;
+  for (int i = 1; i < 32; i++) d |= q[i];
+  return d == 0 ? -1 : 0;
+}
+
+int crypto_scalarmult_ed25519_multi (unsigned char *q, const unsigned char *scalars, const unsigned char *points, size_t count) {
+  ed25519_ge_p3 r;
+
+  if (crypto_scalarmult_ed25519_multi_p3(&r, scalars, points, count) != 0 ||
+      crypto_scalarmult_ed25519_multi_final(q, &r) != 0) {
+    errno = EINVAL;
+    return -1;
+  }
+  return 0;
+}
@@ -0,0 +1,31 @@
+#ifndef CRYPTO_SCALARMULT_ED25519_MULTI_H
+#define CRYPTO_SCALARMULT_ED25519_MULTI_H
+
+#include <stddef.h>
+#include "../libsodium/src/libsodium/include/sodium.h"
+#include "ed25519.h"
+
+// Multi-scalar multiplication q = s[0] * P[0] + ... + s[n - 1] * P[n - 1]
+// over packed arrays of 32 byte scalars and points.
+//
+// Fails where any of the crypto_scalarmult_ed25519_noclamp calls for the
+// terms would: on points that are not canonical encodings of points on the
+// main subgroup, and on scalars that are a multiple of L once their top bit is
+// ignored. Like noclamp the result is also rejected when it is the identity.
+//
+// Small inputs use Straus' method with a sliding window per point, larger
+// ones Pippenger's bucket method. Both are variable time, so the scalars
+// must not be secret.
+
+// up to this many points Straus is faster than Pippenger
+#define CRYPTO_SCALARMULT_ED25519_MULTI_STRAUS_MAX 64
+
+// r = the sum, -1 if a point is rejected
+int crypto_scalarmult_ed25519_multi_p3 (ed25519_ge_p3 *r, const unsigned char *scalars, const unsigned char *points, size_t count);
+
+// encodes a sum from crypto_scalarmult_ed25519_multi_p3, -1 if it is the identity
+int crypto_scalarmult_ed25519_multi_final (unsigned char *q, const ed25519_ge_p3 *r);
+
+int crypto_scalarmult_ed25519_multi (unsigned char *q, const unsigned char *scalars, const unsigned char *points, size_t count);
+
+#endif
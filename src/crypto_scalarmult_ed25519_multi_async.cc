@@ -0,0 +1,80 @@
+#include <nan.h>
+#include <atomic>
+#include <vector>
+#include "macros.h"
+#include "threadpool_slices.h"
+#include "crypto_scalarmult_ed25519_multi.h"
+
+#include "../libsodium/src/libsodium/include/sodium.h"
+
+// fewer points than this per slice and the threads cost more than they save
+#define CRYPTO_SCALARMULT_ED25519_MULTI_SLICE_MIN 512
+
+struct crypto_scalarmult_ed25519_multi_job {
+  unsigned char *q;
+  const unsigned char *scalars;
+  const unsigned char *points;
+  size_t count;
+  // one partial sum per slice, added up when the last slice completes
+  std::vector<ed25519_ge_p3> partials;
+  std::atomic<bool> invalid;
+  // only touched on the main thread
+  size_t pending;
+  Nan::Callback *callback;
+  Nan::Persistent<v8::Array> buffers;
+
+  ~crypto_scalarmult_ed25519_multi_job () {
+    buffers.Reset();
+    delete callback;
+  }
+};
+
+static inline size_t crypto_scalarmult_ed25519_multi_slices (size_t count) {
+  return threadpool_slices(count / CRYPTO_SCALARMULT_ED25519_MULTI_SLICE_MIN);
+}
+
+// the sum over one contiguous range of points. The last slice to complete
+// adds up the partial sums and calls back into javascript
+class CryptoScalarmultEd25519MultiAsync : public Nan::AsyncWorker {
+ public:
+  CryptoScalarmultEd25519MultiAsync(crypto_scalarmult_ed25519_multi_job *job, size_t slice)
+    : Nan::AsyncWorker(NULL, "sodium-native:crypto_scalarmult_ed25519_multi_async"), job(job), slice(slice) {}
+
+  void Execute () {
+    size_t slices = job->partials.size();
+    size_t start = job->count * slice / slices;
+    size_t end = job->count * (slice + 1) / slices;
+
+    if (job->invalid.load(std::memory_order_relaxed)) return;
+
+    int ret = crypto_scalarmult_ed25519_multi_p3(&(job->partials[slice]), job->scalars + 32 * start, job->points + 32 * start, end - start);
+    if (ret != 0) job->invalid.store(true, std::memory_order_relaxed);
+  }
+
+  void HandleOKCallback () {
+    if (--(job->pending) > 0) return;
+
+    Nan::HandleScope scope;
+
+    bool invalid = job->invalid.load();
+
+    if (!invalid) {
+      ed25519_ge_p3 r = job->partials[0];
+      for (size_t i = 1; i < job->partials.size(); i++) {
+        ed25519_ge_p3_add(&r, &r, &(job->partials[i]));
+      }
+      invalid = crypto_scalarmult_ed25519_multi_final(job->q, &r) != 0;
+    }
+
+    v8::Local<v8::Value> argv[] = {
+        invalid ? ERRNO_EXCEPTION(EINVAL) : Nan::Null()
+    };
+
+    job->callback->Call(1, argv, async_resource);
+    delete job;
+  }
+
+ private:
+  crypto_scalarmult_ed25519_multi_job *job;
+  size_t slice;
+};
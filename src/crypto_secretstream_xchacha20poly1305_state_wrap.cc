@@ -1,7 +1,8 @@
 #include "crypto_secretstream_xchacha20poly1305_state_wrap.h"
 #include "macros.h"
+#include "per_isolate.h"
 
-static Nan::Persistent<v8::FunctionTemplate> crypto_secretstream_xchacha20poly1305_state_constructor;
+static thread_local Nan::Persistent<v8::FunctionTemplate> crypto_secretstream_xchacha20poly1305_state_constructor;
 
 CryptoSecretstreamXchacha20poly1305StateWrap::CryptoSecretstreamXchacha20poly1305StateWrap () {}
 
@@ -15,7 +16,7 @@ NAN_METHOD(CryptoSecretstreamXchacha20poly1305StateWrap::New) {
 
 void CryptoSecretstreamXchacha20poly1305StateWrap::Init () {
   v8::Local<v8::FunctionTemplate> tpl = Nan::New<v8::FunctionTemplate>(CryptoSecretstreamXchacha20poly1305StateWrap::New);
-  crypto_secretstream_xchacha20poly1305_state_constructor.Reset(tpl);
+  per_isolate_constructor_set(&crypto_secretstream_xchacha20poly1305_state_constructor, tpl);
   tpl->SetClassName(Nan::New("CryptoSecretstreamXchacha20poly1305StateWrap").ToLocalChecked());
   tpl->InstanceTemplate()->SetInternalFieldCount(1);
   v8::Local<v8::ObjectTemplate> itpl = tpl->InstanceTemplate();
@@ -28,6 +29,8 @@ void CryptoSecretstreamXchacha20poly1305StateWrap::Init () {
 v8::Local<v8::Value> CryptoSecretstreamXchacha20poly1305StateWrap::NewInstance () {
   Nan::EscapableHandleScope scope;
 
+  if (crypto_secretstream_xchacha20poly1305_state_constructor.IsEmpty()) CryptoSecretstreamXchacha20poly1305StateWrap::Init();
+
   v8::Local<v8::Object> instance;
 
   v8::Local<v8::FunctionTemplate> constructorHandle = Nan::New<v8::FunctionTemplate>(crypto_secretstream_xchacha20poly1305_state_constructor);
@@ -0,0 +1,57 @@
+#include "crypto_secretstream_xchacha20poly1305_table.h"
+
+int64_t crypto_secretstream_xchacha20poly1305_table_alloc (crypto_secretstream_xchacha20poly1305_table *table) {
+  uint32_t handle;
+
+  if (!table->free.empty()) {
+    handle = table->free.back();
+    table->free.pop_back();
+  } else {
+    size_t slab = table->slabs.size();
+    if (slab * CRYPTO_SECRETSTREAM_TABLE_SLAB > UINT32_MAX - CRYPTO_SECRETSTREAM_TABLE_SLAB) return -1;
+
+    crypto_secretstream_xchacha20poly1305_state *states = (crypto_secretstream_xchacha20poly1305_state *)
+      sodium_allocarray(CRYPTO_SECRETSTREAM_TABLE_SLAB, sizeof(crypto_secretstream_xchacha20poly1305_state));
+    if (states == NULL) return -1;
+
+    sodium_memzero(states, CRYPTO_SECRETSTREAM_TABLE_SLAB * sizeof(crypto_secretstream_xchacha20poly1305_state));
+    table->slabs.push_back(states);
+    table->used.resize(table->used.size() + CRYPTO_SECRETSTREAM_TABLE_SLAB, 0);
+
+    // queue the rest of the slab so it is handed out in ascending order
+    handle = (uint32_t) (slab * CRYPTO_SECRETSTREAM_TABLE_SLAB);
+    for (uint32_t i = CRYPTO_SECRETSTREAM_TABLE_SLAB - 1; i > 0; i--) {
+      table->free.push_back(handle + i);
+    }
+  }
+
+  table->used[handle] = 1;
+  table->count++;
+  return handle;
+}
+
+crypto_secretstream_xchacha20poly1305_state * crypto_secretstream_xchacha20poly1305_table_get (crypto_secretstream_xchacha20poly1305_table *table, uint32_t handle) {
+  if (handle >= table->used.size() || !table->used[handle]) return NULL;
+  return &(table->slabs[handle / CRYPTO_SECRETSTREAM_TABLE_SLAB][handle % CRYPTO_SECRETSTREAM_TABLE_SLAB]);
+}
+
+int crypto_secretstream_xchacha20poly1305_table_free (crypto_secretstream_xchacha20poly1305_table *table, uint32_t handle) {
+  crypto_secretstream_xchacha20poly1305_state *state = crypto_secretstream_xchacha20poly1305_table_get(table, handle);
+  if (state == NULL) return -1;
+
+  sodium_memzero(state, sizeof(*state));
+  table->used[handle] = 0;
+  table->count--;
+  table->free.push_back(handle);
+  return 0;
+}
+
+void crypto_secretstream_xchacha20poly1305_table_destroy (crypto_secretstream_xchacha20poly1305_table *table) {
+  // sodium_free zeroes the slabs before releasing them
+  for (size_t i = 0; i < table->slabs.size(); i++) sodium_free(table->slabs[i]);
+
+  table->slabs.clear();
+  table->used.clear();
+  table->free.clear();
+  table->count = 0;
+}
@@ -0,0 +1,35 @@
+#ifndef CRYPTO_SECRETSTREAM_XCHACHA20POLY1305_TABLE_H
+#define CRYPTO_SECRETSTREAM_XCHACHA20POLY1305_TABLE_H
+
+#include <stdint.h>
+#include <vector>
+#include "../libsodium/src/libsodium/include/sodium.h"
+
+// Secretstream states addressed by integer handle instead of one ObjectWrap
+// each. States are packed in slabs of CRYPTO_SECRETSTREAM_TABLE_SLAB states,
+// each slab a single sodium_malloc allocation, so the table costs no JS
+// objects and grows without moving existing states. Freed states are zeroed
+// and their handles reused, most recently freed first.
+
+#define CRYPTO_SECRETSTREAM_TABLE_SLAB 1024U
+
+typedef struct crypto_secretstream_xchacha20poly1305_table {
+  std::vector<crypto_secretstream_xchacha20poly1305_state *> slabs;
+  std::vector<uint8_t> used;
+  // unused handles below used.size(), popped from the back
+  std::vector<uint32_t> free;
+  size_t count;
+} crypto_secretstream_xchacha20poly1305_table;
+
+// returns the new handle, or -1 if secure memory could not be allocated
+int64_t crypto_secretstream_xchacha20poly1305_table_alloc (crypto_secretstream_xchacha20poly1305_table *table);
+
+// returns NULL unless handle is allocated
+crypto_secretstream_xchacha20poly1305_state * crypto_secretstream_xchacha20poly1305_table_get (crypto_secretstream_xchacha20poly1305_table *table, uint32_t handle);
+
+// returns -1 unless handle is allocated
+int crypto_secretstream_xchacha20poly1305_table_free (crypto_secretstream_xchacha20poly1305_table *table, uint32_t handle);
+
+void crypto_secretstream_xchacha20poly1305_table_destroy (crypto_secretstream_xchacha20poly1305_table *table);
+
+#endif
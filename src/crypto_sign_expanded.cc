@@ -0,0 +1,60 @@
+#include "crypto_sign_expanded.h"
+#include "ed25519.h"
+#include <stdint.h>
+#include <string.h>
+
+void crypto_sign_expanded_key_init (crypto_sign_expanded_key *key, const unsigned char *sk) {
+  unsigned char az[64];
+
+  crypto_hash_sha512(az, sk, 32);
+  az[0] &= 248;
+  az[31] &= 127;
+  az[31] |= 64;
+
+  memcpy(key->scalar, az, 32);
+  memcpy(key->prefix, az + 32, 32);
+  memcpy(key->pk, sk + 32, crypto_sign_PUBLICKEYBYTES);
+
+  sodium_memzero(az, sizeof(az));
+}
+
+int crypto_sign_expanded_detached (unsigned char *sig, const unsigned char *m, unsigned long long mlen, const crypto_sign_expanded_key *key) {
+  crypto_hash_sha512_state hs;
+  unsigned char nonce[64];
+  unsigned char hram[64];
+  unsigned char r[32];
+  unsigned char k[32];
+
+  crypto_hash_sha512_init(&hs);
+  crypto_hash_sha512_update(&hs, key->prefix, 32);
+  crypto_hash_sha512_update(&hs, m, mlen);
+  crypto_hash_sha512_final(&hs, nonce);
+  crypto_core_ed25519_scalar_reduce(r, nonce);
+
+  // only fails for r = 0, which a hash output reduces to with probability 2^-252
+  if (crypto_scalarmult_ed25519_base_noclamp(sig, r) != 0) {
+    sodium_memzero(nonce, sizeof(nonce));
+    sodium_memzero(r, sizeof(r));
+    return -1;
+  }
+
+  crypto_hash_sha512_init(&hs);
+  crypto_hash_sha512_update(&hs, sig, 32);
+  crypto_hash_sha512_update(&hs, key->pk, 32);
+  crypto_hash_sha512_update(&hs, m, mlen);
+  crypto_hash_sha512_final(&hs, hram);
+  crypto_core_ed25519_scalar_reduce(k, hram);
+
+  ed25519_sc_muladd(sig + 32, k, key->scalar, r);
+
+  sodium_memzero(nonce, sizeof(nonce));
+  sodium_memzero(r, sizeof(r));
+  sodium_memzero(&hs, sizeof(hs));
+
+  return 0;
+}
+
+int crypto_sign_expanded (unsigned char *sm, const unsigned char *m, unsigned long long mlen, const crypto_sign_expanded_key *key) {
+  memmove(sm + crypto_sign_BYTES, m, mlen);
+  return crypto_sign_expanded_detached(sm, sm + crypto_sign_BYTES, mlen, key);
+}
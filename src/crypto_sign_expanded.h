@@ -0,0 +1,25 @@
+#ifndef CRYPTO_SIGN_EXPANDED_H
+#define CRYPTO_SIGN_EXPANDED_H
+
+#include "../libsodium/src/libsodium/include/sodium.h"
+
+// Ed25519 signing with the secret key expanded once up front. A 64 byte
+// secret key is seed || public key, and every crypto_sign call hashes the
+// seed with SHA-512 and clamps the result before it can sign. This keeps the
+// clamped scalar and the nonce prefix around instead. Signatures are byte
+// for byte those of crypto_sign_detached.
+
+typedef struct crypto_sign_expanded_key {
+  unsigned char scalar[32];
+  unsigned char prefix[32];
+  unsigned char pk[crypto_sign_PUBLICKEYBYTES];
+} crypto_sign_expanded_key;
+
+void crypto_sign_expanded_key_init (crypto_sign_expanded_key *key, const unsigned char *sk);
+
+int crypto_sign_expanded_detached (unsigned char *sig, const unsigned char *m, unsigned long long mlen, const crypto_sign_expanded_key *key);
+
+// sm = signature || m, m may overlap sm
+int crypto_sign_expanded (unsigned char *sm, const unsigned char *m, unsigned long long mlen, const crypto_sign_expanded_key *key);
+
+#endif
@@ -0,0 +1,97 @@
+#include "crypto_sign_prepared.h"
+#include <string.h>
+
+void crypto_sign_prepared_key_init (crypto_sign_prepared_key *key, const unsigned char *pk) {
+  ed25519_ge_p3 a;
+  ed25519_ge_p1p1 t;
+
+  memcpy(key->pk, pk, crypto_sign_PUBLICKEYBYTES);
+
+  // the same checks as crypto_sign_verify_detached does on every call
+  key->valid = ed25519_ge_is_canonical(pk) &&
+    !ed25519_ge_has_small_order(pk) &&
+    ed25519_ge_frombytes(&a, pk) == 0;
+
+  if (!key->valid) return;
+
+  ed25519_fe_neg(a.X, a.X);
+  ed25519_fe_neg(a.T, a.T);
+  ed25519_ge_odd_multiples(key->a, &a);
+
+  for (int i = 0; i < 128; i++) {
+    ed25519_ge_p3_dbl(&t, &a);
+    ed25519_ge_p1p1_to_p3(&a, &t);
+  }
+  ed25519_ge_odd_multiples(key->a128, &a);
+}
+
+int crypto_sign_prepared_verify_detached (const unsigned char *sig, const unsigned char *m, unsigned long long mlen, const crypto_sign_prepared_key *key) {
+  crypto_hash_sha512_state hs;
+  unsigned char hram[64];
+  unsigned char h[32];
+  unsigned char half[32];
+  unsigned char rcheck[32];
+  ed25519_wnaf_term terms[4];
+  ed25519_ge_p2 r;
+
+  if (!key->valid) return -1;
+  if (!ed25519_sc_is_canonical(sig + 32) || ed25519_ge_has_small_order(sig)) return -1;
+
+  crypto_hash_sha512_init(&hs);
+  crypto_hash_sha512_update(&hs, sig, 32);
+  crypto_hash_sha512_update(&hs, key->pk, 32);
+  crypto_hash_sha512_update(&hs, m, mlen);
+  crypto_hash_sha512_final(&hs, hram);
+  crypto_core_ed25519_scalar_reduce(h, hram);
+
+  // h * -A + s * B with every scalar split as lo + 2^128 * hi
+  memset(half, 0, sizeof(half));
+
+  memcpy(half, h, 16);
+  ed25519_slide(terms[0].digits, half);
+  memcpy(half, h + 16, 16);
+  ed25519_slide(terms[1].digits, half);
+  memcpy(half, sig + 32, 16);
+  ed25519_slide(terms[2].digits, half);
+  memcpy(half, sig + 48, 16);
+  ed25519_slide(terms[3].digits, half);
+
+  terms[0].cached = key->a;
+  terms[0].precomp = NULL;
+  terms[1].cached = key->a128;
+  terms[1].precomp = NULL;
+  terms[2].cached = NULL;
+  terms[2].precomp = ed25519_ge_base_odd();
+  terms[3].cached = NULL;
+  terms[3].precomp = ed25519_ge_base_odd_128();
+
+  ed25519_ge_wnaf_vartime(&r, terms, 4);
+
+  ed25519_fe recip, x, y;
+  ed25519_fe_invert(recip, r.Z);
+  ed25519_fe_mul(x, r.X, recip);
+  ed25519_fe_mul(y, r.Y, recip);
+  ed25519_fe_tobytes(rcheck, y);
+  rcheck[31] ^= ed25519_fe_isnegative(x) << 7;
+
+  return crypto_verify_32(rcheck, sig);
+}
+
+int crypto_sign_prepared_open (unsigned char *m, unsigned long long *mlen_p, const unsigned char *sm, unsigned long long smlen, const crypto_sign_prepared_key *key) {
+  unsigned long long mlen;
+
+  if (mlen_p != NULL) *mlen_p = 0;
+  if (smlen < crypto_sign_BYTES) return -1;
+
+  mlen = smlen - crypto_sign_BYTES;
+
+  if (crypto_sign_prepared_verify_detached(sm, sm + crypto_sign_BYTES, mlen, key) != 0) {
+    if (m != NULL) memset(m, 0, mlen);
+    return -1;
+  }
+
+  if (mlen_p != NULL) *mlen_p = mlen;
+  if (m != NULL) memmove(m, sm + crypto_sign_BYTES, mlen);
+
+  return 0;
+}
@@ -0,0 +1,27 @@
+#ifndef CRYPTO_SIGN_PREPARED_H
+#define CRYPTO_SIGN_PREPARED_H
+
+#include "../libsodium/src/libsodium/include/sodium.h"
+#include "ed25519.h"
+
+// Ed25519 verification against a public key that was decoded once. Besides
+// skipping the decompression and validation of the key, the prepared key has
+// window tables for -A and -2^128 * A, so both scalars of the verification
+// equation are split in halves and it needs half the doublings. Results are
+// those of crypto_sign_verify_detached and crypto_sign_open.
+
+typedef struct crypto_sign_prepared_key {
+  unsigned char pk[crypto_sign_PUBLICKEYBYTES];
+  // 0 if the key is rejected by libsodium, nothing verifies against it then
+  int valid;
+  ed25519_ge_cached a[8];
+  ed25519_ge_cached a128[8];
+} crypto_sign_prepared_key;
+
+void crypto_sign_prepared_key_init (crypto_sign_prepared_key *key, const unsigned char *pk);
+
+int crypto_sign_prepared_verify_detached (const unsigned char *sig, const unsigned char *m, unsigned long long mlen, const crypto_sign_prepared_key *key);
+
+int crypto_sign_prepared_open (unsigned char *m, unsigned long long *mlen_p, const unsigned char *sm, unsigned long long smlen, const crypto_sign_prepared_key *key);
+
+#endif
@@ -0,0 +1,109 @@
+#include "crypto_sign_verify_cache.h"
+#include <stdlib.h>
+#include <string.h>
+
+int crypto_sign_verify_cache_init (crypto_sign_verify_cache *cache, size_t capacity) {
+  size_t sets = (capacity + CRYPTO_SIGN_VERIFY_CACHE_WAYS - 1) / CRYPTO_SIGN_VERIFY_CACHE_WAYS;
+  if (sets == 0) sets = 1;
+
+  cache->entries = (crypto_sign_verify_cache_entry *) calloc(sets * CRYPTO_SIGN_VERIFY_CACHE_WAYS, sizeof(crypto_sign_verify_cache_entry));
+  if (cache->entries == NULL) return -1;
+
+  cache->sets = sets;
+  randombytes_buf(cache->key, sizeof(cache->key));
+
+  for (size_t i = 0; i < CRYPTO_SIGN_VERIFY_CACHE_SHARDS; i++) cache->shards[i].clock = 0;
+
+  cache->hits = 0;
+  cache->misses = 0;
+  cache->evictions = 0;
+  cache->size = 0;
+
+  return 0;
+}
+
+size_t crypto_sign_verify_cache_capacity (const crypto_sign_verify_cache *cache) {
+  return cache->sets * CRYPTO_SIGN_VERIFY_CACHE_WAYS;
+}
+
+static inline uint64_t load64_le (const unsigned char *s) {
+  uint64_t r = 0;
+  for (int i = 7; i >= 0; i--) r = (r << 8) | s[i];
+  return r;
+}
+
+// index of digest in set, or -1
+static int find (crypto_sign_verify_cache_entry *set, const unsigned char *digest) {
+  for (unsigned int i = 0; i < CRYPTO_SIGN_VERIFY_CACHE_WAYS; i++) {
+    if (set[i].stamp != 0 && crypto_verify_32(set[i].digest, digest) == 0) return (int) i;
+  }
+  return -1;
+}
+
+int crypto_sign_verify_cache_verify_detached (crypto_sign_verify_cache *cache, const unsigned char *sig, const unsigned char *m, unsigned long long mlen, const unsigned char *pk) {
+  crypto_generichash_state hs;
+  unsigned char digest[crypto_generichash_BYTES];
+
+  // public key and signature are fixed length, so the encoding is unambiguous
+  crypto_generichash_init(&hs, cache->key, sizeof(cache->key), sizeof(digest));
+  crypto_generichash_update(&hs, pk, crypto_sign_PUBLICKEYBYTES);
+  crypto_generichash_update(&hs, sig, crypto_sign_BYTES);
+  crypto_generichash_update(&hs, m, mlen);
+  crypto_generichash_final(&hs, digest, sizeof(digest));
+
+  size_t index = (size_t) (load64_le(digest) % cache->sets);
+  crypto_sign_verify_cache_entry *set = cache->entries + index * CRYPTO_SIGN_VERIFY_CACHE_WAYS;
+  crypto_sign_verify_cache_shard *shard = &(cache->shards[index % CRYPTO_SIGN_VERIFY_CACHE_SHARDS]);
+
+  {
+    std::lock_guard<std::mutex> guard(shard->lock);
+    int i = find(set, digest);
+    if (i >= 0) {
+      set[i].stamp = ++shard->clock;
+      cache->hits.fetch_add(1, std::memory_order_relaxed);
+      return 0;
+    }
+  }
+
+  cache->misses.fetch_add(1, std::memory_order_relaxed);
+
+  // verify without holding the lock, it is by far the slowest part
+  if (crypto_sign_verify_detached(sig, m, mlen, pk) != 0) return -1;
+
+  std::lock_guard<std::mutex> guard(shard->lock);
+
+  // another thread may have verified the same tuple meanwhile
+  int i = find(set, digest);
+
+  if (i < 0) {
+    i = 0;
+    for (unsigned int j = 1; j < CRYPTO_SIGN_VERIFY_CACHE_WAYS; j++) {
+      if (set[j].stamp < set[i].stamp) i = (int) j;
+    }
+
+    if (set[i].stamp != 0) cache->evictions.fetch_add(1, std::memory_order_relaxed);
+    else cache->size.fetch_add(1, std::memory_order_relaxed);
+
+    memcpy(set[i].digest, digest, sizeof(digest));
+  }
+
+  set[i].stamp = ++shard->clock;
+  return 0;
+}
+
+void crypto_sign_verify_cache_clear (crypto_sign_verify_cache *cache) {
+  for (size_t s = 0; s < CRYPTO_SIGN_VERIFY_CACHE_SHARDS; s++) {
+    std::lock_guard<std::mutex> guard(cache->shards[s].lock);
+    for (size_t index = s; index < cache->sets; index += CRYPTO_SIGN_VERIFY_CACHE_SHARDS) {
+      memset(cache->entries + index * CRYPTO_SIGN_VERIFY_CACHE_WAYS, 0, CRYPTO_SIGN_VERIFY_CACHE_WAYS * sizeof(crypto_sign_verify_cache_entry));
+    }
+  }
+
+  cache->size = 0;
+}
+
+void crypto_sign_verify_cache_destroy (crypto_sign_verify_cache *cache) {
+  free(cache->entries);
+  cache->entries = NULL;
+  sodium_memzero(cache->key, sizeof(cache->key));
+}
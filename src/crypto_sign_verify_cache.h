@@ -0,0 +1,62 @@
+#ifndef CRYPTO_SIGN_VERIFY_CACHE_H
+#define CRYPTO_SIGN_VERIFY_CACHE_H
+
+#include <stdint.h>
+#include <atomic>
+#include <mutex>
+#include "../libsodium/src/libsodium/include/sodium.h"
+
+// Cache of successful signature verifications, so a message that arrives
+// again, e.g. from several peers of a gossip network, is accepted without
+// any curve arithmetic.
+//
+// Entries are keyed by a BLAKE2b digest of public key || signature ||
+// message under a random per-cache key, so set placement cannot be steered
+// from outside. The table is set associative: a digest maps to one set of
+// CRYPTO_SIGN_VERIFY_CACHE_WAYS entries and evicts the least recently used
+// entry of that set. Sets are spread over CRYPTO_SIGN_VERIFY_CACHE_SHARDS
+// locks. Memory is allocated once up front and never grows. Failed
+// verifications are never cached.
+
+#define CRYPTO_SIGN_VERIFY_CACHE_WAYS 8U
+#define CRYPTO_SIGN_VERIFY_CACHE_SHARDS 64U
+
+// 2^22 entries of 40 bytes, 160 MiB
+#define CRYPTO_SIGN_VERIFY_CACHE_CAPACITY_MAX 4194304U
+
+typedef struct crypto_sign_verify_cache_entry {
+  unsigned char digest[crypto_generichash_BYTES];
+  // 0 for an empty entry, otherwise the shard clock of the last use
+  uint64_t stamp;
+} crypto_sign_verify_cache_entry;
+
+typedef struct crypto_sign_verify_cache_shard {
+  std::mutex lock;
+  uint64_t clock;
+} crypto_sign_verify_cache_shard;
+
+typedef struct crypto_sign_verify_cache {
+  unsigned char key[crypto_generichash_KEYBYTES];
+  crypto_sign_verify_cache_entry *entries;
+  size_t sets;
+  crypto_sign_verify_cache_shard shards[CRYPTO_SIGN_VERIFY_CACHE_SHARDS];
+  std::atomic<uint64_t> hits;
+  std::atomic<uint64_t> misses;
+  std::atomic<uint64_t> evictions;
+  std::atomic<uint64_t> size;
+} crypto_sign_verify_cache;
+
+// capacity is rounded up to a multiple of CRYPTO_SIGN_VERIFY_CACHE_WAYS,
+// returns -1 if the table could not be allocated
+int crypto_sign_verify_cache_init (crypto_sign_verify_cache *cache, size_t capacity);
+
+size_t crypto_sign_verify_cache_capacity (const crypto_sign_verify_cache *cache);
+
+// same result as crypto_sign_verify_detached
+int crypto_sign_verify_cache_verify_detached (crypto_sign_verify_cache *cache, const unsigned char *sig, const unsigned char *m, unsigned long long mlen, const unsigned char *pk);
+
+void crypto_sign_verify_cache_clear (crypto_sign_verify_cache *cache);
+
+void crypto_sign_verify_cache_destroy (crypto_sign_verify_cache *cache);
+
+#endif
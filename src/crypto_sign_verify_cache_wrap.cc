@@ -0,0 +1,81 @@
+#include "crypto_sign_verify_cache_wrap.h"
+#include "macros.h"
+#include "per_isolate.h"
+
+static thread_local Nan::Persistent<v8::FunctionTemplate> crypto_sign_verify_cache_constructor;
+
+CryptoSignVerifyCacheWrap::CryptoSignVerifyCacheWrap () {
+  cache.entries = NULL;
+}
+
+// the table is reported to V8 while it is allocated, as it can be far larger
+// than the object holding it
+CryptoSignVerifyCacheWrap::~CryptoSignVerifyCacheWrap () {
+  if (cache.entries != NULL) {
+    Nan::AdjustExternalMemory(-(int) (crypto_sign_verify_cache_capacity(&cache) * sizeof(crypto_sign_verify_cache_entry)));
+  }
+  crypto_sign_verify_cache_destroy(&(this->cache));
+}
+
+NAN_METHOD(CryptoSignVerifyCacheWrap::New) {
+  CryptoSignVerifyCacheWrap* obj = new CryptoSignVerifyCacheWrap();
+  obj->Wrap(info.This());
+  info.GetReturnValue().Set(info.This());
+}
+
+NAN_METHOD(CryptoSignVerifyCacheWrap::VerifyDetached) {
+  CryptoSignVerifyCacheWrap *self = Nan::ObjectWrap::Unwrap<CryptoSignVerifyCacheWrap>(info.This());
+  ASSERT_BUFFER_MIN_LENGTH(info[0], signature, crypto_sign_BYTES, crypto_sign_bytes())
+  ASSERT_BUFFER(info[1], message)
+  ASSERT_BUFFER_MIN_LENGTH(info[2], public_key, crypto_sign_PUBLICKEYBYTES, crypto_sign_publickeybytes())
+
+  CALL_SODIUM_BOOL(crypto_sign_verify_cache_verify_detached(&(self->cache), CDATA(signature), CDATA(message), CLENGTH(message), CDATA(public_key)))
+}
+
+NAN_METHOD(CryptoSignVerifyCacheWrap::Stats) {
+  CryptoSignVerifyCacheWrap *self = Nan::ObjectWrap::Unwrap<CryptoSignVerifyCacheWrap>(info.This());
+  crypto_sign_verify_cache *cache = &(self->cache);
+
+  v8::Local<v8::Object> result = Nan::New<v8::Object>();
+  Nan::Set(result, LOCAL_STRING("hits"), Nan::New<v8::Number>((double) cache->hits.load()));
+  Nan::Set(result, LOCAL_STRING("misses"), Nan::New<v8::Number>((double) cache->misses.load()));
+  Nan::Set(result, LOCAL_STRING("evictions"), Nan::New<v8::Number>((double) cache->evictions.load()));
+  Nan::Set(result, LOCAL_STRING("size"), Nan::New<v8::Number>((double) cache->size.load()));
+  Nan::Set(result, LOCAL_STRING("capacity"), Nan::New<v8::Number>((double) crypto_sign_verify_cache_capacity(cache)));
+
+  info.GetReturnValue().Set(result);
+}
+
+NAN_METHOD(CryptoSignVerifyCacheWrap::Clear) {
+  CryptoSignVerifyCacheWrap *self = Nan::ObjectWrap::Unwrap<CryptoSignVerifyCacheWrap>(info.This());
+  crypto_sign_verify_cache_clear(&(self->cache));
+}
+
+void CryptoSignVerifyCacheWrap::Init () {
+  v8::Local<v8::FunctionTemplate> tpl = Nan::New<v8::FunctionTemplate>(CryptoSignVerifyCacheWrap::New);
+  per_isolate_constructor_set(&crypto_sign_verify_cache_constructor, tpl);
+  tpl->SetClassName(Nan::New("CryptoSignVerifyCacheWrap").ToLocalChecked());
+  tpl->InstanceTemplate()->SetInternalFieldCount(1);
+
+  STATS_PROTOTYPE_METHOD(tpl, "crypto_sign_verify_cache_instance", "verifyDetached", CryptoSignVerifyCacheWrap::VerifyDetached)
+  STATS_PROTOTYPE_METHOD(tpl, "crypto_sign_verify_cache_instance", "stats", CryptoSignVerifyCacheWrap::Stats)
+  STATS_PROTOTYPE_METHOD(tpl, "crypto_sign_verify_cache_instance", "clear", CryptoSignVerifyCacheWrap::Clear)
+}
+
+// returns an empty handle if the table could not be allocated
+v8::Local<v8::Value> CryptoSignVerifyCacheWrap::NewInstance (size_t capacity) {
+  Nan::EscapableHandleScope scope;
+
+  if (crypto_sign_verify_cache_constructor.IsEmpty()) CryptoSignVerifyCacheWrap::Init();
+
+  v8::Local<v8::Object> instance;
+
+  v8::Local<v8::FunctionTemplate> constructorHandle = Nan::New<v8::FunctionTemplate>(crypto_sign_verify_cache_constructor);
+  instance = Nan::NewInstance(Nan::GetFunction(constructorHandle).ToLocalChecked()).ToLocalChecked();
+
+  CryptoSignVerifyCacheWrap *self = Nan::ObjectWrap::Unwrap<CryptoSignVerifyCacheWrap>(instance);
+  if (crypto_sign_verify_cache_init(&(self->cache), capacity) != 0) return v8::Local<v8::Value>();
+  Nan::AdjustExternalMemory((int) (crypto_sign_verify_cache_capacity(&(self->cache)) * sizeof(crypto_sign_verify_cache_entry)));
+
+  return scope.Escape(instance);
+}
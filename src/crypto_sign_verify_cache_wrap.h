@@ -0,0 +1,24 @@
+#ifndef CRYPTO_SIGN_VERIFY_CACHE_WRAP_H
+#define CRYPTO_SIGN_VERIFY_CACHE_WRAP_H
+
+#include <nan.h>
+#include "../libsodium/src/libsodium/include/sodium.h"
+#include "crypto_sign_verify_cache.h"
+
+class CryptoSignVerifyCacheWrap : public Nan::ObjectWrap {
+public:
+  crypto_sign_verify_cache cache;
+
+  static void Init ();
+  static v8::Local<v8::Value> NewInstance (size_t capacity);
+  CryptoSignVerifyCacheWrap ();
+  ~CryptoSignVerifyCacheWrap ();
+
+private:
+  static NAN_METHOD(New);
+  static NAN_METHOD(VerifyDetached);
+  static NAN_METHOD(Stats);
+  static NAN_METHOD(Clear);
+};
+
+#endif
@@ -0,0 +1,98 @@
+#include <nan.h>
+#include <atomic>
+#include <vector>
+#include "macros.h"
+#include "threadpool_slices.h"
+
+#include "../libsodium/src/libsodium/include/sodium.h"
+
+// tuples are handed out in batches that are a multiple of 8, so every byte of
+// the results bitmap is written by exactly one thread
+#define CRYPTO_SIGN_VERIFY_MANY_BATCH 64
+
+struct crypto_sign_verify_detached_many_tuple {
+  const unsigned char *signature;
+  const unsigned char *message;
+  unsigned long long message_length;
+  const unsigned char *public_key;
+};
+
+struct crypto_sign_verify_detached_many_job {
+  std::vector<crypto_sign_verify_detached_many_tuple> tuples;
+  // NULL when the caller only wants to know if all signatures are valid,
+  // in which case verification stops at the first invalid one
+  unsigned char *results;
+  std::atomic<size_t> next;
+  std::atomic<bool> invalid;
+  // only touched on the main thread
+  size_t pending;
+  Nan::Callback *callback;
+  Nan::Persistent<v8::Array> buffers;
+
+  ~crypto_sign_verify_detached_many_job () {
+    buffers.Reset();
+    delete callback;
+  }
+};
+
+static inline size_t crypto_sign_verify_detached_many_slices (size_t tuples) {
+  return threadpool_slices((tuples + CRYPTO_SIGN_VERIFY_MANY_BATCH - 1) / CRYPTO_SIGN_VERIFY_MANY_BATCH);
+}
+
+// one slice of a job. Every slice pulls batches off the shared job until it
+// is drained and the last one to complete calls back into javascript
+class CryptoSignVerifyDetachedManyAsync : public Nan::AsyncWorker {
+ public:
+  CryptoSignVerifyDetachedManyAsync(crypto_sign_verify_detached_many_job *job)
+    : Nan::AsyncWorker(NULL, "sodium-native:crypto_sign_verify_detached_many_async"), job(job) {}
+
+  void Execute () {
+    size_t length = job->tuples.size();
+    unsigned char *results = job->results;
+
+    while (true) {
+      if (results == NULL && job->invalid.load(std::memory_order_relaxed)) return;
+
+      size_t start = job->next.fetch_add(CRYPTO_SIGN_VERIFY_MANY_BATCH, std::memory_order_relaxed);
+      if (start >= length) return;
+
+      size_t end = start + CRYPTO_SIGN_VERIFY_MANY_BATCH;
+      if (end > length) end = length;
+
+      unsigned char byte = 0;
+
+      for (size_t i = start; i < end; i++) {
+        crypto_sign_verify_detached_many_tuple *t = &(job->tuples[i]);
+
+        if (crypto_sign_verify_detached(t->signature, t->message, t->message_length, t->public_key) == 0) {
+          byte |= 1 << (i & 7);
+        } else {
+          job->invalid.store(true, std::memory_order_relaxed);
+          if (results == NULL) return;
+        }
+
+        if (results != NULL && ((i & 7) == 7 || i + 1 == end)) {
+          results[i >> 3] = byte;
+          byte = 0;
+        }
+      }
+    }
+  }
+
+  void HandleOKCallback () {
+    if (--(job->pending) > 0) return;
+
+    Nan::HandleScope scope;
+
+    v8::Local<v8::Value> argv[] = {
+        Nan::Null(),
+        job->invalid.load() ? Nan::False() : Nan::True()
+    };
+
+    job->callback->Call(2, argv, async_resource);
+    delete job;
+  }
+
+ private:
+  crypto_sign_verify_detached_many_job *job;
+};
@@ -0,0 +1,61 @@
+#include "crypto_sign_verify_wrap.h"
+#include "macros.h"
+#include "per_isolate.h"
+
+static thread_local Nan::Persistent<v8::FunctionTemplate> crypto_sign_verify_constructor;
+
+CryptoSignVerifyWrap::CryptoSignVerifyWrap () {}
+
+CryptoSignVerifyWrap::~CryptoSignVerifyWrap () {}
+
+NAN_METHOD(CryptoSignVerifyWrap::New) {
+  CryptoSignVerifyWrap* obj = new CryptoSignVerifyWrap();
+  obj->Wrap(info.This());
+  info.GetReturnValue().Set(info.This());
+}
+
+NAN_METHOD(CryptoSignVerifyWrap::VerifyDetached) {
+  CryptoSignVerifyWrap *self = Nan::ObjectWrap::Unwrap<CryptoSignVerifyWrap>(info.This());
+  ASSERT_BUFFER_MIN_LENGTH(info[0], signature, crypto_sign_BYTES, crypto_sign_bytes())
+  ASSERT_BUFFER(info[1], message)
+
+  CALL_SODIUM_BOOL(crypto_sign_prepared_verify_detached(CDATA(signature), CDATA(message), CLENGTH(message), &(self->key)))
+}
+
+NAN_METHOD(CryptoSignVerifyWrap::Open) {
+  CryptoSignVerifyWrap *self = Nan::ObjectWrap::Unwrap<CryptoSignVerifyWrap>(info.This());
+  ASSERT_BUFFER_MIN_LENGTH(info[1], signed_message, crypto_sign_BYTES, crypto_sign_bytes())
+  ASSERT_BUFFER_MIN_LENGTH(info[0], message,
+    `signedMessage.length - crypto_sign_BYTES`,
+    signed_message_length - crypto_sign_bytes())
+
+  unsigned long long message_length_dummy;
+
+  CALL_SODIUM_BOOL(crypto_sign_prepared_open(CDATA(message), &message_length_dummy, CDATA(signed_message), signed_message_length, &(self->key)))
+}
+
+void CryptoSignVerifyWrap::Init () {
+  v8::Local<v8::FunctionTemplate> tpl = Nan::New<v8::FunctionTemplate>(CryptoSignVerifyWrap::New);
+  per_isolate_constructor_set(&crypto_sign_verify_constructor, tpl);
+  tpl->SetClassName(Nan::New("CryptoSignVerifyWrap").ToLocalChecked());
+  tpl->InstanceTemplate()->SetInternalFieldCount(1);
+
+  STATS_PROTOTYPE_METHOD(tpl, "crypto_sign_verify_instance", "verifyDetached", CryptoSignVerifyWrap::VerifyDetached)
+  STATS_PROTOTYPE_METHOD(tpl, "crypto_sign_verify_instance", "open", CryptoSignVerifyWrap::Open)
+}
+
+v8::Local<v8::Value> CryptoSignVerifyWrap::NewInstance (unsigned char *public_key) {
+  Nan::EscapableHandleScope scope;
+
+  if (crypto_sign_verify_constructor.IsEmpty()) CryptoSignVerifyWrap::Init();
+
+  v8::Local<v8::Object> instance;
+
+  v8::Local<v8::FunctionTemplate> constructorHandle = Nan::New<v8::FunctionTemplate>(crypto_sign_verify_constructor);
+  instance = Nan::NewInstance(Nan::GetFunction(constructorHandle).ToLocalChecked()).ToLocalChecked();
+
+  CryptoSignVerifyWrap *self = Nan::ObjectWrap::Unwrap<CryptoSignVerifyWrap>(instance);
+  crypto_sign_prepared_key_init(&(self->key), public_key);
+
+  return scope.Escape(instance);
+}
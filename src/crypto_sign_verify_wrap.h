@@ -0,0 +1,23 @@
+#ifndef CRYPTO_SIGN_VERIFY_WRAP_H
+#define CRYPTO_SIGN_VERIFY_WRAP_H
+
+#include <nan.h>
+#include "../libsodium/src/libsodium/include/sodium.h"
+#include "crypto_sign_prepared.h"
+
+class CryptoSignVerifyWrap : public Nan::ObjectWrap {
+public:
+  static void Init ();
+  static v8::Local<v8::Value> NewInstance (unsigned char *public_key);
+  CryptoSignVerifyWrap ();
+  ~CryptoSignVerifyWrap ();
+
+private:
+  crypto_sign_prepared_key key;
+
+  static NAN_METHOD(New);
+  static NAN_METHOD(VerifyDetached);
+  static NAN_METHOD(Open);
+};
+
+#endif
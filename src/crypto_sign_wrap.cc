@@ -0,0 +1,102 @@
+#include "crypto_sign_wrap.h"
+#include "macros.h"
+#include "per_isolate.h"
+
+static thread_local Nan::Persistent<v8::FunctionTemplate> crypto_sign_constructor;
+
+CryptoSignWrap::CryptoSignWrap () {
+  key = (crypto_sign_expanded_key *) sodium_malloc(sizeof(crypto_sign_expanded_key));
+}
+
+CryptoSignWrap::~CryptoSignWrap () {
+  if (key != NULL) sodium_free(key);
+}
+
+NAN_METHOD(CryptoSignWrap::New) {
+  CryptoSignWrap* obj = new CryptoSignWrap();
+  obj->Wrap(info.This());
+  info.GetReturnValue().Set(info.This());
+}
+
+NAN_METHOD(CryptoSignWrap::Sign) {
+  CryptoSignWrap *self = Nan::ObjectWrap::Unwrap<CryptoSignWrap>(info.This());
+  ASSERT_BUFFER_SET_LENGTH(info[1], message)
+  ASSERT_BUFFER_MIN_LENGTH(info[0], signed_message,
+    `message.length + crypto_sign_BYTES`,
+    message_length + crypto_sign_bytes())
+
+  CALL_SODIUM(crypto_sign_expanded(CDATA(signed_message), CDATA(message), message_length, self->key))
+}
+
+NAN_METHOD(CryptoSignWrap::SignDetached) {
+  CryptoSignWrap *self = Nan::ObjectWrap::Unwrap<CryptoSignWrap>(info.This());
+  ASSERT_BUFFER_MIN_LENGTH(info[0], signature, crypto_sign_BYTES, crypto_sign_bytes())
+  ASSERT_BUFFER(info[1], message)
+
+  CALL_SODIUM(crypto_sign_expanded_detached(CDATA(signature), CDATA(message), CLENGTH(message), self->key))
+}
+
+// (signatures, messages), signature i is written at i * crypto_sign_BYTES
+NAN_METHOD(CryptoSignWrap::SignBatch) {
+  CryptoSignWrap *self = Nan::ObjectWrap::Unwrap<CryptoSignWrap>(info.This());
+
+  if (!info[1]->IsArray()) {
+    Nan::ThrowError("messages must be an array of buffers");
+    return;
+  }
+
+  v8::Local<v8::Array> messages = info[1].As<v8::Array>();
+  uint32_t count = messages->Length();
+
+  ASSERT_BUFFER_MIN_LENGTH(info[0], signatures,
+    `messages.length * crypto_sign_BYTES`,
+    (unsigned long long) count * crypto_sign_bytes())
+
+  for (uint32_t i = 0; i < count; i++) {
+    if (!IS_BUFFER_SOURCE(Nan::Get(messages, i).ToLocalChecked())) {
+      Nan::ThrowError("messages must be an array of buffers");
+      return;
+    }
+  }
+
+  unsigned char *out = CDATA(signatures);
+
+  for (uint32_t i = 0; i < count; i++) {
+    v8::Local<v8::Value> message = Nan::Get(messages, i).ToLocalChecked();
+    if (crypto_sign_expanded_detached(out + i * crypto_sign_BYTES, CDATA(message), CLENGTH(message), self->key) != 0) {
+      Nan::ThrowError(ERRNO_EXCEPTION(errno));
+      return;
+    }
+  }
+}
+
+void CryptoSignWrap::Init () {
+  v8::Local<v8::FunctionTemplate> tpl = Nan::New<v8::FunctionTemplate>(CryptoSignWrap::New);
+  per_isolate_constructor_set(&crypto_sign_constructor, tpl);
+  tpl->SetClassName(Nan::New("CryptoSignWrap").ToLocalChecked());
+  tpl->InstanceTemplate()->SetInternalFieldCount(1);
+
+  STATS_PROTOTYPE_METHOD(tpl, "crypto_sign_instance", "sign", CryptoSignWrap::Sign)
+  STATS_PROTOTYPE_METHOD(tpl, "crypto_sign_instance", "signDetached", CryptoSignWrap::SignDetached)
+  STATS_PROTOTYPE_METHOD(tpl, "crypto_sign_instance", "signBatch", CryptoSignWrap::SignBatch)
+}
+
+// returns an empty handle if the secure allocation failed
+v8::Local<v8::Value> CryptoSignWrap::NewInstance (unsigned char *secret_key) {
+  Nan::EscapableHandleScope scope;
+
+  if (crypto_sign_constructor.IsEmpty()) CryptoSignWrap::Init();
+
+  v8::Local<v8::Object> instance;
+
+  v8::Local<v8::FunctionTemplate> constructorHandle = Nan::New<v8::FunctionTemplate>(crypto_sign_constructor);
+  instance = Nan::NewInstance(Nan::GetFunction(constructorHandle).ToLocalChecked()).ToLocalChecked();
+
+  CryptoSignWrap *self = Nan::ObjectWrap::Unwrap<CryptoSignWrap>(instance);
+  if (self->key == NULL) return v8::Local<v8::Value>();
+
+  crypto_sign_expanded_key_init(self->key, secret_key);
+  sodium_mprotect_readonly(self->key);
+
+  return scope.Escape(instance);
+}
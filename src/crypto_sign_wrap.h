@@ -0,0 +1,25 @@
+#ifndef CRYPTO_SIGN_WRAP_H
+#define CRYPTO_SIGN_WRAP_H
+
+#include <nan.h>
+#include "../libsodium/src/libsodium/include/sodium.h"
+#include "crypto_sign_expanded.h"
+
+class CryptoSignWrap : public Nan::ObjectWrap {
+public:
+  static void Init ();
+  static v8::Local<v8::Value> NewInstance (unsigned char *secret_key);
+  CryptoSignWrap ();
+  ~CryptoSignWrap ();
+
+private:
+  // in sodium_malloc memory, read-only once initialised
+  crypto_sign_expanded_key *key;
+
+  static NAN_METHOD(New);
+  static NAN_METHOD(Sign);
+  static NAN_METHOD(SignDetached);
+  static NAN_METHOD(SignBatch);
+};
+
+#endif
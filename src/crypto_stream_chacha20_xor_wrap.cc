@@ -1,7 +1,8 @@
 #include "crypto_stream_chacha20_xor_wrap.h"
 #include "macros.h"
+#include "per_isolate.h"
 
-static Nan::Persistent<v8::FunctionTemplate> crypto_stream_chacha20_xor_constructor;
+static thread_local Nan::Persistent<v8::FunctionTemplate> crypto_stream_chacha20_xor_constructor;
 
 static void crypto_stream_chacha20_xor_wrap_init (CryptoStreamChacha20XorWrap *self, unsigned char *nonce, unsigned char *key) {
   self->remainder = 0;
@@ -82,17 +83,19 @@ NAN_METHOD(CryptoStreamChacha20XorWrap::Final) {
 
 void CryptoStreamChacha20XorWrap::Init () {
   v8::Local<v8::FunctionTemplate> tpl = Nan::New<v8::FunctionTemplate>(CryptoStreamChacha20XorWrap::New);
-  crypto_stream_chacha20_xor_constructor.Reset(tpl);
+  per_isolate_constructor_set(&crypto_stream_chacha20_xor_constructor, tpl);
   tpl->SetClassName(Nan::New("CryptoStreamChacha20XorWrap").ToLocalChecked());
   tpl->InstanceTemplate()->SetInternalFieldCount(1);
 
-  Nan::SetPrototypeMethod(tpl, "update", CryptoStreamChacha20XorWrap::Update);
-  Nan::SetPrototypeMethod(tpl, "final", CryptoStreamChacha20XorWrap::Final);
+  STATS_PROTOTYPE_METHOD(tpl, "crypto_stream_chacha20_xor_instance", "update", CryptoStreamChacha20XorWrap::Update)
+  STATS_PROTOTYPE_METHOD(tpl, "crypto_stream_chacha20_xor_instance", "final", CryptoStreamChacha20XorWrap::Final)
 }
 
 v8::Local<v8::Value> CryptoStreamChacha20XorWrap::NewInstance (unsigned char *nonce, unsigned char *key) {
   Nan::EscapableHandleScope scope;
 
+  if (crypto_stream_chacha20_xor_constructor.IsEmpty()) CryptoStreamChacha20XorWrap::Init();
+
   v8::Local<v8::Object> instance;
 
   v8::Local<v8::FunctionTemplate> constructorHandle = Nan::New<v8::FunctionTemplate>(crypto_stream_chacha20_xor_constructor);
@@ -1,7 +1,8 @@
 #include "crypto_stream_xor_wrap.h"
 #include "macros.h"
+#include "per_isolate.h"
 
-static Nan::Persistent<v8::FunctionTemplate> crypto_stream_xor_constructor;
+static thread_local Nan::Persistent<v8::FunctionTemplate> crypto_stream_xor_constructor;
 
 static void crypto_stream_xor_wrap_init (CryptoStreamXorWrap *self, unsigned char *nonce, unsigned char *key) {
   self->remainder = 0;
@@ -82,17 +83,19 @@ NAN_METHOD(CryptoStreamXorWrap::Final) {
 
 void CryptoStreamXorWrap::Init () {
   v8::Local<v8::FunctionTemplate> tpl = Nan::New<v8::FunctionTemplate>(CryptoStreamXorWrap::New);
-  crypto_stream_xor_constructor.Reset(tpl);
+  per_isolate_constructor_set(&crypto_stream_xor_constructor, tpl);
   tpl->SetClassName(Nan::New("CryptoStreamXorWrap").ToLocalChecked());
   tpl->InstanceTemplate()->SetInternalFieldCount(1);
 
-  Nan::SetPrototypeMethod(tpl, "update", CryptoStreamXorWrap::Update);
-  Nan::SetPrototypeMethod(tpl, "final", CryptoStreamXorWrap::Final);
+  STATS_PROTOTYPE_METHOD(tpl, "crypto_stream_xor_instance", "update", CryptoStreamXorWrap::Update)
+  STATS_PROTOTYPE_METHOD(tpl, "crypto_stream_xor_instance", "final", CryptoStreamXorWrap::Final)
 }
 
 v8::Local<v8::Value> CryptoStreamXorWrap::NewInstance (unsigned char *nonce, unsigned char *key) {
   Nan::EscapableHandleScope scope;
 
+  if (crypto_stream_xor_constructor.IsEmpty()) CryptoStreamXorWrap::Init();
+
   v8::Local<v8::Object> instance;
 
   v8::Local<v8::FunctionTemplate> constructorHandle = Nan::New<v8::FunctionTemplate>(crypto_stream_xor_constructor);
@@ -0,0 +1,944 @@
+#include "ed25519.h"
+#include <string.h>
+#include "../libsodium/src/libsodium/include/sodium.h"
+
+#if defined(_MSC_VER) && defined(_M_X64)
+#include <intrin.h>
+#endif
+
+// 64 x 64 -> 128 bit products, natively where the compiler has a 128 bit type
+
+#if defined(__SIZEOF_INT128__)
+
+typedef unsigned __int128 u128;
+
+static inline u128 mul64 (uint64_t a, uint64_t b) {
+  return (u128) a * b;
+}
+
+static inline uint64_t lo64 (u128 a) {
+  return (uint64_t) a;
+}
+
+static inline uint64_t shr51 (u128 a) {
+  return (uint64_t) (a >> 51);
+}
+
+#else
+
+struct u128 {
+  uint64_t lo;
+  uint64_t hi;
+};
+
+static inline u128 mul64 (uint64_t a, uint64_t b) {
+  u128 r;
+#if defined(_MSC_VER) && defined(_M_X64)
+  r.lo = _umul128(a, b, &r.hi);
+#else
+  uint64_t a0 = (uint32_t) a, a1 = a >> 32;
+  uint64_t b0 = (uint32_t) b, b1 = b >> 32;
+  uint64_t p00 = a0 * b0, p01 = a0 * b1, p10 = a1 * b0, p11 = a1 * b1;
+  uint64_t mid = (p00 >> 32) + (uint32_t) p01 + (uint32_t) p10;
+  r.lo = (mid << 32) | (uint32_t) p00;
+  r.hi = p11 + (p01 >> 32) + (p10 >> 32) + (mid >> 32);
+#endif
+  return r;
+}
+
+static inline u128 operator+ (u128 a, u128 b) {
+  u128 r;
+  r.lo = a.lo + b.lo;
+  r.hi = a.hi + b.hi + (r.lo < a.lo);
+  return r;
+}
+
+static inline u128 operator+ (u128 a, uint64_t b) {
+  u128 r;
+  r.lo = a.lo + b;
+  r.hi = a.hi + (r.lo < a.lo);
+  return r;
+}
+
+static inline uint64_t lo64 (u128 a) {
+  return a.lo;
+}
+
+static inline uint64_t shr51 (u128 a) {
+  return (a.lo >> 51) | (a.hi << 13);
+}
+
+#endif
+
+#define MASK51 ((((uint64_t) 1) << 51) - 1)
+
+// Limb bounds: mul, sq, frombytes and the carried operand of sub give limbs
+// below 2^52. add does not carry, sub adds 2p, so every input to mul and sq
+// stays below 2^54 as long as add and sub are not chained without a mul in
+// between, which the formulas below never do.
+
+void ed25519_fe_0 (ed25519_fe h) {
+  memset(h, 0, sizeof(ed25519_fe));
+}
+
+void ed25519_fe_1 (ed25519_fe h) {
+  memset(h, 0, sizeof(ed25519_fe));
+  h[0] = 1;
+}
+
+void ed25519_fe_copy (ed25519_fe h, const ed25519_fe f) {
+  memmove(h, f, sizeof(ed25519_fe));
+}
+
+void ed25519_fe_add (ed25519_fe h, const ed25519_fe f, const ed25519_fe g) {
+  for (int i = 0; i < 5; i++) h[i] = f[i] + g[i];
+}
+
+static inline void fe_carry (uint64_t t[5]) {
+  t[1] += t[0] >> 51;
+  t[0] &= MASK51;
+  t[2] += t[1] >> 51;
+  t[1] &= MASK51;
+  t[3] += t[2] >> 51;
+  t[2] &= MASK51;
+  t[4] += t[3] >> 51;
+  t[3] &= MASK51;
+  t[0] += 19 * (t[4] >> 51);
+  t[4] &= MASK51;
+}
+
+void ed25519_fe_sub (ed25519_fe h, const ed25519_fe f, const ed25519_fe g) {
+  uint64_t t[5] = { g[0], g[1], g[2], g[3], g[4] };
+  fe_carry(t);
+
+  // + 2p
+  h[0] = (f[0] + 0xfffffffffffdaULL) - t[0];
+  h[1] = (f[1] + 0xffffffffffffeULL) - t[1];
+  h[2] = (f[2] + 0xffffffffffffeULL) - t[2];
+  h[3] = (f[3] + 0xffffffffffffeULL) - t[3];
+  h[4] = (f[4] + 0xffffffffffffeULL) - t[4];
+}
+
+void ed25519_fe_neg (ed25519_fe h, const ed25519_fe f) {
+  ed25519_fe zero;
+  ed25519_fe_0(zero);
+  ed25519_fe_sub(h, zero, f);
+}
+
+static inline void fe_reduce_wide (ed25519_fe h, u128 r0, u128 r1, u128 r2, u128 r3, u128 r4) {
+  uint64_t h0, h1, h2, h3, h4;
+
+  r1 = r1 + shr51(r0);
+  h0 = lo64(r0) & MASK51;
+  r2 = r2 + shr51(r1);
+  h1 = lo64(r1) & MASK51;
+  r3 = r3 + shr51(r2);
+  h2 = lo64(r2) & MASK51;
+  r4 = r4 + shr51(r3);
+  h3 = lo64(r3) & MASK51;
+  h4 = lo64(r4) & MASK51;
+
+  u128 t = mul64(shr51(r4), 19) + h0;
+  h0 = lo64(t) & MASK51;
+  h1 += shr51(t);
+
+  h[0] = h0;
+  h[1] = h1;
+  h[2] = h2;
+  h[3] = h3;
+  h[4] = h4;
+}
+
+void ed25519_fe_mul (ed25519_fe h, const ed25519_fe f, const ed25519_fe g) {
+  uint64_t f0 = f[0], f1 = f[1], f2 = f[2], f3 = f[3], f4 = f[4];
+  uint64_t g0 = g[0], g1 = g[1], g2 = g[2], g3 = g[3], g4 = g[4];
+  uint64_t g1_19 = 19 * g1, g2_19 = 19 * g2, g3_19 = 19 * g3, g4_19 = 19 * g4;
+
+  u128 r0 = mul64(f0, g0) + mul64(f1, g4_19) + mul64(f2, g3_19) + mul64(f3, g2_19) + mul64(f4, g1_19);
+  u128 r1 = mul64(f0, g1) + mul64(f1, g0) + mul64(f2, g4_19) + mul64(f3, g3_19) + mul64(f4, g2_19);
+  u128 r2 = mul64(f0, g2) + mul64(f1, g1) + mul64(f2, g0) + mul64(f3, g4_19) + mul64(f4, g3_19);
+  u128 r3 = mul64(f0, g3) + mul64(f1, g2) + mul64(f2, g1) + mul64(f3, g0) + mul64(f4, g4_19);
+  u128 r4 = mul64(f0, g4) + mul64(f1, g3) + mul64(f2, g2) + mul64(f3, g1) + mul64(f4, g0);
+
+  fe_reduce_wide(h, r0, r1, r2, r3, r4);
+}
+
+void ed25519_fe_sq (ed25519_fe h, const ed25519_fe f) {
+  uint64_t f0 = f[0], f1 = f[1], f2 = f[2], f3 = f[3], f4 = f[4];
+  uint64_t f0_2 = 2 * f0, f1_2 = 2 * f1;
+  uint64_t f1_38 = 38 * f1, f2_38 = 38 * f2, f3_38 = 38 * f3;
+  uint64_t f3_19 = 19 * f3, f4_19 = 19 * f4;
+
+  u128 r0 = mul64(f0, f0) + mul64(f1_38, f4) + mul64(f2_38, f3);
+  u128 r1 = mul64(f0_2, f1) + mul64(f2_38, f4) + mul64(f3_19, f3);
+  u128 r2 = mul64(f0_2, f2) + mul64(f1, f1) + mul64(f3_38, f4);
+  u128 r3 = mul64(f0_2, f3) + mul64(f1_2, f2) + mul64(f4_19, f4);
+  u128 r4 = mul64(f0_2, f4) + mul64(f1_2, f3) + mul64(f2, f2);
+
+  fe_reduce_wide(h, r0, r1, r2, r3, r4);
+}
+
+static void fe_sqn (ed25519_fe h, const ed25519_fe f, int n) {
+  ed25519_fe_sq(h, f);
+  for (int i = 1; i < n; i++) ed25519_fe_sq(h, h);
+}
+
+// z^(2^250 - 1) and z^11, shared by invert and pow22523
+static void fe_pow2_250 (ed25519_fe t250, ed25519_fe z11, const ed25519_fe z) {
+  ed25519_fe t0, t1, t2;
+
+  ed25519_fe_sq(t0, z);            // 2
+  fe_sqn(t1, t0, 2);               // 8
+  ed25519_fe_mul(t1, z, t1);       // 9
+  ed25519_fe_mul(z11, t0, t1);     // 11
+  ed25519_fe_sq(t0, z11);          // 22
+  ed25519_fe_mul(t0, t1, t0);      // 2^5 - 1
+  fe_sqn(t1, t0, 5);
+  ed25519_fe_mul(t0, t1, t0);      // 2^10 - 1
+  fe_sqn(t1, t0, 10);
+  ed25519_fe_mul(t1, t1, t0);      // 2^20 - 1
+  fe_sqn(t2, t1, 20);
+  ed25519_fe_mul(t1, t2, t1);      // 2^40 - 1
+  fe_sqn(t1, t1, 10);
+  ed25519_fe_mul(t0, t1, t0);      // 2^50 - 1
+  fe_sqn(t1, t0, 50);
+  ed25519_fe_mul(t1, t1, t0);      // 2^100 - 1
+  fe_sqn(t2, t1, 100);
+  ed25519_fe_mul(t1, t2, t1);      // 2^200 - 1
+  fe_sqn(t1, t1, 50);
+  ed25519_fe_mul(t250, t1, t0);    // 2^250 - 1
+}
+
+// z^(p - 2) = z^(2^255 - 21)
+void ed25519_fe_invert (ed25519_fe out, const ed25519_fe z) {
+  ed25519_fe t, z11;
+  fe_pow2_250(t, z11, z);
+  fe_sqn(t, t, 5);
+  ed25519_fe_mul(out, t, z11);
+}
+
+// z^((p - 5) / 8) = z^(2^252 - 3)
+static void fe_pow22523 (ed25519_fe out, const ed25519_fe z) {
+  ed25519_fe t, z11;
+  fe_pow2_250(t, z11, z);
+  fe_sqn(t, t, 2);
+  ed25519_fe_mul(out, t, z);
+}
+
+// z^((p - 1) / 2) = z^(2^254 - 10), 1 for squares, -1 for non-squares and 0 for 0
+void ed25519_fe_chi (ed25519_fe out, const ed25519_fe z) {
+  ed25519_fe t, z2, z11;
+  fe_pow2_250(t, z11, z);
+  fe_sqn(t, t, 4);
+  ed25519_fe_sq(z2, z);
+  ed25519_fe_sq(z11, z2);
+  ed25519_fe_mul(z11, z11, z2);     // 6
+  ed25519_fe_mul(out, t, z11);
+}
+
+static inline uint64_t load64_le (const unsigned char *s) {
+  uint64_t r = 0;
+  for (int i = 7; i >= 0; i--) r = (r << 8) | s[i];
+  return r;
+}
+
+static inline void store64_le (unsigned char *s, uint64_t v) {
+  for (int i = 0; i < 8; i++) s[i] = (unsigned char) (v >> (8 * i));
+}
+
+// ignores the top bit
+void ed25519_fe_frombytes (ed25519_fe h, const unsigned char *s) {
+  uint64_t w0 = load64_le(s), w1 = load64_le(s + 8), w2 = load64_le(s + 16), w3 = load64_le(s + 24);
+
+  h[0] = w0 & MASK51;
+  h[1] = ((w0 >> 51) | (w1 << 13)) & MASK51;
+  h[2] = ((w1 >> 38) | (w2 << 26)) & MASK51;
+  h[3] = ((w2 >> 25) | (w3 << 39)) & MASK51;
+  h[4] = (w3 >> 12) & MASK51;
+}
+
+void ed25519_fe_tobytes (unsigned char *s, const ed25519_fe h) {
+  uint64_t t[5] = { h[0], h[1], h[2], h[3], h[4] };
+
+  fe_carry(t);
+  fe_carry(t);
+
+  // t < 2p now, subtract p if t + 19 overflows 2^255
+  uint64_t q = (t[0] + 19) >> 51;
+  q = (t[1] + q) >> 51;
+  q = (t[2] + q) >> 51;
+  q = (t[3] + q) >> 51;
+  q = (t[4] + q) >> 51;
+
+  t[0] += 19 * q;
+  t[1] += t[0] >> 51;
+  t[0] &= MASK51;
+  t[2] += t[1] >> 51;
+  t[1] &= MASK51;
+  t[3] += t[2] >> 51;
+  t[2] &= MASK51;
+  t[4] += t[3] >> 51;
+  t[3] &= MASK51;
+  t[4] &= MASK51;
+
+  store64_le(s, t[0] | (t[1] << 51));
+  store64_le(s + 8, (t[1] >> 13) | (t[2] << 38));
+  store64_le(s + 16, (t[2] >> 26) | (t[3] << 25));
+  store64_le(s + 24, (t[3] >> 39) | (t[4] << 12));
+}
+
+int ed25519_fe_isnegative (const ed25519_fe f) {
+  unsigned char s[32];
+  ed25519_fe_tobytes(s, f);
+  return s[0] & 1;
+}
+
+int ed25519_fe_iszero (const ed25519_fe f) {
+  unsigned char s[32];
+  unsigned char d = 0;
+  ed25519_fe_tobytes(s, f);
+  for (int i = 0; i < 32; i++) d |= s[i];
+  return d == 0;
+}
+
+void ed25519_fe_cmov (ed25519_fe f, const ed25519_fe g, unsigned int b) {
+  uint64_t mask = (uint64_t) 0 - (uint64_t) b;
+  for (int i = 0; i < 5; i++) f[i] ^= mask & (f[i] ^ g[i]);
+}
+
+void ed25519_fe_batch_invert (ed25519_fe *z, ed25519_fe *scratch, size_t count) {
+  if (count == 0) return;
+
+  ed25519_fe acc, inv, t, one;
+  ed25519_fe_1(one);
+  ed25519_fe_1(acc);
+
+  // scratch[i] = product of the non-zero z[0..i), zeros are skipped as 1
+  for (size_t i = 0; i < count; i++) {
+    ed25519_fe_copy(scratch[i], acc);
+    int zero = ed25519_fe_iszero(z[i]);
+    ed25519_fe_mul(t, acc, z[i]);
+    ed25519_fe_cmov(t, acc, zero);
+    ed25519_fe_copy(acc, t);
+  }
+
+  ed25519_fe_invert(inv, acc);
+
+  for (size_t i = count; i-- > 0;) {
+    int zero = ed25519_fe_iszero(z[i]);
+    ed25519_fe_mul(t, inv, scratch[i]);
+    ed25519_fe_mul(acc, inv, z[i]);
+    ed25519_fe_cmov(acc, inv, zero);
+    ed25519_fe_copy(inv, acc);
+    ed25519_fe_cmov(z[i], t, 1 - zero);
+  }
+}
+
+// constants, derived once instead of kept as tables
+
+struct ed25519_constants {
+  ed25519_fe d;
+  ed25519_fe d2;
+  ed25519_fe sqrtm1;
+  ed25519_ge_p3 base;
+  ed25519_ge_precomp base_odd[8];
+  ed25519_ge_precomp base_odd_128[8];
+};
+
+static int ge_frombytes_with (ed25519_ge_p3 *h, const unsigned char *s, const ed25519_fe d, const ed25519_fe sqrtm1);
+
+static ed25519_constants * constants_create () {
+  static ed25519_constants c;
+  ed25519_fe num, den;
+
+  // d = -121665 / 121666
+  ed25519_fe_0(num);
+  num[0] = 121665;
+  ed25519_fe_neg(num, num);
+  ed25519_fe_0(den);
+  den[0] = 121666;
+  ed25519_fe_invert(den, den);
+  ed25519_fe_mul(c.d, num, den);
+  ed25519_fe_add(c.d2, c.d, c.d);
+
+  // sqrt(-1) = 2^((p - 1) / 4) = (2^((p - 5) / 8))^2 * 2
+  ed25519_fe two;
+  ed25519_fe_0(two);
+  two[0] = 2;
+  fe_pow22523(c.sqrtm1, two);
+  ed25519_fe_sq(c.sqrtm1, c.sqrtm1);
+  ed25519_fe_mul(c.sqrtm1, c.sqrtm1, two);
+
+  // y = 4/5, x positive
+  unsigned char base[32];
+  memset(base, 0x66, sizeof(base));
+  base[0] = 0x58;
+  ge_frombytes_with(&c.base, base, c.d, c.sqrtm1);
+
+  return &c;
+}
+
+static const ed25519_constants * constants () {
+  static const ed25519_constants *c = constants_create();
+  return c;
+}
+
+// base point tables need the constants themselves, so they come second
+static const ed25519_constants * base_tables_create () {
+  ed25519_constants *c = (ed25519_constants *) constants();
+  ed25519_ge_p3 odd[16];
+  ed25519_ge_p3 b128;
+  ed25519_ge_p1p1 t;
+  ed25519_fe scratch[32];
+
+  memcpy(&b128, &c->base, sizeof(b128));
+  for (int i = 0; i < 128; i++) {
+    ed25519_ge_p3_dbl(&t, &b128);
+    ed25519_ge_p1p1_to_p3(&b128, &t);
+  }
+
+  for (int k = 0; k < 2; k++) {
+    const ed25519_ge_p3 *p = k == 0 ? &c->base : &b128;
+    ed25519_ge_cached two;
+    ed25519_ge_p3 p2;
+
+    ed25519_ge_p3_dbl(&t, p);
+    ed25519_ge_p1p1_to_p3(&p2, &t);
+    ed25519_ge_p3_to_cached(&two, &p2);
+
+    memcpy(&odd[8 * k], p, sizeof(ed25519_ge_p3));
+    for (int i = 1; i < 8; i++) {
+      ed25519_ge_add(&t, &odd[8 * k + i - 1], &two);
+      ed25519_ge_p1p1_to_p3(&odd[8 * k + i], &t);
+    }
+  }
+
+  ed25519_ge_p3_batch_to_precomp(c->base_odd, odd, scratch, 8);
+  ed25519_ge_p3_batch_to_precomp(c->base_odd_128, odd + 8, scratch, 8);
+
+  return c;
+}
+
+static const ed25519_constants * base_tables () {
+  static const ed25519_constants *c = base_tables_create();
+  return c;
+}
+
+const ed25519_ge_p3 * ed25519_ge_base () {
+  return &(constants()->base);
+}
+
+const ed25519_ge_precomp * ed25519_ge_base_odd () {
+  return base_tables()->base_odd;
+}
+
+const ed25519_ge_precomp * ed25519_ge_base_odd_128 () {
+  return base_tables()->base_odd_128;
+}
+
+// group
+
+void ed25519_ge_p3_0 (ed25519_ge_p3 *h) {
+  ed25519_fe_0(h->X);
+  ed25519_fe_1(h->Y);
+  ed25519_fe_1(h->Z);
+  ed25519_fe_0(h->T);
+}
+
+static void ge_p2_0 (ed25519_ge_p2 *h) {
+  ed25519_fe_0(h->X);
+  ed25519_fe_1(h->Y);
+  ed25519_fe_1(h->Z);
+}
+
+void ed25519_ge_p3_to_cached (ed25519_ge_cached *r, const ed25519_ge_p3 *p) {
+  ed25519_fe_add(r->YplusX, p->Y, p->X);
+  ed25519_fe_sub(r->YminusX, p->Y, p->X);
+  ed25519_fe_copy(r->Z, p->Z);
+  ed25519_fe_mul(r->T2d, p->T, constants()->d2);
+}
+
+void ed25519_ge_p3_to_p2 (ed25519_ge_p2 *r, const ed25519_ge_p3 *p) {
+  ed25519_fe_copy(r->X, p->X);
+  ed25519_fe_copy(r->Y, p->Y);
+  ed25519_fe_copy(r->Z, p->Z);
+}
+
+void ed25519_ge_p2_to_p3 (ed25519_ge_p3 *r, const ed25519_ge_p2 *p) {
+  ed25519_fe_mul(r->T, p->X, p->Y);
+  ed25519_fe_mul(r->X, p->X, p->Z);
+  ed25519_fe_mul(r->Y, p->Y, p->Z);
+  ed25519_fe_sq(r->Z, p->Z);
+}
+
+void ed25519_ge_p1p1_to_p2 (ed25519_ge_p2 *r, const ed25519_ge_p1p1 *p) {
+  ed25519_fe_mul(r->X, p->X, p->T);
+  ed25519_fe_mul(r->Y, p->Y, p->Z);
+  ed25519_fe_mul(r->Z, p->Z, p->T);
+}
+
+void ed25519_ge_p1p1_to_p3 (ed25519_ge_p3 *r, const ed25519_ge_p1p1 *p) {
+  ed25519_fe_mul(r->X, p->X, p->T);
+  ed25519_fe_mul(r->Y, p->Y, p->Z);
+  ed25519_fe_mul(r->Z, p->Z, p->T);
+  ed25519_fe_mul(r->T, p->X, p->Y);
+}
+
+void ed25519_ge_p2_dbl (ed25519_ge_p1p1 *r, const ed25519_ge_p2 *p) {
+  ed25519_fe t0;
+
+  ed25519_fe_sq(r->X, p->X);
+  ed25519_fe_sq(r->Z, p->Y);
+  ed25519_fe_sq(r->T, p->Z);
+  ed25519_fe_add(r->T, r->T, r->T);
+  ed25519_fe_add(r->Y, p->X, p->Y);
+  ed25519_fe_sq(t0, r->Y);
+  ed25519_fe_add(r->Y, r->Z, r->X);
+  ed25519_fe_sub(r->Z, r->Z, r->X);
+  ed25519_fe_sub(r->X, t0, r->Y);
+  ed25519_fe_sub(r->T, r->T, r->Z);
+}
+
+void ed25519_ge_p3_dbl (ed25519_ge_p1p1 *r, const ed25519_ge_p3 *p) {
+  ed25519_ge_p2 q;
+  ed25519_ge_p3_to_p2(&q, p);
+  ed25519_ge_p2_dbl(r, &q);
+}
+
+void ed25519_ge_add (ed25519_ge_p1p1 *r, const ed25519_ge_p3 *p, const ed25519_ge_cached *q) {
+  ed25519_fe t0;
+
+  ed25519_fe_add(r->X, p->Y, p->X);
+  ed25519_fe_sub(r->Y, p->Y, p->X);
+  ed25519_fe_mul(r->Z, r->X, q->YplusX);
+  ed25519_fe_mul(r->Y, r->Y, q->YminusX);
+  ed25519_fe_mul(r->T, q->T2d, p->T);
+  ed25519_fe_mul(r->X, p->Z, q->Z);
+  ed25519_fe_add(t0, r->X, r->X);
+  ed25519_fe_sub(r->X, r->Z, r->Y);
+  ed25519_fe_add(r->Y, r->Z, r->Y);
+  ed25519_fe_add(r->Z, t0, r->T);
+  ed25519_fe_sub(r->T, t0, r->T);
+}
+
+void ed25519_ge_sub (ed25519_ge_p1p1 *r, const ed25519_ge_p3 *p, const ed25519_ge_cached *q) {
+  ed25519_fe t0;
+
+  ed25519_fe_add(r->X, p->Y, p->X);
+  ed25519_fe_sub(r->Y, p->Y, p->X);
+  ed25519_fe_mul(r->Z, r->X, q->YminusX);
+  ed25519_fe_mul(r->Y, r->Y, q->YplusX);
+  ed25519_fe_mul(r->T, q->T2d, p->T);
+  ed25519_fe_mul(r->X, p->Z, q->Z);
+  ed25519_fe_add(t0, r->X, r->X);
+  ed25519_fe_sub(r->X, r->Z, r->Y);
+  ed25519_fe_add(r->Y, r->Z, r->Y);
+  ed25519_fe_sub(r->Z, t0, r->T);
+  ed25519_fe_add(r->T, t0, r->T);
+}
+
+void ed25519_ge_madd (ed25519_ge_p1p1 *r, const ed25519_ge_p3 *p, const ed25519_ge_precomp *q) {
+  ed25519_fe t0;
+
+  ed25519_fe_add(r->X, p->Y, p->X);
+  ed25519_fe_sub(r->Y, p->Y, p->X);
+  ed25519_fe_mul(r->Z, r->X, q->yplusx);
+  ed25519_fe_mul(r->Y, r->Y, q->yminusx);
+  ed25519_fe_mul(r->T, q->xy2d, p->T);
+  ed25519_fe_add(t0, p->Z, p->Z);
+  ed25519_fe_sub(r->X, r->Z, r->Y);
+  ed25519_fe_add(r->Y, r->Z, r->Y);
+  ed25519_fe_add(r->Z, t0, r->T);
+  ed25519_fe_sub(r->T, t0, r->T);
+}
+
+void ed25519_ge_msub (ed25519_ge_p1p1 *r, const ed25519_ge_p3 *p, const ed25519_ge_precomp *q) {
+  ed25519_fe t0;
+
+  ed25519_fe_add(r->X, p->Y, p->X);
+  ed25519_fe_sub(r->Y, p->Y, p->X);
+  ed25519_fe_mul(r->Z, r->X, q->yminusx);
+  ed25519_fe_mul(r->Y, r->Y, q->yplusx);
+  ed25519_fe_mul(r->T, q->xy2d, p->T);
+  ed25519_fe_add(t0, p->Z, p->Z);
+  ed25519_fe_sub(r->X, r->Z, r->Y);
+  ed25519_fe_add(r->Y, r->Z, r->Y);
+  ed25519_fe_sub(r->Z, t0, r->T);
+  ed25519_fe_add(r->T, t0, r->T);
+}
+
+void ed25519_ge_p3_add (ed25519_ge_p3 *r, const ed25519_ge_p3 *p, const ed25519_ge_p3 *q) {
+  ed25519_ge_cached c;
+  ed25519_ge_p1p1 t;
+  ed25519_ge_p3_to_cached(&c, q);
+  ed25519_ge_add(&t, p, &c);
+  ed25519_ge_p1p1_to_p3(r, &t);
+}
+
+void ed25519_ge_p3_sub (ed25519_ge_p3 *r, const ed25519_ge_p3 *p, const ed25519_ge_p3 *q) {
+  ed25519_ge_cached c;
+  ed25519_ge_p1p1 t;
+  ed25519_ge_p3_to_cached(&c, q);
+  ed25519_ge_sub(&t, p, &c);
+  ed25519_ge_p1p1_to_p3(r, &t);
+}
+
+static int ge_frombytes_with (ed25519_ge_p3 *h, const unsigned char *s, const ed25519_fe d, const ed25519_fe sqrtm1) {
+  ed25519_fe u, v, v3, vxx, check, x_sqrtm1, negx;
+
+  ed25519_fe_frombytes(h->Y, s);
+  ed25519_fe_1(h->Z);
+  ed25519_fe_sq(u, h->Y);
+  ed25519_fe_mul(v, u, d);
+  ed25519_fe_sub(u, u, h->Z);       // u = y^2 - 1
+  ed25519_fe_add(v, v, h->Z);       // v = d * y^2 + 1
+
+  ed25519_fe_sq(v3, v);
+  ed25519_fe_mul(v3, v3, v);        // v^3
+  ed25519_fe_sq(h->X, v3);
+  ed25519_fe_mul(h->X, h->X, v);
+  ed25519_fe_mul(h->X, h->X, u);    // u * v^7
+
+  fe_pow22523(h->X, h->X);          // (u * v^7)^((p - 5) / 8)
+  ed25519_fe_mul(h->X, h->X, v3);
+  ed25519_fe_mul(h->X, h->X, u);    // u * v^3 * (u * v^7)^((p - 5) / 8)
+
+  ed25519_fe_sq(vxx, h->X);
+  ed25519_fe_mul(vxx, vxx, v);
+  ed25519_fe_sub(check, vxx, u);    // v * x^2 - u
+  int has_m_root = ed25519_fe_iszero(check);
+  ed25519_fe_add(check, vxx, u);    // v * x^2 + u
+  int has_p_root = ed25519_fe_iszero(check);
+
+  // selected without branches, hash to curve decodes secret points
+  ed25519_fe_mul(x_sqrtm1, h->X, sqrtm1);
+  ed25519_fe_cmov(h->X, x_sqrtm1, 1 - has_m_root);
+
+  ed25519_fe_neg(negx, h->X);
+  ed25519_fe_cmov(h->X, negx, ed25519_fe_isnegative(h->X) ^ (s[31] >> 7));
+
+  ed25519_fe_mul(h->T, h->X, h->Y);
+  return (has_m_root | has_p_root) - 1;
+}
+
+int ed25519_ge_frombytes (ed25519_ge_p3 *h, const unsigned char *s) {
+  const ed25519_constants *c = constants();
+  return ge_frombytes_with(h, s, c->d, c->sqrtm1);
+}
+
+void ed25519_ge_p3_tobytes (unsigned char *s, const ed25519_ge_p3 *h) {
+  ed25519_fe recip, x, y;
+
+  ed25519_fe_invert(recip, h->Z);
+  ed25519_fe_mul(x, h->X, recip);
+  ed25519_fe_mul(y, h->Y, recip);
+  ed25519_fe_tobytes(s, y);
+  s[31] ^= ed25519_fe_isnegative(x) << 7;
+}
+
+void ed25519_ge_p3_batch_tobytes (unsigned char *s, const ed25519_ge_p3 *h, ed25519_fe *scratch, size_t count) {
+  ed25519_fe *z = scratch;
+  ed25519_fe x, y;
+
+  for (size_t i = 0; i < count; i++) ed25519_fe_copy(z[i], h[i].Z);
+  ed25519_fe_batch_invert(z, scratch + count, count);
+
+  for (size_t i = 0; i < count; i++) {
+    ed25519_fe_mul(x, h[i].X, z[i]);
+    ed25519_fe_mul(y, h[i].Y, z[i]);
+    ed25519_fe_tobytes(s + 32 * i, y);
+    s[32 * i + 31] ^= ed25519_fe_isnegative(x) << 7;
+  }
+}
+
+void ed25519_ge_p3_batch_to_precomp (ed25519_ge_precomp *r, const ed25519_ge_p3 *h, ed25519_fe *scratch, size_t count) {
+  const ed25519_constants *c = constants();
+  ed25519_fe *z = scratch;
+  ed25519_fe x, y;
+
+  for (size_t i = 0; i < count; i++) ed25519_fe_copy(z[i], h[i].Z);
+  ed25519_fe_batch_invert(z, scratch + count, count);
+
+  for (size_t i = 0; i < count; i++) {
+    ed25519_fe_mul(x, h[i].X, z[i]);
+    ed25519_fe_mul(y, h[i].Y, z[i]);
+    ed25519_fe_add(r[i].yplusx, y, x);
+    ed25519_fe_sub(r[i].yminusx, y, x);
+    ed25519_fe_mul(r[i].xy2d, x, y);
+    ed25519_fe_mul(r[i].xy2d, r[i].xy2d, c->d2);
+  }
+}
+
+void ed25519_ge_from_uniform_batch (ed25519_ge_p3 *h, const unsigned char *r, ed25519_fe *scratch, size_t count) {
+  ed25519_fe *x = scratch;
+  ed25519_fe *t = scratch + count;
+  ed25519_fe a, u, e, x2, one;
+  ed25519_ge_p1p1 p1;
+  ed25519_ge_p2 p2;
+  unsigned char s[32];
+
+  // the Montgomery curve constant A = 486662
+  ed25519_fe_0(a);
+  a[0] = 486662;
+  ed25519_fe_1(one);
+
+  // 1 / (2 * r^2 + 1), top bit of r ignored
+  for (size_t i = 0; i < count; i++) {
+    ed25519_fe_frombytes(u, r + 32 * i);
+    ed25519_fe_sq(u, u);
+    ed25519_fe_add(u, u, u);
+    ed25519_fe_add(t[i], u, one);
+  }
+  ed25519_fe_batch_invert(t, scratch + 2 * count, count);
+
+  // elligator 2: x = -A / (2 * r^2 + 1), or -x - A if x^3 + A * x^2 + x is
+  // not a square
+  for (size_t i = 0; i < count; i++) {
+    ed25519_fe_mul(x[i], a, t[i]);
+    ed25519_fe_neg(x[i], x[i]);
+
+    ed25519_fe_sq(x2, x[i]);
+    ed25519_fe_mul(e, x[i], x2);
+    ed25519_fe_add(e, e, x[i]);
+    ed25519_fe_mul(x2, x2, a);
+    ed25519_fe_add(e, x2, e);
+    ed25519_fe_chi(e, e);
+
+    // chi is -1 exactly when the encoding has bit 8 set. r may be secret,
+    // so -x - A is selected without a branch, as libsodium does
+    ed25519_fe_tobytes(s, e);
+    ed25519_fe_neg(u, x[i]);
+    ed25519_fe_sub(u, u, a);
+    ed25519_fe_cmov(x[i], u, s[1] & 1);
+
+    ed25519_fe_add(t[i], x[i], one);
+  }
+  ed25519_fe_batch_invert(t, scratch + 2 * count, count);
+
+  // y = (x - 1) / (x + 1) on the Edwards curve, sign of x from the top bit
+  // of r, then times the cofactor
+  for (size_t i = 0; i < count; i++) {
+    ed25519_fe_sub(u, x[i], one);
+    ed25519_fe_mul(u, u, t[i]);
+    ed25519_fe_tobytes(s, u);
+    s[31] |= r[32 * i + 31] & 0x80;
+
+    // never taken, every elligator 2 output decodes
+    if (ed25519_ge_frombytes(&h[i], s) != 0) {
+      ed25519_ge_p3_0(&h[i]);
+      continue;
+    }
+
+    ed25519_ge_p3_dbl(&p1, &h[i]);
+    ed25519_ge_p1p1_to_p2(&p2, &p1);
+    ed25519_ge_p2_dbl(&p1, &p2);
+    ed25519_ge_p1p1_to_p2(&p2, &p1);
+    ed25519_ge_p2_dbl(&p1, &p2);
+    ed25519_ge_p1p1_to_p3(&h[i], &p1);
+  }
+}
+
+int ed25519_ge_is_canonical (const unsigned char *s) {
+  // y < p = 2^255 - 19, ignoring the sign bit
+  if ((s[31] & 0x7f) != 0x7f) return 1;
+  for (int i = 30; i > 0; i--) {
+    if (s[i] != 0xff) return 1;
+  }
+  return s[0] < 0xed;
+}
+
+int ed25519_ge_has_small_order (const unsigned char *s) {
+  const ed25519_constants *c = constants();
+  ed25519_fe y, y2, t, one;
+  unsigned char b[32];
+
+  ed25519_fe_frombytes(y, s);
+  ed25519_fe_1(one);
+
+  // points of order 1, 2 and 4 have y = 1, -1 and 0
+  ed25519_fe_sq(y2, y);
+  ed25519_fe_sub(t, y2, one);
+  if (ed25519_fe_iszero(y) || ed25519_fe_iszero(t)) return 1;
+
+  // doubling a point of order 8 gives y = 0, so x^2 = -y^2 and the curve
+  // equation becomes d * y^4 + 2 * y^2 - 1 = 0. Only one root of that is a
+  // square, so this matches exactly the two y of the order 8 points.
+  ed25519_fe_sq(t, y2);
+  ed25519_fe_mul(t, t, c->d);
+  ed25519_fe_add(t, t, y2);
+  ed25519_fe_add(t, t, y2);
+  ed25519_fe_sub(t, t, one);
+  ed25519_fe_tobytes(b, t);
+
+  unsigned char d = 0;
+  for (int i = 0; i < 32; i++) d |= b[i];
+  return d == 0;
+}
+
+static const unsigned char L[32] = {
+  0xed, 0xd3, 0xf5, 0x5c, 0x1a, 0x63, 0x12, 0x58,
+  0xd6, 0x9c, 0xf7, 0xa2, 0xde, 0xf9, 0xde, 0x14,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x10
+};
+
+int ed25519_sc_is_canonical (const unsigned char *s) {
+  for (int i = 31; i >= 0; i--) {
+    if (s[i] < L[i]) return 1;
+    if (s[i] > L[i]) return 0;
+  }
+  return 0;
+}
+
+int ed25519_ge_is_on_main_subgroup_vartime (const ed25519_ge_p3 *p) {
+  ed25519_ge_cached table[8];
+
+  ed25519_ge_odd_multiples(table, p);
+  return ed25519_ge_odd_multiples_on_main_subgroup_vartime(table);
+}
+
+int ed25519_ge_odd_multiples_on_main_subgroup_vartime (const ed25519_ge_cached table[8]) {
+  ed25519_wnaf_term term;
+  ed25519_ge_p2 r;
+  unsigned char s[32];
+
+  ed25519_slide(term.digits, L);
+  term.cached = table;
+  term.precomp = NULL;
+  ed25519_ge_wnaf_vartime(&r, &term, 1);
+
+  // identity is (0 : Z : Z)
+  ed25519_fe_sub(r.Y, r.Y, r.Z);
+  ed25519_fe_tobytes(s, r.X);
+  unsigned char d = 0;
+  for (int i = 0; i < 32; i++) d |= s[i];
+  ed25519_fe_tobytes(s, r.Y);
+  for (int i = 0; i < 32; i++) d |= s[i];
+  return d == 0;
+}
+
+void ed25519_ge_odd_multiples (ed25519_ge_cached r[8], const ed25519_ge_p3 *p) {
+  ed25519_ge_p1p1 t;
+  ed25519_ge_p3 p2, u;
+
+  ed25519_ge_p3_dbl(&t, p);
+  ed25519_ge_p1p1_to_p3(&p2, &t);
+  ed25519_ge_p3_to_cached(&r[0], p);
+
+  for (int i = 1; i < 8; i++) {
+    ed25519_ge_add(&t, &p2, &r[i - 1]);
+    ed25519_ge_p1p1_to_p3(&u, &t);
+    ed25519_ge_p3_to_cached(&r[i], &u);
+  }
+}
+
+void ed25519_slide (signed char r[256], const unsigned char *a) {
+  for (int i = 0; i < 256; i++) r[i] = 1 & (a[i >> 3] >> (i & 7));
+
+  for (int i = 0; i < 256; i++) {
+    if (!r[i]) continue;
+
+    for (int b = 1; b <= 6 && i + b < 256; b++) {
+      if (!r[i + b]) continue;
+
+      if (r[i] + (r[i + b] << b) <= 15) {
+        r[i] += r[i + b] << b;
+        r[i + b] = 0;
+      } else if (r[i] - (r[i + b] << b) >= -15) {
+        r[i] -= r[i + b] << b;
+        for (int k = i + b; k < 256; k++) {
+          if (!r[k]) {
+            r[k] = 1;
+            break;
+          }
+          r[k] = 0;
+        }
+      } else {
+        break;
+      }
+    }
+  }
+}
+
+void ed25519_ge_wnaf_vartime (ed25519_ge_p2 *r, const ed25519_wnaf_term *terms, size_t count) {
+  ed25519_ge_p1p1 t;
+  ed25519_ge_p3 u;
+  int i = 255;
+
+  ge_p2_0(r);
+
+  for (; i >= 0; i--) {
+    size_t j = 0;
+    while (j < count && terms[j].digits[i] == 0) j++;
+    if (j < count) break;
+  }
+
+  for (; i >= 0; i--) {
+    ed25519_ge_p2_dbl(&t, r);
+
+    for (size_t j = 0; j < count; j++) {
+      signed char d = terms[j].digits[i];
+      if (d == 0) continue;
+
+      ed25519_ge_p1p1_to_p3(&u, &t);
+      if (terms[j].precomp != NULL) {
+        if (d > 0) ed25519_ge_madd(&t, &u, &terms[j].precomp[d / 2]);
+        else ed25519_ge_msub(&t, &u, &terms[j].precomp[(-d) / 2]);
+      } else {
+        if (d > 0) ed25519_ge_add(&t, &u, &terms[j].cached[d / 2]);
+        else ed25519_ge_sub(&t, &u, &terms[j].cached[(-d) / 2]);
+      }
+    }
+
+    ed25519_ge_p1p1_to_p2(r, &t);
+  }
+}
+
+// the product is computed in full with 32 bit limbs and reduced by
+// libsodium, which has no exported scalar multiplication yet
+void ed25519_sc_muladd (unsigned char *s, const unsigned char *a, const unsigned char *b, const unsigned char *c) {
+  uint32_t x[8], y[8];
+  uint32_t t[16] = { 0 };
+  unsigned char wide[64];
+
+  for (int i = 0; i < 8; i++) {
+    x[i] = (uint32_t) a[4 * i] | ((uint32_t) a[4 * i + 1] << 8) | ((uint32_t) a[4 * i + 2] << 16) | ((uint32_t) a[4 * i + 3] << 24);
+    y[i] = (uint32_t) b[4 * i] | ((uint32_t) b[4 * i + 1] << 8) | ((uint32_t) b[4 * i + 2] << 16) | ((uint32_t) b[4 * i + 3] << 24);
+  }
+
+  for (int i = 0; i < 8; i++) {
+    uint64_t carry = 0;
+    for (int j = 0; j < 8; j++) {
+      uint64_t acc = (uint64_t) x[i] * y[j] + t[i + j] + carry;
+      t[i + j] = (uint32_t) acc;
+      carry = acc >> 32;
+    }
+    t[i + 8] = (uint32_t) carry;
+  }
+
+  uint64_t carry = 0;
+  for (int i = 0; i < 16; i++) {
+    uint64_t acc = (uint64_t) t[i] + carry;
+    if (i < 8) {
+      acc += (uint32_t) c[4 * i] | ((uint32_t) c[4 * i + 1] << 8) | ((uint32_t) c[4 * i + 2] << 16) | ((uint32_t) c[4 * i + 3] << 24);
+    }
+    wide[4 * i] = (unsigned char) acc;
+    wide[4 * i + 1] = (unsigned char) (acc >> 8);
+    wide[4 * i + 2] = (unsigned char) (acc >> 16);
+    wide[4 * i + 3] = (unsigned char) (acc >> 24);
+    carry = acc >> 32;
+  }
+
+  crypto_core_ed25519_scalar_reduce(s, wide);
+
+  // b is the secret scalar when signing
+  sodium_memzero(x, sizeof(x));
+  sodium_memzero(y, sizeof(y));
+  sodium_memzero(t, sizeof(t));
+  sodium_memzero(wide, sizeof(wide));
+}
+
+void ed25519_sc_mul (unsigned char *s, const unsigned char *a, const unsigned char *b) {
+  static const unsigned char zero[32] = { 0 };
+  ed25519_sc_muladd(s, a, b, zero);
+}
@@ -0,0 +1,166 @@
+#ifndef SODIUM_NATIVE_ED25519_H
+#define SODIUM_NATIVE_ED25519_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Edwards25519 field and group arithmetic for the functions libsodium does
+// not export: verification with prepared keys, multi-scalar multiplication,
+// batched point operations and fixed-base tables.
+//
+// Field elements are 5 limbs of 51 bits, points use the extended coordinates
+// of the ref10 implementation. Everything is prefixed with ed25519_ so it
+// never clashes with libsodium's internal fe25519/ge25519 symbols when
+// libsodium is linked statically.
+//
+// Functions ending in _vartime may leak their inputs through timing and must
+// only be used on public data.
+
+typedef uint64_t ed25519_fe[5];
+
+// (X:Y:Z) with x = X/Z, y = Y/Z
+typedef struct ed25519_ge_p2 {
+  ed25519_fe X;
+  ed25519_fe Y;
+  ed25519_fe Z;
+} ed25519_ge_p2;
+
+// (X:Y:Z:T) with x = X/Z, y = Y/Z, x * y = T/Z
+typedef struct ed25519_ge_p3 {
+  ed25519_fe X;
+  ed25519_fe Y;
+  ed25519_fe Z;
+  ed25519_fe T;
+} ed25519_ge_p3;
+
+// ((X:Z),(Y:T)) with x = X/Z, y = Y/T, the result of an addition
+typedef struct ed25519_ge_p1p1 {
+  ed25519_fe X;
+  ed25519_fe Y;
+  ed25519_fe Z;
+  ed25519_fe T;
+} ed25519_ge_p1p1;
+
+// affine (y + x, y - x, 2 * d * x * y), the cheapest addend
+typedef struct ed25519_ge_precomp {
+  ed25519_fe yplusx;
+  ed25519_fe yminusx;
+  ed25519_fe xy2d;
+} ed25519_ge_precomp;
+
+// projective (Y + X, Y - X, Z, 2 * d * T)
+typedef struct ed25519_ge_cached {
+  ed25519_fe YplusX;
+  ed25519_fe YminusX;
+  ed25519_fe Z;
+  ed25519_fe T2d;
+} ed25519_ge_cached;
+
+// field
+
+void ed25519_fe_0 (ed25519_fe h);
+void ed25519_fe_1 (ed25519_fe h);
+void ed25519_fe_copy (ed25519_fe h, const ed25519_fe f);
+void ed25519_fe_add (ed25519_fe h, const ed25519_fe f, const ed25519_fe g);
+void ed25519_fe_sub (ed25519_fe h, const ed25519_fe f, const ed25519_fe g);
+void ed25519_fe_neg (ed25519_fe h, const ed25519_fe f);
+void ed25519_fe_mul (ed25519_fe h, const ed25519_fe f, const ed25519_fe g);
+void ed25519_fe_sq (ed25519_fe h, const ed25519_fe f);
+void ed25519_fe_invert (ed25519_fe out, const ed25519_fe z);
+void ed25519_fe_frombytes (ed25519_fe h, const unsigned char *s);
+void ed25519_fe_tobytes (unsigned char *s, const ed25519_fe h);
+int ed25519_fe_isnegative (const ed25519_fe f);
+int ed25519_fe_iszero (const ed25519_fe f);
+void ed25519_fe_cmov (ed25519_fe f, const ed25519_fe g, unsigned int b);
+
+// z^((p - 1) / 2): 1, -1 or 0
+void ed25519_fe_chi (ed25519_fe out, const ed25519_fe z);
+
+// Inverts count elements in place with a single field inversion (Montgomery's
+// trick). Zero elements stay zero. scratch holds count elements.
+void ed25519_fe_batch_invert (ed25519_fe *z, ed25519_fe *scratch, size_t count);
+
+// group
+
+void ed25519_ge_p3_0 (ed25519_ge_p3 *h);
+void ed25519_ge_p3_to_cached (ed25519_ge_cached *r, const ed25519_ge_p3 *p);
+void ed25519_ge_p3_to_p2 (ed25519_ge_p2 *r, const ed25519_ge_p3 *p);
+void ed25519_ge_p2_to_p3 (ed25519_ge_p3 *r, const ed25519_ge_p2 *p);
+void ed25519_ge_p1p1_to_p2 (ed25519_ge_p2 *r, const ed25519_ge_p1p1 *p);
+void ed25519_ge_p1p1_to_p3 (ed25519_ge_p3 *r, const ed25519_ge_p1p1 *p);
+void ed25519_ge_p2_dbl (ed25519_ge_p1p1 *r, const ed25519_ge_p2 *p);
+void ed25519_ge_p3_dbl (ed25519_ge_p1p1 *r, const ed25519_ge_p3 *p);
+void ed25519_ge_add (ed25519_ge_p1p1 *r, const ed25519_ge_p3 *p, const ed25519_ge_cached *q);
+void ed25519_ge_sub (ed25519_ge_p1p1 *r, const ed25519_ge_p3 *p, const ed25519_ge_cached *q);
+void ed25519_ge_madd (ed25519_ge_p1p1 *r, const ed25519_ge_p3 *p, const ed25519_ge_precomp *q);
+void ed25519_ge_msub (ed25519_ge_p1p1 *r, const ed25519_ge_p3 *p, const ed25519_ge_precomp *q);
+
+// r = p + q and r = p - q on p3 points
+void ed25519_ge_p3_add (ed25519_ge_p3 *r, const ed25519_ge_p3 *p, const ed25519_ge_p3 *q);
+void ed25519_ge_p3_sub (ed25519_ge_p3 *r, const ed25519_ge_p3 *p, const ed25519_ge_p3 *q);
+
+// Decodes a point, -1 if s is not the encoding of a curve point. Like
+// libsodium the sign bit of x = 0 is not checked and y may be non-canonical.
+int ed25519_ge_frombytes (ed25519_ge_p3 *h, const unsigned char *s);
+void ed25519_ge_p3_tobytes (unsigned char *s, const ed25519_ge_p3 *h);
+
+// Encodes count points with one field inversion. scratch holds 2 * count
+// field elements.
+void ed25519_ge_p3_batch_tobytes (unsigned char *s, const ed25519_ge_p3 *h, ed25519_fe *scratch, size_t count);
+
+// Affine form of count points with one field inversion, for tables.
+// scratch holds 2 * count field elements.
+void ed25519_ge_p3_batch_to_precomp (ed25519_ge_precomp *r, const ed25519_ge_p3 *h, ed25519_fe *scratch, size_t count);
+
+// The points crypto_core_ed25519_from_uniform maps count 32 byte strings to,
+// sharing the two field inversions of the map. scratch holds 3 * count field
+// elements.
+void ed25519_ge_from_uniform_batch (ed25519_ge_p3 *h, const unsigned char *r, ed25519_fe *scratch, size_t count);
+
+// Checks on encodings, matching libsodium's ge25519_is_canonical and
+// ge25519_has_small_order: y < p, and y is that of a point of order 1, 2, 4
+// or 8 (both ignore the sign bit).
+int ed25519_ge_is_canonical (const unsigned char *s);
+int ed25519_ge_has_small_order (const unsigned char *s);
+
+// L * p == 0, vartime
+int ed25519_ge_is_on_main_subgroup_vartime (const ed25519_ge_p3 *p);
+
+// the same from the table of ed25519_ge_odd_multiples of p
+int ed25519_ge_odd_multiples_on_main_subgroup_vartime (const ed25519_ge_cached table[8]);
+
+// the standard base point
+const ed25519_ge_p3 * ed25519_ge_base ();
+
+// odd multiples B, 3B, ..., 15B and the same for 2^128 * B
+const ed25519_ge_precomp * ed25519_ge_base_odd ();
+const ed25519_ge_precomp * ed25519_ge_base_odd_128 ();
+
+// r[i] = (2i + 1) * p for i < 8
+void ed25519_ge_odd_multiples (ed25519_ge_cached r[8], const ed25519_ge_p3 *p);
+
+// Signed sliding window digits of a 256 bit little endian scalar, every
+// non-zero digit is odd and in [-15, 15]
+void ed25519_slide (signed char r[256], const unsigned char *a);
+
+// One term of a vartime multi-scalar multiplication: digits from
+// ed25519_slide and a table of odd multiples in one of the two forms.
+typedef struct ed25519_wnaf_term {
+  signed char digits[256];
+  const ed25519_ge_cached *cached;
+  const ed25519_ge_precomp *precomp;
+} ed25519_wnaf_term;
+
+// r = sum of the terms, sharing the doublings, vartime
+void ed25519_ge_wnaf_vartime (ed25519_ge_p2 *r, const ed25519_wnaf_term *terms, size_t count);
+
+// scalars
+
+// s < L
+int ed25519_sc_is_canonical (const unsigned char *s);
+
+// s = a * b + c mod L and s = a * b mod L, for any 256 bit a, b and c
+void ed25519_sc_muladd (unsigned char *s, const unsigned char *a, const unsigned char *b, const unsigned char *c);
+void ed25519_sc_mul (unsigned char *s, const unsigned char *a, const unsigned char *b);
+
+#endif
@@ -0,0 +1,850 @@
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <atomic>
+#include <thread>
+#include <vector>
+#include "file_crypt.h"
+
+#ifdef _WIN32
+#include <io.h>
+#include <windows.h>
+#else
+#include <unistd.h>
+#endif
+
+#if defined(__linux__) && defined(__has_include)
+#if __has_include(<linux/io_uring.h>)
+#define FILE_CRYPT_HAVE_IO_URING 1
+#include <sys/eventfd.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <linux/io_uring.h>
+#endif
+#endif
+
+typedef struct file_crypt_job {
+  const file_crypt_options *options;
+  unsigned char header[FILE_CRYPT_HEADERBYTES];
+  uint32_t chunk_size;
+  uint64_t count;
+  uint64_t in_size;
+  uint64_t in_base;
+  uint64_t in_stride;
+  uint64_t out_base;
+  uint64_t out_stride;
+} file_crypt_job;
+
+static void store32_le (unsigned char *dst, uint32_t w) {
+  for (int i = 0; i < 4; i++) dst[i] = (unsigned char) (w >> (8 * i));
+}
+
+static uint32_t load32_le (const unsigned char *src) {
+  uint32_t w = 0;
+  for (int i = 0; i < 4; i++) w |= ((uint32_t) src[i]) << (8 * i);
+  return w;
+}
+
+static void store64_le (unsigned char *dst, uint64_t w) {
+  for (int i = 0; i < 8; i++) dst[i] = (unsigned char) (w >> (8 * i));
+}
+
+// positional reads and writes, safe to use from several threads on one fd.
+// Returns the number of bytes transferred, 0 at the end of the file or -1
+static long file_crypt_pread (int fd, unsigned char *buf, size_t length, uint64_t offset) {
+#ifdef _WIN32
+  OVERLAPPED o;
+  DWORD n = 0;
+  memset(&o, 0, sizeof(o));
+  o.Offset = (DWORD) offset;
+  o.OffsetHigh = (DWORD) (offset >> 32);
+  if (!ReadFile((HANDLE) _get_osfhandle(fd), buf, (DWORD) length, &n, &o)) {
+    if (GetLastError() == ERROR_HANDLE_EOF) return 0;
+    errno = EIO;
+    return -1;
+  }
+  return (long) n;
+#else
+  ssize_t n;
+  do {
+    n = pread(fd, buf, length, (off_t) offset);
+  } while (n < 0 && errno == EINTR);
+  return (long) n;
+#endif
+}
+
+static long file_crypt_pwrite (int fd, const unsigned char *buf, size_t length, uint64_t offset) {
+#ifdef _WIN32
+  OVERLAPPED o;
+  DWORD n = 0;
+  memset(&o, 0, sizeof(o));
+  o.Offset = (DWORD) offset;
+  o.OffsetHigh = (DWORD) (offset >> 32);
+  if (!WriteFile((HANDLE) _get_osfhandle(fd), buf, (DWORD) length, &n, &o)) {
+    errno = EIO;
+    return -1;
+  }
+  return (long) n;
+#else
+  ssize_t n;
+  do {
+    n = pwrite(fd, buf, length, (off_t) offset);
+  } while (n < 0 && errno == EINTR);
+  return (long) n;
+#endif
+}
+
+// a file that ends before length bytes changed while it was read
+static int file_crypt_pread_full (int fd, unsigned char *buf, size_t length, uint64_t offset) {
+  while (length > 0) {
+    long n = file_crypt_pread(fd, buf, length, offset);
+    if (n < 0) return -1;
+    if (n == 0) {
+      errno = EIO;
+      return -1;
+    }
+    buf += n;
+    length -= n;
+    offset += n;
+  }
+  return 0;
+}
+
+static int file_crypt_pwrite_full (int fd, const unsigned char *buf, size_t length, uint64_t offset) {
+  while (length > 0) {
+    long n = file_crypt_pwrite(fd, buf, length, offset);
+    if (n < 0) return -1;
+    if (n == 0) {
+      errno = EIO;
+      return -1;
+    }
+    buf += n;
+    length -= n;
+    offset += n;
+  }
+  return 0;
+}
+
+static int file_crypt_size (int fd, uint64_t *size) {
+#ifdef _WIN32
+  struct _stat64 st;
+  if (_fstat64(fd, &st) != 0) return -1;
+  if ((st.st_mode & _S_IFMT) != _S_IFREG) {
+#else
+  struct stat st;
+  if (fstat(fd, &st) != 0) return -1;
+  if (!S_ISREG(st.st_mode)) {
+#endif
+    errno = EINVAL;
+    return -1;
+  }
+  *size = (uint64_t) st.st_size;
+  return 0;
+}
+
+// fails with EINVAL when both fds are the same file, through the same path, a
+// hard link or a dup, since writing the output would overwrite the input
+static int file_crypt_check_distinct (int in_fd, int out_fd) {
+#ifdef _WIN32
+  BY_HANDLE_FILE_INFORMATION in_info;
+  BY_HANDLE_FILE_INFORMATION out_info;
+
+  if (!GetFileInformationByHandle((HANDLE) _get_osfhandle(in_fd), &in_info) ||
+      !GetFileInformationByHandle((HANDLE) _get_osfhandle(out_fd), &out_info)) {
+    errno = EBADF;
+    return -1;
+  }
+
+  if (in_info.dwVolumeSerialNumber == out_info.dwVolumeSerialNumber &&
+      in_info.nFileIndexHigh == out_info.nFileIndexHigh &&
+      in_info.nFileIndexLow == out_info.nFileIndexLow) {
+#else
+  struct stat in_st;
+  struct stat out_st;
+
+  if (fstat(in_fd, &in_st) != 0 || fstat(out_fd, &out_st) != 0) return -1;
+
+  if (in_st.st_dev == out_st.st_dev && in_st.st_ino == out_st.st_ino) {
+#endif
+    errno = EINVAL;
+    return -1;
+  }
+
+  return 0;
+}
+
+// cuts off whatever the output held past the result
+static int file_crypt_truncate (int fd, uint64_t size) {
+#ifdef _WIN32
+  errno = _chsize_s(fd, (__int64) size);
+  return errno == 0 ? 0 : -1;
+#else
+  return ftruncate(fd, (off_t) size);
+#endif
+}
+
+static size_t file_crypt_in_length (const file_crypt_job *job, uint64_t index) {
+  if (index + 1 < job->count) return (size_t) job->in_stride;
+  return (size_t) (job->in_size - job->in_base - index * job->in_stride);
+}
+
+static size_t file_crypt_out_length (const file_crypt_job *job, size_t in_length) {
+  return job->options->encrypt ? in_length + FILE_CRYPT_ABYTES : in_length - FILE_CRYPT_ABYTES;
+}
+
+// encrypts or decrypts chunk index in place
+static int file_crypt_chunk (const file_crypt_job *job, uint64_t index, unsigned char *buf, size_t in_length) {
+  unsigned char nonce[crypto_aead_xchacha20poly1305_ietf_NPUBBYTES];
+  unsigned char ad[FILE_CRYPT_HEADERBYTES + 9];
+
+  memcpy(nonce, job->header, FILE_CRYPT_NONCE_PREFIXBYTES);
+  store64_le(nonce + FILE_CRYPT_NONCE_PREFIXBYTES, index);
+
+  memcpy(ad, job->header, FILE_CRYPT_HEADERBYTES);
+  store64_le(ad + FILE_CRYPT_HEADERBYTES, index);
+  ad[FILE_CRYPT_HEADERBYTES + 8] = index + 1 == job->count ? 1 : 0;
+
+  if (job->options->encrypt) {
+    crypto_aead_xchacha20poly1305_ietf_encrypt(buf, NULL, buf, in_length, ad, sizeof(ad), NULL, nonce, job->options->key);
+    return 0;
+  }
+
+  if (crypto_aead_xchacha20poly1305_ietf_decrypt(buf, NULL, NULL, buf, in_length, ad, sizeof(ad), nonce, job->options->key) != 0) {
+    errno = EBADMSG;
+    return -1;
+  }
+
+  return 0;
+}
+
+// sizes the job from the input, and writes or reads the header
+static int file_crypt_prepare (file_crypt_job *job, const file_crypt_options *options) {
+  job->options = options;
+
+  if (file_crypt_size(options->in_fd, &job->in_size) != 0) return -1;
+  if (file_crypt_check_distinct(options->in_fd, options->out_fd) != 0) return -1;
+
+  if (options->encrypt) {
+    uint32_t chunk_size = options->chunk_size;
+
+    if (chunk_size < FILE_CRYPT_CHUNK_MIN || chunk_size > FILE_CRYPT_CHUNK_MAX) {
+      errno = EINVAL;
+      return -1;
+    }
+
+    randombytes_buf(job->header, FILE_CRYPT_NONCE_PREFIXBYTES);
+    store32_le(job->header + FILE_CRYPT_NONCE_PREFIXBYTES, chunk_size);
+    memset(job->header + FILE_CRYPT_NONCE_PREFIXBYTES + 4, 0, 4);
+
+    job->chunk_size = chunk_size;
+    job->in_base = 0;
+    job->in_stride = chunk_size;
+    job->out_base = FILE_CRYPT_HEADERBYTES;
+    job->out_stride = (uint64_t) chunk_size + FILE_CRYPT_ABYTES;
+    job->count = job->in_size == 0 ? 1 : (job->in_size + chunk_size - 1) / chunk_size;
+
+    return file_crypt_pwrite_full(options->out_fd, job->header, FILE_CRYPT_HEADERBYTES, 0);
+  }
+
+  if (job->in_size < FILE_CRYPT_HEADERBYTES + FILE_CRYPT_ABYTES) {
+    errno = EBADMSG;
+    return -1;
+  }
+
+  if (file_crypt_pread_full(options->in_fd, job->header, FILE_CRYPT_HEADERBYTES, 0) != 0) return -1;
+
+  uint32_t chunk_size = load32_le(job->header + FILE_CRYPT_NONCE_PREFIXBYTES);
+
+  if (chunk_size < FILE_CRYPT_CHUNK_MIN || chunk_size > FILE_CRYPT_CHUNK_MAX ||
+      load32_le(job->header + FILE_CRYPT_NONCE_PREFIXBYTES + 4) != 0) {
+    errno = EBADMSG;
+    return -1;
+  }
+
+  uint64_t body = job->in_size - FILE_CRYPT_HEADERBYTES;
+
+  job->chunk_size = chunk_size;
+  job->in_base = FILE_CRYPT_HEADERBYTES;
+  job->in_stride = (uint64_t) chunk_size + FILE_CRYPT_ABYTES;
+  job->out_base = 0;
+  job->out_stride = chunk_size;
+  job->count = (body + job->in_stride - 1) / job->in_stride;
+
+  // every chunk, the last one included, has at least a MAC
+  if (body - (job->count - 1) * job->in_stride < FILE_CRYPT_ABYTES) {
+    errno = EBADMSG;
+    return -1;
+  }
+
+  return 0;
+}
+
+// pread engine: every thread claims the next chunk and reads, encrypts and
+// writes it on its own, so the threads overlap each other's I/O and CPU time
+
+typedef struct file_crypt_pread_shared {
+  const file_crypt_job *job;
+  std::atomic<uint64_t> next;
+  std::atomic<int> error;
+} file_crypt_pread_shared;
+
+static void file_crypt_set_error (std::atomic<int> *error, int err) {
+  int expected = 0;
+  error->compare_exchange_strong(expected, err);
+}
+
+static void file_crypt_pread_worker (file_crypt_pread_shared *shared) {
+  const file_crypt_job *job = shared->job;
+  size_t buf_length = (size_t) job->chunk_size + FILE_CRYPT_ABYTES;
+  unsigned char *buf = (unsigned char *) malloc(buf_length);
+
+  if (buf == NULL) {
+    file_crypt_set_error(&shared->error, ENOMEM);
+    return;
+  }
+
+  while (shared->error.load() == 0) {
+    uint64_t index = shared->next.fetch_add(1);
+    if (index >= job->count) break;
+
+    size_t in_length = file_crypt_in_length(job, index);
+
+    if (file_crypt_pread_full(job->options->in_fd, buf, in_length, job->in_base + index * job->in_stride) != 0 ||
+        file_crypt_chunk(job, index, buf, in_length) != 0 ||
+        file_crypt_pwrite_full(job->options->out_fd, buf, file_crypt_out_length(job, in_length), job->out_base + index * job->out_stride) != 0) {
+      file_crypt_set_error(&shared->error, errno);
+      break;
+    }
+  }
+
+  sodium_memzero(buf, buf_length);
+  free(buf);
+}
+
+static int file_crypt_run_pread (const file_crypt_job *job, uint32_t threads) {
+  file_crypt_pread_shared shared;
+  shared.job = job;
+  shared.next = 0;
+  shared.error = 0;
+
+  if (threads > job->count) threads = (uint32_t) job->count;
+
+  std::vector<std::thread> pool;
+  for (uint32_t i = 1; i < threads; i++) {
+    pool.push_back(std::thread(file_crypt_pread_worker, &shared));
+  }
+
+  file_crypt_pread_worker(&shared);
+
+  for (size_t i = 0; i < pool.size(); i++) pool[i].join();
+
+  if (shared.error.load() != 0) {
+    errno = shared.error.load();
+    return -1;
+  }
+
+  return 0;
+}
+
+#ifdef FILE_CRYPT_HAVE_IO_URING
+
+// io_uring engine, on the raw system calls so there is no liburing dependency
+
+typedef struct file_crypt_ring {
+  int fd;
+  unsigned *sq_head;
+  unsigned *sq_tail;
+  unsigned *sq_mask;
+  unsigned *sq_array;
+  unsigned sq_entries;
+  unsigned sq_local_tail;
+  struct io_uring_sqe *sqes;
+  unsigned *cq_head;
+  unsigned *cq_tail;
+  unsigned *cq_mask;
+  struct io_uring_cqe *cqes;
+  void *sq_ring;
+  size_t sq_ring_size;
+  void *cq_ring;
+  size_t cq_ring_size;
+  size_t sqes_size;
+} file_crypt_ring;
+
+static void file_crypt_ring_free (file_crypt_ring *ring) {
+  if (ring->sqes != NULL) munmap(ring->sqes, ring->sqes_size);
+  if (ring->cq_ring != NULL && ring->cq_ring != ring->sq_ring) munmap(ring->cq_ring, ring->cq_ring_size);
+  if (ring->sq_ring != NULL) munmap(ring->sq_ring, ring->sq_ring_size);
+  close(ring->fd);
+}
+
+static int file_crypt_ring_init (file_crypt_ring *ring, unsigned entries) {
+  struct io_uring_params params;
+  memset(&params, 0, sizeof(params));
+  memset(ring, 0, sizeof(*ring));
+
+  ring->fd = (int) syscall(__NR_io_uring_setup, entries, &params);
+  if (ring->fd < 0) return -1;
+
+  ring->sq_ring_size = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+  ring->cq_ring_size = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+  ring->sqes_size = params.sq_entries * sizeof(struct io_uring_sqe);
+
+  bool single_mmap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+  if (single_mmap && ring->cq_ring_size > ring->sq_ring_size) ring->sq_ring_size = ring->cq_ring_size;
+
+  void *sq_ring = mmap(NULL, ring->sq_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring->fd, IORING_OFF_SQ_RING);
+  void *cq_ring = single_mmap ? sq_ring : mmap(NULL, ring->cq_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring->fd, IORING_OFF_CQ_RING);
+  void *sqes = mmap(NULL, ring->sqes_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring->fd, IORING_OFF_SQES);
+
+  ring->sq_ring = sq_ring == MAP_FAILED ? NULL : sq_ring;
+  ring->cq_ring = cq_ring == MAP_FAILED ? NULL : cq_ring;
+  ring->sqes = sqes == MAP_FAILED ? NULL : (struct io_uring_sqe *) sqes;
+
+  if (ring->sq_ring == NULL || ring->cq_ring == NULL || ring->sqes == NULL) {
+    int err = errno;
+    file_crypt_ring_free(ring);
+    errno = err;
+    return -1;
+  }
+
+  unsigned char *sq = (unsigned char *) ring->sq_ring;
+  unsigned char *cq = (unsigned char *) ring->cq_ring;
+
+  ring->sq_head = (unsigned *) (sq + params.sq_off.head);
+  ring->sq_tail = (unsigned *) (sq + params.sq_off.tail);
+  ring->sq_mask = (unsigned *) (sq + params.sq_off.ring_mask);
+  ring->sq_array = (unsigned *) (sq + params.sq_off.array);
+  ring->sq_entries = params.sq_entries;
+  ring->sq_local_tail = *ring->sq_tail;
+
+  ring->cq_head = (unsigned *) (cq + params.cq_off.head);
+  ring->cq_tail = (unsigned *) (cq + params.cq_off.tail);
+  ring->cq_mask = (unsigned *) (cq + params.cq_off.ring_mask);
+  ring->cqes = (struct io_uring_cqe *) (cq + params.cq_off.cqes);
+
+  return 0;
+}
+
+// the engine never has more operations in flight than the ring has entries
+static struct io_uring_sqe * file_crypt_ring_sqe (file_crypt_ring *ring) {
+  unsigned index = ring->sq_local_tail & *ring->sq_mask;
+  struct io_uring_sqe *sqe = &ring->sqes[index];
+
+  ring->sq_array[index] = index;
+  ring->sq_local_tail++;
+  memset(sqe, 0, sizeof(*sqe));
+
+  return sqe;
+}
+
+// submits everything queued and waits for at least one completion
+static int file_crypt_ring_enter (file_crypt_ring *ring) {
+  __atomic_store_n(ring->sq_tail, ring->sq_local_tail, __ATOMIC_RELEASE);
+
+  for (;;) {
+    unsigned to_submit = ring->sq_local_tail - __atomic_load_n(ring->sq_head, __ATOMIC_ACQUIRE);
+    long ret = syscall(__NR_io_uring_enter, ring->fd, to_submit, 1, IORING_ENTER_GETEVENTS, NULL, 0);
+
+    if (ret >= 0) return 0;
+    if (errno != EINTR && errno != EAGAIN && errno != EBUSY) return -1;
+  }
+}
+
+#define FILE_CRYPT_OP_READ 1
+#define FILE_CRYPT_OP_WRITE 2
+#define FILE_CRYPT_OP_EVENTFD 3
+
+enum file_crypt_slot_state {
+  FILE_CRYPT_SLOT_FREE,
+  FILE_CRYPT_SLOT_READING,
+  FILE_CRYPT_SLOT_CRYPTING,
+  FILE_CRYPT_SLOT_WRITING
+};
+
+typedef struct file_crypt_slot {
+  unsigned char *buf;
+  uint64_t index;
+  uint64_t offset;
+  size_t length;
+  size_t done;
+  enum file_crypt_slot_state state;
+  int error;
+} file_crypt_slot;
+
+// chunks read by the ring wait in todo for a thread, and wait in done for the
+// ring once encrypted. Threads wake the ring with the eventfd, which always
+// has a read queued on it while anything is being encrypted
+typedef struct file_crypt_uring_shared {
+  const file_crypt_job *job;
+  file_crypt_slot *slots;
+  std::mutex lock;
+  std::condition_variable ready;
+  std::deque<unsigned> todo;
+  std::vector<unsigned> done;
+  bool stop;
+  int event_fd;
+} file_crypt_uring_shared;
+
+static void file_crypt_uring_worker (file_crypt_uring_shared *shared) {
+  for (;;) {
+    std::unique_lock<std::mutex> guard(shared->lock);
+    while (!shared->stop && shared->todo.empty()) shared->ready.wait(guard);
+    if (shared->todo.empty()) return;
+
+    unsigned id = shared->todo.front();
+    shared->todo.pop_front();
+    guard.unlock();
+
+    file_crypt_slot *slot = &shared->slots[id];
+    slot->error = file_crypt_chunk(shared->job, slot->index, slot->buf, slot->length) == 0 ? 0 : errno;
+
+    guard.lock();
+    shared->done.push_back(id);
+    guard.unlock();
+
+    uint64_t one = 1;
+    ssize_t n;
+    do {
+      n = write(shared->event_fd, &one, sizeof(one));
+    } while (n < 0 && errno == EINTR);
+  }
+}
+
+static void file_crypt_queue_io (file_crypt_ring *ring, int opcode, int fd, unsigned id, file_crypt_slot *slot, uint64_t tag) {
+  struct io_uring_sqe *sqe = file_crypt_ring_sqe(ring);
+
+  sqe->opcode = opcode;
+  sqe->fd = fd;
+  sqe->addr = (uint64_t) (uintptr_t) (slot->buf + slot->done);
+  sqe->len = (uint32_t) (slot->length - slot->done);
+  sqe->off = slot->offset + slot->done;
+  sqe->buf_index = (uint16_t) id;
+  sqe->user_data = ((uint64_t) id << 2) | tag;
+}
+
+static void file_crypt_queue_eventfd (file_crypt_ring *ring, int event_fd, struct iovec *iov) {
+  struct io_uring_sqe *sqe = file_crypt_ring_sqe(ring);
+
+  sqe->opcode = IORING_OP_READV;
+  sqe->fd = event_fd;
+  sqe->addr = (uint64_t) (uintptr_t) iov;
+  sqe->len = 1;
+  sqe->user_data = FILE_CRYPT_OP_EVENTFD;
+}
+
+// Sets *unavailable when the ring could not be set up, before anything was
+// read or written, so the caller can fall back to the pread engine
+static int file_crypt_run_io_uring (const file_crypt_job *job, uint32_t threads, uint32_t depth, bool *unavailable) {
+  *unavailable = true;
+
+  if (depth > job->count) depth = (uint32_t) job->count;
+  if (threads > depth) threads = depth;
+
+  size_t slot_size = ((size_t) job->chunk_size + FILE_CRYPT_ABYTES + 4095) & ~((size_t) 4095);
+  size_t arena_size = slot_size * depth;
+  void *arena = NULL;
+
+  if (posix_memalign(&arena, 4096, arena_size) != 0) {
+    errno = ENOMEM;
+    return -1;
+  }
+
+  file_crypt_ring ring;
+  if (file_crypt_ring_init(&ring, depth + 1) != 0) {
+    int err = errno;
+    free(arena);
+    errno = err;
+    return -1;
+  }
+
+  std::vector<file_crypt_slot> slots(depth);
+  std::vector<struct iovec> iovs(depth);
+  std::vector<unsigned> free_slots;
+
+  for (uint32_t i = 0; i < depth; i++) {
+    slots[i].buf = (unsigned char *) arena + i * slot_size;
+    slots[i].state = FILE_CRYPT_SLOT_FREE;
+    iovs[i].iov_base = slots[i].buf;
+    iovs[i].iov_len = slot_size;
+    free_slots.push_back(depth - 1 - i);
+  }
+
+  int event_fd = eventfd(0, EFD_CLOEXEC);
+
+  // registering pins the buffers once, instead of mapping them for every read
+  // and write
+  if (event_fd < 0 || syscall(__NR_io_uring_register, ring.fd, IORING_REGISTER_BUFFERS, iovs.data(), depth) != 0) {
+    int err = errno;
+    if (event_fd >= 0) close(event_fd);
+    file_crypt_ring_free(&ring);
+    free(arena);
+    errno = err;
+    return -1;
+  }
+
+  *unavailable = false;
+
+  file_crypt_uring_shared shared;
+  shared.job = job;
+  shared.slots = slots.data();
+  shared.stop = false;
+  shared.event_fd = event_fd;
+
+  std::vector<std::thread> pool;
+  for (uint32_t i = 0; i < threads; i++) {
+    pool.push_back(std::thread(file_crypt_uring_worker, &shared));
+  }
+
+  uint64_t event_value = 0;
+  struct iovec event_iov = { &event_value, sizeof(event_value) };
+  std::vector<unsigned> done;
+
+  uint64_t next_read = 0;
+  uint64_t written = 0;
+  unsigned io_in_flight = 0;
+  unsigned crypting = 0;
+  bool event_pending = true;
+  int error = 0;
+  bool ring_failed = false;
+
+  file_crypt_queue_eventfd(&ring, event_fd, &event_iov);
+
+  for (;;) {
+    while (error == 0 && next_read < job->count && !free_slots.empty()) {
+      unsigned id = free_slots.back();
+      file_crypt_slot *slot = &slots[id];
+      free_slots.pop_back();
+
+      slot->index = next_read++;
+      slot->offset = job->in_base + slot->index * job->in_stride;
+      slot->length = file_crypt_in_length(job, slot->index);
+      slot->done = 0;
+      slot->state = FILE_CRYPT_SLOT_READING;
+
+      file_crypt_queue_io(&ring, IORING_OP_READ_FIXED, job->options->in_fd, id, slot, FILE_CRYPT_OP_READ);
+      io_in_flight++;
+    }
+
+    if (error == 0 ? written == job->count : io_in_flight == 0 && crypting == 0) break;
+
+    if (file_crypt_ring_enter(&ring) != 0) {
+      error = errno;
+      ring_failed = true;
+      break;
+    }
+
+    unsigned head = *ring.cq_head;
+    unsigned tail = __atomic_load_n(ring.cq_tail, __ATOMIC_ACQUIRE);
+
+    for (; head != tail; head++) {
+      struct io_uring_cqe *cqe = &ring.cqes[head & *ring.cq_mask];
+      uint64_t tag = cqe->user_data & 3;
+      unsigned id = (unsigned) (cqe->user_data >> 2);
+      int res = cqe->res;
+
+      if (tag == FILE_CRYPT_OP_EVENTFD) {
+        event_pending = false;
+        continue;
+      }
+
+      file_crypt_slot *slot = &slots[id];
+
+      if (res == -EINTR || res == -EAGAIN) {
+        file_crypt_queue_io(&ring, tag == FILE_CRYPT_OP_READ ? IORING_OP_READ_FIXED : IORING_OP_WRITE_FIXED,
+          tag == FILE_CRYPT_OP_READ ? job->options->in_fd : job->options->out_fd, id, slot, tag);
+        continue;
+      }
+
+      // the chunk of an empty file is an empty read and write
+      if (res < 0 || (res == 0 && slot->done < slot->length)) {
+        if (error == 0) error = res == 0 ? EIO : -res;
+        io_in_flight--;
+        slot->state = FILE_CRYPT_SLOT_FREE;
+        free_slots.push_back(id);
+        continue;
+      }
+
+      slot->done += res;
+
+      // short transfers continue where they stopped
+      if (slot->done < slot->length) {
+        file_crypt_queue_io(&ring, tag == FILE_CRYPT_OP_READ ? IORING_OP_READ_FIXED : IORING_OP_WRITE_FIXED,
+          tag == FILE_CRYPT_OP_READ ? job->options->in_fd : job->options->out_fd, id, slot, tag);
+        continue;
+      }
+
+      io_in_flight--;
+
+      if (tag == FILE_CRYPT_OP_WRITE) {
+        written++;
+        slot->state = FILE_CRYPT_SLOT_FREE;
+        free_slots.push_back(id);
+      } else if (error != 0) {
+        slot->state = FILE_CRYPT_SLOT_FREE;
+        free_slots.push_back(id);
+      } else {
+        slot->state = FILE_CRYPT_SLOT_CRYPTING;
+        crypting++;
+        {
+          std::lock_guard<std::mutex> guard(shared.lock);
+          shared.todo.push_back(id);
+        }
+        shared.ready.notify_one();
+      }
+    }
+
+    __atomic_store_n(ring.cq_head, head, __ATOMIC_RELEASE);
+
+    {
+      std::lock_guard<std::mutex> guard(shared.lock);
+      done.swap(shared.done);
+    }
+
+    for (size_t i = 0; i < done.size(); i++) {
+      unsigned id = done[i];
+      file_crypt_slot *slot = &slots[id];
+      crypting--;
+
+      if (slot->error != 0 && error == 0) error = slot->error;
+
+      if (error != 0) {
+        slot->state = FILE_CRYPT_SLOT_FREE;
+        free_slots.push_back(id);
+        continue;
+      }
+
+      slot->offset = job->out_base + slot->index * job->out_stride;
+      slot->length = file_crypt_out_length(job, slot->length);
+      slot->done = 0;
+      slot->state = FILE_CRYPT_SLOT_WRITING;
+
+      file_crypt_queue_io(&ring, IORING_OP_WRITE_FIXED, job->options->out_fd, id, slot, FILE_CRYPT_OP_WRITE);
+      io_in_flight++;
+    }
+    done.clear();
+
+    if (!event_pending) {
+      file_crypt_queue_eventfd(&ring, event_fd, &event_iov);
+      event_pending = true;
+    }
+  }
+
+  {
+    std::lock_guard<std::mutex> guard(shared.lock);
+    shared.stop = true;
+  }
+  shared.ready.notify_all();
+  for (size_t i = 0; i < pool.size(); i++) pool[i].join();
+
+  // complete the read still queued on the eventfd before its iovec goes away
+  if (!ring_failed && event_pending) {
+    uint64_t one = 1;
+    if (write(event_fd, &one, sizeof(one)) < 0 && error == 0) error = errno;
+
+    while (event_pending) {
+      if (file_crypt_ring_enter(&ring) != 0) {
+        if (error == 0) error = errno;
+        ring_failed = true;
+        break;
+      }
+
+      unsigned head = *ring.cq_head;
+      unsigned tail = __atomic_load_n(ring.cq_tail, __ATOMIC_ACQUIRE);
+      for (; head != tail; head++) {
+        if ((ring.cqes[head & *ring.cq_mask].user_data & 3) == FILE_CRYPT_OP_EVENTFD) event_pending = false;
+      }
+      __atomic_store_n(ring.cq_head, head, __ATOMIC_RELEASE);
+    }
+  }
+
+  close(event_fd);
+
+  // when the ring itself failed, the kernel may still be using the buffers,
+  // so they are leaked rather than freed under it
+  if (!ring_failed) {
+    file_crypt_ring_free(&ring);
+    sodium_memzero(arena, arena_size);
+    free(arena);
+  }
+
+  if (error != 0) {
+    errno = error;
+    return -1;
+  }
+
+  return 0;
+}
+
+#endif
+
+bool file_crypt_io_uring_available () {
+#ifdef FILE_CRYPT_HAVE_IO_URING
+  static std::atomic<int> available(-1);
+
+  if (available.load() == -1) {
+    file_crypt_ring ring;
+    int ok = file_crypt_ring_init(&ring, 2) == 0;
+    if (ok) file_crypt_ring_free(&ring);
+    available = ok;
+  }
+
+  return available.load() == 1;
+#else
+  return false;
+#endif
+}
+
+// after a successful run, sizes the output to exactly the result
+static int file_crypt_finish (const file_crypt_job *job, int ret) {
+  if (ret != 0) return ret;
+
+  uint64_t macs = job->count * FILE_CRYPT_ABYTES;
+  uint64_t body = job->in_size - job->in_base;
+  uint64_t size = job->out_base + (job->options->encrypt ? body + macs : body - macs);
+
+  return file_crypt_truncate(job->options->out_fd, size);
+}
+
+int file_crypt_run (const file_crypt_options *options, enum file_crypt_engine *used) {
+  file_crypt_job job;
+
+  if (file_crypt_prepare(&job, options) != 0) return -1;
+
+  uint32_t threads = options->threads;
+  if (threads == 0) threads = std::thread::hardware_concurrency();
+  if (threads == 0) threads = 1;
+  if (threads > FILE_CRYPT_THREADS_MAX) threads = FILE_CRYPT_THREADS_MAX;
+
+  uint32_t depth = options->depth == 0 ? FILE_CRYPT_DEPTH_DEFAULT : options->depth;
+  if (depth > FILE_CRYPT_DEPTH_MAX) depth = FILE_CRYPT_DEPTH_MAX;
+
+  if (options->engine != FILE_CRYPT_ENGINE_PREAD) {
+#ifdef FILE_CRYPT_HAVE_IO_URING
+    bool unavailable = false;
+    int ret = file_crypt_run_io_uring(&job, threads, depth, &unavailable);
+
+    if (!unavailable || options->engine == FILE_CRYPT_ENGINE_IO_URING) {
+      *used = FILE_CRYPT_ENGINE_IO_URING;
+      return file_crypt_finish(&job, ret);
+    }
+#else
+    if (options->engine == FILE_CRYPT_ENGINE_IO_URING) {
+      errno = ENOSYS;
+      return -1;
+    }
+#endif
+  }
+
+  *used = FILE_CRYPT_ENGINE_PREAD;
+  return file_crypt_finish(&job, file_crypt_run_pread(&job, threads));
+}
+
+int file_crypt_discard (const file_crypt_options *options) {
+  if (file_crypt_check_distinct(options->in_fd, options->out_fd) != 0) return -1;
+  return file_crypt_truncate(options->out_fd, 0);
+}
@@ -0,0 +1,86 @@
+#ifndef SODIUM_NATIVE_FILE_CRYPT_H
+#define SODIUM_NATIVE_FILE_CRYPT_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "../libsodium/src/libsodium/include/sodium.h"
+
+// Encrypts or decrypts a whole file with crypto_aead_xchacha20poly1305_ietf,
+// keeping reads, encryption and writes of different chunks going at the same
+// time.
+//
+// An encrypted file is a header followed by every chunk of the plaintext
+// encrypted on its own, with its MAC appended:
+//
+//   header   random nonce prefix (16) || chunk size (4, LE) || zero (4)
+//   chunk i  ciphertext (chunk size, or less for the last) || MAC (16)
+//
+// Chunk i is encrypted with the nonce prefix || i (8, LE) and the additional
+// data header || i (8, LE) || final (1), where final is 1 only for the last
+// chunk. Since chunks do not depend on each other, they are encrypted and
+// decrypted in parallel and written out of order, while reordering, dropping
+// or truncating chunks still fails to decrypt. An empty file is a single empty
+// final chunk.
+//
+// Two engines move the data. On Linux the io_uring engine keeps up to depth
+// chunk reads and writes queued in the kernel, into buffers registered with
+// the ring once, while threads encrypt the chunks already read. Elsewhere, or
+// when io_uring is unavailable, each thread does pread, encrypt and pwrite on
+// its own chunks with a buffer of its own. Neither allocates per chunk.
+//
+// The input must be a regular file. The output is written at offsets from 0,
+// so it must be seekable too, and is truncated to the size of the result once
+// it is complete. Input and output must not be the same file. When a run
+// fails, the chunks that were done before the failure may already have been
+// written, see file_crypt_discard.
+
+#define FILE_CRYPT_HEADERBYTES 24U
+#define FILE_CRYPT_NONCE_PREFIXBYTES 16U
+#define FILE_CRYPT_ABYTES crypto_aead_xchacha20poly1305_ietf_ABYTES
+
+#define FILE_CRYPT_CHUNK_MIN 4096U
+#define FILE_CRYPT_CHUNK_MAX (16U * 1024 * 1024)
+#define FILE_CRYPT_CHUNK_DEFAULT (256U * 1024)
+
+#define FILE_CRYPT_DEPTH_MAX 256U
+#define FILE_CRYPT_DEPTH_DEFAULT 16U
+
+#define FILE_CRYPT_THREADS_MAX 64U
+
+enum file_crypt_engine {
+  FILE_CRYPT_ENGINE_AUTO,
+  FILE_CRYPT_ENGINE_IO_URING,
+  FILE_CRYPT_ENGINE_PREAD
+};
+
+typedef struct file_crypt_options {
+  int encrypt;
+  int in_fd;
+  int out_fd;
+  unsigned char key[crypto_aead_xchacha20poly1305_ietf_KEYBYTES];
+  // only used to encrypt, decryption reads it from the header
+  uint32_t chunk_size;
+  // chunks in flight at once, for the io_uring engine
+  uint32_t depth;
+  // encryption threads, 0 for one per CPU
+  uint32_t threads;
+  enum file_crypt_engine engine;
+} file_crypt_options;
+
+// Returns 0 and sets *used to the engine that ran, or -1 with errno set.
+// A FILE_CRYPT_ENGINE_AUTO request falls back from io_uring to pread when the
+// ring cannot be set up, while FILE_CRYPT_ENGINE_IO_URING fails with the error
+// from setting it up, or ENOSYS where there is no io_uring at all.
+// Decryption fails with EBADMSG when the input does not verify, and both fail
+// with EINVAL when the input and output are the same file.
+int file_crypt_run (const file_crypt_options *options, enum file_crypt_engine *used);
+
+// Empties the output after a failed run, so none of a partial result or of
+// what the output held before is left, unless it is the input.
+int file_crypt_discard (const file_crypt_options *options);
+
+// Whether the io_uring engine can run in this process.
+bool file_crypt_io_uring_available ();
+
+#endif
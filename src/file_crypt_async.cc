@@ -0,0 +1,126 @@
+#include <nan.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <string>
+#include "macros.h"
+#include "timed_async_worker.h"
+#include "file_crypt.h"
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+#include "../libsodium/src/libsodium/include/sodium.h"
+
+// encrypts or decrypts a whole file on the threadpool. A negative fd in the
+// options means the matching path is opened on the worker, and closed after.
+// The output is not opened with O_TRUNC, so a path naming the input is
+// rejected before it is written, and file_crypt_run truncates it when done.
+// When the run fails, an output the worker created is removed and one it
+// opened by path is emptied
+class FileCryptAsync : public TimedAsyncWorker {
+ public:
+  FileCryptAsync(Nan::Callback *callback, const char *resource_name, const file_crypt_options &options, const std::string &in_path, const std::string &out_path)
+    : TimedAsyncWorker(callback, resource_name), options(options), in_path(in_path), out_path(out_path), used(FILE_CRYPT_ENGINE_AUTO), errorno(0) {}
+  ~FileCryptAsync() {
+    sodium_memzero(options.key, sizeof(options.key));
+  }
+
+  void Run () {
+    int in_fd = options.in_fd;
+    int out_fd = options.out_fd;
+    bool created = false;
+    bool failed = true;
+
+    if (in_fd < 0) in_fd = FileOpen(in_path, false, NULL);
+    if (in_fd >= 0 && out_fd < 0) out_fd = FileOpen(out_path, true, &created);
+
+    if (in_fd >= 0 && out_fd >= 0) {
+      file_crypt_options opened = options;
+      opened.in_fd = in_fd;
+      opened.out_fd = out_fd;
+
+      CALL_SODIUM_ASYNC_WORKER(errorno, file_crypt_run(&opened, &used))
+      failed = ret != 0;
+      if (failed && options.out_fd < 0 && !created) file_crypt_discard(&opened);
+      sodium_memzero(opened.key, sizeof(opened.key));
+    } else {
+      SetErrorMessage("error");
+      errorno = errno;
+    }
+
+    if (options.in_fd < 0 && in_fd >= 0) FileClose(in_fd);
+    if (options.out_fd < 0 && out_fd >= 0) {
+      FileClose(out_fd);
+      if (failed && created) FileUnlink(out_path);
+    }
+  }
+
+  void HandleOKCallback () {
+    Nan::HandleScope scope;
+
+    v8::Local<v8::Value> argv[] = {
+        Nan::Null(),
+        Nan::New(used == FILE_CRYPT_ENGINE_IO_URING ? "io_uring" : "pread").ToLocalChecked()
+    };
+
+    callback->Call(2, argv, async_resource);
+  }
+
+  void HandleErrorCallback () {
+    Nan::HandleScope scope;
+
+    v8::Local<v8::Value> argv[] = {
+        ERRNO_EXCEPTION(errorno)
+    };
+
+    callback->Call(1, argv, async_resource);
+  }
+
+ private:
+  // an output is created exclusively first, so *created tells whether it is
+  // ours to remove again
+  static int FileOpen (const std::string &path, bool output, bool *created) {
+#ifdef _WIN32
+    if (!output) return _open(path.c_str(), _O_RDONLY | _O_BINARY);
+
+    int fd = _open(path.c_str(), _O_WRONLY | _O_CREAT | _O_EXCL | _O_BINARY, _S_IREAD | _S_IWRITE);
+    *created = fd >= 0;
+    if (fd < 0 && errno == EEXIST) fd = _open(path.c_str(), _O_WRONLY | _O_BINARY);
+#else
+    if (!output) return open(path.c_str(), O_RDONLY | O_CLOEXEC);
+
+    int fd = open(path.c_str(), O_WRONLY | O_CREAT | O_EXCL | O_CLOEXEC, 0666);
+    *created = fd >= 0;
+    if (fd < 0 && errno == EEXIST) fd = open(path.c_str(), O_WRONLY | O_CLOEXEC);
+#endif
+    return fd;
+  }
+
+  static void FileUnlink (const std::string &path) {
+#ifdef _WIN32
+    _unlink(path.c_str());
+#else
+    unlink(path.c_str());
+#endif
+  }
+
+  static void FileClose (int fd) {
+    int err = errno;
+#ifdef _WIN32
+    _close(fd);
+#else
+    close(fd);
+#endif
+    errno = err;
+  }
+
+  file_crypt_options options;
+  std::string in_path;
+  std::string out_path;
+  enum file_crypt_engine used;
+  int errorno;
+};
@@ -0,0 +1,187 @@
+#include <errno.h>
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include "file_hash.h"
+
+#ifdef _WIN32
+#include <io.h>
+#include <malloc.h>
+#else
+#include <unistd.h>
+#endif
+
+#include "../libsodium/src/libsodium/include/sodium.h"
+
+typedef union file_hash_state {
+  crypto_generichash_state generichash;
+  crypto_hash_sha256_state sha256;
+  crypto_hash_sha512_state sha512;
+} file_hash_state;
+
+static int file_hash_init (file_hash_state *state, enum file_hash_algorithm algorithm, const unsigned char *key, size_t key_length, size_t output_length) {
+  switch (algorithm) {
+    case FILE_HASH_GENERICHASH:
+      return crypto_generichash_init(&state->generichash, key, key_length, output_length);
+    case FILE_HASH_SHA256:
+      if (output_length != crypto_hash_sha256_BYTES) break;
+      return crypto_hash_sha256_init(&state->sha256);
+    case FILE_HASH_SHA512:
+      if (output_length != crypto_hash_sha512_BYTES) break;
+      return crypto_hash_sha512_init(&state->sha512);
+  }
+
+  return -1;
+}
+
+static void file_hash_update (file_hash_state *state, enum file_hash_algorithm algorithm, const unsigned char *input, size_t input_length) {
+  switch (algorithm) {
+    case FILE_HASH_GENERICHASH:
+      crypto_generichash_update(&state->generichash, input, input_length);
+      break;
+    case FILE_HASH_SHA256:
+      crypto_hash_sha256_update(&state->sha256, input, input_length);
+      break;
+    case FILE_HASH_SHA512:
+      crypto_hash_sha512_update(&state->sha512, input, input_length);
+      break;
+  }
+}
+
+static void file_hash_final (file_hash_state *state, enum file_hash_algorithm algorithm, unsigned char *output, size_t output_length) {
+  switch (algorithm) {
+    case FILE_HASH_GENERICHASH:
+      crypto_generichash_final(&state->generichash, output, output_length);
+      break;
+    case FILE_HASH_SHA256:
+      crypto_hash_sha256_final(&state->sha256, output);
+      break;
+    case FILE_HASH_SHA512:
+      crypto_hash_sha512_final(&state->sha512, output);
+      break;
+  }
+}
+
+static unsigned char * file_hash_buffer_alloc () {
+#ifdef _WIN32
+  return (unsigned char *) _aligned_malloc(FILE_HASH_READ_SIZE, 4096);
+#else
+  void *buf = NULL;
+  if (posix_memalign(&buf, 4096, FILE_HASH_READ_SIZE)) return NULL;
+  return (unsigned char *) buf;
+#endif
+}
+
+static void file_hash_buffer_free (unsigned char *buf) {
+#ifdef _WIN32
+  _aligned_free(buf);
+#else
+  free(buf);
+#endif
+}
+
+// reads at an offset, or from the current position when offset is NULL.
+// Returns the number of bytes read, 0 at the end of the file or -1
+static long file_hash_read (int fd, unsigned char *buf, size_t length, const uint64_t *offset) {
+#ifdef _WIN32
+  if (offset != NULL && _lseeki64(fd, (__int64) *offset, SEEK_SET) < 0) return -1;
+  return _read(fd, buf, (unsigned int) length);
+#else
+  ssize_t n;
+
+  do {
+    n = offset == NULL ? read(fd, buf, length) : pread(fd, buf, length, (off_t) *offset);
+  } while (n < 0 && errno == EINTR);
+
+  return (long) n;
+#endif
+}
+
+int file_hash_fd (enum file_hash_algorithm algorithm, unsigned char *output, size_t output_length, const unsigned char *key, size_t key_length, int fd, uint64_t offset, uint64_t length) {
+  file_hash_state state;
+
+  if (file_hash_init(&state, algorithm, key, key_length, output_length) != 0) {
+    errno = EINVAL;
+    return -1;
+  }
+
+  unsigned char *buf = file_hash_buffer_alloc();
+  if (buf == NULL) {
+    errno = ENOMEM;
+    return -1;
+  }
+
+  uint64_t end = length > UINT64_MAX - offset ? UINT64_MAX : offset + length;
+  uint64_t position = offset;
+  bool positional = true;
+  int err = 0;
+
+#if !defined(_WIN32) && defined(POSIX_FADV_SEQUENTIAL)
+  posix_fadvise(fd, (off_t) offset, length == FILE_HASH_TO_END ? 0 : (off_t) length, POSIX_FADV_SEQUENTIAL);
+#endif
+
+  while (position < end) {
+    // after the first read every read starts on a block boundary
+    uint64_t want = FILE_HASH_READ_SIZE - position % FILE_HASH_READ_SIZE;
+    if (want > end - position) want = end - position;
+
+    long n = file_hash_read(fd, buf, (size_t) want, positional ? &position : NULL);
+
+#ifndef _WIN32
+    // a pipe or socket, read it from where it is
+    if (n < 0 && errno == ESPIPE && positional) {
+      positional = false;
+      position = 0;
+      continue;
+    }
+#endif
+
+    if (n < 0) {
+      err = errno;
+      break;
+    }
+
+    if (n == 0) break;
+
+    // bytes before offset are only read from files that cannot seek
+    if (position + n > offset) {
+      uint64_t skip = position < offset ? offset - position : 0;
+      file_hash_update(&state, algorithm, buf + skip, n - skip);
+    }
+
+    position += n;
+  }
+
+  file_hash_buffer_free(buf);
+
+  if (err != 0) {
+    sodium_memzero(&state, sizeof(state));
+    errno = err;
+    return -1;
+  }
+
+  file_hash_final(&state, algorithm, output, output_length);
+  return 0;
+}
+
+int file_hash_path (enum file_hash_algorithm algorithm, unsigned char *output, size_t output_length, const unsigned char *key, size_t key_length, const char *path, uint64_t offset, uint64_t length) {
+#ifdef _WIN32
+  int fd = _open(path, _O_RDONLY | _O_BINARY | _O_SEQUENTIAL);
+#else
+  int fd = open(path, O_RDONLY | O_CLOEXEC);
+#endif
+
+  if (fd < 0) return -1;
+
+  int ret = file_hash_fd(algorithm, output, output_length, key, key_length, fd, offset, length);
+  int err = errno;
+
+#ifdef _WIN32
+  _close(fd);
+#else
+  close(fd);
+#endif
+
+  errno = err;
+  return ret;
+}
@@ -0,0 +1,37 @@
+#ifndef SODIUM_NATIVE_FILE_HASH_H
+#define SODIUM_NATIVE_FILE_HASH_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Hashes a range of a file without handing any of it to JS. The file is read
+// in FILE_HASH_READ_SIZE blocks, at offsets that are a multiple of the block
+// size after the first one, into a single page aligned buffer, and the kernel
+// is told the access is sequential so it reads ahead while a block is hashed.
+//
+// Reads are used rather than mmap, so a file truncated while it is hashed ends
+// the hash early instead of raising SIGBUS in the whole process. Pipes and
+// other files that cannot be read at an offset are read from their current
+// position, discarding offset bytes first.
+
+#define FILE_HASH_READ_SIZE (1024 * 1024)
+
+// hash everything from offset to the end of the file
+#define FILE_HASH_TO_END UINT64_MAX
+
+enum file_hash_algorithm {
+  FILE_HASH_GENERICHASH,
+  FILE_HASH_SHA256,
+  FILE_HASH_SHA512
+};
+
+// Hashes up to length bytes of fd starting at offset, stopping early at the end
+// of the file. key is only used by FILE_HASH_GENERICHASH, and output_length must
+// be the digest length of the algorithm for the others. fd is not closed.
+// Returns 0, or -1 with errno set.
+int file_hash_fd (enum file_hash_algorithm algorithm, unsigned char *output, size_t output_length, const unsigned char *key, size_t key_length, int fd, uint64_t offset, uint64_t length);
+
+// Same as file_hash_fd, opening path for reading and closing it afterwards.
+int file_hash_path (enum file_hash_algorithm algorithm, unsigned char *output, size_t output_length, const unsigned char *key, size_t key_length, const char *path, uint64_t offset, uint64_t length);
+
+#endif
@@ -0,0 +1,59 @@
+#include <nan.h>
+#include <string>
+#include "macros.h"
+#include "timed_async_worker.h"
+#include "file_hash.h"
+
+#include "../libsodium/src/libsodium/include/sodium.h"
+
+// hashes a whole range of a file on the threadpool, the output and key buffers
+// are kept alive by the binding with SaveToPersistent. A negative fd means path
+// is opened on the worker, so a slow open does not block the loop either
+class FileHashAsync : public TimedAsyncWorker {
+ public:
+  FileHashAsync(Nan::Callback *callback, const char *resource_name, enum file_hash_algorithm algorithm, unsigned char *output, size_t output_length, const unsigned char *key, size_t key_length, int fd, const std::string &path, uint64_t offset, uint64_t length)
+    : TimedAsyncWorker(callback, resource_name), algorithm(algorithm), output(output), output_length(output_length), key(key), key_length(key_length), fd(fd), path(path), has_path(fd < 0), offset(offset), length(length), errorno(0) {}
+  ~FileHashAsync() {}
+
+  void Run () {
+    if (has_path) {
+      CALL_SODIUM_ASYNC_WORKER(errorno, file_hash_path(algorithm, output, output_length, key, key_length, path.c_str(), offset, length))
+    } else {
+      CALL_SODIUM_ASYNC_WORKER(errorno, file_hash_fd(algorithm, output, output_length, key, key_length, fd, offset, length))
+    }
+  }
+
+  void HandleOKCallback () {
+    Nan::HandleScope scope;
+
+    v8::Local<v8::Value> argv[] = {
+        Nan::Null(),
+        GetFromPersistent("output")
+    };
+
+    callback->Call(2, argv, async_resource);
+  }
+
+  void HandleErrorCallback () {
+    Nan::HandleScope scope;
+
+    v8::Local<v8::Value> argv[] = {
+        ERRNO_EXCEPTION(errorno)
+    };
+
+    callback->Call(1, argv, async_resource);
+  }
+
+ private:
+  enum file_hash_algorithm algorithm;
+  unsigned char *output;
+  size_t output_length;
+  const unsigned char *key;
+  size_t key_length;
+  int fd;
+  std::string path;
+  bool has_path;
+  uint64_t offset;
+  uint64_t length;
+  int errorno;
+};
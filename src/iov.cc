@@ -0,0 +1,327 @@
+#include "iov.h"
+
+#include <string.h>
+
+// position in a list of buffers
+typedef struct iov_cursor {
+  const iov_buffer *iov;
+  size_t count;
+  size_t index;
+  size_t offset;
+} iov_cursor;
+
+// keystream of salsa20 (secretbox) or chacha20_ietf (aead) with the partial
+// block left over from the previous fragment
+typedef struct iov_stream {
+  int ietf;
+  unsigned char key[32];
+  unsigned char nonce[12];
+  uint64_t block;
+  unsigned char buf[64];
+  size_t used;
+} iov_stream;
+
+static const unsigned char iov_pad0[16] = { 0 };
+
+size_t iov_length (const iov_buffer *iov, size_t count) {
+  size_t length = 0;
+  for (size_t i = 0; i < count; i++) length += iov[i].length;
+  return length;
+}
+
+static void iov_cursor_init (iov_cursor *cursor, const iov_buffer *iov, size_t count) {
+  cursor->iov = iov;
+  cursor->count = count;
+  cursor->index = 0;
+  cursor->offset = 0;
+}
+
+// the longest contiguous span of at most max bytes at the cursor, which is
+// then advanced past it
+static unsigned char * iov_cursor_next (iov_cursor *cursor, size_t max, size_t *length) {
+  while (cursor->index < cursor->count && cursor->offset == cursor->iov[cursor->index].length) {
+    cursor->index++;
+    cursor->offset = 0;
+  }
+
+  const iov_buffer *buf = &(cursor->iov[cursor->index]);
+  size_t available = buf->length - cursor->offset;
+  unsigned char *data = buf->data + cursor->offset;
+
+  *length = available < max ? available : max;
+  cursor->offset += *length;
+  return data;
+}
+
+static void iov_cursor_skip (iov_cursor *cursor, size_t length) {
+  while (length > 0) {
+    size_t n;
+    iov_cursor_next(cursor, length, &n);
+    length -= n;
+  }
+}
+
+static void iov_cursor_read (iov_cursor *cursor, unsigned char *out, size_t length) {
+  while (length > 0) {
+    size_t n;
+    unsigned char *data = iov_cursor_next(cursor, length, &n);
+    memcpy(out, data, n);
+    out += n;
+    length -= n;
+  }
+}
+
+static void iov_cursor_write (iov_cursor *cursor, const unsigned char *in, size_t length) {
+  while (length > 0) {
+    size_t n;
+    unsigned char *data = iov_cursor_next(cursor, length, &n);
+    memcpy(data, in, n);
+    in += n;
+    length -= n;
+  }
+}
+
+static void iov_stream_xor_ic (iov_stream *stream, unsigned char *out, const unsigned char *in, size_t length) {
+  if (stream->ietf) {
+    crypto_stream_chacha20_ietf_xor_ic(out, in, length, stream->nonce, (uint32_t) stream->block, stream->key);
+  } else {
+    crypto_stream_salsa20_xor_ic(out, in, length, stream->nonce, stream->block, stream->key);
+  }
+  stream->block += length / 64;
+}
+
+static void iov_stream_refill (iov_stream *stream) {
+  memset(stream->buf, 0, 64);
+  iov_stream_xor_ic(stream, stream->buf, stream->buf, 64);
+  stream->used = 0;
+}
+
+static void iov_stream_xor (iov_stream *stream, unsigned char *out, const unsigned char *in, size_t length) {
+  while (length > 0 && stream->used < 64) {
+    *out++ = *in++ ^ stream->buf[stream->used++];
+    length--;
+  }
+
+  size_t whole = length & ~((size_t) 63);
+  if (whole > 0) {
+    iov_stream_xor_ic(stream, out, in, whole);
+    out += whole;
+    in += whole;
+    length -= whole;
+  }
+
+  if (length > 0) {
+    iov_stream_refill(stream);
+    for (size_t i = 0; i < length; i++) out[i] = in[i] ^ stream->buf[stream->used++];
+  }
+}
+
+// encrypts length bytes from in to out and feeds the ciphertext to the mac
+static void iov_encrypt (iov_stream *stream, crypto_onetimeauth_poly1305_state *mac, iov_cursor *out, iov_cursor *in, size_t length) {
+  while (length > 0) {
+    size_t n;
+    unsigned char *src = iov_cursor_next(in, length, &n);
+    length -= n;
+
+    while (n > 0) {
+      size_t m;
+      unsigned char *dst = iov_cursor_next(out, n, &m);
+      iov_stream_xor(stream, dst, src, m);
+      crypto_onetimeauth_poly1305_update(mac, dst, m);
+      src += m;
+      n -= m;
+    }
+  }
+}
+
+// decrypts length bytes from in to out, the mac has already been checked
+static void iov_decrypt (iov_stream *stream, iov_cursor *out, iov_cursor *in, size_t length) {
+  while (length > 0) {
+    size_t n;
+    unsigned char *src = iov_cursor_next(in, length, &n);
+    length -= n;
+
+    while (n > 0) {
+      size_t m;
+      unsigned char *dst = iov_cursor_next(out, n, &m);
+      iov_stream_xor(stream, dst, src, m);
+      src += m;
+      n -= m;
+    }
+  }
+}
+
+static void iov_mac_update (crypto_onetimeauth_poly1305_state *mac, iov_cursor *in, size_t length) {
+  while (length > 0) {
+    size_t n;
+    unsigned char *data = iov_cursor_next(in, length, &n);
+    crypto_onetimeauth_poly1305_update(mac, data, n);
+    length -= n;
+  }
+}
+
+// secretbox: subkey = hsalsa20(k, n[0..16]), salsa20 with nonce n[16..24].
+// The first 32 bytes of block 0 key poly1305, the message starts right after
+static void iov_secretbox_init (iov_stream *stream, crypto_onetimeauth_poly1305_state *mac, const unsigned char *n, const unsigned char *k) {
+  stream->ietf = 0;
+  crypto_core_hsalsa20(stream->key, n, k, NULL);
+  memcpy(stream->nonce, n + 16, 8);
+  stream->block = 0;
+
+  iov_stream_refill(stream);
+  crypto_onetimeauth_poly1305_init(mac, stream->buf);
+  stream->used = 32;
+}
+
+int iov_secretbox_easy (const iov_buffer *c, size_t c_count, const iov_buffer *m, size_t m_count, const unsigned char *n, const unsigned char *k) {
+  iov_stream stream;
+  crypto_onetimeauth_poly1305_state mac;
+  unsigned char tag[crypto_secretbox_MACBYTES];
+  iov_cursor in, out, tag_out;
+
+  size_t length = iov_length(m, m_count);
+  if (iov_length(c, c_count) < length + crypto_secretbox_MACBYTES) return -1;
+
+  iov_cursor_init(&in, m, m_count);
+  iov_cursor_init(&out, c, c_count);
+
+  // the mac goes in front of the ciphertext
+  tag_out = out;
+  iov_cursor_skip(&out, crypto_secretbox_MACBYTES);
+
+  iov_secretbox_init(&stream, &mac, n, k);
+  iov_encrypt(&stream, &mac, &out, &in, length);
+  crypto_onetimeauth_poly1305_final(&mac, tag);
+  iov_cursor_write(&tag_out, tag, crypto_secretbox_MACBYTES);
+
+  sodium_memzero(&stream, sizeof(stream));
+  sodium_memzero(&mac, sizeof(mac));
+  return 0;
+}
+
+int iov_secretbox_open_easy (const iov_buffer *m, size_t m_count, const iov_buffer *c, size_t c_count, const unsigned char *n, const unsigned char *k) {
+  iov_stream stream;
+  crypto_onetimeauth_poly1305_state mac;
+  unsigned char tag[crypto_secretbox_MACBYTES];
+  unsigned char expected[crypto_secretbox_MACBYTES];
+  iov_cursor in, out, body;
+
+  size_t c_length = iov_length(c, c_count);
+  if (c_length < crypto_secretbox_MACBYTES) return -1;
+
+  size_t length = c_length - crypto_secretbox_MACBYTES;
+  if (iov_length(m, m_count) < length) return -1;
+
+  iov_cursor_init(&in, c, c_count);
+  iov_cursor_read(&in, expected, crypto_secretbox_MACBYTES);
+  body = in;
+
+  iov_secretbox_init(&stream, &mac, n, k);
+  iov_mac_update(&mac, &in, length);
+  crypto_onetimeauth_poly1305_final(&mac, tag);
+
+  int ret = crypto_verify_16(tag, expected);
+
+  if (ret == 0) {
+    iov_cursor_init(&out, m, m_count);
+    iov_decrypt(&stream, &out, &body, length);
+  }
+
+  sodium_memzero(&stream, sizeof(stream));
+  sodium_memzero(&mac, sizeof(mac));
+  return ret;
+}
+
+// xchacha20poly1305_ietf: subkey = hchacha20(k, npub[0..16]), chacha20_ietf
+// with nonce 0^4 || npub[16..24]. Block 0 keys poly1305, the message starts
+// at block 1 and the mac covers ad, padding, ciphertext, padding and lengths
+static void iov_aead_init (iov_stream *stream, crypto_onetimeauth_poly1305_state *mac, const unsigned char *ad, unsigned long long ad_length, const unsigned char *npub, const unsigned char *k) {
+  stream->ietf = 1;
+  crypto_core_hchacha20(stream->key, npub, k, NULL);
+  memset(stream->nonce, 0, 4);
+  memcpy(stream->nonce + 4, npub + 16, 8);
+  stream->block = 0;
+
+  iov_stream_refill(stream);
+  crypto_onetimeauth_poly1305_init(mac, stream->buf);
+  stream->used = 64;
+
+  crypto_onetimeauth_poly1305_update(mac, ad, ad_length);
+  crypto_onetimeauth_poly1305_update(mac, iov_pad0, (0x10 - ad_length) & 0xf);
+}
+
+static void iov_aead_final (crypto_onetimeauth_poly1305_state *mac, unsigned long long ad_length, unsigned long long length, unsigned char *tag) {
+  unsigned char lengths[16];
+
+  crypto_onetimeauth_poly1305_update(mac, iov_pad0, (0x10 - length) & 0xf);
+  for (int i = 0; i < 8; i++) {
+    lengths[i] = (unsigned char) (ad_length >> (8 * i));
+    lengths[8 + i] = (unsigned char) (((uint64_t) length) >> (8 * i));
+  }
+  crypto_onetimeauth_poly1305_update(mac, lengths, sizeof(lengths));
+  crypto_onetimeauth_poly1305_final(mac, tag);
+}
+
+int iov_aead_xchacha20poly1305_ietf_encrypt (const iov_buffer *c, size_t c_count, const iov_buffer *m, size_t m_count, const unsigned char *ad, unsigned long long ad_length, const unsigned char *npub, const unsigned char *k) {
+  iov_stream stream;
+  crypto_onetimeauth_poly1305_state mac;
+  unsigned char tag[crypto_aead_xchacha20poly1305_ietf_ABYTES];
+  iov_cursor in, out;
+
+  size_t length = iov_length(m, m_count);
+  if (length > crypto_aead_xchacha20poly1305_ietf_MESSAGEBYTES_MAX) return -1;
+  if (iov_length(c, c_count) < length + crypto_aead_xchacha20poly1305_ietf_ABYTES) return -1;
+
+  iov_cursor_init(&in, m, m_count);
+  iov_cursor_init(&out, c, c_count);
+
+  iov_aead_init(&stream, &mac, ad, ad_length, npub, k);
+  iov_encrypt(&stream, &mac, &out, &in, length);
+  iov_aead_final(&mac, ad_length, length, tag);
+  iov_cursor_write(&out, tag, sizeof(tag));
+
+  sodium_memzero(&stream, sizeof(stream));
+  sodium_memzero(&mac, sizeof(mac));
+  return 0;
+}
+
+int iov_aead_xchacha20poly1305_ietf_decrypt (const iov_buffer *m, size_t m_count, const iov_buffer *c, size_t c_count, const unsigned char *ad, unsigned long long ad_length, const unsigned char *npub, const unsigned char *k) {
+  iov_stream stream;
+  crypto_onetimeauth_poly1305_state mac;
+  unsigned char tag[crypto_aead_xchacha20poly1305_ietf_ABYTES];
+  unsigned char expected[crypto_aead_xchacha20poly1305_ietf_ABYTES];
+  iov_cursor in, out, body;
+
+  size_t c_length = iov_length(c, c_count);
+  if (c_length < crypto_aead_xchacha20poly1305_ietf_ABYTES) return -1;
+
+  size_t length = c_length - crypto_aead_xchacha20poly1305_ietf_ABYTES;
+  if (iov_length(m, m_count) < length) return -1;
+
+  iov_cursor_init(&in, c, c_count);
+  body = in;
+
+  iov_aead_init(&stream, &mac, ad, ad_length, npub, k);
+  iov_mac_update(&mac, &in, length);
+  iov_aead_final(&mac, ad_length, length, tag);
+  iov_cursor_read(&in, expected, sizeof(expected));
+
+  int ret = crypto_verify_16(tag, expected);
+
+  if (ret == 0) {
+    iov_cursor_init(&out, m, m_count);
+    iov_decrypt(&stream, &out, &body, length);
+  }
+
+  sodium_memzero(&stream, sizeof(stream));
+  sodium_memzero(&mac, sizeof(mac));
+  return ret;
+}
+
+int iov_generichash (unsigned char *out, size_t out_length, const iov_buffer *in, size_t in_count, const unsigned char *key, size_t key_length) {
+  crypto_generichash_state state;
+
+  if (crypto_generichash_init(&state, key, key_length, out_length) != 0) return -1;
+  for (size_t i = 0; i < in_count; i++) crypto_generichash_update(&state, in[i].data, in[i].length);
+  return crypto_generichash_final(&state, out, out_length);
+}
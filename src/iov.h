@@ -0,0 +1,38 @@
+#ifndef SODIUM_NATIVE_IOV_H
+#define SODIUM_NATIVE_IOV_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "../libsodium/src/libsodium/include/sodium.h"
+
+// Scatter/gather variants of secretbox, xchacha20poly1305_ietf and
+// generichash. Input and output are lists of buffers whose boundaries need not
+// line up; data is streamed through the cipher and MAC fragment by fragment,
+// so a framed message never has to be concatenated first. The results are
+// byte for byte those of the contiguous functions over the concatenation.
+//
+// Outputs must not overlap inputs. Output lists may be longer than needed,
+// the remainder is left untouched.
+
+typedef struct iov_buffer {
+  unsigned char *data;
+  size_t length;
+} iov_buffer;
+
+size_t iov_length (const iov_buffer *iov, size_t count);
+
+// c = mac || ciphertext, needs iov_length(c) >= iov_length(m) + crypto_secretbox_MACBYTES
+int iov_secretbox_easy (const iov_buffer *c, size_t c_count, const iov_buffer *m, size_t m_count, const unsigned char *n, const unsigned char *k);
+
+// returns -1 if the mac does not verify, in which case m is not written
+int iov_secretbox_open_easy (const iov_buffer *m, size_t m_count, const iov_buffer *c, size_t c_count, const unsigned char *n, const unsigned char *k);
+
+// c = ciphertext || mac, needs iov_length(c) >= iov_length(m) + crypto_aead_xchacha20poly1305_ietf_ABYTES
+int iov_aead_xchacha20poly1305_ietf_encrypt (const iov_buffer *c, size_t c_count, const iov_buffer *m, size_t m_count, const unsigned char *ad, unsigned long long ad_length, const unsigned char *npub, const unsigned char *k);
+
+// returns -1 if the mac does not verify, in which case m is not written
+int iov_aead_xchacha20poly1305_ietf_decrypt (const iov_buffer *m, size_t m_count, const iov_buffer *c, size_t c_count, const unsigned char *ad, unsigned long long ad_length, const unsigned char *npub, const unsigned char *k);
+
+int iov_generichash (unsigned char *out, size_t out_length, const iov_buffer *in, size_t in_count, const unsigned char *key, size_t key_length);
+
+#endif
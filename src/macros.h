@@ -3,24 +3,173 @@
 
 #include <errno.h>
 #include <string.h>
+#include <nan.h>
+#include "stats.h"
+
+#include "../libsodium/src/libsodium/include/sodium.h"
+
+// Every buffer argument may be a BufferSource: any ArrayBufferView (Buffer,
+// TypedArray or DataView) or a plain ArrayBuffer / SharedArrayBuffer. Data is
+// always read in place from the backing store, honouring the view's offset.
+
+#if NODE_MODULE_VERSION >= NODE_6_0_MODULE_VERSION
+#define IS_SHARED_ARRAY_BUFFER(val) val->IsSharedArrayBuffer()
+#else
+#define IS_SHARED_ARRAY_BUFFER(val) false
+#endif
+
+#define IS_BUFFER_SOURCE(val) (val->IsArrayBufferView() || val->IsArrayBuffer() || IS_SHARED_ARRAY_BUFFER(val))
+
+#if V8_MAJOR_VERSION >= 8
+#define ARRAY_BUFFER_DATA(ab) (unsigned char *) ab->GetBackingStore()->Data()
+#else
+#define ARRAY_BUFFER_DATA(ab) (unsigned char *) ab->GetContents().Data()
+#endif
+
+static inline unsigned char * buffer_source_data (v8::Local<v8::Value> buf) {
+  // node::Buffer::Data is the fast path for Buffer / Uint8Array on all versions
+  if (buf->IsUint8Array()) return (unsigned char *) node::Buffer::Data(buf);
+
+  if (buf->IsArrayBufferView()) {
+    v8::Local<v8::ArrayBufferView> view = buf.As<v8::ArrayBufferView>();
+    return ARRAY_BUFFER_DATA(view->Buffer()) + view->ByteOffset();
+  }
+
+  if (buf->IsArrayBuffer()) return ARRAY_BUFFER_DATA(buf.As<v8::ArrayBuffer>());
+
+#if NODE_MODULE_VERSION >= NODE_6_0_MODULE_VERSION
+  if (buf->IsSharedArrayBuffer()) return ARRAY_BUFFER_DATA(buf.As<v8::SharedArrayBuffer>());
+#endif
+
+  return NULL;
+}
+
+static inline unsigned long long buffer_source_length (v8::Local<v8::Value> buf) {
+  if (buf->IsArrayBufferView()) return buf.As<v8::ArrayBufferView>()->ByteLength();
+  if (buf->IsArrayBuffer()) return buf.As<v8::ArrayBuffer>()->ByteLength();
+
+#if NODE_MODULE_VERSION >= NODE_6_0_MODULE_VERSION
+  if (buf->IsSharedArrayBuffer()) return buf.As<v8::SharedArrayBuffer>()->ByteLength();
+#endif
+
+  return 0;
+}
 
 #define STR_HELPER(x) #x
 #define STR(x) STR_HELPER(x)
 
-#define CDATA(buf) (unsigned char *) node::Buffer::Data(buf)
-#define CLENGTH(buf) (unsigned long long) node::Buffer::Length(buf)
+#define CDATA(buf) buffer_source_data(buf)
+#define CLENGTH(buf) buffer_source_length(buf)
 #define LOCAL_STRING(str) Nan::New<v8::String>(str).ToLocalChecked()
 #define LOCAL_FUNCTION(fn) Nan::GetFunction(Nan::New<v8::FunctionTemplate>(fn)).ToLocalChecked()
 #define EXPORT_NUMBER(name) Nan::Set(target, LOCAL_STRING(#name), Nan::New<v8::Number>(name));
 #define EXPORT_NUMBER_VALUE(name, value) Nan::Set(target, LOCAL_STRING(#name), Nan::New<v8::Number>(value));
 #define EXPORT_STRING(name) Nan::Set(target, LOCAL_STRING(#name), LOCAL_STRING(name));
-#define EXPORT_FUNCTION(name) Nan::Set(target, LOCAL_STRING(#name), LOCAL_FUNCTION(name));
+// Functions are only created on first access, as most programs use a handful
+// of them. V8 replaces the lazy property with a plain data property afterwards.
+#if V8_MAJOR_VERSION >= 6
+#define EXPORT_FUNCTION(name) \
+  target->SetLazyDataProperty(Nan::GetCurrentContext(), LOCAL_STRING(#name), lazy_function_getter<name>).FromJust();
+#else
+#define EXPORT_FUNCTION(name) Nan::Set(target, LOCAL_STRING(#name), STATS_FUNCTION(#name, name));
+#endif
 #define EXPORT_BYTE_TAG_AS_BUFFER(name) \
   const char name##_TMP = name; \
   Nan::Set(target, \
            LOCAL_STRING(#name), \
            Nan::CopyBuffer(&name##_TMP, crypto_secretstream_xchacha20poly1305_TAGBYTES).ToLocalChecked());
 
+template <Nan::FunctionCallback fn>
+static void lazy_function_getter (v8::Local<v8::Name> property, const v8::PropertyCallbackInfo<v8::Value> &info) {
+  info.GetReturnValue().Set(STATS_FUNCTION(*Nan::Utf8String(property), fn));
+}
+
+// Incremental states can live in caller-owned buffers, at any offset. States
+// that are not aligned for their type are worked on in an aligned copy, which
+// is written back and wiped when this goes out of scope.
+template <typename T>
+class caller_state {
+ public:
+  T *state;
+
+  explicit caller_state (unsigned char *data) : data(data) {
+    if (((uintptr_t) data) % alignof(T) == 0) {
+      state = (T *) data;
+    } else {
+      memcpy(&copy, data, sizeof(T));
+      state = &copy;
+    }
+  }
+
+  ~caller_state () {
+    if (state != &copy) return;
+    memcpy(data, &copy, sizeof(T));
+    sodium_memzero(&copy, sizeof(T));
+  }
+
+ private:
+  unsigned char *data;
+  T copy;
+};
+
+// States whose contents libsodium trusts, like the buffer offsets in the
+// generichash and onetimeauth states, are sealed: the caller-owned buffer holds
+// the state followed by a keyed tag over it, so a state not written by this
+// class is refused instead of letting libsodium write out of bounds. The state
+// is always worked on in a private copy, so another thread changing the buffer
+// meanwhile cannot bypass the check either.
+#define SEALED_STATE_TAGBYTES crypto_shorthash_BYTES
+
+inline const unsigned char * sealed_state_key () {
+  // shared by every isolate, so sealed states can be handed to workers
+  static struct key {
+    unsigned char bytes[crypto_shorthash_KEYBYTES];
+    key () { randombytes_buf(bytes, sizeof(bytes)); }
+  } key;
+
+  return key.bytes;
+}
+
+template <typename T>
+class sealed_state {
+ public:
+  T *state;
+  bool valid;
+
+  // fresh is for init, which writes a state over whatever the buffer held, and
+  // sets valid once it succeeded
+  sealed_state (unsigned char *data, bool fresh) : state(&copy), valid(false), data(data) {
+    if (fresh) return;
+
+    unsigned char tag[SEALED_STATE_TAGBYTES];
+    memcpy(&copy, data, sizeof(T));
+    crypto_shorthash(tag, (unsigned char *) &copy, sizeof(T), sealed_state_key());
+    valid = sodium_memcmp(tag, data + sizeof(T), sizeof(tag)) == 0;
+  }
+
+  ~sealed_state () {
+    if (valid) {
+      memcpy(data, &copy, sizeof(T));
+      crypto_shorthash(data + sizeof(T), (unsigned char *) &copy, sizeof(T), sealed_state_key());
+    }
+    sodium_memzero(&copy, sizeof(T));
+  }
+
+ private:
+  unsigned char *data;
+  T copy;
+};
+
+#define SEALED_STATEBYTES(type) (sizeof(type) + SEALED_STATE_TAGBYTES)
+
+// declares var as the sealed state in name, throwing unless it is valid
+#define ASSERT_SEALED_STATE(name, var, type, init_name) \
+  sealed_state<type> var(CDATA(name), false); \
+  if (!var.valid) { \
+    Nan::ThrowError(#name " must be a state initialised with " #init_name); \
+    return; \
+  }
+
 // workaround for old compilers
 #ifndef SIZE_MAX
 #define SIZE_MAX ((size_t) - 1)
@@ -59,11 +208,11 @@
   info.GetReturnValue().Set(ret == 1 ? Nan::True() : Nan::False());
 
 #define ASSERT_BUFFER(name, var) \
-  if (!name->IsObject()) { \
+  if (!IS_BUFFER_SOURCE(name)) { \
     Nan::ThrowError(#var " must be a buffer"); \
     return; \
   } \
-  v8::Local<v8::Object> var = name->ToObject(Nan::GetCurrentContext()).ToLocalChecked();
+  v8::Local<v8::Object> var = name.As<v8::Object>();
 
 #define ASSERT_BUFFER_SET_LENGTH(name, var) \
   ASSERT_BUFFER(name, var) \
@@ -76,6 +225,12 @@
     return; \
   }
 
+#define ASSERT_UINT32ARRAY(name, var) \
+  if (!name->IsUint32Array()) { \
+    Nan::ThrowError(#var " must be a Uint32Array"); \
+    return; \
+  }
+
 #define ASSERT_UINT(name, var) \
   if (!name->IsNumber()) { \
     Nan::ThrowError(#var " must be a number"); \
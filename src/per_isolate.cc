@@ -0,0 +1,29 @@
+#include "per_isolate.h"
+
+#if NODE_MAJOR_VERSION > 10 || (NODE_MAJOR_VERSION == 10 && NODE_MINOR_VERSION >= 2)
+#define HAVE_ENVIRONMENT_CLEANUP_HOOK 1
+#endif
+
+#ifdef HAVE_ENVIRONMENT_CLEANUP_HOOK
+static void per_isolate_constructor_cleanup (void *arg) {
+  Nan::Persistent<v8::FunctionTemplate> *constructor = (Nan::Persistent<v8::FunctionTemplate> *) arg;
+  constructor->Reset();
+}
+#endif
+
+void per_isolate_constructor_set (Nan::Persistent<v8::FunctionTemplate> *constructor, v8::Local<v8::FunctionTemplate> tpl) {
+#ifdef HAVE_ENVIRONMENT_CLEANUP_HOOK
+  // node refuses duplicate hooks, so only register when loaded the first time
+  if (constructor->IsEmpty()) {
+    node::AddEnvironmentCleanupHook(v8::Isolate::GetCurrent(), per_isolate_constructor_cleanup, constructor);
+  }
+#endif
+
+  constructor->Reset(tpl);
+}
+
+void per_isolate_cleanup_add (void (*fn)(void *), void *arg) {
+#ifdef HAVE_ENVIRONMENT_CLEANUP_HOOK
+  node::AddEnvironmentCleanupHook(v8::Isolate::GetCurrent(), fn, arg);
+#endif
+}
@@ -0,0 +1,22 @@
+#ifndef SODIUM_NATIVE_PER_ISOLATE_H
+#define SODIUM_NATIVE_PER_ISOLATE_H
+
+#include <nan.h>
+
+// Wrap constructors are declared `static thread_local`. Node runs every
+// isolate, the main one and each worker_thread, on a thread of its own, so
+// this gives each isolate its own set of templates.
+//
+// Templates are built lazily: NewInstance calls Init when the constructor of
+// the current isolate is still empty, so loading the module, and each worker
+// loading it, does not pay for the classes it never instantiates.
+
+// Store tpl in constructor and reset it when the environment owning the
+// current isolate is torn down, e.g. when a worker exits.
+void per_isolate_constructor_set (Nan::Persistent<v8::FunctionTemplate> *constructor, v8::Local<v8::FunctionTemplate> tpl);
+
+// Run fn(arg) when the environment owning the current isolate is torn down.
+// A no-op on node versions without environment cleanup hooks.
+void per_isolate_cleanup_add (void (*fn)(void *), void *arg);
+
+#endif
@@ -0,0 +1,312 @@
+#include "pwhash_arena.h"
+
+#ifdef SODIUM_NATIVE_PWHASH_ARENA
+
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <stdint.h>
+#include <string.h>
+#include <sys/eventfd.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "../libsodium/src/libsodium/include/sodium.h"
+
+// what the static libsodium calls instead of mmap and munmap
+extern "C" {
+void * sodium_native_pwhash_mmap (void *addr, size_t length, int prot, int flags, int fd, off_t offset);
+int sodium_native_pwhash_munmap (void *addr, size_t length);
+}
+
+// huge pages need 2 MiB alignment, which also rounds arenas up so a slightly
+// larger memlimit does not remap
+#define PWHASH_ARENA_ALIGN ((size_t) 2 * 1024 * 1024)
+
+typedef struct pwhash_arena {
+  unsigned char *base;
+  size_t size;
+  bool busy;
+} pwhash_arena;
+
+// arenas are owned by the thread that created them and never freed, only
+// their memory is, so a thread keeps its pointer across trims
+static std::mutex arenas_lock;
+static std::vector<pwhash_arena *> arenas;
+
+static std::atomic<bool> enabled(false);
+static std::atomic<bool> huge_pages(false);
+
+static thread_local pwhash_arena *thread_arena = NULL;
+static thread_local bool armed = false;
+static thread_local void *lent = NULL;
+static thread_local size_t lent_length = 0;
+
+// set once libsodium is seen calling the functions below
+static std::once_flag probe_once;
+static std::atomic<bool> probe_reached(false);
+static thread_local bool probing = false;
+
+static unsigned char * pwhash_arena_map (size_t size) {
+  unsigned char *raw = (unsigned char *) mmap(NULL, size + PWHASH_ARENA_ALIGN, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (raw == MAP_FAILED) return NULL;
+
+  unsigned char *base = (unsigned char *) (((uintptr_t) raw + PWHASH_ARENA_ALIGN - 1) & ~(uintptr_t) (PWHASH_ARENA_ALIGN - 1));
+  size_t head = base - raw;
+
+  if (head > 0) munmap(raw, head);
+  if (PWHASH_ARENA_ALIGN - head > 0) munmap(base + size, PWHASH_ARENA_ALIGN - head);
+
+#ifdef MADV_DONTDUMP
+  madvise(base, size, MADV_DONTDUMP);
+#endif
+
+#ifdef MADV_HUGEPAGE
+  if (huge_pages.load()) madvise(base, size, MADV_HUGEPAGE);
+#endif
+
+  // fault everything in now, so jobs never do
+#ifdef MADV_POPULATE_WRITE
+  if (madvise(base, size, MADV_POPULATE_WRITE) == 0) return base;
+#endif
+
+  long page = sysconf(_SC_PAGESIZE);
+  for (size_t i = 0; i < size; i += page) ((volatile unsigned char *) base)[i] = 0;
+
+  return base;
+}
+
+static void pwhash_arena_release (pwhash_arena *arena) {
+  if (arena->base != NULL) munmap(arena->base, arena->size);
+  arena->base = NULL;
+  arena->size = 0;
+}
+
+pwhash_arena_scope::pwhash_arena_scope () {
+  if (!enabled.load()) return;
+
+  std::lock_guard<std::mutex> guard(arenas_lock);
+
+  if (thread_arena == NULL) {
+    thread_arena = new pwhash_arena();
+    thread_arena->base = NULL;
+    thread_arena->size = 0;
+    arenas.push_back(thread_arena);
+  }
+
+  thread_arena->busy = true;
+  armed = true;
+}
+
+pwhash_arena_scope::~pwhash_arena_scope () {
+  if (thread_arena == NULL || !thread_arena->busy) return;
+
+  armed = false;
+
+  // only left lent if libsodium never unmapped it
+  if (lent != NULL) sodium_memzero(lent, lent_length);
+  lent = NULL;
+  lent_length = 0;
+
+  std::lock_guard<std::mutex> guard(arenas_lock);
+  thread_arena->busy = false;
+  if (!enabled.load()) pwhash_arena_release(thread_arena);
+}
+
+void * sodium_native_pwhash_mmap (void *addr, size_t length, int prot, int flags, int fd, off_t offset) {
+  // only the work area, the first large anonymous mapping of a job
+  bool work_area = addr == NULL && fd == -1 && length >= PWHASH_ARENA_MIN &&
+    (flags & (MAP_ANONYMOUS | MAP_PRIVATE | MAP_FIXED)) == (MAP_ANONYMOUS | MAP_PRIVATE);
+
+  if (probing && work_area) probe_reached = true;
+
+  if (!armed || !work_area) return mmap(addr, length, prot, flags, fd, offset);
+
+  armed = false;
+
+  pwhash_arena *arena = thread_arena;
+
+  if (arena->size < length) {
+    size_t size = (length + PWHASH_ARENA_ALIGN - 1) & ~(PWHASH_ARENA_ALIGN - 1);
+    unsigned char *base;
+
+    {
+      std::lock_guard<std::mutex> guard(arenas_lock);
+      pwhash_arena_release(arena);
+    }
+
+    base = pwhash_arena_map(size);
+    if (base == NULL) return mmap(addr, length, prot, flags, fd, offset);
+
+    std::lock_guard<std::mutex> guard(arenas_lock);
+    arena->base = base;
+    arena->size = size;
+  }
+
+  lent = arena->base;
+  lent_length = length;
+
+  return arena->base;
+}
+
+int sodium_native_pwhash_munmap (void *addr, size_t length) {
+  if (addr == NULL || addr != lent) return munmap(addr, length);
+
+  // kept mapped and faulted in, but not readable by whoever looks next
+  sodium_memzero(addr, lent_length);
+  lent = NULL;
+  lent_length = 0;
+
+  return 0;
+}
+
+// memory pressure, from a pressure stall information trigger: woken when
+// tasks stalled on memory for 150ms within any 2s window
+static std::mutex watcher_lock;
+static std::thread *watcher = NULL;
+static int watcher_stop = -1;
+
+static void pwhash_arena_watch (int psi, int stop) {
+  struct pollfd fds[2];
+  fds[0].fd = psi;
+  fds[0].events = POLLPRI;
+  fds[1].fd = stop;
+  fds[1].events = POLLIN;
+
+  for (;;) {
+    fds[0].revents = fds[1].revents = 0;
+
+    if (poll(fds, 2, -1) < 0) {
+      if (errno == EINTR) continue;
+      break;
+    }
+
+    if (fds[1].revents != 0 || (fds[0].revents & POLLERR) != 0) break;
+    if (fds[0].revents & POLLPRI) pwhash_arena_trim();
+  }
+
+  close(psi);
+}
+
+static bool pwhash_arena_watch_start () {
+  std::lock_guard<std::mutex> guard(watcher_lock);
+  if (watcher != NULL) return true;
+
+  int psi = open("/proc/pressure/memory", O_RDWR | O_NONBLOCK | O_CLOEXEC);
+  if (psi < 0) return false;
+
+  const char trigger[] = "some 150000 2000000";
+
+  // the trigger string includes its terminating zero
+  if (write(psi, trigger, sizeof(trigger)) < 0) {
+    close(psi);
+    return false;
+  }
+
+  int stop = eventfd(0, EFD_CLOEXEC);
+  if (stop < 0) {
+    close(psi);
+    return false;
+  }
+
+  // never deleted, a joinable std::thread destroyed at exit would terminate
+  watcher = new std::thread(pwhash_arena_watch, psi, stop);
+  watcher_stop = stop;
+
+  return true;
+}
+
+static void pwhash_arena_watch_stop () {
+  std::lock_guard<std::mutex> guard(watcher_lock);
+  if (watcher == NULL) return;
+
+  uint64_t one = 1;
+  if (write(watcher_stop, &one, sizeof(one)) < 0) return;
+
+  watcher->join();
+  delete watcher;
+  watcher = NULL;
+
+  close(watcher_stop);
+  watcher_stop = -1;
+}
+
+// a libsodium built without the renaming, e.g. an archive left from an older
+// build, never calls the functions above, so one small hash checks it does
+static void pwhash_arena_probe () {
+  unsigned char out[16];
+  unsigned char salt[crypto_pwhash_SALTBYTES] = { 0 };
+
+  probing = true;
+  crypto_pwhash(out, sizeof(out), "", 0, salt, crypto_pwhash_OPSLIMIT_MIN, PWHASH_ARENA_MIN, crypto_pwhash_ALG_ARGON2ID13);
+  probing = false;
+}
+
+bool pwhash_arena_available () {
+  std::call_once(probe_once, pwhash_arena_probe);
+  return probe_reached.load();
+}
+
+bool pwhash_arena_enable (bool use_huge_pages) {
+  huge_pages = use_huge_pages;
+  enabled = true;
+  return pwhash_arena_watch_start();
+}
+
+void pwhash_arena_disable () {
+  enabled = false;
+  pwhash_arena_watch_stop();
+  pwhash_arena_trim();
+}
+
+size_t pwhash_arena_trim () {
+  std::lock_guard<std::mutex> guard(arenas_lock);
+  size_t released = 0;
+
+  for (size_t i = 0; i < arenas.size(); i++) {
+    if (arenas[i]->busy) continue;
+    released += arenas[i]->size;
+    pwhash_arena_release(arenas[i]);
+  }
+
+  return released;
+}
+
+size_t pwhash_arena_bytes () {
+  std::lock_guard<std::mutex> guard(arenas_lock);
+  size_t bytes = 0;
+
+  for (size_t i = 0; i < arenas.size(); i++) bytes += arenas[i]->size;
+
+  return bytes;
+}
+
+#else
+
+pwhash_arena_scope::pwhash_arena_scope () {}
+
+pwhash_arena_scope::~pwhash_arena_scope () {}
+
+bool pwhash_arena_available () {
+  return false;
+}
+
+bool pwhash_arena_enable (bool) {
+  return false;
+}
+
+void pwhash_arena_disable () {}
+
+size_t pwhash_arena_trim () {
+  return 0;
+}
+
+size_t pwhash_arena_bytes () {
+  return 0;
+}
+
+#endif
@@ -0,0 +1,55 @@
+#ifndef SODIUM_NATIVE_PWHASH_ARENA_H
+#define SODIUM_NATIVE_PWHASH_ARENA_H
+
+#include <stddef.h>
+
+// Keeps the memory crypto_pwhash and crypto_pwhash_scryptsalsa208sha256 work
+// in between jobs, instead of libsodium mapping and unmapping the whole
+// memlimit, and faulting in every page of it, for every hash.
+//
+// libsodium has no allocator hook, but it maps its work area with a single
+// anonymous mmap and releases it with munmap. On Linux, preinstall.js compiles
+// the static libsodium with mmap and munmap renamed to
+// sodium_native_pwhash_mmap and sodium_native_pwhash_munmap, defined here, and
+// binding.gyp defines SODIUM_NATIVE_PWHASH_ARENA. The renaming happens before
+// compilation, so link time optimisation cannot undo it, and only libsodium's
+// calls are affected, not those of the binding. pwhash_arena_available checks
+// with one small hash that libsodium really calls them.
+//
+// While a pwhash_arena_scope is open on a thread, its first large anonymous
+// mapping is served from an arena owned by that thread, which is mapped and
+// pre-faulted once, optionally with transparent huge pages, and the matching
+// munmap leaves it mapped. Every other mapping goes straight to the kernel.
+// The used part of the arena is wiped when libsodium unmaps it, so the blocks
+// of the last job do not outlive it, and arenas are left out of core dumps.
+//
+// Arenas are only lent out after pwhash_arena_enable. Idle arenas are released
+// by pwhash_arena_trim, which also runs when the kernel reports memory pressure
+// through /proc/pressure/memory, where pressure stall information is available.
+// Without SODIUM_NATIVE_PWHASH_ARENA everything here does nothing.
+
+#define PWHASH_ARENA_MIN (1024 * 1024)
+
+// brackets a pwhash job on a threadpool thread
+class pwhash_arena_scope {
+ public:
+  pwhash_arena_scope();
+  ~pwhash_arena_scope();
+};
+
+// Whether libsodium's work areas reach the arenas, checked once.
+bool pwhash_arena_available ();
+
+// Starts lending arenas. Returns whether memory pressure is watched.
+bool pwhash_arena_enable (bool huge_pages);
+
+// Stops lending arenas and releases the idle ones.
+void pwhash_arena_disable ();
+
+// Releases the arenas not in use by a job, returning the bytes released.
+size_t pwhash_arena_trim ();
+
+// Bytes held by arenas, in use or not.
+size_t pwhash_arena_bytes ();
+
+#endif
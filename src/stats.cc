@@ -0,0 +1,270 @@
+#include "stats.h"
+#include "macros.h"
+
+#ifdef SODIUM_NATIVE_STATS
+
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <vector>
+#include <stdint.h>
+#include <stdlib.h>
+
+#define STATS_MAX_FUNCTIONS 512
+
+// HDR-style histogram of nanoseconds: exact below 2^SUB_BITS, then every power
+// of two is split into 2^SUB_BITS linear sub-buckets (at most 12.5% error).
+// Everything from 2^40ns (~18 minutes) up lands in the last bucket.
+#define STATS_SUB_BITS 3
+#define STATS_SUB_BUCKETS (1 << STATS_SUB_BITS)
+#define STATS_MAX_EXPONENT 40
+#define STATS_BUCKETS ((STATS_MAX_EXPONENT - STATS_SUB_BITS + 1) * STATS_SUB_BUCKETS)
+
+struct stats_counter {
+  std::atomic<uint64_t> calls;
+  std::atomic<uint64_t> bytes;
+  std::atomic<uint64_t> time;
+  std::atomic<uint64_t> buckets[STATS_BUCKETS];
+};
+
+// plain totals, only ever touched with stats_lock held
+struct stats_totals {
+  uint64_t calls;
+  uint64_t bytes;
+  uint64_t time;
+  uint64_t buckets[STATS_BUCKETS];
+};
+
+struct stats_thread {
+  // allocated on a function's first call on this thread
+  std::atomic<stats_counter *> counters[STATS_MAX_FUNCTIONS];
+};
+
+struct stats_function {
+  char *name;
+  Nan::FunctionCallback fn;
+};
+
+static std::mutex stats_lock;
+static stats_function stats_functions[STATS_MAX_FUNCTIONS];
+static uint32_t stats_function_count = 0;
+static std::vector<stats_thread *> stats_threads;
+// counts of threads that have exited, and the snapshot of the last reset
+static stats_totals stats_retired[STATS_MAX_FUNCTIONS];
+static stats_totals stats_baseline[STATS_MAX_FUNCTIONS];
+
+static void stats_add (stats_totals *dst, stats_counter *src) {
+  dst->calls += src->calls.load(std::memory_order_relaxed);
+  dst->bytes += src->bytes.load(std::memory_order_relaxed);
+  dst->time += src->time.load(std::memory_order_relaxed);
+  for (int i = 0; i < STATS_BUCKETS; i++) {
+    dst->buckets[i] += src->buckets[i].load(std::memory_order_relaxed);
+  }
+}
+
+// registers the thread on construction and folds its counts into
+// stats_retired when the thread (e.g. a worker) exits
+class stats_thread_holder {
+ public:
+  stats_thread *thread;
+
+  stats_thread_holder () {
+    thread = new stats_thread();
+    for (int i = 0; i < STATS_MAX_FUNCTIONS; i++) thread->counters[i] = NULL;
+
+    std::lock_guard<std::mutex> guard(stats_lock);
+    stats_threads.push_back(thread);
+  }
+
+  ~stats_thread_holder () {
+    std::lock_guard<std::mutex> guard(stats_lock);
+
+    for (size_t i = 0; i < stats_threads.size(); i++) {
+      if (stats_threads[i] != thread) continue;
+      stats_threads.erase(stats_threads.begin() + i);
+      break;
+    }
+
+    for (int i = 0; i < STATS_MAX_FUNCTIONS; i++) {
+      stats_counter *counter = thread->counters[i].load();
+      if (counter == NULL) continue;
+      stats_add(&stats_retired[i], counter);
+      delete counter;
+    }
+
+    delete thread;
+  }
+};
+
+static thread_local stats_thread_holder stats_holder;
+
+static inline int stats_bucket (uint64_t ns) {
+  if (ns < STATS_SUB_BUCKETS) return (int) ns;
+
+#if defined(__GNUC__) || defined(__clang__)
+  int exponent = 63 - __builtin_clzll(ns);
+#else
+  int exponent = STATS_SUB_BITS;
+  while (exponent < 63 && (ns >> (exponent + 1))) exponent++;
+#endif
+
+  if (exponent >= STATS_MAX_EXPONENT) return STATS_BUCKETS - 1;
+
+  int sub = (int) (ns >> (exponent - STATS_SUB_BITS)) & (STATS_SUB_BUCKETS - 1);
+  return (exponent - STATS_SUB_BITS + 1) * STATS_SUB_BUCKETS + sub;
+}
+
+// the largest value that maps to bucket, as reported by HDR histograms
+static uint64_t stats_bucket_max (int bucket) {
+  if (bucket < STATS_SUB_BUCKETS) return bucket;
+
+  int exponent = bucket / STATS_SUB_BUCKETS + STATS_SUB_BITS - 1;
+  uint64_t sub = bucket % STATS_SUB_BUCKETS;
+  uint64_t lower = (STATS_SUB_BUCKETS + sub) << (exponent - STATS_SUB_BITS);
+
+  return lower + (((uint64_t) 1) << (exponent - STATS_SUB_BITS)) - 1;
+}
+
+static inline void stats_increment (std::atomic<uint64_t> *counter, uint64_t value) {
+  // single writer, so a relaxed load and store is enough and avoids a locked op
+  counter->store(counter->load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+}
+
+static inline void stats_record (uint32_t id, uint64_t bytes, uint64_t ns) {
+  stats_thread *thread = stats_holder.thread;
+  stats_counter *counter = thread->counters[id].load(std::memory_order_relaxed);
+
+  if (counter == NULL) {
+    counter = new stats_counter();
+    counter->calls = 0;
+    counter->bytes = 0;
+    counter->time = 0;
+    for (int i = 0; i < STATS_BUCKETS; i++) counter->buckets[i] = 0;
+    thread->counters[id].store(counter, std::memory_order_release);
+  }
+
+  stats_increment(&(counter->calls), 1);
+  stats_increment(&(counter->bytes), bytes);
+  stats_increment(&(counter->time), ns);
+  stats_increment(&(counter->buckets[stats_bucket(ns)]), 1);
+}
+
+static NAN_METHOD(stats_trampoline) {
+  uint32_t id = Nan::To<uint32_t>(info.Data()).FromJust();
+  uint64_t bytes = 0;
+
+  for (int i = 0; i < info.Length(); i++) {
+    if (IS_BUFFER_SOURCE(info[i])) bytes += CLENGTH(info[i]);
+  }
+
+  uint64_t start = uv_hrtime();
+  stats_functions[id].fn(info);
+  stats_record(id, bytes, uv_hrtime() - start);
+}
+
+// functions are registered by name once per process, so every isolate
+// reports into the same entry
+static uint32_t stats_register (const char *name, Nan::FunctionCallback fn) {
+  std::lock_guard<std::mutex> guard(stats_lock);
+
+  for (uint32_t i = 0; i < stats_function_count; i++) {
+    if (strcmp(stats_functions[i].name, name) == 0) return i;
+  }
+
+  if (stats_function_count == STATS_MAX_FUNCTIONS) abort();
+
+  stats_functions[stats_function_count].name = strdup(name);
+  stats_functions[stats_function_count].fn = fn;
+  return stats_function_count++;
+}
+
+v8::Local<v8::Function> sodium_native_stats_function (const char *name, Nan::FunctionCallback fn) {
+  v8::Local<v8::Value> id = Nan::New<v8::Uint32>(stats_register(name, fn));
+  return Nan::GetFunction(Nan::New<v8::FunctionTemplate>(stats_trampoline, id)).ToLocalChecked();
+}
+
+void sodium_native_stats_prototype_method (v8::Local<v8::FunctionTemplate> tpl, const char *prefix, const char *name, Nan::FunctionCallback fn) {
+  std::string full = std::string(prefix) + "." + name;
+  v8::Local<v8::Value> id = Nan::New<v8::Uint32>(stats_register(full.c_str(), fn));
+  Nan::SetPrototypeMethod(tpl, name, stats_trampoline, id);
+}
+
+// sums every live thread and every exited one, with stats_lock held
+static void stats_collect (stats_totals *totals) {
+  memcpy(totals, stats_retired, sizeof(stats_retired));
+
+  for (size_t t = 0; t < stats_threads.size(); t++) {
+    for (uint32_t i = 0; i < stats_function_count; i++) {
+      stats_counter *counter = stats_threads[t]->counters[i].load(std::memory_order_acquire);
+      if (counter != NULL) stats_add(&totals[i], counter);
+    }
+  }
+}
+
+static uint64_t stats_percentile (stats_totals *totals, double percentile) {
+  // counters are read without stopping their writers, so go by the histogram
+  // itself rather than calls, which may be a few ahead
+  uint64_t count = 0;
+  for (int i = 0; i < STATS_BUCKETS; i++) count += totals->buckets[i];
+
+  uint64_t target = (uint64_t) (count * percentile / 100.0 + 0.5);
+  if (target == 0) target = 1;
+
+  uint64_t seen = 0;
+  for (int i = 0; i < STATS_BUCKETS; i++) {
+    seen += totals->buckets[i];
+    if (seen >= target) return stats_bucket_max(i);
+  }
+
+  return stats_bucket_max(STATS_BUCKETS - 1);
+}
+
+NAN_METHOD(sodium_native_stats) {
+  static stats_totals totals[STATS_MAX_FUNCTIONS];
+  v8::Local<v8::Object> result = Nan::New<v8::Object>();
+
+  std::lock_guard<std::mutex> guard(stats_lock);
+  stats_collect(totals);
+
+  for (uint32_t i = 0; i < stats_function_count; i++) {
+    stats_totals *t = &totals[i];
+    stats_totals *base = &stats_baseline[i];
+
+    t->calls -= base->calls;
+    if (t->calls == 0) continue;
+
+    t->bytes -= base->bytes;
+    t->time -= base->time;
+    for (int b = 0; b < STATS_BUCKETS; b++) t->buckets[b] -= base->buckets[b];
+
+    v8::Local<v8::Object> entry = Nan::New<v8::Object>();
+    Nan::Set(entry, LOCAL_STRING("calls"), Nan::New<v8::Number>((double) t->calls));
+    Nan::Set(entry, LOCAL_STRING("bytes"), Nan::New<v8::Number>((double) t->bytes));
+    Nan::Set(entry, LOCAL_STRING("time"), Nan::New<v8::Number>((double) t->time));
+    Nan::Set(entry, LOCAL_STRING("p50"), Nan::New<v8::Number>((double) stats_percentile(t, 50)));
+    Nan::Set(entry, LOCAL_STRING("p90"), Nan::New<v8::Number>((double) stats_percentile(t, 90)));
+    Nan::Set(entry, LOCAL_STRING("p99"), Nan::New<v8::Number>((double) stats_percentile(t, 99)));
+    Nan::Set(entry, LOCAL_STRING("p999"), Nan::New<v8::Number>((double) stats_percentile(t, 99.9)));
+    Nan::Set(entry, LOCAL_STRING("max"), Nan::New<v8::Number>((double) stats_percentile(t, 100)));
+    Nan::Set(result, LOCAL_STRING(stats_functions[i].name), entry);
+  }
+
+  info.GetReturnValue().Set(result);
+}
+
+// counters are owned by their threads, so a reset records a baseline that
+// later snapshots subtract instead of clearing them
+NAN_METHOD(sodium_native_reset_stats) {
+  std::lock_guard<std::mutex> guard(stats_lock);
+  stats_collect(stats_baseline);
+}
+
+#else
+
+NAN_METHOD(sodium_native_stats) {
+  info.GetReturnValue().Set(Nan::Null());
+}
+
+NAN_METHOD(sodium_native_reset_stats) {}
+
+#endif
@@ -0,0 +1,35 @@
+#ifndef SODIUM_NATIVE_STATS_H
+#define SODIUM_NATIVE_STATS_H
+
+#include <nan.h>
+
+// Opt-in instrumentation, enabled by building with SODIUM_NATIVE_STATS=1 in
+// the environment. Every exported function and instance method then goes
+// through a trampoline that counts calls, the bytes of all buffer arguments
+// and the wall time of the call into a log-linear latency histogram.
+//
+// Counters live in per-thread blocks that are only written by their own
+// thread, so recording takes no locks. Without the flag the macros below
+// expand to the plain Nan calls and nothing is recorded.
+
+#ifdef SODIUM_NATIVE_STATS
+
+v8::Local<v8::Function> sodium_native_stats_function (const char *name, Nan::FunctionCallback fn);
+void sodium_native_stats_prototype_method (v8::Local<v8::FunctionTemplate> tpl, const char *prefix, const char *name, Nan::FunctionCallback fn);
+
+#define STATS_FUNCTION(name, fn) sodium_native_stats_function(name, fn)
+#define STATS_PROTOTYPE_METHOD(tpl, prefix, name, fn) sodium_native_stats_prototype_method(tpl, prefix, name, fn);
+
+#else
+
+#define STATS_FUNCTION(name, fn) Nan::GetFunction(Nan::New<v8::FunctionTemplate>(fn)).ToLocalChecked()
+#define STATS_PROTOTYPE_METHOD(tpl, prefix, name, fn) Nan::SetPrototypeMethod(tpl, name, fn);
+
+#endif
+
+// sodium.stats() returns a snapshot keyed by function name, or null when
+// built without instrumentation. sodium.resetStats() starts a new window.
+NAN_METHOD(sodium_native_stats);
+NAN_METHOD(sodium_native_reset_stats);
+
+#endif
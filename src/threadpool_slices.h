@@ -0,0 +1,21 @@
+#ifndef SODIUM_NATIVE_THREADPOOL_SLICES_H
+#define SODIUM_NATIVE_THREADPOOL_SLICES_H
+
+#include <stddef.h>
+#include <stdlib.h>
+
+// Number of slices to split a job of the given number of units of work into,
+// one per libuv threadpool thread as sized by UV_THREADPOOL_SIZE, but never
+// more than there are units. libuv reads the variable the same way when it
+// starts its threads and caps it at 1024.
+static inline size_t threadpool_slices (size_t units) {
+  const char *env = getenv("UV_THREADPOOL_SIZE");
+  long threads = env == NULL ? 4 : atol(env);
+  if (threads < 1) threads = 1;
+  if (threads > 1024) threads = 1024;
+
+  if (units < 1) units = 1;
+  return units < (size_t) threads ? units : (size_t) threads;
+}
+
+#endif
@@ -0,0 +1,104 @@
+#ifndef SODIUM_NATIVE_TIMED_ASYNC_WORKER_H
+#define SODIUM_NATIVE_TIMED_ASYNC_WORKER_H
+
+#include <nan.h>
+#include <atomic>
+#include <stdint.h>
+
+// AsyncWorker that records when a job was queued, when it started and
+// finished running on the threadpool, and when its callback ran, so slow
+// calls can be split into queueing delay and actual work.
+//
+// Before the callback runs, the timestamps are set as `timing` on the
+// async_hooks resource of the job (in nanoseconds, on the same clock as
+// process.hrtime.bigint()). When the `sodium-native` trace category is
+// enabled, they are also emitted as nested async trace events:
+//
+//   <name>        queued until the callback returned
+//     queue       waiting for a threadpool thread
+//     execute     running on the threadpool
+//     complete    waiting for the event loop to pick up the result
+//     callback    running the javascript callback
+//
+// Subclasses implement Run() instead of Execute().
+
+#if NODE_MAJOR_VERSION >= 12
+#define HAVE_NODE_TRACING_CONTROLLER 1
+#endif
+
+// from trace_event_common.h, which is not part of node's public headers
+#define TIMED_ASYNC_PHASE_BEGIN 'b'
+#define TIMED_ASYNC_PHASE_END 'e'
+#define TIMED_ASYNC_FLAG_HAS_ID (1 << 1)
+
+class TimedAsyncWorker : public Nan::AsyncWorker {
+ public:
+  TimedAsyncWorker(Nan::Callback *callback, const char *resource_name)
+    : Nan::AsyncWorker(callback, resource_name), name(resource_name), execute_start(0), execute_end(0) {
+    static std::atomic<uint64_t> ids(0);
+    id = ++ids;
+    enqueue = uv_hrtime();
+  }
+
+  virtual void Run () = 0;
+
+  void Execute () {
+    execute_start = uv_hrtime();
+    Run();
+    execute_end = uv_hrtime();
+  }
+
+  void WorkComplete () {
+    Nan::HandleScope scope;
+
+    uint64_t callback_start = uv_hrtime();
+
+    v8::Local<v8::Object> timing = Nan::New<v8::Object>();
+    Nan::Set(timing, Nan::New("enqueue").ToLocalChecked(), Nan::New<v8::Number>((double) enqueue));
+    Nan::Set(timing, Nan::New("executeStart").ToLocalChecked(), Nan::New<v8::Number>((double) execute_start));
+    Nan::Set(timing, Nan::New("executeEnd").ToLocalChecked(), Nan::New<v8::Number>((double) execute_end));
+    Nan::Set(timing, Nan::New("callback").ToLocalChecked(), Nan::New<v8::Number>((double) callback_start));
+    Nan::Set(Nan::New(persistentHandle), Nan::New("timing").ToLocalChecked(), timing);
+
+    Nan::AsyncWorker::WorkComplete();
+
+    Trace(callback_start, uv_hrtime());
+  }
+
+ private:
+  const char *name;
+  uint64_t id;
+  uint64_t enqueue;
+  uint64_t execute_start;
+  uint64_t execute_end;
+
+  void Trace (uint64_t callback_start, uint64_t callback_end) {
+#ifdef HAVE_NODE_TRACING_CONTROLLER
+    v8::TracingController *controller = node::GetTracingController();
+    if (controller == NULL) return;
+
+    static const uint8_t *enabled = controller->GetCategoryGroupEnabled("sodium-native");
+    if (*enabled == 0) return;
+
+    Event(controller, enabled, TIMED_ASYNC_PHASE_BEGIN, name, enqueue);
+    Event(controller, enabled, TIMED_ASYNC_PHASE_BEGIN, "queue", enqueue);
+    Event(controller, enabled, TIMED_ASYNC_PHASE_END, "queue", execute_start);
+    Event(controller, enabled, TIMED_ASYNC_PHASE_BEGIN, "execute", execute_start);
+    Event(controller, enabled, TIMED_ASYNC_PHASE_END, "execute", execute_end);
+    Event(controller, enabled, TIMED_ASYNC_PHASE_BEGIN, "complete", execute_end);
+    Event(controller, enabled, TIMED_ASYNC_PHASE_END, "complete", callback_start);
+    Event(controller, enabled, TIMED_ASYNC_PHASE_BEGIN, "callback", callback_start);
+    Event(controller, enabled, TIMED_ASYNC_PHASE_END, "callback", callback_end);
+    Event(controller, enabled, TIMED_ASYNC_PHASE_END, name, callback_end);
+#endif
+  }
+
+#ifdef HAVE_NODE_TRACING_CONTROLLER
+  void Event (v8::TracingController *controller, const uint8_t *enabled, char phase, const char *event, uint64_t timestamp) {
+    // trace timestamps are in microseconds on the uv_hrtime clock
+    controller->AddTraceEventWithTimestamp(phase, enabled, event, NULL, id, 0, 0, NULL, NULL, NULL, NULL, TIMED_ASYNC_FLAG_HAS_ID, (int64_t) (timestamp / 1000));
+  }
+#endif
+};
+
+#endif
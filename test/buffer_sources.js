@@ -0,0 +1,100 @@
+var tape = require('tape')
+var sodium = require('../')
+
+tape('accepts typed arrays, DataView and ArrayBuffer', function (t) {
+  var message = Buffer.from('Hello, World!')
+  var expected = Buffer.alloc(sodium.crypto_generichash_BYTES)
+  sodium.crypto_generichash(expected, message)
+
+  var out = new Uint8Array(sodium.crypto_generichash_BYTES)
+  sodium.crypto_generichash(out, new Uint8Array(message))
+  t.same(Buffer.from(out), expected, 'Uint8Array')
+
+  var ab = new ArrayBuffer(message.length)
+  message.copy(Buffer.from(ab))
+  out = new ArrayBuffer(sodium.crypto_generichash_BYTES)
+  sodium.crypto_generichash(out, ab)
+  t.same(Buffer.from(out), expected, 'ArrayBuffer')
+
+  var view = new DataView(new ArrayBuffer(message.length))
+  message.copy(Buffer.from(view.buffer))
+  out = new Uint32Array(sodium.crypto_generichash_BYTES / 4)
+  sodium.crypto_generichash(out, view)
+  t.same(Buffer.from(out.buffer), expected, 'DataView and Uint32Array')
+
+  t.end()
+})
+
+tape('honours byteOffset and byteLength of views', function (t) {
+  var message = Buffer.from('Hello, World!')
+  var expected = Buffer.alloc(sodium.crypto_generichash_BYTES)
+  sodium.crypto_generichash(expected, message)
+
+  var backing = new ArrayBuffer(64 + message.length + 64)
+  var input = new Uint8Array(backing, 64, message.length)
+  input.set(message)
+
+  var outBacking = new ArrayBuffer(128)
+  var out = new DataView(outBacking, 32, sodium.crypto_generichash_BYTES)
+  sodium.crypto_generichash(out, input)
+
+  t.same(Buffer.from(outBacking, 32, sodium.crypto_generichash_BYTES), expected, 'read and write at offset')
+  t.ok(sodium.sodium_is_zero(new Uint8Array(outBacking, 0, 32)), 'bytes before the view untouched')
+  t.ok(sodium.sodium_is_zero(new Uint8Array(outBacking, 64)), 'bytes after the view untouched')
+
+  t.throws(function () {
+    sodium.crypto_generichash(new Uint8Array(backing, 0, sodium.crypto_generichash_BYTES_MIN - 1), input)
+  }, 'length is the view length, not the backing length')
+
+  t.end()
+})
+
+tape('encrypts a SharedArrayBuffer region in place', function (t) {
+  if (typeof SharedArrayBuffer === 'undefined') {
+    t.pass('SharedArrayBuffer not supported')
+    return t.end()
+  }
+
+  var key = Buffer.alloc(sodium.crypto_secretbox_KEYBYTES)
+  var nonce = Buffer.alloc(sodium.crypto_secretbox_NONCEBYTES)
+  sodium.randombytes_buf(key)
+  sodium.randombytes_buf(nonce)
+
+  var message = Buffer.from('shared memory')
+  var shared = new SharedArrayBuffer(256)
+  var plain = new Uint8Array(shared, 16, message.length)
+  var cipher = new Uint8Array(shared, 128, message.length + sodium.crypto_secretbox_MACBYTES)
+  plain.set(message)
+
+  sodium.crypto_secretbox_easy(cipher, plain, nonce, key)
+
+  var expected = Buffer.alloc(cipher.length)
+  sodium.crypto_secretbox_easy(expected, message, nonce, key)
+  t.same(Buffer.from(cipher), expected, 'ciphertext written into shared memory')
+
+  var decrypted = new Uint8Array(message.length)
+  t.ok(sodium.crypto_secretbox_open_easy(decrypted, cipher, nonce, key), 'decrypts from shared memory')
+  t.same(Buffer.from(decrypted), message, 'roundtrips')
+
+  var whole = new SharedArrayBuffer(sodium.crypto_generichash_BYTES)
+  sodium.crypto_generichash(whole, Buffer.from(shared, 16, message.length))
+  t.notOk(sodium.sodium_is_zero(new Uint8Array(whole)), 'plain SharedArrayBuffer as output')
+
+  t.end()
+})
+
+tape('rejects non buffer objects', function (t) {
+  t.throws(function () {
+    sodium.crypto_generichash(Buffer.alloc(32), {})
+  }, 'plain object')
+
+  t.throws(function () {
+    sodium.crypto_generichash(Buffer.alloc(32), [1, 2, 3])
+  }, 'array')
+
+  t.throws(function () {
+    sodium.crypto_generichash_batch(Buffer.alloc(32), [Buffer.alloc(1), {}])
+  }, 'plain object in batch')
+
+  t.end()
+})
@@ -0,0 +1,135 @@
+var tape = require('tape')
+var sodium = require('../')
+
+// kdf -> aead -> generichash -> sign, as a request handler would run them
+function program () {
+  var key = Buffer.alloc(sodium.crypto_kdf_KEYBYTES)
+  var pk = Buffer.alloc(sodium.crypto_sign_PUBLICKEYBYTES)
+  var sk = Buffer.alloc(sodium.crypto_sign_SECRETKEYBYTES)
+  var nonce = Buffer.alloc(sodium.crypto_aead_xchacha20poly1305_ietf_NPUBBYTES)
+  var message = Buffer.from('Hello, World!')
+
+  sodium.crypto_kdf_keygen(key)
+  sodium.crypto_sign_keypair(pk, sk)
+  sodium.randombytes_buf(nonce)
+
+  var buffers = [
+    key,
+    Buffer.from('context_'),
+    Buffer.alloc(sodium.crypto_aead_xchacha20poly1305_ietf_KEYBYTES),
+    nonce,
+    message,
+    Buffer.alloc(message.length + sodium.crypto_aead_xchacha20poly1305_ietf_ABYTES),
+    Buffer.alloc(sodium.crypto_generichash_BYTES),
+    sk,
+    Buffer.alloc(sodium.crypto_sign_BYTES),
+    pk,
+    Buffer.alloc(message.length)
+  ]
+
+  var commands = new Uint32Array([
+    sodium.sodium_command_crypto_kdf_derive_from_key, 2, 42, 1, 0,
+    sodium.sodium_command_crypto_aead_xchacha20poly1305_ietf_encrypt, 5, 4, sodium.sodium_command_NONE, 3, 2,
+    sodium.sodium_command_crypto_generichash, 6, 5, sodium.sodium_command_NONE,
+    sodium.sodium_command_crypto_sign_detached, 8, 6, 7,
+    sodium.sodium_command_crypto_sign_verify_detached, 8, 6, 9,
+    sodium.sodium_command_crypto_aead_xchacha20poly1305_ietf_decrypt, 10, 5, sodium.sodium_command_NONE, 3, 2
+  ])
+
+  return { commands: commands, buffers: buffers }
+}
+
+function expected (buffers) {
+  var subkey = Buffer.alloc(sodium.crypto_aead_xchacha20poly1305_ietf_KEYBYTES)
+  var ciphertext = Buffer.alloc(buffers[5].length)
+  var hash = Buffer.alloc(sodium.crypto_generichash_BYTES)
+  var sig = Buffer.alloc(sodium.crypto_sign_BYTES)
+
+  sodium.crypto_kdf_derive_from_key(subkey, 42, buffers[1], buffers[0])
+  sodium.crypto_aead_xchacha20poly1305_ietf_encrypt(ciphertext, buffers[4], null, null, buffers[3], subkey)
+  sodium.crypto_generichash(hash, ciphertext)
+  sodium.crypto_sign_detached(sig, hash, buffers[7])
+
+  return { subkey: subkey, ciphertext: ciphertext, hash: hash, sig: sig }
+}
+
+tape('sodium_command_buffer_run', function (t) {
+  var p = program()
+  var e = expected(p.buffers)
+
+  t.ok(sodium.sodium_command_buffer_run(p.commands, p.buffers))
+  t.same(p.buffers[2], e.subkey, 'subkey')
+  t.same(p.buffers[5], e.ciphertext, 'ciphertext')
+  t.same(p.buffers[6], e.hash, 'hash')
+  t.same(p.buffers[8], e.sig, 'signature')
+  t.same(p.buffers[10], p.buffers[4], 'decrypted')
+  t.end()
+})
+
+tape('sodium_command_buffer_run stops at a failed verification', function (t) {
+  var key = Buffer.alloc(sodium.crypto_secretbox_KEYBYTES)
+  var nonce = Buffer.alloc(sodium.crypto_secretbox_NONCEBYTES)
+  var ciphertext = Buffer.alloc(5 + sodium.crypto_secretbox_MACBYTES)
+  var message = Buffer.alloc(5)
+  var hash = Buffer.alloc(sodium.crypto_hash_sha256_BYTES)
+
+  sodium.randombytes_buf(key)
+  sodium.randombytes_buf(nonce)
+  sodium.crypto_secretbox_easy(ciphertext, Buffer.from('hello'), nonce, key)
+  ciphertext[0] ^= 1
+
+  var commands = new Uint32Array([
+    sodium.sodium_command_crypto_secretbox_open_easy, 0, 1, 2, 3,
+    sodium.sodium_command_crypto_hash_sha256, 4, 0
+  ])
+
+  t.notOk(sodium.sodium_command_buffer_run(commands, [message, ciphertext, nonce, key, hash]))
+  t.same(hash, Buffer.alloc(hash.length), 'later commands did not run')
+  t.end()
+})
+
+tape('sodium_command_buffer_run validates before running', function (t) {
+  var p = program()
+
+  var small = p.buffers.slice()
+  small[5] = Buffer.alloc(p.buffers[5].length - 1)
+
+  t.throws(function () {
+    sodium.sodium_command_buffer_run(p.commands, small)
+  }, /command 1: ciphertext/, 'short output')
+
+  t.same(p.buffers[2], Buffer.alloc(p.buffers[2].length), 'earlier commands did not run')
+
+  t.throws(function () {
+    sodium.sodium_command_buffer_run(p.commands, p.buffers.slice(0, 10))
+  }, /command 5/, 'missing slot')
+
+  t.throws(function () {
+    sodium.sodium_command_buffer_run(p.commands.subarray(0, 3), p.buffers)
+  }, /missing operands/, 'truncated')
+
+  t.throws(function () {
+    sodium.sodium_command_buffer_run(new Uint32Array([1000]), p.buffers)
+  }, /unknown opcode/, 'unknown opcode')
+
+  t.throws(function () {
+    sodium.sodium_command_buffer_run(Array.from(p.commands), p.buffers)
+  }, 'commands must be a Uint32Array')
+
+  t.same(p.buffers[2], Buffer.alloc(p.buffers[2].length), 'nothing ran')
+  t.end()
+})
+
+tape('sodium_command_buffer_run_async', function (t) {
+  var p = program()
+  var e = expected(p.buffers)
+
+  sodium.sodium_command_buffer_run_async(p.commands, p.buffers, function (err, ok) {
+    t.error(err)
+    t.ok(ok)
+    t.same(p.buffers[5], e.ciphertext, 'ciphertext')
+    t.same(p.buffers[8], e.sig, 'signature')
+    t.same(p.buffers[10], p.buffers[4], 'decrypted')
+    t.end()
+  })
+})
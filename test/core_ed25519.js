@@ -270,3 +270,295 @@ test('ported libsodium test', function (assert) {
   assert.ok(sodium.crypto_core_ed25519_UNIFORMBYTES >= sodium.crypto_core_ed25519_BYTES)
   assert.end()
 })
+
+function multiTerms (n) {
+  var scalars = Buffer.alloc(n * sodium.crypto_scalarmult_ed25519_SCALARBYTES)
+  var points = Buffer.alloc(n * sodium.crypto_scalarmult_ed25519_BYTES)
+  var r = Buffer.alloc(sodium.crypto_core_ed25519_UNIFORMBYTES)
+
+  sodium.randombytes_buf(scalars)
+  for (var i = 0; i < n; i++) {
+    sodium.randombytes_buf(r)
+    sodium.crypto_core_ed25519_from_uniform(points.subarray(i * 32, i * 32 + 32), r)
+  }
+
+  return { scalars: scalars, points: points }
+}
+
+function naiveSum (scalars, points) {
+  var sum = null
+  var q = Buffer.alloc(sodium.crypto_scalarmult_ed25519_BYTES)
+
+  for (var i = 0; i < scalars.length / 32; i++) {
+    sodium.crypto_scalarmult_ed25519_noclamp(q, scalars.subarray(i * 32, i * 32 + 32), points.subarray(i * 32, i * 32 + 32))
+    if (sum) sodium.crypto_core_ed25519_add(sum, sum, q)
+    else sum = Buffer.from(q)
+  }
+
+  return sum
+}
+
+test('crypto_scalarmult_ed25519_multi', function (assert) {
+  // both sides of the Straus / Pippenger threshold
+  ;[1, 2, 7, 63, 64, 65, 300].forEach(function (n) {
+    var terms = multiTerms(n)
+    var q = Buffer.alloc(sodium.crypto_scalarmult_ed25519_BYTES)
+
+    sodium.crypto_scalarmult_ed25519_multi(q, terms.scalars, terms.points)
+    assert.same(q, naiveSum(terms.scalars, terms.points), n + ' terms')
+  })
+
+  var terms = multiTerms(2)
+  var q = Buffer.alloc(sodium.crypto_scalarmult_ed25519_BYTES)
+
+  assert.throws(function () {
+    sodium.crypto_scalarmult_ed25519_multi(q, terms.scalars, terms.points.subarray(0, 32))
+  }, 'one point per scalar')
+
+  // s * P + (L - s) * P
+  terms.points.copy(terms.points, 32, 0, 32)
+  sodium.crypto_core_ed25519_scalar_reduce(terms.scalars.subarray(0, 32), Buffer.concat([terms.scalars.subarray(0, 32), Buffer.alloc(32)]))
+  sodium.crypto_core_ed25519_scalar_negate(terms.scalars.subarray(32), terms.scalars.subarray(0, 32))
+  assert.throws(function () {
+    sodium.crypto_scalarmult_ed25519_multi(q, terms.scalars, terms.points)
+  }, 'identity')
+
+  terms = multiTerms(2)
+  nonCanonicalP.copy(terms.points, 32)
+  assert.throws(function () {
+    sodium.crypto_scalarmult_ed25519_multi(q, terms.scalars, terms.points)
+  }, 'invalid point')
+
+  // a point plus one of order 8, on both sides of the Straus / Pippenger
+  // threshold, which noclamp rejects too
+  var torsion = Buffer.from('26e8958fc2b227b045c3f489f2ef98f0d5dfac05d3c63339b13802886d53fc05', 'hex')
+  ;[2, 100].forEach(function (n) {
+    var terms = multiTerms(n)
+    var mixed = terms.points.subarray(32, 64)
+
+    sodium.crypto_core_ed25519_add(mixed, mixed, torsion)
+    assert.throws(function () {
+      sodium.crypto_scalarmult_ed25519_noclamp(q, terms.scalars.subarray(32, 64), mixed)
+    }, 'noclamp rejects a mixed order point')
+    assert.throws(function () {
+      sodium.crypto_scalarmult_ed25519_multi(q, terms.scalars, terms.points)
+    }, n + ' terms with a mixed order point')
+  })
+
+  terms = multiTerms(2)
+  terms.scalars.fill(0, 32)
+  terms.scalars[63] = 0x80
+  assert.throws(function () {
+    sodium.crypto_scalarmult_ed25519_multi(q, terms.scalars, terms.points)
+  }, 'zero scalar')
+
+  assert.end()
+})
+
+test('crypto_scalarmult_ed25519_multi_async', function (assert) {
+  var terms = multiTerms(2000)
+  var q = Buffer.alloc(sodium.crypto_scalarmult_ed25519_BYTES)
+  var expected = Buffer.alloc(sodium.crypto_scalarmult_ed25519_BYTES)
+
+  sodium.crypto_scalarmult_ed25519_multi(expected, terms.scalars, terms.points)
+
+  sodium.crypto_scalarmult_ed25519_multi_async(q, terms.scalars, terms.points, function (err) {
+    assert.error(err)
+    assert.same(q, expected, 'same as sync')
+
+    nonCanonicalP.copy(terms.points, 1999 * 32)
+    sodium.crypto_scalarmult_ed25519_multi_async(q, terms.scalars, terms.points, function (err) {
+      assert.ok(err, 'invalid point')
+      assert.end()
+    })
+  })
+})
+
+test('crypto_core_ed25519 batch operations', function (assert) {
+  var n = 150
+  var r = Buffer.alloc(n * sodium.crypto_core_ed25519_UNIFORMBYTES)
+  var p = Buffer.alloc(n * sodium.crypto_core_ed25519_BYTES)
+  var q = Buffer.alloc(n * sodium.crypto_core_ed25519_BYTES)
+  var expected = Buffer.alloc(n * sodium.crypto_core_ed25519_BYTES)
+  var i
+
+  sodium.randombytes_buf(r)
+  sodium.crypto_core_ed25519_from_uniform_batch(p, r)
+  for (i = 0; i < n; i++) {
+    sodium.crypto_core_ed25519_from_uniform(expected.subarray(i * 32, i * 32 + 32), r.subarray(i * 32, i * 32 + 32))
+  }
+  assert.same(p, expected, 'from_uniform_batch')
+
+  sodium.randombytes_buf(r)
+  sodium.crypto_core_ed25519_from_uniform_batch(q, r)
+
+  var sum = Buffer.alloc(p.length)
+  sodium.crypto_core_ed25519_add_batch(sum, p, q)
+  for (i = 0; i < n; i++) {
+    sodium.crypto_core_ed25519_add(expected.subarray(i * 32, i * 32 + 32), p.subarray(i * 32, i * 32 + 32), q.subarray(i * 32, i * 32 + 32))
+  }
+  assert.same(sum, expected, 'add_batch')
+
+  sodium.crypto_core_ed25519_sub_batch(sum, sum, q)
+  assert.same(sum, p, 'sub_batch in place')
+
+  var results = Buffer.alloc(Math.ceil(n / 8))
+  assert.ok(sodium.crypto_core_ed25519_is_valid_point_batch(results, p), 'all valid')
+  assert.same(results.readUInt8(results.length - 1), 0x3f, 'trailing bits are cleared')
+
+  nonCanonicalP.copy(p, 3 * 32)
+  p.fill(0, 100 * 32, 101 * 32)
+  assert.notOk(sodium.crypto_core_ed25519_is_valid_point_batch(results, p), 'not all valid')
+  for (i = 0; i < n; i++) {
+    var bit = (results[i >> 3] >> (i & 7)) & 1
+    if (bit !== (sodium.crypto_core_ed25519_is_valid_point(p.subarray(i * 32, i * 32 + 32)) ? 1 : 0)) assert.fail('bit ' + i)
+  }
+
+  nonCanonicalInvalidP.copy(q, 7 * 32)
+  assert.throws(function () {
+    sodium.crypto_core_ed25519_add_batch(sum, p, q)
+  }, 'invalid point')
+
+  assert.throws(function () {
+    sodium.crypto_core_ed25519_add_batch(sum, p, q.subarray(32))
+  }, 'same number of points')
+
+  assert.end()
+})
+
+test('crypto_core_ed25519 batch operations async', function (assert) {
+  var n = 1000
+  var r = Buffer.alloc(n * sodium.crypto_core_ed25519_UNIFORMBYTES)
+  var p = Buffer.alloc(n * sodium.crypto_core_ed25519_BYTES)
+  var q = Buffer.alloc(n * sodium.crypto_core_ed25519_BYTES)
+  var sum = Buffer.alloc(n * sodium.crypto_core_ed25519_BYTES)
+  var results = Buffer.alloc(Math.ceil(n / 8))
+
+  sodium.randombytes_buf(r)
+  sodium.crypto_core_ed25519_from_uniform_batch(q, r)
+
+  sodium.crypto_core_ed25519_from_uniform_batch_async(p, r, function (err) {
+    assert.error(err)
+    assert.same(p, q, 'from_uniform_batch_async')
+
+    sodium.crypto_core_ed25519_add_batch_async(sum, p, q, function (err) {
+      assert.error(err)
+
+      sodium.crypto_core_ed25519_sub_batch_async(sum, sum, q, function (err) {
+        assert.error(err)
+        assert.same(sum, p, 'add then sub')
+
+        p.fill(0, 999 * 32)
+        sodium.crypto_core_ed25519_is_valid_point_batch_async(results, p, function (err, valid) {
+          assert.error(err)
+          assert.notOk(valid)
+          assert.same(results.readUInt8(124), 0x7f, 'last point invalid')
+          assert.end()
+        })
+      })
+    })
+  })
+})
+
+test('crypto_scalarmult_ed25519_fixed_base_instance', function (assert) {
+  var h = Buffer.alloc(sodium.crypto_core_ed25519_UNIFORMBYTES)
+  var p = Buffer.alloc(sodium.crypto_core_ed25519_BYTES)
+  sodium.randombytes_buf(h)
+  sodium.crypto_core_ed25519_from_uniform(p, h)
+
+  var base = sodium.crypto_scalarmult_ed25519_fixed_base_instance(p)
+  var n = 100
+  var scalars = Buffer.alloc(n * sodium.crypto_scalarmult_ed25519_SCALARBYTES)
+  var expected = Buffer.alloc(n * sodium.crypto_scalarmult_ed25519_BYTES)
+  var q = Buffer.alloc(sodium.crypto_scalarmult_ed25519_BYTES)
+
+  sodium.randombytes_buf(scalars)
+  scalars.fill(0xff, 0, 32)
+
+  for (var i = 0; i < n; i++) {
+    var s = scalars.subarray(i * 32, i * 32 + 32)
+    sodium.crypto_scalarmult_ed25519_noclamp(expected.subarray(i * 32, i * 32 + 32), s, p)
+    base.mul(q, s)
+    if (!q.equals(expected.subarray(i * 32, i * 32 + 32))) assert.fail('mul ' + i)
+  }
+
+  var many = Buffer.alloc(expected.length)
+  base.mulMany(many, scalars)
+  assert.same(many, expected, 'mulMany')
+
+  assert.throws(function () {
+    base.mul(q, Buffer.alloc(32))
+  }, 'zero scalar')
+
+  assert.throws(function () {
+    sodium.crypto_scalarmult_ed25519_fixed_base_instance(nonCanonicalP)
+  }, 'invalid point')
+
+  assert.end()
+})
+
+test('crypto_core_ed25519 scalar batch operations', function (assert) {
+  var n = 64
+  var x = Buffer.alloc(n * sodium.crypto_core_ed25519_SCALARBYTES)
+  var y = Buffer.alloc(n * sodium.crypto_core_ed25519_SCALARBYTES)
+  var z = Buffer.alloc(n * sodium.crypto_core_ed25519_SCALARBYTES)
+  var expected = Buffer.alloc(n * sodium.crypto_core_ed25519_SCALARBYTES)
+  var i
+
+  for (i = 0; i < n; i++) {
+    sodium.crypto_core_ed25519_scalar_random(x.subarray(i * 32, i * 32 + 32))
+    sodium.crypto_core_ed25519_scalar_random(y.subarray(i * 32, i * 32 + 32))
+  }
+
+  function each (fn, out, a, b) {
+    for (var i = 0; i < n; i++) {
+      if (b) fn(out.subarray(i * 32, i * 32 + 32), a.subarray(i * 32, i * 32 + 32), b.subarray(i * 32, i * 32 + 32))
+      else fn(out.subarray(i * 32, i * 32 + 32), a.subarray(i * 32, i * 32 + 32))
+    }
+  }
+
+  each(sodium.crypto_core_ed25519_scalar_add, expected, x, y)
+  sodium.crypto_core_ed25519_scalar_add_batch(z, x, y)
+  assert.same(z, expected, 'add')
+
+  each(sodium.crypto_core_ed25519_scalar_sub, expected, x, y)
+  sodium.crypto_core_ed25519_scalar_sub_batch(z, x, y)
+  assert.same(z, expected, 'sub')
+
+  each(sodium.crypto_core_ed25519_scalar_negate, expected, x)
+  sodium.crypto_core_ed25519_scalar_negate_batch(z, x)
+  assert.same(z, expected, 'negate')
+
+  each(sodium.crypto_core_ed25519_scalar_invert, expected, x)
+  sodium.crypto_core_ed25519_scalar_invert_batch(z, x)
+  assert.same(z, expected, 'invert')
+
+  // x * (1 / x) = 1
+  var one = Buffer.alloc(32)
+  one[0] = 1
+  sodium.crypto_core_ed25519_scalar_mul_batch(z, x, z)
+  for (i = 0; i < n; i++) {
+    if (!z.subarray(i * 32, i * 32 + 32).equals(one)) assert.fail('mul ' + i)
+  }
+
+  var q = Buffer.alloc(32)
+  sodium.crypto_core_ed25519_scalar_mul(q, x.subarray(0, 32), y.subarray(0, 32))
+  sodium.crypto_core_ed25519_scalar_mul_batch(z, x, y)
+  assert.same(q, z.subarray(0, 32), 'mul')
+
+  var wide = Buffer.alloc(n * sodium.crypto_core_ed25519_NONREDUCEDSCALARBYTES)
+  sodium.randombytes_buf(wide)
+  for (i = 0; i < n; i++) {
+    sodium.crypto_core_ed25519_scalar_reduce(expected.subarray(i * 32, i * 32 + 32), wide.subarray(i * 64, i * 64 + 64))
+  }
+  sodium.crypto_core_ed25519_scalar_reduce_batch(wide, wide)
+  assert.same(wide.subarray(0, n * 32), expected, 'reduce in place')
+
+  x.fill(0, 32, 64)
+  assert.throws(function () {
+    sodium.crypto_core_ed25519_scalar_invert_batch(z, x)
+  }, 'zero scalar')
+  assert.same(z.subarray(32, 64), Buffer.alloc(32), 'zero inverts to zero')
+
+  assert.end()
+})
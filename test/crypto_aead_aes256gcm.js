@@ -0,0 +1,107 @@
+var tape = require('tape')
+var sodium = require('../')
+
+var available = sodium.crypto_aead_aes256gcm_is_available()
+
+// AES-256 test case 16 of the GCM specification
+var vector = {
+  key: Buffer.from('feffe9928665731c6d6a8f9467308308feffe9928665731c6d6a8f9467308308', 'hex'),
+  nonce: Buffer.from('cafebabefacedbaddecaf888', 'hex'),
+  ad: Buffer.from('feedfacedeadbeeffeedfacedeadbeefabaddad2', 'hex'),
+  message: Buffer.from('d9313225f88406e5a55909c5aff5269a86a7a9531534f7da2e4c303d8a318a721c3c0c95956809532fcf0e2449a6b525b16aedf5aa0de657ba637b39', 'hex'),
+  ciphertext: Buffer.from('522dc1f099567d07f47f37a32a84427d643a8cdcbfe5c0c97598a2bd2555d1aa8cb08e48590dbb3da7b08b1056828838c5f61e6393ba7a0abcc9f662', 'hex'),
+  mac: Buffer.from('76fc6ece0f4e1768cddf8853bb2d551b', 'hex')
+}
+
+tape('constants', function (t) {
+  t.equal(typeof sodium.crypto_aead_aes256gcm_is_available(), 'boolean')
+  t.equal(sodium.crypto_aead_aes256gcm_ABYTES, 16)
+  t.equal(sodium.crypto_aead_aes256gcm_KEYBYTES, 32)
+  t.equal(sodium.crypto_aead_aes256gcm_NPUBBYTES, 12)
+  t.equal(sodium.crypto_aead_aes256gcm_NSECBYTES, 0)
+  t.end()
+})
+
+tape('crypto_aead_aes256gcm unavailable', { skip: available }, function (t) {
+  t.throws(function () {
+    sodium.crypto_aead_aes256gcm_instance(vector.key)
+  })
+  t.throws(function () {
+    sodium.crypto_aead_aes256gcm_encrypt(Buffer.alloc(16), Buffer.alloc(0), null, null, vector.nonce, vector.key)
+  })
+  t.end()
+})
+
+tape('crypto_aead_aes256gcm_encrypt', { skip: !available }, function (t) {
+  var ciphertext = Buffer.alloc(vector.message.length + sodium.crypto_aead_aes256gcm_ABYTES)
+
+  t.equal(sodium.crypto_aead_aes256gcm_encrypt(ciphertext, vector.message, vector.ad, null, vector.nonce, vector.key), ciphertext.length)
+  t.same(ciphertext, Buffer.concat([vector.ciphertext, vector.mac]), 'test vector')
+
+  var message = Buffer.alloc(vector.message.length)
+  t.equal(sodium.crypto_aead_aes256gcm_decrypt(message, null, ciphertext, vector.ad, vector.nonce, vector.key), message.length)
+  t.same(message, vector.message)
+
+  ciphertext[0] ^= 1
+  t.throws(function () {
+    sodium.crypto_aead_aes256gcm_decrypt(message, null, ciphertext, vector.ad, vector.nonce, vector.key)
+  }, 'tampered ciphertext')
+
+  t.throws(function () {
+    sodium.crypto_aead_aes256gcm_encrypt(Buffer.alloc(vector.message.length), vector.message, null, null, vector.nonce, vector.key)
+  }, 'ciphertext too short')
+
+  t.end()
+})
+
+tape('crypto_aead_aes256gcm_encrypt_detached', { skip: !available }, function (t) {
+  var ciphertext = Buffer.alloc(vector.message.length)
+  var mac = Buffer.alloc(sodium.crypto_aead_aes256gcm_ABYTES)
+
+  sodium.crypto_aead_aes256gcm_encrypt_detached(ciphertext, mac, vector.message, vector.ad, null, vector.nonce, vector.key)
+  t.same(ciphertext, vector.ciphertext)
+  t.same(mac, vector.mac)
+
+  var message = Buffer.alloc(ciphertext.length)
+  sodium.crypto_aead_aes256gcm_decrypt_detached(message, null, ciphertext, mac, vector.ad, vector.nonce, vector.key)
+  t.same(message, vector.message)
+
+  mac[0] ^= 1
+  t.throws(function () {
+    sodium.crypto_aead_aes256gcm_decrypt_detached(message, null, ciphertext, mac, vector.ad, vector.nonce, vector.key)
+  }, 'tampered mac')
+
+  t.end()
+})
+
+tape('crypto_aead_aes256gcm_instance', { skip: !available }, function (t) {
+  var instance = sodium.crypto_aead_aes256gcm_instance(vector.key)
+  var ciphertext = Buffer.alloc(vector.message.length + sodium.crypto_aead_aes256gcm_ABYTES)
+  var message = Buffer.alloc(vector.message.length)
+
+  t.equal(instance.encrypt(ciphertext, vector.message, vector.ad, null, vector.nonce), ciphertext.length)
+  t.same(ciphertext, Buffer.concat([vector.ciphertext, vector.mac]), 'test vector')
+  t.equal(instance.decrypt(message, null, ciphertext, vector.ad, vector.nonce), message.length)
+  t.same(message, vector.message)
+
+  var detached = Buffer.alloc(vector.message.length)
+  var mac = Buffer.alloc(sodium.crypto_aead_aes256gcm_ABYTES)
+  instance.encryptDetached(detached, mac, vector.message, vector.ad, null, vector.nonce)
+  t.same(detached, vector.ciphertext)
+  t.same(mac, vector.mac)
+
+  message.fill(0)
+  instance.decryptDetached(message, null, detached, mac, vector.ad, vector.nonce)
+  t.same(message, vector.message)
+
+  ciphertext[ciphertext.length - 1] ^= 1
+  t.throws(function () {
+    instance.decrypt(message, null, ciphertext, vector.ad, vector.nonce)
+  }, 'tampered mac')
+
+  t.throws(function () {
+    sodium.crypto_aead_aes256gcm_instance(Buffer.alloc(16))
+  }, 'short key')
+
+  t.end()
+})
@@ -287,6 +287,48 @@ test('non-detached -> detached', function (assert) {
   assert.end()
 })
 
+test('crypto_aead_xchacha20poly1305_ietf_encrypt_iov', function (assert) {
+  var m = Buffer.alloc(777)
+  var ad = Buffer.from('header')
+  var nonce = Buffer.alloc(sodium.crypto_aead_xchacha20poly1305_ietf_NPUBBYTES)
+  var key = Buffer.alloc(sodium.crypto_aead_xchacha20poly1305_ietf_KEYBYTES)
+  sodium.randombytes_buf(m)
+  sodium.randombytes_buf(nonce)
+  sodium.crypto_aead_xchacha20poly1305_ietf_keygen(key)
+
+  var expected = Buffer.alloc(m.byteLength + sodium.crypto_aead_xchacha20poly1305_ietf_ABYTES)
+  sodium.crypto_aead_xchacha20poly1305_ietf_encrypt(expected, m, ad, null, nonce, key)
+
+  var c = Buffer.alloc(expected.byteLength)
+  var clen = sodium.crypto_aead_xchacha20poly1305_ietf_encrypt_iov(split(c), split(m), ad, null, nonce, key)
+  assert.equal(clen, c.byteLength)
+  assert.same(c, expected, 'same as contiguous encrypt')
+
+  var m1 = Buffer.alloc(m.byteLength)
+  var mlen = sodium.crypto_aead_xchacha20poly1305_ietf_decrypt_iov(split(m1), null, split(c), ad, nonce, key)
+  assert.equal(mlen, m.byteLength)
+  assert.same(m1, m)
+
+  var m2 = Buffer.alloc(m.byteLength)
+  assert.throws(function () {
+    sodium.crypto_aead_xchacha20poly1305_ietf_decrypt_iov(split(m2), null, split(c), null, nonce, key)
+  }, 'wrong ad')
+  assert.same(m2, Buffer.alloc(m.byteLength), 'message not written')
+
+  assert.end()
+})
+
+function split (buf) {
+  var parts = []
+  var offset = 0
+  while (offset < buf.byteLength) {
+    var len = Math.min(buf.byteLength - offset, Math.floor(Math.random() * 100))
+    parts.push(buf.subarray(offset, offset + len))
+    offset += len
+  }
+  return parts
+}
+
 /**
  * Need to test in-place encryption
  * detach can talk to non detach
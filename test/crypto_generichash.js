@@ -127,3 +127,91 @@ tape('crypto_generichash_batch with key', function (t) {
   t.same(out.toString('hex'), '405f14acbeeb30396b8030f78e6a84bab0acf08cb1376aa200a500f669f675dc', 'batch keyed hash')
   t.end()
 })
+
+tape('crypto_generichash_init with caller-owned states', function (t) {
+  var key = Buffer.alloc(sodium.crypto_generichash_KEYBYTES, 'lo')
+  var input = Buffer.from('Hej, Verden')
+  var pool = Buffer.alloc(2 * sodium.crypto_generichash_STATEBYTES + 8)
+  var a = pool.subarray(0, sodium.crypto_generichash_STATEBYTES)
+  var b = pool.subarray(sodium.crypto_generichash_STATEBYTES + 8)
+
+  var expected = Buffer.alloc(sodium.crypto_generichash_BYTES)
+  var expectedKeyed = Buffer.alloc(sodium.crypto_generichash_BYTES_MAX)
+  sodium.crypto_generichash(expected, input)
+  sodium.crypto_generichash(expectedKeyed, input, key)
+
+  sodium.crypto_generichash_init(a)
+  sodium.crypto_generichash_init(b, key, sodium.crypto_generichash_BYTES_MAX)
+
+  for (var i = 0; i < input.length; i++) {
+    sodium.crypto_generichash_update(a, input.subarray(i, i + 1))
+    sodium.crypto_generichash_update(b, input.subarray(i, i + 1))
+  }
+
+  var out = Buffer.alloc(sodium.crypto_generichash_BYTES)
+  var outKeyed = Buffer.alloc(sodium.crypto_generichash_BYTES_MAX)
+  sodium.crypto_generichash_final(a, out)
+  sodium.crypto_generichash_final(b, outKeyed)
+
+  t.same(out, expected, 'interleaved states hash independently')
+  t.same(outKeyed, expectedKeyed, 'keyed state with output length')
+
+  t.throws(function () {
+    sodium.crypto_generichash_init(a, null, sodium.crypto_generichash_BYTES_MAX + 1)
+  }, 'should validate output length')
+
+  t.end()
+})
+
+tape('crypto_generichash_update refuses forged states', function (t) {
+  var state = Buffer.alloc(sodium.crypto_generichash_STATEBYTES)
+  var out = Buffer.alloc(sodium.crypto_generichash_BYTES)
+
+  t.throws(function () {
+    sodium.crypto_generichash_update(state, Buffer.from('hi'))
+  }, /crypto_generichash_init/, 'update of an uninitialised state')
+
+  sodium.crypto_generichash_init(state)
+  sodium.crypto_generichash_update(state, Buffer.from('hi'))
+
+  // the buffered length of a blake2b state sits after its 352 bytes of hash
+  // state and buffer
+  state[352] = 0xff
+  state[353] = 0xff
+
+  t.throws(function () {
+    sodium.crypto_generichash_update(state, Buffer.from('hi'))
+  }, /crypto_generichash_init/, 'update of a forged state')
+
+  t.throws(function () {
+    sodium.crypto_generichash_final(state, out)
+  }, /crypto_generichash_init/, 'final of a forged state')
+
+  t.end()
+})
+
+tape('crypto_generichash_iov', function (t) {
+  var input = Buffer.alloc(1234)
+  sodium.randombytes_buf(input)
+  var key = Buffer.alloc(sodium.crypto_generichash_KEYBYTES)
+  sodium.randombytes_buf(key)
+
+  var expected = Buffer.alloc(sodium.crypto_generichash_BYTES)
+  sodium.crypto_generichash(expected, input, key)
+
+  var output = Buffer.alloc(sodium.crypto_generichash_BYTES)
+  sodium.crypto_generichash_iov(output, [input.subarray(0, 100), Buffer.alloc(0), input.subarray(100, 129), input.subarray(129)], key)
+  t.same(output, expected, 'same as crypto_generichash over the concatenation')
+
+  var unkeyed = Buffer.alloc(sodium.crypto_generichash_BYTES_MAX)
+  sodium.crypto_generichash(unkeyed, input)
+  var large = Buffer.alloc(sodium.crypto_generichash_BYTES_MAX)
+  sodium.crypto_generichash_iov(large, [input.subarray(0, 1), input.subarray(1)])
+  t.same(large, unkeyed, 'unkeyed with BYTES_MAX output')
+
+  t.throws(function () {
+    sodium.crypto_generichash_iov(output, [input], Buffer.alloc(sodium.crypto_generichash_KEYBYTES_MAX + 1))
+  }, /KEYBYTES_MAX/, 'key longer than KEYBYTES_MAX')
+
+  t.end()
+})
@@ -0,0 +1,202 @@
+var tape = require('tape')
+var sodium = require('../')
+
+var MIN = 1024
+var AVG = 4096
+var MAX = 16384
+
+function capacity (length) {
+  return Math.floor(length / MIN) + 1
+}
+
+function digestAt (digests, i) {
+  return digests.slice(i * sodium.crypto_generichash_BYTES, (i + 1) * sodium.crypto_generichash_BYTES)
+}
+
+tape('crypto_generichash_chunks', function (t) {
+  var input = Buffer.alloc(256 * 1024)
+  sodium.randombytes_buf(input)
+
+  var lengths = new Uint32Array(capacity(input.length))
+  var digests = Buffer.alloc(lengths.length * sodium.crypto_generichash_BYTES)
+
+  var count = sodium.crypto_generichash_chunks(lengths, digests, input, MIN, AVG, MAX)
+  t.ok(count > 1, 'splits into several chunks')
+
+  var offset = 0
+  var ok = true
+  for (var i = 0; i < count; i++) {
+    var chunk = input.slice(offset, offset + lengths[i])
+    var expected = Buffer.alloc(sodium.crypto_generichash_BYTES)
+    sodium.crypto_generichash(expected, chunk)
+    if (!expected.equals(digestAt(digests, i))) ok = false
+    if (i < count - 1 && (lengths[i] <= MIN || lengths[i] > MAX)) ok = false
+    offset += lengths[i]
+  }
+
+  t.ok(ok, 'chunks are within bounds and digests match crypto_generichash')
+  t.same(offset, input.length, 'chunks cover the input')
+  t.end()
+})
+
+tape('crypto_generichash_chunks with key', function (t) {
+  var input = Buffer.alloc(64 * 1024)
+  var key = Buffer.alloc(sodium.crypto_generichash_KEYBYTES, 'lo')
+  sodium.randombytes_buf(input)
+
+  var lengths = new Uint32Array(capacity(input.length))
+  var digests = Buffer.alloc(lengths.length * sodium.crypto_generichash_BYTES)
+  var unkeyed = Buffer.alloc(digests.length)
+
+  var count = sodium.crypto_generichash_chunks(lengths, digests, input, MIN, AVG, MAX, key)
+  var unkeyedCount = sodium.crypto_generichash_chunks(new Uint32Array(lengths.length), unkeyed, input, MIN, AVG, MAX)
+
+  var expected = Buffer.alloc(sodium.crypto_generichash_BYTES)
+  sodium.crypto_generichash(expected, input.slice(0, lengths[0]), key)
+
+  t.same(count, unkeyedCount, 'key does not change boundaries')
+  t.same(digestAt(digests, 0), expected, 'keyed digest')
+  t.notSame(digestAt(unkeyed, 0), expected, 'unkeyed digest differs')
+  t.end()
+})
+
+tape('crypto_generichash_chunks key length', function (t) {
+  var input = Buffer.alloc(1024)
+  var lengths = new Uint32Array(capacity(input.length))
+  var digests = Buffer.alloc(lengths.length * sodium.crypto_generichash_BYTES)
+  var short = Buffer.alloc(sodium.crypto_generichash_KEYBYTES_MIN - 1)
+  var long = Buffer.alloc(sodium.crypto_generichash_KEYBYTES_MAX + 1)
+
+  t.throws(function () {
+    sodium.crypto_generichash_chunks(lengths, digests, input, MIN, AVG, MAX, short)
+  }, /crypto_generichash_KEYBYTES_MIN/, 'short key')
+
+  t.throws(function () {
+    sodium.crypto_generichash_chunks(lengths, digests, input, MIN, AVG, MAX, long)
+  }, /at most crypto_generichash_KEYBYTES_MAX/, 'long key')
+
+  t.throws(function () {
+    sodium.crypto_generichash_chunker_instance(MIN, AVG, MAX, long)
+  }, /at most crypto_generichash_KEYBYTES_MAX/, 'long key for an instance')
+
+  t.end()
+})
+
+tape('crypto_generichash_chunks is content defined', function (t) {
+  var input = Buffer.alloc(128 * 1024)
+  sodium.randombytes_buf(input)
+  var shifted = Buffer.concat([Buffer.from('prefix'), input])
+
+  var a = hashes(input)
+  var b = hashes(shifted)
+
+  var shared = a.filter(function (h) {
+    return b.indexOf(h) > -1
+  })
+
+  t.ok(shared.length >= a.length - 2, 'only the chunks around the edit change')
+  t.end()
+
+  function hashes (buf) {
+    var lengths = new Uint32Array(capacity(buf.length))
+    var digests = Buffer.alloc(lengths.length * sodium.crypto_generichash_BYTES)
+    var count = sodium.crypto_generichash_chunks(lengths, digests, buf, MIN, AVG, MAX)
+    var res = []
+    for (var i = 0; i < count; i++) res.push(digestAt(digests, i).toString('hex'))
+    return res
+  }
+})
+
+tape('crypto_generichash_chunks arguments', function (t) {
+  var input = Buffer.alloc(4096)
+  var lengths = new Uint32Array(capacity(input.length))
+  var digests = Buffer.alloc(lengths.length * sodium.crypto_generichash_BYTES)
+
+  t.throws(function () {
+    sodium.crypto_generichash_chunks(Buffer.alloc(lengths.length * 4), digests, input, MIN, AVG, MAX)
+  }, 'lengths must be a Uint32Array')
+
+  t.throws(function () {
+    sodium.crypto_generichash_chunks(new Uint32Array(1), digests, input, MIN, AVG, MAX)
+  }, 'lengths too small')
+
+  t.throws(function () {
+    sodium.crypto_generichash_chunks(lengths, Buffer.alloc(32), input, MIN, AVG, MAX)
+  }, 'digests too small')
+
+  t.throws(function () {
+    sodium.crypto_generichash_chunks(lengths, digests, input, 32, AVG, MAX)
+  }, 'min too small')
+
+  t.throws(function () {
+    sodium.crypto_generichash_chunks(lengths, digests, input, MIN, MAX * 2, MAX)
+  }, 'avg larger than max')
+
+  t.same(sodium.crypto_generichash_chunks(lengths, digests, Buffer.alloc(0), MIN, AVG, MAX), 0, 'no chunks for empty input')
+  t.same(sodium.crypto_generichash_chunks(lengths, digests, Buffer.alloc(10), MIN, AVG, MAX), 1, 'short input is one chunk')
+  t.end()
+})
+
+tape('crypto_generichash_chunker_instance', function (t) {
+  var input = Buffer.alloc(200 * 1024)
+  sodium.randombytes_buf(input)
+
+  var lengths = new Uint32Array(capacity(input.length))
+  var digests = Buffer.alloc(lengths.length * sodium.crypto_generichash_BYTES)
+  var count = sodium.crypto_generichash_chunks(lengths, digests, input, MIN, AVG, MAX)
+
+  var instance = sodium.crypto_generichash_chunker_instance(MIN, AVG, MAX)
+  var streamLengths = new Uint32Array(lengths.length)
+  var streamDigests = Buffer.alloc(digests.length)
+  var streamCount = 0
+
+  for (var offset = 0; offset < input.length;) {
+    var size = Math.min(1 + Math.floor(Math.random() * 10000), input.length - offset)
+    var l = new Uint32Array(capacity(size))
+    var d = Buffer.alloc(l.length * sodium.crypto_generichash_BYTES)
+    var n = instance.update(l, d, input.slice(offset, offset + size))
+    streamLengths.set(l.subarray(0, n), streamCount)
+    d.copy(streamDigests, streamCount * sodium.crypto_generichash_BYTES, 0, n * sodium.crypto_generichash_BYTES)
+    streamCount += n
+    offset += size
+  }
+
+  var last = new Uint32Array(1)
+  var lastDigest = Buffer.alloc(sodium.crypto_generichash_BYTES)
+  var n = instance.final(last, lastDigest)
+  streamLengths.set(last.subarray(0, n), streamCount)
+  lastDigest.copy(streamDigests, streamCount * sodium.crypto_generichash_BYTES, 0, n * sodium.crypto_generichash_BYTES)
+  streamCount += n
+
+  t.same(streamCount, count, 'same number of chunks')
+  t.same(Buffer.from(streamLengths.buffer), Buffer.from(lengths.buffer), 'same chunk lengths')
+  t.same(streamDigests, digests, 'same digests')
+  t.same(instance.final(last, lastDigest), 0, 'nothing left after final')
+  t.end()
+})
+
+tape('crypto_generichash_chunks_async', function (t) {
+  var input = Buffer.alloc(512 * 1024)
+  var key = Buffer.alloc(sodium.crypto_generichash_KEYBYTES, 'lo')
+  sodium.randombytes_buf(input)
+
+  var lengths = new Uint32Array(capacity(input.length))
+  var digests = Buffer.alloc(lengths.length * sodium.crypto_generichash_BYTES)
+  var count = sodium.crypto_generichash_chunks(lengths, digests, input, MIN, AVG, MAX, key)
+
+  var asyncLengths = new Uint32Array(lengths.length)
+  var asyncDigests = Buffer.alloc(digests.length)
+
+  sodium.crypto_generichash_chunks_async(asyncLengths, asyncDigests, input, MIN, AVG, MAX, key, function (err, asyncCount) {
+    t.error(err)
+    t.same(asyncCount, count, 'same number of chunks')
+    t.same(Buffer.from(asyncLengths.buffer), Buffer.from(lengths.buffer), 'same chunk lengths')
+    t.same(asyncDigests, digests, 'same digests')
+
+    sodium.crypto_generichash_chunks_async(asyncLengths, asyncDigests, input, MIN, AVG, MAX, function (err, count) {
+      t.error(err)
+      t.ok(count > 0, 'works without key')
+      t.end()
+    })
+  })
+})
@@ -30,3 +30,30 @@ tape('crypto_hash_sha256_instance', function (t) {
 
   t.end()
 })
+
+tape('crypto_hash_sha512_init with caller-owned states', function (t) {
+  var pool = Buffer.alloc(3 * sodium.crypto_hash_sha512_STATEBYTES + 1)
+  var expected = Buffer.alloc(sodium.crypto_hash_sha512_BYTES)
+  var out = Buffer.alloc(sodium.crypto_hash_sha512_BYTES)
+  var input = Buffer.from('Hej, Verden!')
+
+  sodium.crypto_hash_sha512(expected, input)
+
+  for (var i = 0; i < 3; i++) {
+    // the + 1 offset exercises unaligned states
+    var offset = i * sodium.crypto_hash_sha512_STATEBYTES + 1
+    var state = pool.subarray(offset, offset + sodium.crypto_hash_sha512_STATEBYTES)
+
+    sodium.crypto_hash_sha512_init(state)
+    sodium.crypto_hash_sha512_update(state, input.subarray(0, 4))
+    sodium.crypto_hash_sha512_update(state, input.subarray(4))
+    sodium.crypto_hash_sha512_final(state, out)
+    t.same(out, expected, 'state ' + i + ' matches crypto_hash_sha512')
+  }
+
+  t.throws(function () {
+    sodium.crypto_hash_sha512_init(Buffer.alloc(1))
+  }, 'should validate state length')
+
+  t.end()
+})
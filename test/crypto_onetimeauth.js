@@ -37,3 +37,48 @@ tape('crypto_onetimeauth_instance', function (t) {
 
   t.end()
 })
+
+tape('crypto_onetimeauth_init with caller-owned state', function (t) {
+  var key = Buffer.alloc(sodium.crypto_onetimeauth_KEYBYTES, 'lo')
+  var state = Buffer.alloc(sodium.crypto_onetimeauth_STATEBYTES)
+  var expected = Buffer.alloc(sodium.crypto_onetimeauth_BYTES)
+  var mac = Buffer.alloc(sodium.crypto_onetimeauth_BYTES)
+  var input = Buffer.from('Hello, World!')
+
+  sodium.crypto_onetimeauth(expected, input, key)
+
+  sodium.crypto_onetimeauth_init(state, key)
+  sodium.crypto_onetimeauth_update(state, input.subarray(0, 5))
+  sodium.crypto_onetimeauth_update(state, input.subarray(5))
+  sodium.crypto_onetimeauth_final(state, mac)
+
+  t.same(mac, expected, 'matches crypto_onetimeauth')
+  t.end()
+})
+
+tape('crypto_onetimeauth_update refuses forged states', function (t) {
+  var key = Buffer.alloc(sodium.crypto_onetimeauth_KEYBYTES, 'lo')
+  var state = Buffer.alloc(sodium.crypto_onetimeauth_STATEBYTES)
+  var mac = Buffer.alloc(sodium.crypto_onetimeauth_BYTES)
+
+  t.throws(function () {
+    sodium.crypto_onetimeauth_final(state, mac)
+  }, /crypto_onetimeauth_init/, 'final of an uninitialised state')
+
+  sodium.crypto_onetimeauth_init(state, key)
+  sodium.crypto_onetimeauth_update(state, Buffer.from('hello'))
+
+  // the number of buffered bytes is somewhere in the first 128 bytes, where
+  // depends on the poly1305 implementation
+  state.fill(0xff, 0, 128)
+
+  t.throws(function () {
+    sodium.crypto_onetimeauth_update(state, Buffer.from('hello'))
+  }, /crypto_onetimeauth_init/, 'update of a forged state')
+
+  t.throws(function () {
+    sodium.crypto_onetimeauth_final(state, mac)
+  }, /crypto_onetimeauth_init/, 'final of a forged state')
+
+  t.end()
+})
@@ -115,6 +115,34 @@ tape('crypto_pwhash_async', function (t) {
   })
 })
 
+tape('crypto_pwhash_async timing', function (t) {
+  var asyncHooks = require('async_hooks')
+  var resources = []
+
+  var hook = asyncHooks.createHook({
+    init: function (id, type, trigger, resource) {
+      if (type === 'sodium-native:crypto_pwhash_async') resources.push(resource)
+    }
+  }).enable()
+
+  var output = Buffer.alloc(32)
+  var passwd = Buffer.from('Hej, Verden!')
+  var salt = Buffer.alloc(sodium.crypto_pwhash_SALTBYTES, 'lo')
+
+  sodium.crypto_pwhash_async(output, passwd, salt, sodium.crypto_pwhash_OPSLIMIT_INTERACTIVE, sodium.crypto_pwhash_MEMLIMIT_INTERACTIVE, sodium.crypto_pwhash_ALG_DEFAULT, function (err) {
+    hook.disable()
+    t.error(err)
+    t.same(resources.length, 1, 'one resource')
+
+    var timing = resources[0].timing
+    t.ok(timing, 'timing is set before the callback')
+    t.ok(timing.enqueue <= timing.executeStart, 'queued before executing')
+    t.ok(timing.executeStart < timing.executeEnd, 'executed')
+    t.ok(timing.executeEnd <= timing.callback, 'called back after executing')
+    t.end()
+  })
+})
+
 tape('crypto_pwhash_str_async', function (t) {
   var output = Buffer.alloc(sodium.crypto_pwhash_STRBYTES)
   var passwd = Buffer.from('Hej, Verden!')
@@ -152,3 +180,50 @@ tape('crypto_pwhash limits', function (t) {
   }, 'should throw on large limits')
   t.end()
 })
+
+// the build and the tests see the same SODIUM_NATIVE_STATIC
+var staticLinux = process.platform === 'linux' && !!Number(process.env.SODIUM_NATIVE_STATIC || 0)
+
+tape('crypto_pwhash_arena_available in static Linux builds', { skip: !staticLinux }, function (t) {
+  t.ok(sodium.crypto_pwhash_arena_available(), 'libsodium maps its work areas through the arenas')
+  t.end()
+})
+
+tape('crypto_pwhash_async with arenas', function (t) {
+  if (!sodium.crypto_pwhash_arena_available()) {
+    t.throws(function () {
+      sodium.crypto_pwhash_arena_enable()
+    }, 'enable throws without arenas')
+    t.same(sodium.crypto_pwhash_arena_bytes(), 0)
+    t.end()
+    return
+  }
+
+  var expected = Buffer.alloc(32)
+  var output = Buffer.alloc(32)
+  var passwd = Buffer.from('Hej, Verden!')
+  var salt = Buffer.alloc(sodium.crypto_pwhash_SALTBYTES, 'lo')
+  var memlimit = 8 * 1024 * 1024
+
+  sodium.crypto_pwhash(expected, passwd, salt, sodium.crypto_pwhash_OPSLIMIT_MIN, memlimit, sodium.crypto_pwhash_ALG_DEFAULT)
+  sodium.crypto_pwhash_arena_enable()
+
+  sodium.crypto_pwhash_async(output, passwd, salt, sodium.crypto_pwhash_OPSLIMIT_MIN, memlimit, sodium.crypto_pwhash_ALG_DEFAULT, function (err) {
+    t.error(err)
+    t.same(output, expected, 'same hash')
+    t.ok(sodium.crypto_pwhash_arena_bytes() >= memlimit, 'kept the work area')
+
+    output.fill(0)
+
+    sodium.crypto_pwhash_async(output, passwd, salt, sodium.crypto_pwhash_OPSLIMIT_MIN, memlimit, sodium.crypto_pwhash_ALG_DEFAULT, function (err) {
+      t.error(err)
+      t.same(output, expected, 'same hash from a reused work area')
+
+      t.ok(sodium.crypto_pwhash_arena_trim() >= memlimit, 'trim releases idle arenas')
+      t.same(sodium.crypto_pwhash_arena_bytes(), 0)
+
+      sodium.crypto_pwhash_arena_disable()
+      t.end()
+    })
+  })
+})
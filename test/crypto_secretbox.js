@@ -75,3 +75,51 @@ tape('crypto_secretbox_detached', function (t) {
 
   t.end()
 })
+
+tape('crypto_secretbox_easy_iov', function (t) {
+  var message = Buffer.alloc(1000)
+  sodium.randombytes_buf(message)
+
+  var key = Buffer.alloc(sodium.crypto_secretbox_KEYBYTES)
+  sodium.randombytes_buf(key)
+
+  var nonce = Buffer.alloc(sodium.crypto_secretbox_NONCEBYTES)
+  sodium.randombytes_buf(nonce)
+
+  var expected = Buffer.alloc(message.length + sodium.crypto_secretbox_MACBYTES)
+  sodium.crypto_secretbox_easy(expected, message, nonce, key)
+
+  var output = Buffer.alloc(expected.length)
+  sodium.crypto_secretbox_easy_iov(split(output), split(message), nonce, key)
+  t.same(output, expected, 'same as crypto_secretbox_easy')
+
+  var single = Buffer.alloc(expected.length)
+  sodium.crypto_secretbox_easy_iov(single, message, nonce, key)
+  t.same(single, expected, 'accepts single buffers')
+
+  var result = Buffer.alloc(message.length)
+  t.ok(sodium.crypto_secretbox_open_easy_iov(split(result), split(output), nonce, key), 'could decrypt')
+  t.same(result, message, 'decrypted message is correct')
+
+  output[500] ^= 1
+  var untouched = Buffer.alloc(message.length)
+  t.notOk(sodium.crypto_secretbox_open_easy_iov(split(untouched), split(output), nonce, key), 'could not decrypt tampered')
+  t.same(untouched, Buffer.alloc(message.length), 'message not written')
+
+  t.throws(function () {
+    sodium.crypto_secretbox_easy_iov([Buffer.alloc(10)], [message], nonce, key)
+  }, 'ciphertext too short')
+
+  t.end()
+})
+
+function split (buf) {
+  var parts = []
+  var offset = 0
+  while (offset < buf.length) {
+    var len = Math.min(buf.length - offset, Math.floor(Math.random() * 80))
+    parts.push(buf.subarray(offset, offset + len))
+    offset += len
+  }
+  return parts
+}
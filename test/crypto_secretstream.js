@@ -149,3 +149,55 @@ test('crypto_secretstream', function (assert) {
 
   assert.end()
 })
+
+test('crypto_secretstream handles', function (assert) {
+  var key = Buffer.alloc(sodium.crypto_secretstream_xchacha20poly1305_KEYBYTES)
+  var header = Buffer.alloc(sodium.crypto_secretstream_xchacha20poly1305_HEADERBYTES)
+  var tag = Buffer.alloc(1)
+  sodium.crypto_secretstream_xchacha20poly1305_keygen(key)
+
+  var handles = []
+  for (var i = 0; i < 2000; i++) handles.push(sodium.crypto_secretstream_xchacha20poly1305_handle_new())
+
+  var push = handles[0]
+  var pull = handles[handles.length - 1]
+
+  var message = Buffer.from('handle message')
+  var ciphertext = Buffer.alloc(message.length + sodium.crypto_secretstream_xchacha20poly1305_ABYTES)
+  var plaintext = Buffer.alloc(message.length)
+
+  sodium.crypto_secretstream_xchacha20poly1305_init_push(push, header, key)
+  sodium.crypto_secretstream_xchacha20poly1305_push(push, ciphertext, message, null, sodium.crypto_secretstream_xchacha20poly1305_TAG_MESSAGE)
+  sodium.crypto_secretstream_xchacha20poly1305_init_pull(pull, header, key)
+  sodium.crypto_secretstream_xchacha20poly1305_pull(pull, plaintext, tag, ciphertext, null)
+  assert.same(plaintext, message, 'pulls what was pushed')
+
+  sodium.crypto_secretstream_xchacha20poly1305_rekey(push)
+  sodium.crypto_secretstream_xchacha20poly1305_rekey(pull)
+  sodium.crypto_secretstream_xchacha20poly1305_push(push, ciphertext, message, null, sodium.crypto_secretstream_xchacha20poly1305_TAG_FINAL)
+  sodium.crypto_secretstream_xchacha20poly1305_pull(pull, plaintext, tag, ciphertext, null)
+  assert.same(plaintext, message, 'rekeys by handle')
+  assert.same(tag, sodium.crypto_secretstream_xchacha20poly1305_TAG_FINAL)
+
+  var freed = handles[10]
+  sodium.crypto_secretstream_xchacha20poly1305_handle_free(freed)
+
+  assert.throws(function () {
+    sodium.crypto_secretstream_xchacha20poly1305_rekey(freed)
+  }, 'freed handles are rejected')
+
+  assert.throws(function () {
+    sodium.crypto_secretstream_xchacha20poly1305_handle_free(freed)
+  }, 'double free is rejected')
+
+  assert.throws(function () {
+    sodium.crypto_secretstream_xchacha20poly1305_rekey(1e9)
+  }, 'unknown handles are rejected')
+
+  assert.same(sodium.crypto_secretstream_xchacha20poly1305_handle_new(), freed, 'handles are reused')
+
+  handles.forEach(function (handle) {
+    sodium.crypto_secretstream_xchacha20poly1305_handle_free(handle)
+  })
+  assert.end()
+})
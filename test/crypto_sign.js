@@ -94,3 +94,195 @@ tape('crypto_sign_detached', function (t) {
 
   t.end()
 })
+
+tape('crypto_sign_verify_detached_many_async', function (t) {
+  var pk = Buffer.alloc(sodium.crypto_sign_PUBLICKEYBYTES)
+  var sk = Buffer.alloc(sodium.crypto_sign_SECRETKEYBYTES)
+  sodium.crypto_sign_keypair(pk, sk)
+
+  var signatures = []
+  var messages = []
+  var publicKeys = []
+
+  for (var i = 0; i < 301; i++) {
+    var message = Buffer.from('message ' + i)
+    var signature = Buffer.alloc(sodium.crypto_sign_BYTES)
+    sodium.crypto_sign_detached(signature, message, sk)
+    if (i % 37 === 3) signature[0] ^= 1
+    signatures.push(signature)
+    messages.push(message)
+    publicKeys.push(pk)
+  }
+
+  t.throws(function () {
+    sodium.crypto_sign_verify_detached_many_async(Buffer.alloc(1), signatures, messages, publicKeys, function () {})
+  }, 'should validate results length')
+
+  t.throws(function () {
+    sodium.crypto_sign_verify_detached_many_async(null, signatures, messages.slice(1), publicKeys, function () {})
+  }, 'should validate array lengths')
+
+  var results = Buffer.alloc(Math.ceil(signatures.length / 8), 0xff)
+
+  sodium.crypto_sign_verify_detached_many_async(results, signatures, messages, publicKeys, function (err, allValid) {
+    t.error(err)
+    t.notOk(allValid, 'not all valid')
+
+    var ok = true
+    for (var i = 0; i < signatures.length; i++) {
+      var bit = (results[i >> 3] >> (i & 7)) & 1
+      if (bit !== (sodium.crypto_sign_verify_detached(signatures[i], messages[i], publicKeys[i]) ? 1 : 0)) ok = false
+    }
+    t.ok(ok, 'bitmap matches crypto_sign_verify_detached')
+    t.same(results[results.length - 1] >> (signatures.length & 7), 0, 'trailing bits are cleared')
+
+    var valid = signatures.filter(function (s, i) {
+      return i % 37 !== 3
+    })
+
+    sodium.crypto_sign_verify_detached_many_async(null, valid, messages.filter(function (m, i) {
+      return i % 37 !== 3
+    }), publicKeys.slice(0, valid.length), function (err, allValid) {
+      t.error(err)
+      t.ok(allValid, 'all valid')
+
+      sodium.crypto_sign_verify_detached_many_async(null, signatures, messages, publicKeys, function (err, allValid) {
+        t.error(err)
+        t.notOk(allValid, 'exits early when one is invalid')
+
+        sodium.crypto_sign_verify_detached_many_async(null, [], [], [], function (err, allValid) {
+          t.error(err)
+          t.ok(allValid, 'empty input is valid')
+          t.end()
+        })
+      })
+    })
+  })
+})
+
+tape('crypto_sign_instance', function (t) {
+  var pk = Buffer.alloc(sodium.crypto_sign_PUBLICKEYBYTES)
+  var sk = Buffer.alloc(sodium.crypto_sign_SECRETKEYBYTES)
+  sodium.crypto_sign_keypair(pk, sk)
+
+  var instance = sodium.crypto_sign_instance(sk)
+  var messages = []
+  for (var i = 0; i < 20; i++) {
+    var message = Buffer.alloc(i * 7)
+    sodium.randombytes_buf(message)
+    messages.push(message)
+  }
+
+  var expected = Buffer.alloc(sodium.crypto_sign_BYTES)
+  var signature = Buffer.alloc(sodium.crypto_sign_BYTES)
+  sodium.crypto_sign_detached(expected, messages[5], sk)
+  instance.signDetached(signature, messages[5])
+  t.same(signature, expected, 'same signature as crypto_sign_detached')
+
+  var signed = Buffer.alloc(messages[5].length + sodium.crypto_sign_BYTES)
+  instance.sign(signed, messages[5])
+  t.same(signed, Buffer.concat([expected, messages[5]]), 'same as crypto_sign')
+
+  var signatures = Buffer.alloc(messages.length * sodium.crypto_sign_BYTES)
+  instance.signBatch(signatures, messages)
+
+  var valid = messages.every(function (message, i) {
+    var sig = signatures.subarray(i * sodium.crypto_sign_BYTES, (i + 1) * sodium.crypto_sign_BYTES)
+    sodium.crypto_sign_detached(expected, message, sk)
+    return expected.equals(sig) && sodium.crypto_sign_verify_detached(sig, message, pk)
+  })
+  t.ok(valid, 'batch signatures match and verify')
+
+  t.throws(function () {
+    instance.signBatch(Buffer.alloc(sodium.crypto_sign_BYTES), messages)
+  }, 'signatures too short')
+
+  t.throws(function () {
+    sodium.crypto_sign_instance(Buffer.alloc(10))
+  }, 'secret key too short')
+
+  t.end()
+})
+
+tape('crypto_sign_verify_instance', function (t) {
+  var pk = Buffer.alloc(sodium.crypto_sign_PUBLICKEYBYTES)
+  var sk = Buffer.alloc(sodium.crypto_sign_SECRETKEYBYTES)
+  sodium.crypto_sign_keypair(pk, sk)
+
+  var instance = sodium.crypto_sign_verify_instance(pk)
+
+  for (var i = 0; i < 50; i++) {
+    var message = Buffer.alloc(i * 3)
+    var signature = Buffer.alloc(sodium.crypto_sign_BYTES)
+    sodium.randombytes_buf(message)
+    sodium.crypto_sign_detached(signature, message, sk)
+
+    if (i % 2) signature[i % signature.length] ^= 1
+    if (i % 5 === 0 && message.length) message[0] ^= 1
+
+    var expected = sodium.crypto_sign_verify_detached(signature, message, pk)
+    if (instance.verifyDetached(signature, message) !== expected) break
+  }
+  t.equal(i, 50, 'same results as crypto_sign_verify_detached')
+
+  var signed = Buffer.alloc(10 + sodium.crypto_sign_BYTES)
+  var opened = Buffer.alloc(10)
+  sodium.crypto_sign(signed, Buffer.from('0123456789'), sk)
+  t.ok(instance.open(opened, signed), 'opens signed message')
+  t.same(opened, Buffer.from('0123456789'))
+
+  signed[0] ^= 1
+  t.notOk(instance.open(opened, signed), 'does not open tampered message')
+
+  var small = sodium.crypto_sign_verify_instance(Buffer.alloc(sodium.crypto_sign_PUBLICKEYBYTES))
+  t.notOk(small.verifyDetached(Buffer.alloc(sodium.crypto_sign_BYTES), Buffer.alloc(0)), 'small order key never verifies')
+
+  t.end()
+})
+
+tape('crypto_sign_verify_cache_instance', function (t) {
+  var pk = Buffer.alloc(sodium.crypto_sign_PUBLICKEYBYTES)
+  var sk = Buffer.alloc(sodium.crypto_sign_SECRETKEYBYTES)
+  sodium.crypto_sign_keypair(pk, sk)
+
+  var cache = sodium.crypto_sign_verify_cache_instance(100)
+  t.same(cache.stats(), { hits: 0, misses: 0, evictions: 0, size: 0, capacity: 104 }, 'capacity rounded up')
+
+  var message = Buffer.from('gossip')
+  var signature = Buffer.alloc(sodium.crypto_sign_BYTES)
+  sodium.crypto_sign_detached(signature, message, sk)
+
+  t.ok(cache.verifyDetached(signature, message, pk), 'verifies')
+  t.ok(cache.verifyDetached(signature, message, pk), 'verifies from cache')
+  t.same(cache.stats().hits, 1)
+  t.same(cache.stats().misses, 1)
+  t.same(cache.stats().size, 1)
+
+  var tampered = Buffer.from(signature)
+  tampered[0] ^= 1
+  t.notOk(cache.verifyDetached(tampered, message, pk), 'tampered signature')
+  t.notOk(cache.verifyDetached(signature, Buffer.from('gossiq'), pk), 'other message')
+  t.notOk(cache.verifyDetached(tampered, message, pk), 'failures are not cached')
+  t.same(cache.stats().size, 1)
+
+  for (var i = 0; i < 500; i++) {
+    var m = Buffer.alloc(8)
+    m.writeUInt32LE(i, 0)
+    sodium.crypto_sign_detached(signature, m, sk)
+    cache.verifyDetached(signature, m, pk)
+  }
+
+  var stats = cache.stats()
+  t.ok(stats.size <= 104, 'bounded')
+  t.ok(stats.evictions > 0, 'evicted')
+  t.same(stats.size + stats.evictions, 501, 'every insert is counted')
+
+  cache.clear()
+  t.same(cache.stats().size, 0, 'cleared')
+
+  t.throws(function () {
+    sodium.crypto_sign_verify_cache_instance(sodium.crypto_sign_verify_cache_CAPACITY_MAX + 1)
+  }, 'capacity is bounded')
+
+  t.end()
+})
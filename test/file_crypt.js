@@ -0,0 +1,230 @@
+var tape = require('tape')
+var fs = require('fs')
+var os = require('os')
+var path = require('path')
+var sodium = require('../')
+
+var dir = fs.mkdtempSync(path.join(os.tmpdir(), 'sodium-native-file-crypt-'))
+var plain = path.join(dir, 'plain')
+var encrypted = path.join(dir, 'encrypted')
+var decrypted = path.join(dir, 'decrypted')
+
+var CHUNK = 4096
+var ABYTES = sodium.crypto_aead_xchacha20poly1305_ietf_ABYTES
+
+var key = Buffer.alloc(sodium.crypto_aead_xchacha20poly1305_ietf_KEYBYTES)
+sodium.randombytes_buf(key)
+
+var engines = ['pread']
+if (sodium.crypto_aead_xchacha20poly1305_ietf_file_io_uring_available()) engines.push('io_uring')
+
+function roundtrip (t, data, engine, cb) {
+  fs.writeFileSync(plain, data)
+
+  var opts = { chunkSize: CHUNK, engine: engine, depth: 4 }
+
+  sodium.crypto_aead_xchacha20poly1305_ietf_encrypt_file_async(plain, encrypted, key, opts, function (err, used) {
+    t.error(err)
+    t.same(used, engine, 'ran on ' + engine)
+
+    var chunks = Math.max(1, Math.ceil(data.length / CHUNK))
+    var size = sodium.crypto_aead_xchacha20poly1305_ietf_FILE_HEADERBYTES + data.length + chunks * ABYTES
+    t.same(fs.statSync(encrypted).size, size, 'header and a MAC per chunk')
+
+    sodium.crypto_aead_xchacha20poly1305_ietf_decrypt_file_async(encrypted, decrypted, key, { engine: engine }, function (err) {
+      t.error(err)
+      t.same(fs.readFileSync(decrypted), data, 'decrypted')
+      cb()
+    })
+  })
+}
+
+engines.forEach(function (engine) {
+  tape('crypto_aead_xchacha20poly1305_ietf_encrypt_file_async with ' + engine, function (t) {
+    var data = Buffer.alloc(10 * CHUNK + 123)
+    sodium.randombytes_buf(data)
+
+    roundtrip(t, data, engine, function () {
+      roundtrip(t, Buffer.alloc(0), engine, function () {
+        roundtrip(t, data.subarray(0, 3 * CHUNK), engine, function () {
+          t.end()
+        })
+      })
+    })
+  })
+})
+
+tape('crypto_aead_xchacha20poly1305_ietf_decrypt_file_async detects tampering', function (t) {
+  var data = Buffer.alloc(4 * CHUNK)
+  sodium.randombytes_buf(data)
+
+  roundtrip(t, data, 'pread', function () {
+    var valid = fs.readFileSync(encrypted)
+    var stride = CHUNK + ABYTES
+    var header = sodium.crypto_aead_xchacha20poly1305_ietf_FILE_HEADERBYTES
+
+    var flipped = Buffer.from(valid)
+    flipped[header + stride + 10] ^= 1
+
+    var truncated = valid.subarray(0, header + 2 * stride)
+
+    var swapped = Buffer.concat([
+      valid.subarray(0, header),
+      valid.subarray(header + stride, header + 2 * stride),
+      valid.subarray(header, header + stride),
+      valid.subarray(header + 2 * stride)
+    ])
+
+    var cases = [[flipped, 'flipped bit'], [truncated, 'truncated at a chunk'], [swapped, 'reordered chunks']]
+
+    next(0)
+
+    function next (i) {
+      if (i === cases.length) return t.end()
+
+      fs.writeFileSync(encrypted, cases[i][0])
+      sodium.crypto_aead_xchacha20poly1305_ietf_decrypt_file_async(encrypted, decrypted, key, function (err) {
+        t.ok(err, cases[i][1])
+        t.same(err && err.code, 'EBADMSG')
+        next(i + 1)
+      })
+    }
+  })
+})
+
+tape('crypto_aead_xchacha20poly1305_ietf_encrypt_file_async with file descriptors', function (t) {
+  var data = Buffer.alloc(5 * CHUNK + 1)
+  sodium.randombytes_buf(data)
+  fs.writeFileSync(plain, data)
+
+  var input = fs.openSync(plain, 'r')
+  var output = fs.openSync(encrypted, 'w')
+
+  sodium.crypto_aead_xchacha20poly1305_ietf_encrypt_file_async(input, output, key, function (err) {
+    fs.closeSync(input)
+    fs.closeSync(output)
+    t.error(err)
+
+    sodium.crypto_aead_xchacha20poly1305_ietf_decrypt_file_async(encrypted, decrypted, key, function (err) {
+      t.error(err)
+      t.same(fs.readFileSync(decrypted), data, 'decrypted')
+      t.end()
+    })
+  })
+})
+
+tape('crypto_aead_xchacha20poly1305_ietf_encrypt_file_async truncates a larger output', function (t) {
+  var data = Buffer.alloc(2 * CHUNK + 7)
+  sodium.randombytes_buf(data)
+  fs.writeFileSync(plain, data)
+  fs.writeFileSync(encrypted, Buffer.alloc(8 * CHUNK, 'x'))
+
+  var output = fs.openSync(encrypted, 'r+')
+
+  sodium.crypto_aead_xchacha20poly1305_ietf_encrypt_file_async(plain, output, key, { chunkSize: CHUNK }, function (err) {
+    fs.closeSync(output)
+    t.error(err)
+
+    var size = sodium.crypto_aead_xchacha20poly1305_ietf_FILE_HEADERBYTES + data.length + 3 * ABYTES
+    t.same(fs.statSync(encrypted).size, size, 'no stale bytes after the result')
+
+    fs.writeFileSync(decrypted, Buffer.alloc(8 * CHUNK, 'x'))
+    output = fs.openSync(decrypted, 'r+')
+
+    sodium.crypto_aead_xchacha20poly1305_ietf_decrypt_file_async(encrypted, output, key, function (err) {
+      fs.closeSync(output)
+      t.error(err)
+      t.same(fs.readFileSync(decrypted), data, 'decrypted without stale bytes')
+      t.end()
+    })
+  })
+})
+
+tape('crypto_aead_xchacha20poly1305_ietf_decrypt_file_async leaves no partial output', function (t) {
+  var data = Buffer.alloc(4 * CHUNK)
+  sodium.randombytes_buf(data)
+
+  roundtrip(t, data, 'pread', function () {
+    var tampered = fs.readFileSync(encrypted)
+    var header = sodium.crypto_aead_xchacha20poly1305_ietf_FILE_HEADERBYTES
+    tampered[header + 3 * (CHUNK + ABYTES) + 10] ^= 1
+    fs.writeFileSync(encrypted, tampered)
+
+    // chunks before the last verify and would be written
+    fs.writeFileSync(decrypted, Buffer.alloc(8 * CHUNK, 'x'))
+
+    sodium.crypto_aead_xchacha20poly1305_ietf_decrypt_file_async(encrypted, decrypted, key, { threads: 1 }, function (err) {
+      t.same(err && err.code, 'EBADMSG')
+      t.same(fs.statSync(decrypted).size, 0, 'existing output emptied')
+
+      var fresh = path.join(dir, 'fresh')
+
+      sodium.crypto_aead_xchacha20poly1305_ietf_decrypt_file_async(encrypted, fresh, key, { threads: 1 }, function (err) {
+        t.same(err && err.code, 'EBADMSG')
+        t.notOk(fs.existsSync(fresh), 'created output removed')
+        t.end()
+      })
+    })
+  })
+})
+
+tape('crypto_aead_xchacha20poly1305_ietf_encrypt_file_async refuses to overwrite its input', function (t) {
+  var data = Buffer.alloc(3 * CHUNK)
+  sodium.randombytes_buf(data)
+  fs.writeFileSync(plain, data)
+
+  var link = path.join(dir, 'link')
+  fs.linkSync(plain, link)
+
+  sodium.crypto_aead_xchacha20poly1305_ietf_encrypt_file_async(plain, plain, key, function (err) {
+    t.same(err && err.code, 'EINVAL', 'same path')
+    t.same(fs.readFileSync(plain), data, 'input intact')
+
+    sodium.crypto_aead_xchacha20poly1305_ietf_decrypt_file_async(plain, link, key, function (err) {
+      t.same(err && err.code, 'EINVAL', 'hard link')
+      t.same(fs.readFileSync(plain), data, 'input intact')
+
+      var input = fs.openSync(plain, 'r')
+      var output = fs.openSync(plain, 'r+')
+
+      sodium.crypto_aead_xchacha20poly1305_ietf_encrypt_file_async(input, output, key, function (err) {
+        fs.closeSync(input)
+        fs.closeSync(output)
+        t.same(err && err.code, 'EINVAL', 'two fds on one file')
+        t.same(fs.readFileSync(plain), data, 'input intact')
+
+        fs.unlinkSync(link)
+        t.end()
+      })
+    })
+  })
+})
+
+tape('file encryption errors', function (t) {
+  t.throws(function () {
+    sodium.crypto_aead_xchacha20poly1305_ietf_encrypt_file_async(plain, encrypted, Buffer.alloc(5), function () {})
+  }, /key/, 'short key')
+
+  t.throws(function () {
+    sodium.crypto_aead_xchacha20poly1305_ietf_encrypt_file_async(plain, encrypted, key, { chunkSize: 100 }, function () {})
+  }, /chunkSize/, 'chunk too small')
+
+  t.throws(function () {
+    sodium.crypto_aead_xchacha20poly1305_ietf_encrypt_file_async(plain, encrypted, key, { engine: 'mmap' }, function () {})
+  }, /engine/, 'unknown engine')
+
+  t.throws(function () {
+    sodium.crypto_aead_xchacha20poly1305_ietf_encrypt_file_async(plain, encrypted, key, { get depth () { throw new Error('getter') } }, function () {})
+  }, /getter/, 'throwing option getter')
+
+  t.throws(function () {
+    sodium.crypto_aead_xchacha20poly1305_ietf_encrypt_file_async(null, encrypted, key, function () {})
+  }, /input/, 'input must be a file')
+
+  sodium.crypto_aead_xchacha20poly1305_ietf_encrypt_file_async(path.join(dir, 'missing'), encrypted, key, function (err) {
+    t.same(err && err.code, 'ENOENT', 'missing input')
+
+    fs.rmSync(dir, { recursive: true })
+    t.end()
+  })
+})
@@ -0,0 +1,101 @@
+var tape = require('tape')
+var fs = require('fs')
+var os = require('os')
+var path = require('path')
+var sodium = require('../')
+
+// spans several read blocks, and does not end on one
+var data = Buffer.alloc(3 * 1024 * 1024 + 1234)
+sodium.randombytes_buf(data)
+
+var file = path.join(os.tmpdir(), 'sodium-native-file-hash-' + process.pid)
+fs.writeFileSync(file, data)
+
+function sha256 (input) {
+  var out = Buffer.alloc(sodium.crypto_hash_sha256_BYTES)
+  sodium.crypto_hash_sha256(out, input)
+  return out
+}
+
+tape('crypto_generichash_file_async', function (t) {
+  var expected = Buffer.alloc(sodium.crypto_generichash_BYTES)
+  sodium.crypto_generichash(expected, data)
+
+  sodium.crypto_generichash_file_async(file, function (err, digest) {
+    t.error(err)
+    t.same(digest, expected, 'hashed the whole file')
+    t.end()
+  })
+})
+
+tape('crypto_generichash_file_async with key and outputLength', function (t) {
+  var key = Buffer.alloc(sodium.crypto_generichash_KEYBYTES, 'lo')
+  var expected = Buffer.alloc(sodium.crypto_generichash_BYTES_MAX)
+  sodium.crypto_generichash(expected, data, key)
+
+  var fd = fs.openSync(file, 'r')
+
+  sodium.crypto_generichash_file_async(fd, { key: key, outputLength: expected.length }, function (err, digest) {
+    fs.closeSync(fd)
+    t.error(err)
+    t.same(digest, expected, 'keyed hash of the whole file')
+    t.end()
+  })
+})
+
+tape('crypto_hash_sha256_file_async with a range', function (t) {
+  var offset = 1024 * 1024 - 7
+  var length = 2 * 1024 * 1024
+
+  sodium.crypto_hash_sha256_file_async(file, { offset: offset, length: length }, function (err, digest) {
+    t.error(err)
+    t.same(digest, sha256(data.subarray(offset, offset + length)), 'hashed the range')
+
+    sodium.crypto_hash_sha256_file_async(file, { offset: data.length - 10, length: 100 }, function (err, digest) {
+      t.error(err)
+      t.same(digest, sha256(data.subarray(data.length - 10)), 'stops at the end of the file')
+      t.end()
+    })
+  })
+})
+
+tape('crypto_hash_sha512_file_async', function (t) {
+  var expected = Buffer.alloc(sodium.crypto_hash_sha512_BYTES)
+  sodium.crypto_hash_sha512(expected, data.subarray(12345))
+
+  sodium.crypto_hash_sha512_file_async(file, { offset: 12345 }, function (err, digest) {
+    t.error(err)
+    t.same(digest, expected, 'hashed from offset to the end')
+    t.end()
+  })
+})
+
+tape('file hashing errors', function (t) {
+  t.throws(function () {
+    sodium.crypto_hash_sha256_file_async(Buffer.from(file), function () {})
+  }, /file descriptor or a path/, 'file must be a fd or a path')
+
+  t.throws(function () {
+    sodium.crypto_hash_sha256_file_async(file, { offset: -1 }, function () {})
+  }, /offset/, 'offset must not be negative')
+
+  t.throws(function () {
+    sodium.crypto_generichash_file_async(file, { outputLength: 1 }, function () {})
+  }, /outputLength/, 'outputLength must be in bounds')
+
+  t.throws(function () {
+    sodium.crypto_hash_sha256_file_async(file)
+  }, /callback/, 'callback is required')
+
+  t.throws(function () {
+    sodium.crypto_hash_sha256_file_async(file, { get offset () { throw new Error('getter') } }, function () {})
+  }, /getter/, 'throwing option getter')
+
+  sodium.crypto_hash_sha256_file_async(file + '-missing', function (err) {
+    t.ok(err, 'missing file')
+    t.same(err.code, 'ENOENT')
+
+    fs.unlinkSync(file)
+    t.end()
+  })
+})
@@ -0,0 +1,52 @@
+/* eslint-disable */
+// Runs every wrap class, so each isolate has to build its own templates
+module.exports = function (sodium, input, rounds) {
+  var key = Buffer.alloc(32, 'lo')
+  var nonce = Buffer.alloc(sodium.crypto_stream_NONCEBYTES, 'no')
+  var result = sodium.crypto_generichash_instance()
+
+  for (var i = 0; i < rounds; i++) {
+    var generichash = sodium.crypto_generichash_instance(key)
+    var sha256 = sodium.crypto_hash_sha256_instance()
+    var sha512 = sodium.crypto_hash_sha512_instance()
+    var onetimeauth = sodium.crypto_onetimeauth_instance(key)
+    var xor = sodium.crypto_stream_xor_instance(nonce, key)
+    var chacha = sodium.crypto_stream_chacha20_xor_instance(nonce.slice(0, sodium.crypto_stream_chacha20_NONCEBYTES), key)
+    var state = sodium.crypto_secretstream_xchacha20poly1305_state_new()
+    var header = Buffer.alloc(sodium.crypto_secretstream_xchacha20poly1305_HEADERBYTES)
+    var cipher = Buffer.alloc(input.length + sodium.crypto_secretstream_xchacha20poly1305_ABYTES)
+    var out = Buffer.alloc(64)
+
+    generichash.update(input)
+    generichash.final(out.slice(0, 32))
+    result.update(out.slice(0, 32))
+
+    sha256.update(input)
+    sha256.final(out.slice(0, 32))
+    result.update(out.slice(0, 32))
+
+    sha512.update(input)
+    sha512.final(out)
+    result.update(out)
+
+    onetimeauth.update(input)
+    onetimeauth.final(out.slice(0, 16))
+    result.update(out.slice(0, 16))
+
+    xor.update(cipher.slice(0, input.length), input)
+    xor.final()
+    result.update(cipher.slice(0, input.length))
+
+    chacha.update(cipher.slice(0, input.length), input)
+    chacha.final()
+    result.update(cipher.slice(0, input.length))
+
+    sodium.crypto_secretstream_xchacha20poly1305_init_push(state, header, key)
+    sodium.crypto_secretstream_xchacha20poly1305_push(state, cipher, input, null, sodium.crypto_secretstream_xchacha20poly1305_TAG_MESSAGE)
+    result.update(Buffer.from([cipher.length > input.length ? 1 : 0]))
+  }
+
+  var digest = Buffer.alloc(32)
+  result.final(digest)
+  return digest.toString('hex')
+}
@@ -0,0 +1,19 @@
+/* eslint-disable */
+var workerThreads = require('worker_threads')
+var sodium = require('../..')
+
+var data = workerThreads.workerData
+var input = Buffer.alloc(data.size, data.fill)
+
+if (data.mode === 'throughput') {
+  var out = Buffer.alloc(sodium.crypto_generichash_BYTES)
+  var ops = 0
+  var end = Date.now() + data.duration
+  while (Date.now() < end) {
+    for (var i = 0; i < 16; i++) sodium.crypto_generichash(out, input)
+    ops += 16
+  }
+  workerThreads.parentPort.postMessage({ ops: ops })
+} else {
+  workerThreads.parentPort.postMessage(require('./worker-workload')(sodium, input, data.rounds))
+}
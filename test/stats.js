@@ -0,0 +1,37 @@
+var tape = require('tape')
+var sodium = require('../')
+
+var stats = sodium.stats()
+
+tape('stats are null without instrumentation', { skip: stats !== null }, function (t) {
+  t.same(sodium.stats(), null)
+  sodium.resetStats()
+  t.end()
+})
+
+tape('stats count calls, bytes and latency', { skip: stats === null }, function (t) {
+  sodium.resetStats()
+
+  var output = Buffer.alloc(sodium.crypto_generichash_BYTES)
+  var input = Buffer.alloc(1000)
+
+  for (var i = 0; i < 10; i++) sodium.crypto_generichash(output, input)
+
+  var instance = sodium.crypto_generichash_instance()
+  instance.update(input)
+  instance.final(output)
+
+  var s = sodium.stats()
+  var hash = s.crypto_generichash
+
+  t.same(hash.calls, 10)
+  t.same(hash.bytes, 10 * (output.length + input.length))
+  t.ok(hash.time > 0, 'records time')
+  t.ok(hash.p50 <= hash.p99 && hash.p99 <= hash.max, 'percentiles are ordered')
+  t.same(s['crypto_generichash_instance.update'].calls, 1)
+  t.same(s['crypto_generichash_instance.update'].bytes, input.length)
+
+  sodium.resetStats()
+  t.notOk(sodium.stats().crypto_generichash, 'reset starts a new window')
+  t.end()
+})
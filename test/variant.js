@@ -0,0 +1,72 @@
+var tape = require('tape')
+var path = require('path')
+var variant = require('../variant')
+
+var root = path.join('/', 'sodium-native')
+var v3 = path.join(root, 'variants', 'x86-64-v3')
+var v4 = path.join(root, 'variants', 'x86-64-v4')
+
+var v3Flags = 'fpu sse2 avx avx2 bmi1 bmi2 f16c fma abm movbe xsave'
+var v4Flags = v3Flags + ' avx512f avx512bw avx512cd avx512dq avx512vl'
+
+function cpuinfo (flags) {
+  return function () {
+    return [
+      'processor\t: 0',
+      'model name\t: Some CPU',
+      'flags\t\t: ' + flags,
+      '',
+      'processor\t: 1',
+      'flags\t\t: ' + flags,
+      ''
+    ].join('\n')
+  }
+}
+
+function builds () {
+  var dirs = Array.prototype.slice.call(arguments)
+  return function (dir) {
+    return dirs.indexOf(dir) > -1
+  }
+}
+
+function noCpuinfo () {
+  throw new Error('cpuinfo should not be read')
+}
+
+tape('cpuFlags', function (t) {
+  t.same(variant.cpuFlags(cpuinfo('fpu  avx2 ')()), ['fpu', 'avx2'], 'flags of the first processor')
+  t.same(variant.cpuFlags('processor\t: 0\n'), [], 'no flags line')
+  t.same(variant.cpuFlags(null), [], 'no cpuinfo')
+  t.end()
+})
+
+tape('variant picks the best supported build', function (t) {
+  t.same(variant(root, {}, cpuinfo(v4Flags), builds(v3, v4)), v4, 'x86-64-v4')
+  t.same(variant(root, {}, cpuinfo(v3Flags), builds(v3, v4)), v3, 'x86-64-v3 without avx512')
+  t.same(variant(root, {}, cpuinfo(v4Flags), builds(v3)), v3, 'x86-64-v3 without a x86-64-v4 build')
+  t.end()
+})
+
+tape('variant falls back to the baseline', function (t) {
+  t.same(variant(root, {}, noCpuinfo, builds()), root, 'no variants, cpuinfo not read')
+  t.same(variant(root, {}, cpuinfo('fpu sse2'), builds(v3, v4)), root, 'old CPU')
+  t.same(variant(root, {}, cpuinfo(v4Flags.replace('avx2 ', '')), builds(v3, v4)), root, 'avx512 without the x86-64-v3 flags')
+  t.same(variant(root, {}, function () { return null }, builds(v3, v4)), root, 'no cpuinfo')
+  t.end()
+})
+
+tape('SODIUM_NATIVE_VARIANT overrides the selection', function (t) {
+  t.same(variant(root, { SODIUM_NATIVE_VARIANT: 'baseline' }, noCpuinfo, builds(v3, v4)), root, 'baseline')
+  t.same(variant(root, { SODIUM_NATIVE_VARIANT: 'x86-64-v4' }, noCpuinfo, builds(v3, v4)), v4, 'even if the CPU is not checked')
+
+  t.throws(function () {
+    variant(root, { SODIUM_NATIVE_VARIANT: 'x86-64-v9' }, noCpuinfo, builds(v3, v4))
+  }, /Unknown SODIUM_NATIVE_VARIANT x86-64-v9/, 'unknown variant')
+
+  t.throws(function () {
+    variant(root, { SODIUM_NATIVE_VARIANT: 'x86-64-v4' }, noCpuinfo, builds(v3))
+  }, /No x86-64-v4 build/, 'missing variant')
+
+  t.end()
+})
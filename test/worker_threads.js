@@ -0,0 +1,98 @@
+var tape = require('tape')
+var os = require('os')
+var sodium = require('../')
+
+var workerThreads = null
+try {
+  workerThreads = require('worker_threads')
+} catch (err) {
+  // worker_threads is not available on this node version
+}
+
+var fixture = require.resolve('./fixtures/worker')
+var workload = require('./fixtures/worker-workload')
+
+function run (workerData, cb) {
+  var worker = new workerThreads.Worker(fixture, { workerData: workerData })
+  var result = null
+  worker.once('message', function (msg) {
+    result = msg
+  })
+  worker.once('error', cb)
+  worker.once('exit', function (code) {
+    if (code !== 0) return cb(new Error('worker exited with ' + code))
+    cb(null, result)
+  })
+  return worker
+}
+
+tape('loads in many workers at once', { skip: !workerThreads }, function (t) {
+  var workers = 8
+  var data = { size: 1024, fill: 'sodium', rounds: 50 }
+  var expected = workload(sodium, Buffer.alloc(data.size, data.fill), data.rounds)
+  var pending = workers
+
+  for (var i = 0; i < workers; i++) {
+    run(data, function (err, result) {
+      t.error(err, 'worker exited cleanly')
+      t.same(result, expected, 'worker computed the same results as the main thread')
+      if (--pending === 0) t.end()
+    })
+  }
+})
+
+tape('workers can be terminated and reloaded', { skip: !workerThreads }, function (t) {
+  var rounds = 20
+  var data = { size: 64, fill: 'stress', rounds: 1000 }
+
+  loop(0)
+
+  function loop (i) {
+    if (i === rounds) {
+      t.pass('survived ' + rounds + ' terminated workers')
+      return t.end()
+    }
+
+    var worker = new workerThreads.Worker(fixture, { workerData: data })
+    worker.once('online', function () {
+      setTimeout(function () {
+        worker.terminate()
+      }, i % 5)
+    })
+    worker.once('exit', function () {
+      loop(i + 1)
+    })
+  }
+})
+
+tape('throughput scales across workers', { skip: !workerThreads }, function (t) {
+  var duration = 300
+  var data = { size: 64 * 1024, fill: 'throughput', mode: 'throughput', duration: duration }
+  var counts = [1, Math.max(2, Math.min(os.cpus().length, 8))]
+  var results = []
+
+  next(0)
+
+  function next (i) {
+    if (i === counts.length) {
+      t.ok(results[0] > 0, 'made progress')
+      return t.end()
+    }
+
+    var pending = counts[i]
+    var ops = 0
+
+    for (var j = 0; j < counts[i]; j++) {
+      run(data, function (err, result) {
+        t.error(err)
+        ops += result.ops
+        if (--pending > 0) return
+
+        var mbps = ops * data.size / (duration / 1000) / 1e6
+        t.comment(counts[i] + ' worker(s): ' + mbps.toFixed(1) + ' MB/s crypto_generichash')
+        results.push(ops)
+        next(i + 1)
+      })
+    }
+  }
+})
@@ -0,0 +1,64 @@
+var path = require('path')
+
+// Builds for newer x64 microarchitecture levels, best first. They are made by
+// prebuild-variants.js and each lives in variants/<name> with its own prebuilds.
+var variants = [
+  { name: 'x86-64-v4', flags: ['avx512f', 'avx512bw', 'avx512cd', 'avx512dq', 'avx512vl'] },
+  { name: 'x86-64-v3', flags: ['avx', 'avx2', 'bmi1', 'bmi2', 'f16c', 'fma', 'abm', 'movbe', 'xsave'] }
+]
+
+module.exports = variant
+module.exports.variants = variants
+module.exports.cpuFlags = cpuFlags
+
+// Picks the directory to load sodium.node from, root for the baseline build.
+// readCpuinfo() returns the text of /proc/cpuinfo or null, and is only called
+// once a variant has a build. loadable(dir) tells whether dir has a build for
+// this platform and node version.
+function variant (root, env, readCpuinfo, loadable) {
+  // SODIUM_NATIVE_VARIANT forces a variant, to compare them on one machine
+  var forced = env.SODIUM_NATIVE_VARIANT
+  if (forced === 'baseline') return root
+
+  if (forced) {
+    var known = variants.some(function (v) {
+      return v.name === forced
+    })
+
+    if (!known) {
+      throw new Error('Unknown SODIUM_NATIVE_VARIANT ' + forced + ', use baseline or ' + variants.map(function (v) {
+        return v.name
+      }).join(', '))
+    }
+
+    var dir = path.join(root, 'variants', forced)
+    if (!loadable(dir)) throw new Error('No ' + forced + ' build for this platform in ' + dir)
+    return dir
+  }
+
+  var flags = null
+
+  for (var i = 0; i < variants.length; i++) {
+    var candidate = path.join(root, 'variants', variants[i].name)
+    if (!loadable(candidate)) continue
+
+    if (flags === null) flags = cpuFlags(readCpuinfo())
+
+    // x86-64-v4 implies x86-64-v3, so the flags of every lower level are needed too
+    var supported = variants.slice(i).every(function (v) {
+      return v.flags.every(function (flag) {
+        return flags.indexOf(flag) > -1
+      })
+    })
+
+    if (supported) return candidate
+  }
+
+  return root
+}
+
+// the flags of the first processor in /proc/cpuinfo, they are the same for all
+function cpuFlags (cpuinfo) {
+  var match = cpuinfo && cpuinfo.match(/^flags\s*:(.*)$/m)
+  return match ? match[1].trim().split(/\s+/) : []
+}